@@ -5,9 +5,9 @@
  * Project  : lib-avr
  * Author   : Copyright (C) 2020 Johannes Krottmayer <krjdev@gmail.com>
  * Created  : 2020-03-08
- * Modified : 
+ * Modified : 2026-10-19
  * Revised  : 
- * Version  : 0.1.0.0
+ * Version  : 0.3.0.0
  * License  : ISC (see file LICENSE.txt)
  * Target   : Atmel AVR Series
  *
@@ -203,3 +203,171 @@ int can_frame_get_data(can_frame_t *frame, uint8_t *buf)
     
     return 0;
 }
+
+int can_frame_get_bits(can_frame_t *frame)
+{
+    if (!frame)
+        return -1;
+    
+    /* Nominal length from SOF to IFS, without stuff bits */
+    switch (frame->f_type) {
+    case CAN_TYPE_DATA_STD:
+        return (47 + (frame->f_d_std.dlen * 8));
+    case CAN_TYPE_DATA_EXT:
+        return (67 + (frame->f_d_ext.dlen * 8));
+    case CAN_TYPE_REMOTE_STD:
+        return 47;
+    case CAN_TYPE_REMOTE_EXT:
+        return 67;
+    default:
+        return -1;
+    }
+}
+
+int can_frame_pack(can_frame_t *frame, can_packed_t *pkd)
+{
+    if (!frame)
+        return -1;
+    
+    if (!pkd)
+        return -1;
+    
+    memset(pkd, 0, sizeof(can_packed_t));
+    
+    switch (frame->f_type) {
+    case CAN_TYPE_DATA_STD:
+        if (frame->f_d_std.dlen > CAN_DATA_LENMAX)
+            return -1;
+        
+        pkd->cp_id = frame->f_d_std.sid & CAN_ID_SFF_MASK;
+        pkd->cp_dlen = frame->f_d_std.dlen;
+        memcpy(pkd->cp_data, frame->f_d_std.data, pkd->cp_dlen);
+        break;
+    case CAN_TYPE_DATA_EXT:
+        if (frame->f_d_ext.dlen > CAN_DATA_LENMAX)
+            return -1;
+        
+        /* An eid above 18 bits would corrupt the SID, as in mcp2515 frame_id() */
+        pkd->cp_id = ((((uint32_t) frame->f_d_ext.sid << 18) | (frame->f_d_ext.eid & CAN_ID_EID_MASK)) & CAN_ID_EFF_MASK) | CAN_ID_EFF_FLAG;
+        pkd->cp_dlen = frame->f_d_ext.dlen;
+        memcpy(pkd->cp_data, frame->f_d_ext.data, pkd->cp_dlen);
+        break;
+    case CAN_TYPE_REMOTE_STD:
+        pkd->cp_id = (frame->f_r_std.sid & CAN_ID_SFF_MASK) | CAN_ID_RTR_FLAG;
+        break;
+    case CAN_TYPE_REMOTE_EXT:
+        pkd->cp_id = ((((uint32_t) frame->f_r_ext.sid << 18) | (frame->f_r_ext.eid & CAN_ID_EID_MASK)) & CAN_ID_EFF_MASK) | CAN_ID_EFF_FLAG | CAN_ID_RTR_FLAG;
+        break;
+    default:
+        return -1;
+    }
+    
+    return 0;
+}
+
+int can_frame_unpack(can_packed_t *pkd, can_frame_t *frame)
+{
+    uint32_t id;
+    
+    if (!pkd)
+        return -1;
+    
+    if (!frame)
+        return -1;
+    
+    id = pkd->cp_id;
+    
+    /* Error frames have no counterpart in can_frame_t */
+    if (id & CAN_ID_ERR_FLAG)
+        return -1;
+    
+    if (pkd->cp_dlen > CAN_DATA_LENMAX)
+        return -1;
+    
+    if (id & CAN_ID_EFF_FLAG) {
+        if (id & CAN_ID_RTR_FLAG) {
+            frame->f_type = CAN_TYPE_REMOTE_EXT;
+            frame->f_r_ext.sid = (uint16_t) ((id & CAN_ID_EFF_MASK) >> 18);
+            frame->f_r_ext.eid = id & CAN_ID_EID_MASK;
+        } else {
+            frame->f_type = CAN_TYPE_DATA_EXT;
+            frame->f_d_ext.sid = (uint16_t) ((id & CAN_ID_EFF_MASK) >> 18);
+            frame->f_d_ext.eid = id & CAN_ID_EID_MASK;
+            frame->f_d_ext.dlen = pkd->cp_dlen;
+            memcpy(frame->f_d_ext.data, pkd->cp_data, pkd->cp_dlen);
+        }
+    } else {
+        if (id & CAN_ID_RTR_FLAG) {
+            frame->f_type = CAN_TYPE_REMOTE_STD;
+            frame->f_r_std.sid = (uint16_t) (id & CAN_ID_SFF_MASK);
+        } else {
+            frame->f_type = CAN_TYPE_DATA_STD;
+            frame->f_d_std.sid = (uint16_t) (id & CAN_ID_SFF_MASK);
+            frame->f_d_std.dlen = pkd->cp_dlen;
+            memcpy(frame->f_d_std.data, pkd->cp_data, pkd->cp_dlen);
+        }
+    }
+    
+    return 0;
+}
+
+int can_frame_pack_batch(can_frame_t *frames, can_packed_t *pkd, int num)
+{
+    int i;
+    
+    if (!frames)
+        return -1;
+    
+    if (!pkd)
+        return -1;
+    
+    if (num < 0)
+        return -1;
+    
+    /* Stops at the first invalid frame, returns the frames packed */
+    for (i = 0; i < num; i++) {
+        if (can_frame_pack(&frames[i], &pkd[i]) == -1)
+            break;
+    }
+    
+    return i;
+}
+
+int can_frame_unpack_batch(can_packed_t *pkd, can_frame_t *frames, int num)
+{
+    int i;
+    
+    if (!pkd)
+        return -1;
+    
+    if (!frames)
+        return -1;
+    
+    if (num < 0)
+        return -1;
+    
+    for (i = 0; i < num; i++) {
+        if (can_frame_unpack(&pkd[i], &frames[i]) == -1)
+            break;
+    }
+    
+    return i;
+}
+
+int can_packed_get_bits(can_packed_t *pkd)
+{
+    int bits;
+    
+    if (!pkd)
+        return -1;
+    
+    if (pkd->cp_id & CAN_ID_EFF_FLAG)
+        bits = 67;
+    else
+        bits = 47;
+    
+    if (!(pkd->cp_id & CAN_ID_RTR_FLAG))
+        bits += (pkd->cp_dlen * 8);
+    
+    return bits;
+}
@@ -5,9 +5,9 @@
  * Project  : lib-avr
  * Author   : Copyright (C) 2020 Johannes Krottmayer <krjdev@gmail.com>
  * Created  : 2020-03-08
- * Modified : 
+ * Modified : 2026-10-19
  * Revised  : 
- * Version  : 0.1.0.0
+ * Version  : 0.3.0.0
  * License  : ISC (see file LICENSE.txt)
  * Target   : Atmel AVR Series
  *
@@ -71,6 +71,25 @@ typedef struct can_frame
     };
 } can_frame_t;
 
+/* Identifier word of the packed frame, same bits as SocketCAN can_id */
+#define CAN_ID_EFF_FLAG         0x80000000UL
+#define CAN_ID_RTR_FLAG         0x40000000UL
+#define CAN_ID_ERR_FLAG         0x20000000UL
+#define CAN_ID_SFF_MASK         0x000007FFUL
+#define CAN_ID_EFF_MASK         0x1FFFFFFFUL
+#define CAN_ID_EID_MASK         0x0003FFFFUL    /* Low 18 bits, the eid field */
+
+/* Packed 16 byte frame, layout of the Linux struct can_frame */
+typedef struct can_packed
+{
+    uint32_t cp_id;         /* (SID << 18) | EID for extended frames */
+    uint8_t cp_dlen;
+    uint8_t cp_pad;
+    uint8_t cp_res0;
+    uint8_t cp_res1;
+    uint8_t cp_data[CAN_DATA_LENMAX];
+} can_packed_t;
+
 extern int can_frame_set_sid(can_frame_t *frame, uint16_t sid);
 extern int can_frame_set_eid(can_frame_t *frame, uint32_t eid);
 extern int can_frame_set_data(can_frame_t *frame, uint8_t *buf, int len);
@@ -80,5 +99,11 @@ extern int can_frame_get_sid(can_frame_t *frame, uint16_t *sid);
 extern int can_frame_get_eid(can_frame_t *frame, uint32_t *eid);
 extern int can_frame_get_data_len(can_frame_t *frame, int *len);
 extern int can_frame_get_data(can_frame_t *frame, uint8_t *buf);
+extern int can_frame_get_bits(can_frame_t *frame);
+extern int can_frame_pack(can_frame_t *frame, can_packed_t *pkd);
+extern int can_frame_unpack(can_packed_t *pkd, can_frame_t *frame);
+extern int can_frame_pack_batch(can_frame_t *frames, can_packed_t *pkd, int num);
+extern int can_frame_unpack_batch(can_packed_t *pkd, can_frame_t *frames, int num);
+extern int can_packed_get_bits(can_packed_t *pkd);
 
 #endif
@@ -0,0 +1,217 @@
+/**
+ *
+ * File Name: can_if.c
+ * Title    : CAN controller interface
+ * Project  : lib-avr
+ * Author   : Copyright (C) 2026 Johannes Krottmayer <krjdev@gmail.com>
+ * Created  : 2026-10-19
+ * Modified : 
+ * Revised  : 
+ * Version  : 0.1.0.0
+ * License  : ISC (see file LICENSE.txt)
+ * Target   : Atmel AVR Series
+ *
+ * NOTE: This code is currently below version 1.0, and therefore is considered
+ * to be lacking in some functionality or documentation, or may not be fully
+ * tested. Nonetheless, you can expect most functions to work.
+ *
+ */
+
+#include "can_if.h"
+
+#if defined(CAN_DEVICE_SOCKETCAN)
+#include "can_socket.h"
+#elif defined(CAN_DEVICE_MCP2515)
+#include "../spi/mcp2515.h"
+#endif
+
+static int error = CAN_IF_ERROR_SUCCESS;
+
+int can_if_init(uint32_t bitrate)
+{
+    int ret;
+
+#if defined(CAN_DEVICE_SOCKETCAN)
+    ret = can_socket_init(CAN_SOCKET_IFNAME, bitrate);
+    
+    if (ret == -1) {
+        switch (can_socket_get_last_error()) {
+        case CAN_SOCKET_ERROR_INVAL:
+            error = CAN_IF_ERROR_INVAL;
+            break;
+        default:
+            error = CAN_IF_ERROR_DRIVER;
+        }
+    }
+#elif defined(CAN_DEVICE_MCP2515)
+    ret = mcp2515_init(bitrate, MCP2515_MODE_NORMAL);
+    
+    if (ret == -1) {
+        switch (mcp2515_get_last_error()) {
+        case MCP2515_ERR_INVAL:
+        case MCP2515_ERR_BITRATE:
+            error = CAN_IF_ERROR_INVAL;
+            break;
+        default:
+            error = CAN_IF_ERROR_DRIVER;
+        }
+    }
+#endif
+
+    return ret;
+}
+
+int can_if_set_filters(can_filter_t *rules, int num)
+{
+    int ret;
+
+#if defined(CAN_DEVICE_SOCKETCAN)
+    ret = can_socket_set_filters(rules, num);
+    
+    if (ret == -1) {
+        switch (can_socket_get_last_error()) {
+        case CAN_SOCKET_ERROR_INVAL:
+            error = CAN_IF_ERROR_INVAL;
+            break;
+        default:
+            error = CAN_IF_ERROR_DRIVER;
+        }
+    }
+#elif defined(CAN_DEVICE_MCP2515)
+    ret = mcp2515_set_filters(rules, num);
+    
+    if (ret == -1) {
+        switch (mcp2515_get_last_error()) {
+        case MCP2515_ERR_INVAL:
+            error = CAN_IF_ERROR_INVAL;
+            break;
+        default:
+            error = CAN_IF_ERROR_DRIVER;
+        }
+    }
+#endif
+
+    return ret;
+}
+
+int can_if_send(can_frame_t *frame)
+{
+    int ret;
+
+#if defined(CAN_DEVICE_SOCKETCAN)
+    ret = can_socket_send(frame);
+    
+    if (ret == -1) {
+        switch (can_socket_get_last_error()) {
+        case CAN_SOCKET_ERROR_INVAL:
+            error = CAN_IF_ERROR_INVAL;
+            break;
+        case CAN_SOCKET_ERROR_TXFULL:
+            error = CAN_IF_ERROR_TXFULL;
+            break;
+        default:
+            error = CAN_IF_ERROR_DRIVER;
+        }
+    }
+#elif defined(CAN_DEVICE_MCP2515)
+    mcp2515_poll();
+    ret = mcp2515_send(frame);
+    
+    if (ret == -1) {
+        switch (mcp2515_get_last_error()) {
+        case MCP2515_ERR_INVAL:
+            error = CAN_IF_ERROR_INVAL;
+            break;
+        case MCP2515_ERR_TXFULL:
+            error = CAN_IF_ERROR_TXFULL;
+            break;
+        default:
+            error = CAN_IF_ERROR_DRIVER;
+        }
+    }
+#endif
+
+    return ret;
+}
+
+int can_if_recv(can_frame_t *frame)
+{
+    int ret;
+
+#if defined(CAN_DEVICE_SOCKETCAN)
+    ret = can_socket_recv(frame);
+    
+    if (ret == -1) {
+        switch (can_socket_get_last_error()) {
+        case CAN_SOCKET_ERROR_INVAL:
+            error = CAN_IF_ERROR_INVAL;
+            break;
+        case CAN_SOCKET_ERROR_BUSOFF:
+            error = CAN_IF_ERROR_BUSOFF;
+            break;
+        default:
+            error = CAN_IF_ERROR_DRIVER;
+        }
+    }
+#elif defined(CAN_DEVICE_MCP2515)
+    mcp2515_poll();
+    ret = mcp2515_recv(frame);
+    
+    if (ret == -1) {
+        error = CAN_IF_ERROR_INVAL;
+    } else if (ret == 0) {
+        /* Bus-off is a state, the last error of the driver is kept */
+        if (mcp2515_is_busoff()) {
+            error = CAN_IF_ERROR_BUSOFF;
+            ret = -1;
+        }
+    }
+#endif
+
+    return ret;
+}
+
+void can_if_tick(void)
+{
+#if defined(CAN_DEVICE_SOCKETCAN)
+    can_socket_tick();
+#elif defined(CAN_DEVICE_MCP2515)
+    mcp2515_tick();
+#endif
+}
+
+char *can_if_get_driver_name(void)
+{
+#if defined(CAN_DEVICE_SOCKETCAN)
+    return can_socket_get_driver_name();
+#elif defined(CAN_DEVICE_MCP2515)
+    return mcp2515_get_driver_name();
+#endif
+}
+
+char *can_if_get_driver_vers(void)
+{
+#if defined(CAN_DEVICE_SOCKETCAN)
+    return can_socket_get_driver_vers();
+#elif defined(CAN_DEVICE_MCP2515)
+    return mcp2515_get_driver_vers();
+#endif
+}
+
+can_stats_t can_if_get_stats(void)
+{
+#if defined(CAN_DEVICE_SOCKETCAN)
+    return can_socket_get_stats();
+#elif defined(CAN_DEVICE_MCP2515)
+    return mcp2515_get_stats();
+#endif
+}
+
+int can_if_get_last_error(void)
+{
+    int err;
+    
+    err = error;
+    error = CAN_IF_ERROR_SUCCESS;
+    return err;
+}
@@ -0,0 +1,77 @@
+/**
+ *
+ * File Name: can_if.h
+ * Title    : Generic CAN controller wrapper library
+ * Project  : lib-avr
+ * Author   : Copyright (C) 2026 Johannes Krottmayer <krjdev@gmail.com>
+ * Created  : 2026-10-19
+ * Modified : 
+ * Revised  : 
+ * Version  : 0.1.0.0
+ * License  : ISC (see file LICENSE.txt)
+ * Target   : Atmel AVR Series
+ *
+ * NOTE: This code is currently below version 1.0, and therefore is considered
+ * to be lacking in some functionality or documentation, or may not be fully
+ * tested. Nonetheless, you can expect most functions to work.
+ *
+ */
+
+#ifndef LIBAVR_CAN_CAN_IF_H
+#define LIBAVR_CAN_CAN_IF_H
+
+#include <stdint.h>
+
+#include "can.h"
+
+/* CAN controllers, the host backend is selected with -DCAN_DEVICE_SOCKETCAN */
+#ifndef CAN_DEVICE_SOCKETCAN
+#define CAN_DEVICE_MCP2515
+#endif
+
+/* SocketCAN backend (ip link add dev vcan0 type vcan) */
+#ifndef CAN_SOCKET_IFNAME
+#define CAN_SOCKET_IFNAME       "vcan0"
+#endif
+
+/* Interval of can_if_tick() calls, base of the bus load */
+#define CAN_IF_TICK_MS          1000
+
+#define CAN_IF_FILTER_MAX       16
+
+/* Error codes */
+#define CAN_IF_ERROR_SUCCESS    0
+#define CAN_IF_ERROR_INVAL      1
+#define CAN_IF_ERROR_DRIVER     2
+#define CAN_IF_ERROR_TXFULL     3
+#define CAN_IF_ERROR_BUSOFF     4
+
+/* Acceptance rule, identifiers are 11 (standard) or 29 bit (extended) */
+typedef struct can_filter {
+    uint8_t cf_ext;         /* 0: standard, 1: extended frames */
+    uint32_t cf_id;         /* (SID << 18) | EID for extended frames */
+    uint32_t cf_mask;       /* Set bits must match cf_id */
+} can_filter_t;
+
+typedef struct can_stats {
+    uint32_t rx_frm;
+    uint32_t tx_frm;
+    uint16_t rx_drop;       /* RX queue full or controller overrun */
+    uint16_t rx_filt;       /* Passed hardware, rejected by software filter */
+    uint16_t tx_err;
+    uint8_t tec;            /* Transmit error counter */
+    uint8_t rec;            /* Receive error counter */
+    uint16_t bus_load;      /* Permille of the last tick interval */
+} can_stats_t;
+
+extern int can_if_init(uint32_t bitrate);
+extern int can_if_set_filters(can_filter_t *rules, int num);
+extern int can_if_send(can_frame_t *frame);
+extern int can_if_recv(can_frame_t *frame);
+extern void can_if_tick(void);
+extern char *can_if_get_driver_name(void);
+extern char *can_if_get_driver_vers(void);
+extern can_stats_t can_if_get_stats(void);
+extern int can_if_get_last_error(void);
+
+#endif
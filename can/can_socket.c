@@ -0,0 +1,251 @@
+/**
+ *
+ * File Name: can_socket.c
+ * Title    : Linux SocketCAN CAN backend
+ * Project  : lib-avr
+ * Author   : Copyright (C) 2026 Johannes Krottmayer <krjdev@gmail.com>
+ * Created  : 2026-10-19
+ * Modified : 2026-10-19
+ * Revised  : 
+ * Version  : 0.2.0.0
+ * License  : ISC (see file LICENSE.txt)
+ * Target   : Linux (host)
+ *
+ * NOTE: This code is currently below version 1.0, and therefore is considered
+ * to be lacking in some functionality or documentation, or may not be fully
+ * tested. Nonetheless, you can expect most functions to work.
+ *
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <net/if.h>
+
+/* Kernel structures share their names with the ones of this library */
+#define can_frame   linux_can_frame
+#define can_filter  linux_can_filter
+#include <linux/can.h>
+#include <linux/can/error.h>
+#include <linux/can/raw.h>
+#undef can_frame
+#undef can_filter
+
+#include "can_socket.h"
+
+#define DRIVER_NAME         "Linux SocketCAN"
+#define DRIVER_VERSION      "0.2.0.0"
+
+static int error = CAN_SOCKET_ERROR_SUCCESS;
+static int fd = -1;
+static can_stats_t stats;
+static uint32_t bus_rate;
+static uint32_t bus_bits;
+
+int can_socket_init(const char *ifname, uint32_t bitrate)
+{
+    struct sockaddr_can addr;
+    struct ifreq ifr;
+    can_err_mask_t err_mask;
+    
+    if (!ifname || (bitrate < 1000)) {
+        error = CAN_SOCKET_ERROR_INVAL;
+        return -1;
+    }
+    
+    if (fd != -1)
+        close(fd);
+    
+    fd = socket(PF_CAN, SOCK_RAW | SOCK_NONBLOCK, CAN_RAW);
+    
+    if (fd == -1) {
+        error = CAN_SOCKET_ERROR_OPEN;
+        return -1;
+    }
+    
+    memset(&ifr, 0, sizeof(struct ifreq));
+    strncpy(ifr.ifr_name, ifname, IFNAMSIZ - 1);
+    
+    if (ioctl(fd, SIOCGIFINDEX, &ifr) == -1)
+        goto err_close;
+    
+    memset(&addr, 0, sizeof(struct sockaddr_can));
+    addr.can_family = AF_CAN;
+    addr.can_ifindex = ifr.ifr_ifindex;
+    
+    if (bind(fd, (struct sockaddr *) &addr, sizeof(struct sockaddr_can)) == -1)
+        goto err_close;
+    
+    /* Error frames feed the statistics, a virtual bus never sends them */
+    err_mask = CAN_ERR_CRTL | CAN_ERR_BUSOFF;
+#ifdef CAN_ERR_CNT
+    err_mask |= CAN_ERR_CNT;
+#endif
+    setsockopt(fd, SOL_CAN_RAW, CAN_RAW_ERR_FILTER, &err_mask, sizeof(err_mask));
+    memset(&stats, 0, sizeof(can_stats_t));
+    bus_rate = bitrate;
+    bus_bits = 0;
+    return 0;
+
+err_close:
+    close(fd);
+    fd = -1;
+    error = CAN_SOCKET_ERROR_OPEN;
+    return -1;
+}
+
+int can_socket_set_filters(can_filter_t *rules, int num)
+{
+    struct linux_can_filter flt[CAN_IF_FILTER_MAX];
+    int i;
+    
+    if ((num < 0) || (num > CAN_IF_FILTER_MAX) || (!rules && (num > 0))) {
+        error = CAN_SOCKET_ERROR_INVAL;
+        return -1;
+    }
+    
+    /* The kernel filters exactly, no software stage needed */
+    for (i = 0; i < num; i++) {
+        if (rules[i].cf_ext) {
+            flt[i].can_id = (rules[i].cf_id & CAN_EFF_MASK) | CAN_EFF_FLAG;
+            flt[i].can_mask = (rules[i].cf_mask & CAN_EFF_MASK) | CAN_EFF_FLAG;
+        } else {
+            flt[i].can_id = rules[i].cf_id & CAN_SFF_MASK;
+            flt[i].can_mask = (rules[i].cf_mask & CAN_SFF_MASK) | CAN_EFF_FLAG;
+        }
+    }
+    
+    /* An empty list would receive nothing, accept all instead */
+    if (num == 0) {
+        flt[0].can_id = 0;
+        flt[0].can_mask = 0;
+        num = 1;
+    }
+    
+    if (setsockopt(fd, SOL_CAN_RAW, CAN_RAW_FILTER, flt, (num * sizeof(struct linux_can_filter))) == -1) {
+        error = CAN_SOCKET_ERROR_IO;
+        return -1;
+    }
+    
+    return 0;
+}
+
+int can_socket_send(can_frame_t *frame)
+{
+    can_packed_t cp;
+    
+    if (!frame) {
+        error = CAN_SOCKET_ERROR_INVAL;
+        return -1;
+    }
+    
+    /* The packed frame is the kernel struct can_frame */
+    if (can_frame_pack(frame, &cp) == -1) {
+        error = CAN_SOCKET_ERROR_INVAL;
+        return -1;
+    }
+    
+    if (write(fd, &cp, sizeof(can_packed_t)) != sizeof(can_packed_t)) {
+        stats.tx_err++;
+        
+        /* Queue of the network device is full */
+        if (errno == ENOBUFS)
+            error = CAN_SOCKET_ERROR_TXFULL;
+        else
+            error = CAN_SOCKET_ERROR_IO;
+        
+        return -1;
+    }
+    
+    stats.tx_frm++;
+    bus_bits += can_packed_get_bits(&cp);
+    return 0;
+}
+
+int can_socket_recv(can_frame_t *frame)
+{
+    can_packed_t cp;
+    ssize_t len;
+    
+    if (!frame) {
+        error = CAN_SOCKET_ERROR_INVAL;
+        return -1;
+    }
+    
+    for (;;) {
+        len = read(fd, &cp, sizeof(can_packed_t));
+        
+        if (len == -1) {
+            /* Non-blocking, nothing received */
+            if ((errno == EAGAIN) || (errno == EWOULDBLOCK))
+                return 0;
+            
+            error = CAN_SOCKET_ERROR_IO;
+            return -1;
+        }
+        
+        if (len != sizeof(can_packed_t))
+            continue;
+        
+        if (!(cp.cp_id & CAN_ID_ERR_FLAG))
+            break;
+        
+        if ((cp.cp_id & CAN_ERR_CRTL) && (cp.cp_data[1] & CAN_ERR_CRTL_RX_OVERFLOW))
+            stats.rx_drop++;
+
+#ifdef CAN_ERR_CNT
+        if (cp.cp_id & CAN_ERR_CNT) {
+            stats.tec = cp.cp_data[6];
+            stats.rec = cp.cp_data[7];
+        }
+#endif
+
+        if (cp.cp_id & CAN_ERR_BUSOFF) {
+            error = CAN_SOCKET_ERROR_BUSOFF;
+            return -1;
+        }
+    }
+    
+    if (can_frame_unpack(&cp, frame) == -1) {
+        stats.rx_drop++;
+        error = CAN_SOCKET_ERROR_IO;
+        return -1;
+    }
+    
+    stats.rx_frm++;
+    bus_bits += can_packed_get_bits(&cp);
+    return 1;
+}
+
+void can_socket_tick(void)
+{
+    stats.bus_load = (uint16_t) (((uint64_t) bus_bits * 1000) / ((bus_rate / 1000) * CAN_IF_TICK_MS));
+    bus_bits = 0;
+}
+
+char *can_socket_get_driver_name(void)
+{
+    return DRIVER_NAME;
+}
+
+char *can_socket_get_driver_vers(void)
+{
+    return DRIVER_VERSION;
+}
+
+can_stats_t can_socket_get_stats(void)
+{
+    return stats;
+}
+
+int can_socket_get_last_error(void)
+{
+    int err;
+    
+    err = error;
+    error = CAN_SOCKET_ERROR_SUCCESS;
+    return err;
+}
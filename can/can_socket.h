@@ -0,0 +1,45 @@
+/**
+ *
+ * File Name: can_socket.h
+ * Title    : Linux SocketCAN CAN backend
+ * Project  : lib-avr
+ * Author   : Copyright (C) 2026 Johannes Krottmayer <krjdev@gmail.com>
+ * Created  : 2026-10-19
+ * Modified : 
+ * Revised  : 
+ * Version  : 0.1.0.0
+ * License  : ISC (see file LICENSE.txt)
+ * Target   : Linux (host)
+ *
+ * NOTE: This code is currently below version 1.0, and therefore is considered
+ * to be lacking in some functionality or documentation, or may not be fully
+ * tested. Nonetheless, you can expect most functions to work.
+ *
+ */
+
+#ifndef LIBAVR_CAN_CAN_SOCKET_H
+#define LIBAVR_CAN_CAN_SOCKET_H
+
+#include <stdint.h>
+
+#include "can.h"
+#include "can_if.h"
+
+#define CAN_SOCKET_ERROR_SUCCESS    0
+#define CAN_SOCKET_ERROR_INVAL      1
+#define CAN_SOCKET_ERROR_OPEN       2
+#define CAN_SOCKET_ERROR_IO         3
+#define CAN_SOCKET_ERROR_TXFULL     4
+#define CAN_SOCKET_ERROR_BUSOFF     5
+
+extern int can_socket_init(const char *ifname, uint32_t bitrate);
+extern int can_socket_set_filters(can_filter_t *rules, int num);
+extern int can_socket_send(can_frame_t *frame);
+extern int can_socket_recv(can_frame_t *frame);
+extern void can_socket_tick(void);
+extern char *can_socket_get_driver_name(void);
+extern char *can_socket_get_driver_vers(void);
+extern can_stats_t can_socket_get_stats(void);
+extern int can_socket_get_last_error(void);
+
+#endif
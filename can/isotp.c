@@ -0,0 +1,662 @@
+/**
+ *
+ * File Name: isotp.c
+ * Title    : CAN ISO-TP (ISO 15765-2) transport library
+ * Project  : lib-avr
+ * Author   : Copyright (C) 2026 Johannes Krottmayer <krjdev@gmail.com>
+ * Created  : 2026-10-19
+ * Modified : 
+ * Revised  : 
+ * Version  : 0.1.0.0
+ * License  : ISC (see file LICENSE.txt)
+ * Target   : Atmel AVR Series
+ *
+ * NOTE: This code is currently below version 1.0, and therefore is considered
+ * to be lacking in some functionality or documentation, or may not be fully
+ * tested. Nonetheless, you can expect most functions to work.
+ *
+ */
+
+#include <string.h>
+
+#include "isotp.h"
+#include "can_if.h"
+
+/* Protocol control information, upper nibble of the first byte */
+#define PCI_SF          0x00 /* Single Frame */
+#define PCI_FF          0x10 /* First Frame */
+#define PCI_CF          0x20 /* Consecutive Frame */
+#define PCI_FC          0x30 /* Flow Control */
+
+/* Flow status */
+#define FS_CTS          0
+#define FS_WAIT         1
+#define FS_OVFLW        2
+#define FS_NONE         0xFF
+
+#define SF_DATA_MAX     7
+#define FF_DATA         6
+#define CF_DATA         7
+
+#define TX_IDLE         0
+#define TX_SF           1 /* Single Frame pending */
+#define TX_FF           2 /* First Frame pending */
+#define TX_WAIT_FC      3
+#define TX_CF           4
+#define TX_DONE         5
+#define TX_FAIL         6
+
+#define RX_IDLE         0
+#define RX_CF           1
+
+typedef struct isotp_chan {
+    isotp_cfg_t ch_cfg;
+    isotp_stream_t ch_stream;
+    uint8_t ch_open;
+    uint8_t ch_tx_state;
+    uint8_t *ch_tx_buf;
+    uint16_t ch_tx_len;
+    uint16_t ch_tx_off;
+    uint8_t ch_tx_sn;
+    uint8_t ch_tx_bs;
+    uint8_t ch_tx_bs_cnt;
+    uint8_t ch_tx_st;       /* STmin of the receiver (ticks) */
+    uint8_t ch_tx_wft;
+    uint16_t ch_tx_timer;   /* N_Bs or STmin, depending on the state */
+    int ch_tx_err;
+    uint8_t ch_rx_state;
+    uint8_t ch_rx_sn;
+    uint8_t ch_rx_bs_cnt;
+    uint8_t ch_rx_ready;
+    uint8_t ch_fc;          /* Flow status to send, FS_NONE if none */
+    uint16_t ch_rx_len;
+    uint16_t ch_rx_off;
+    uint16_t ch_rx_timer;   /* N_Cr */
+    uint8_t ch_rx_buf[ISOTP_BUF_LEN];
+} isotp_chan_t;
+
+static int error = ISOTP_ERROR_SUCCESS;
+static isotp_chan_t chans[ISOTP_CHAN_MAX];
+static isotp_stats_t stats;
+
+static int frame_send(isotp_chan_t *ch, uint8_t *data, uint8_t len)
+{
+    can_frame_t f;
+    
+    if (ch->ch_cfg.ic_pad && (len < CAN_DATA_LENMAX)) {
+        memset(&data[len], ISOTP_PAD_BYTE, (CAN_DATA_LENMAX - len));
+        len = CAN_DATA_LENMAX;
+    }
+    
+    if (ch->ch_cfg.ic_ext) {
+        f.f_type = CAN_TYPE_DATA_EXT;
+        f.f_d_ext.sid = (uint16_t) (ch->ch_cfg.ic_tx_id >> 18);
+        f.f_d_ext.eid = ch->ch_cfg.ic_tx_id & 0x3FFFF;
+        f.f_d_ext.dlen = len;
+        memcpy(f.f_d_ext.data, data, len);
+    } else {
+        f.f_type = CAN_TYPE_DATA_STD;
+        f.f_d_std.sid = (uint16_t) ch->ch_cfg.ic_tx_id;
+        f.f_d_std.dlen = len;
+        memcpy(f.f_d_std.data, data, len);
+    }
+    
+    return can_if_send(&f);
+}
+
+static void fc_send(isotp_chan_t *ch)
+{
+    uint8_t d[CAN_DATA_LENMAX];
+    
+    if (ch->ch_fc == FS_NONE)
+        return;
+    
+    d[0] = PCI_FC | ch->ch_fc;
+    d[1] = ch->ch_cfg.ic_bs;
+    d[2] = ch->ch_cfg.ic_stmin;
+    
+    /* Retried by isotp_poll() if the controller is busy */
+    if (frame_send(ch, d, 3) == 0)
+        ch->ch_fc = FS_NONE;
+}
+
+static uint8_t stmin_ticks(uint8_t raw)
+{
+    uint8_t ms;
+    uint8_t ticks;
+    
+    /* 0x00-0x7F: milliseconds, 0xF1-0xF9: 100-900 us, reserved: max. */
+    if (raw <= 0x7F)
+        ms = raw;
+    else if ((raw >= 0xF1) && (raw <= 0xF9))
+        ms = 1;
+    else
+        ms = 0x7F;
+    
+    ticks = (ms + ISOTP_TICK_MS - 1) / ISOTP_TICK_MS;
+    
+    /* One more, the first tick may come right after the frame */
+    if (ticks)
+        ticks++;
+    
+    return ticks;
+}
+
+static void tx_fail(isotp_chan_t *ch, int err)
+{
+    ch->ch_tx_err = err;
+    ch->ch_tx_state = TX_FAIL;
+    stats.tx_err++;
+}
+
+/* Returns -1 if the frame was not sent, retry only if the queue was full */
+static int tx_frame(isotp_chan_t *ch, uint8_t *data, uint8_t len)
+{
+    if (frame_send(ch, data, len) == -1) {
+        if (can_if_get_last_error() != CAN_IF_ERROR_TXFULL)
+            tx_fail(ch, ISOTP_ERROR_CAN);
+        
+        return -1;
+    }
+    
+    return 0;
+}
+
+static void tx_run(isotp_chan_t *ch)
+{
+    uint8_t d[CAN_DATA_LENMAX];
+    uint16_t n;
+    
+    switch (ch->ch_tx_state) {
+    case TX_SF:
+        d[0] = PCI_SF | (uint8_t) ch->ch_tx_len;
+        memcpy(&d[1], ch->ch_tx_buf, ch->ch_tx_len);
+        
+        if (tx_frame(ch, d, (1 + ch->ch_tx_len)) == -1)
+            return;
+        
+        ch->ch_tx_state = TX_DONE;
+        stats.tx_msg++;
+        break;
+    case TX_FF:
+        d[0] = PCI_FF | (uint8_t) (ch->ch_tx_len >> 8);
+        d[1] = (uint8_t) ch->ch_tx_len;
+        memcpy(&d[2], ch->ch_tx_buf, FF_DATA);
+        
+        if (tx_frame(ch, d, CAN_DATA_LENMAX) == -1)
+            return;
+        
+        ch->ch_tx_off = FF_DATA;
+        ch->ch_tx_sn = 1;
+        ch->ch_tx_wft = 0;
+        ch->ch_tx_timer = ISOTP_TIMEOUT;
+        ch->ch_tx_state = TX_WAIT_FC;
+        break;
+    case TX_CF:
+        while ((ch->ch_tx_state == TX_CF) && (ch->ch_tx_timer == 0)) {
+            n = ch->ch_tx_len - ch->ch_tx_off;
+            
+            if (n > CF_DATA)
+                n = CF_DATA;
+            
+            d[0] = PCI_CF | ch->ch_tx_sn;
+            memcpy(&d[1], &ch->ch_tx_buf[ch->ch_tx_off], n);
+            
+            if (tx_frame(ch, d, (1 + n)) == -1)
+                return;
+            
+            ch->ch_tx_off += n;
+            ch->ch_tx_sn = (ch->ch_tx_sn + 1) & 0x0F;
+            
+            if (ch->ch_tx_off == ch->ch_tx_len) {
+                ch->ch_tx_state = TX_DONE;
+                stats.tx_msg++;
+                break;
+            }
+            
+            if (ch->ch_tx_bs && (--ch->ch_tx_bs_cnt == 0)) {
+                ch->ch_tx_timer = ISOTP_TIMEOUT;
+                ch->ch_tx_state = TX_WAIT_FC;
+                break;
+            }
+            
+            ch->ch_tx_timer = ch->ch_tx_st;
+        }
+        
+        break;
+    default:
+        break;
+    }
+}
+
+static void rx_data(isotp_chan_t *ch, uint8_t *data, uint16_t len)
+{
+    if (ch->ch_stream)
+        ch->ch_stream((uint8_t) (ch - chans), data, len, ch->ch_rx_off, ch->ch_rx_len);
+    else
+        memcpy(&ch->ch_rx_buf[ch->ch_rx_off], data, len);
+    
+    ch->ch_rx_off += len;
+}
+
+static void rx_abort(isotp_chan_t *ch)
+{
+    if (ch->ch_stream)
+        ch->ch_stream((uint8_t) (ch - chans), NULL, -1, ch->ch_rx_off, ch->ch_rx_len);
+    
+    ch->ch_rx_state = RX_IDLE;
+    stats.rx_drop++;
+}
+
+static void rx_done(isotp_chan_t *ch)
+{
+    ch->ch_rx_state = RX_IDLE;
+    
+    if (!ch->ch_stream)
+        ch->ch_rx_ready = 1;
+    
+    stats.rx_msg++;
+}
+
+static isotp_chan_t *chan_find(can_frame_t *frame, uint8_t **data, uint8_t *dlen)
+{
+    uint32_t id;
+    uint8_t ext;
+    int i;
+    
+    switch (frame->f_type) {
+    case CAN_TYPE_DATA_STD:
+        id = frame->f_d_std.sid;
+        ext = 0;
+        (*data) = frame->f_d_std.data;
+        (*dlen) = frame->f_d_std.dlen;
+        break;
+    case CAN_TYPE_DATA_EXT:
+        id = ((uint32_t) frame->f_d_ext.sid << 18) | frame->f_d_ext.eid;
+        ext = 1;
+        (*data) = frame->f_d_ext.data;
+        (*dlen) = frame->f_d_ext.dlen;
+        break;
+    default:
+        return NULL;
+    }
+    
+    for (i = 0; i < ISOTP_CHAN_MAX; i++) {
+        if (chans[i].ch_open && 
+            (chans[i].ch_cfg.ic_ext == ext) && 
+            (chans[i].ch_cfg.ic_rx_id == id))
+            return &chans[i];
+    }
+    
+    return NULL;
+}
+
+static void input_sf(isotp_chan_t *ch, uint8_t *data, uint8_t dlen)
+{
+    uint8_t len;
+    
+    len = data[0] & 0x0F;
+    
+    if ((len == 0) || (len > (dlen - 1)))
+        return;
+    
+    /* A new message aborts the one in progress */
+    if (ch->ch_rx_state == RX_CF)
+        rx_abort(ch);
+    
+    if (!ch->ch_stream && ch->ch_rx_ready) {
+        stats.rx_drop++;
+        return;
+    }
+    
+    ch->ch_rx_len = len;
+    ch->ch_rx_off = 0;
+    rx_data(ch, &data[1], len);
+    rx_done(ch);
+}
+
+static void input_ff(isotp_chan_t *ch, uint8_t *data, uint8_t dlen)
+{
+    uint16_t len;
+    
+    if (dlen < CAN_DATA_LENMAX)
+        return;
+    
+    len = ((uint16_t) (data[0] & 0x0F) << 8) | data[1];
+    
+    if (len <= SF_DATA_MAX)
+        return;
+    
+    if (ch->ch_rx_state == RX_CF)
+        rx_abort(ch);
+    
+    /* Without a stream handler the message must fit the buffer */
+    if (!ch->ch_stream && ((len > ISOTP_BUF_LEN) || ch->ch_rx_ready)) {
+        stats.rx_drop++;
+        ch->ch_fc = FS_OVFLW;
+        fc_send(ch);
+        return;
+    }
+    
+    ch->ch_rx_len = len;
+    ch->ch_rx_off = 0;
+    rx_data(ch, &data[2], FF_DATA);
+    ch->ch_rx_sn = 1;
+    ch->ch_rx_bs_cnt = ch->ch_cfg.ic_bs;
+    ch->ch_rx_timer = ISOTP_TIMEOUT;
+    ch->ch_rx_state = RX_CF;
+    ch->ch_fc = FS_CTS;
+    fc_send(ch);
+}
+
+static void input_cf(isotp_chan_t *ch, uint8_t *data, uint8_t dlen)
+{
+    uint16_t n;
+    
+    if (ch->ch_rx_state != RX_CF)
+        return;
+    
+    if ((data[0] & 0x0F) != ch->ch_rx_sn) {
+        rx_abort(ch);
+        return;
+    }
+    
+    n = ch->ch_rx_len - ch->ch_rx_off;
+    
+    if (n > CF_DATA)
+        n = CF_DATA;
+    
+    if ((dlen - 1) < n) {
+        rx_abort(ch);
+        return;
+    }
+    
+    rx_data(ch, &data[1], n);
+    ch->ch_rx_sn = (ch->ch_rx_sn + 1) & 0x0F;
+    ch->ch_rx_timer = ISOTP_TIMEOUT;
+    
+    if (ch->ch_rx_off == ch->ch_rx_len) {
+        rx_done(ch);
+        return;
+    }
+    
+    if (ch->ch_cfg.ic_bs && (--ch->ch_rx_bs_cnt == 0)) {
+        ch->ch_rx_bs_cnt = ch->ch_cfg.ic_bs;
+        ch->ch_fc = FS_CTS;
+        fc_send(ch);
+    }
+}
+
+static void input_fc(isotp_chan_t *ch, uint8_t *data, uint8_t dlen)
+{
+    if (ch->ch_tx_state != TX_WAIT_FC)
+        return;
+    
+    if (dlen < 3)
+        return;
+    
+    switch (data[0] & 0x0F) {
+    case FS_CTS:
+        ch->ch_tx_bs = data[1];
+        ch->ch_tx_bs_cnt = data[1];
+        ch->ch_tx_st = stmin_ticks(data[2]);
+        ch->ch_tx_wft = 0;
+        ch->ch_tx_timer = 0;
+        ch->ch_tx_state = TX_CF;
+        tx_run(ch);
+        break;
+    case FS_WAIT:
+        if (++ch->ch_tx_wft > ISOTP_WFT_MAX)
+            tx_fail(ch, ISOTP_ERROR_WFT);
+        else
+            ch->ch_tx_timer = ISOTP_TIMEOUT;
+        
+        break;
+    case FS_OVFLW:
+        tx_fail(ch, ISOTP_ERROR_OVFLW);
+        break;
+    default:
+        tx_fail(ch, ISOTP_ERROR_INVAL);
+    }
+}
+
+void isotp_init(void)
+{
+    int i;
+    
+    memset(chans, 0, sizeof(chans));
+    memset(&stats, 0, sizeof(isotp_stats_t));
+    
+    for (i = 0; i < ISOTP_CHAN_MAX; i++)
+        chans[i].ch_fc = FS_NONE;
+}
+
+int isotp_open(uint8_t chan, isotp_cfg_t *cfg)
+{
+    uint32_t id_max;
+    
+    if ((chan >= ISOTP_CHAN_MAX) || !cfg) {
+        error = ISOTP_ERROR_INVAL;
+        return -1;
+    }
+    
+    if (cfg->ic_ext)
+        id_max = 0x1FFFFFFF;
+    else
+        id_max = 0x7FF;
+    
+    if ((cfg->ic_ext > 1) || (cfg->ic_tx_id > id_max) || (cfg->ic_rx_id > id_max)) {
+        error = ISOTP_ERROR_INVAL;
+        return -1;
+    }
+    
+    memset(&chans[chan], 0, sizeof(isotp_chan_t));
+    chans[chan].ch_cfg = (*cfg);
+    chans[chan].ch_fc = FS_NONE;
+    chans[chan].ch_open = 1;
+    return 0;
+}
+
+int isotp_close(uint8_t chan)
+{
+    if (chan >= ISOTP_CHAN_MAX) {
+        error = ISOTP_ERROR_INVAL;
+        return -1;
+    }
+    
+    memset(&chans[chan], 0, sizeof(isotp_chan_t));
+    chans[chan].ch_fc = FS_NONE;
+    return 0;
+}
+
+int isotp_set_stream(uint8_t chan, isotp_stream_t handler)
+{
+    if ((chan >= ISOTP_CHAN_MAX) || !chans[chan].ch_open) {
+        error = ISOTP_ERROR_INVAL;
+        return -1;
+    }
+    
+    if (chans[chan].ch_rx_state != RX_IDLE) {
+        error = ISOTP_ERROR_BUSY;
+        return -1;
+    }
+    
+    chans[chan].ch_stream = handler;
+    return 0;
+}
+
+int isotp_send(uint8_t chan, uint8_t *buf, int len)
+{
+    isotp_chan_t *ch;
+    
+    if ((chan >= ISOTP_CHAN_MAX) || !chans[chan].ch_open || !buf || (len < 1)) {
+        error = ISOTP_ERROR_INVAL;
+        return -1;
+    }
+    
+    if (len > ISOTP_MSG_MAX) {
+        error = ISOTP_ERROR_TOOBIG;
+        return -1;
+    }
+    
+    ch = &chans[chan];
+    
+    if ((ch->ch_tx_state != TX_IDLE) && 
+        (ch->ch_tx_state != TX_DONE) && 
+        (ch->ch_tx_state != TX_FAIL)) {
+        error = ISOTP_ERROR_BUSY;
+        return -1;
+    }
+    
+    /* The buffer is not copied, keep it until isotp_send_status() != 0 */
+    ch->ch_tx_buf = buf;
+    ch->ch_tx_len = (uint16_t) len;
+    ch->ch_tx_off = 0;
+    ch->ch_tx_err = ISOTP_ERROR_SUCCESS;
+    
+    if (len <= SF_DATA_MAX)
+        ch->ch_tx_state = TX_SF;
+    else
+        ch->ch_tx_state = TX_FF;
+    
+    tx_run(ch);
+    return 0;
+}
+
+int isotp_send_status(uint8_t chan)
+{
+    isotp_chan_t *ch;
+    
+    if (chan >= ISOTP_CHAN_MAX) {
+        error = ISOTP_ERROR_INVAL;
+        return -1;
+    }
+    
+    ch = &chans[chan];
+    
+    switch (ch->ch_tx_state) {
+    case TX_IDLE:
+        return 1;
+    case TX_DONE:
+        ch->ch_tx_state = TX_IDLE;
+        return 1;
+    case TX_FAIL:
+        ch->ch_tx_state = TX_IDLE;
+        error = ch->ch_tx_err;
+        return -1;
+    default:
+        return 0;
+    }
+}
+
+int isotp_recv(uint8_t chan, uint8_t *buf, int len)
+{
+    isotp_chan_t *ch;
+    
+    if ((chan >= ISOTP_CHAN_MAX) || !buf) {
+        error = ISOTP_ERROR_INVAL;
+        return -1;
+    }
+    
+    ch = &chans[chan];
+    
+    if (!ch->ch_rx_ready)
+        return 0;
+    
+    if (len < ch->ch_rx_len) {
+        error = ISOTP_ERROR_TOOBIG;
+        return -1;
+    }
+    
+    memcpy(buf, ch->ch_rx_buf, ch->ch_rx_len);
+    ch->ch_rx_ready = 0;
+    return ch->ch_rx_len;
+}
+
+int isotp_input(can_frame_t *frame)
+{
+    isotp_chan_t *ch;
+    uint8_t *data;
+    uint8_t dlen;
+    
+    if (!frame) {
+        error = ISOTP_ERROR_INVAL;
+        return -1;
+    }
+    
+    ch = chan_find(frame, &data, &dlen);
+    
+    /* Not an ISO-TP frame of an open channel */
+    if (!ch)
+        return 0;
+    
+    if (dlen < 1)
+        return 1;
+    
+    switch (data[0] & 0xF0) {
+    case PCI_SF:
+        input_sf(ch, data, dlen);
+        break;
+    case PCI_FF:
+        input_ff(ch, data, dlen);
+        break;
+    case PCI_CF:
+        input_cf(ch, data, dlen);
+        break;
+    case PCI_FC:
+        input_fc(ch, data, dlen);
+        break;
+    default:
+        break;
+    }
+    
+    return 1;
+}
+
+void isotp_poll(void)
+{
+    int i;
+    
+    for (i = 0; i < ISOTP_CHAN_MAX; i++) {
+        if (!chans[i].ch_open)
+            continue;
+        
+        fc_send(&chans[i]);
+        tx_run(&chans[i]);
+    }
+}
+
+void isotp_tick(void)
+{
+    isotp_chan_t *ch;
+    int i;
+    
+    for (i = 0; i < ISOTP_CHAN_MAX; i++) {
+        ch = &chans[i];
+        
+        if (!ch->ch_open)
+            continue;
+        
+        if (ch->ch_tx_timer && (--ch->ch_tx_timer == 0)) {
+            if (ch->ch_tx_state == TX_WAIT_FC)
+                tx_fail(ch, ISOTP_ERROR_TIMEO);
+        }
+        
+        if ((ch->ch_rx_state == RX_CF) && (--ch->ch_rx_timer == 0))
+            rx_abort(ch);
+    }
+}
+
+isotp_stats_t isotp_get_stats(void)
+{
+    return stats;
+}
+
+int isotp_get_last_error(void)
+{
+    int err;
+    
+    err = error;
+    error = ISOTP_ERROR_SUCCESS;
+    return err;
+}
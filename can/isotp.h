@@ -0,0 +1,77 @@
+/**
+ *
+ * File Name: isotp.h
+ * Title    : CAN ISO-TP (ISO 15765-2) transport library
+ * Project  : lib-avr
+ * Author   : Copyright (C) 2026 Johannes Krottmayer <krjdev@gmail.com>
+ * Created  : 2026-10-19
+ * Modified : 
+ * Revised  : 
+ * Version  : 0.1.0.0
+ * License  : ISC (see file LICENSE.txt)
+ * Target   : Atmel AVR Series
+ *
+ * NOTE: This code is currently below version 1.0, and therefore is considered
+ * to be lacking in some functionality or documentation, or may not be fully
+ * tested. Nonetheless, you can expect most functions to work.
+ *
+ */
+
+#ifndef LIBAVR_CAN_ISOTP_H
+#define LIBAVR_CAN_ISOTP_H
+
+#include <stdint.h>
+
+#include "can.h"
+
+#define ISOTP_CHAN_MAX          2       /* Concurrent connections */
+#define ISOTP_BUF_LEN           256     /* Reassembly buffer per channel */
+#define ISOTP_MSG_MAX           4095    /* Max. message length */
+#define ISOTP_TICK_MS           1       /* Interval of isotp_tick() calls */
+#define ISOTP_TIMEOUT           1000    /* N_Bs and N_Cr (ticks) */
+#define ISOTP_WFT_MAX           8       /* Flow control WAIT frames in a row */
+#define ISOTP_PAD_BYTE          0xCC
+
+#define ISOTP_ERROR_SUCCESS     0
+#define ISOTP_ERROR_INVAL       1
+#define ISOTP_ERROR_BUSY        2
+#define ISOTP_ERROR_TOOBIG      3
+#define ISOTP_ERROR_CAN         4
+#define ISOTP_ERROR_TIMEO       5
+#define ISOTP_ERROR_OVFLW       6
+#define ISOTP_ERROR_WFT         7
+
+/* Identifiers use the can_filter_t layout, (SID << 18) | EID if extended */
+typedef struct isotp_cfg {
+    uint8_t ic_ext;         /* 0: standard, 1: extended identifiers */
+    uint32_t ic_tx_id;      /* Outgoing frames (SF, FF, CF, own FC) */
+    uint32_t ic_rx_id;      /* Incoming frames */
+    uint8_t ic_bs;          /* Block size announced to the sender */
+    uint8_t ic_stmin;       /* STmin announced to the sender (raw) */
+    uint8_t ic_pad;         /* Pad frames to 8 bytes */
+} isotp_cfg_t;
+
+typedef struct isotp_stats {
+    uint16_t tx_msg;        /* Messages sent */
+    uint16_t rx_msg;        /* Messages received */
+    uint16_t tx_err;        /* Aborted transmissions */
+    uint16_t rx_drop;       /* Lost sequence, overflow or timed out */
+} isotp_stats_t;
+
+/* Streaming receiver, called for every segment, len -1 on abort */
+typedef void (*isotp_stream_t)(uint8_t chan, uint8_t *data, int len, uint16_t offset, uint16_t total);
+
+extern void isotp_init(void);
+extern int isotp_open(uint8_t chan, isotp_cfg_t *cfg);
+extern int isotp_close(uint8_t chan);
+extern int isotp_set_stream(uint8_t chan, isotp_stream_t handler);
+extern int isotp_send(uint8_t chan, uint8_t *buf, int len);
+extern int isotp_send_status(uint8_t chan);
+extern int isotp_recv(uint8_t chan, uint8_t *buf, int len);
+extern int isotp_input(can_frame_t *frame);
+extern void isotp_poll(void);
+extern void isotp_tick(void);
+extern isotp_stats_t isotp_get_stats(void);
+extern int isotp_get_last_error(void);
+
+#endif
@@ -0,0 +1,297 @@
+/**
+ *
+ * File Name: example/can_isotp/main.c
+ * Title    : ISO-TP flow control and throughput test over a loopback CAN bus
+ * Project  : lib-avr
+ * Author   : Copyright (C) 2026 Johannes Krottmayer <krjdev@gmail.com>
+ * Created  : 2026-10-19
+ * Modified : 
+ * Revised  : 
+ * Version  : 0.1.0.0
+ * License  : ISC (see file LICENSE.txt)
+ * Target   : Linux (host)
+ *
+ * NOTE: This code is currently below version 1.0, and therefore is considered
+ * to be lacking in some functionality or documentation, or may not be fully
+ * tested. Nonetheless, you can expect most functions to work.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "../../can/can_if.h"
+#include "../../can/isotp.h"
+
+#define BITRATE         500000UL
+#define TX_MBOX         3           /* Transmit buffers of the controller */
+
+#define CHAN_TESTER     0
+#define CHAN_ECU        1
+#define ID_TESTER       0x7E0
+#define ID_ECU          0x7E8
+
+#define PCI_FF          1
+#define PCI_CF          2
+#define PCI_FC          3
+#define FS_CTS          0
+#define FS_WAIT         1
+
+#define MSG_LEN         200
+#define STMIN_MS        5
+#define WAIT_MS         500         /* Between WAIT frames, half of N_Bs */
+
+/* The loopback bus, frames in the order they were queued */
+static can_frame_t bus[TX_MBOX];
+static int bus_head;
+static int bus_num;
+static int bus_error;
+static uint32_t bus_us;
+static uint32_t tick_us;
+static uint32_t pci[16];    /* Frames on the bus by PCI type */
+
+static uint8_t msg[ISOTP_MSG_MAX];
+static uint32_t stream_len;
+static uint32_t stream_bad;
+
+int can_if_send(can_frame_t *frame)
+{
+    if (bus_num == TX_MBOX) {
+        bus_error = CAN_IF_ERROR_TXFULL;
+        return -1;
+    }
+    
+    bus[(bus_head + bus_num) % TX_MBOX] = (*frame);
+    bus_num++;
+    return 0;
+}
+
+int can_if_get_last_error(void)
+{
+    int err;
+    
+    err = bus_error;
+    bus_error = CAN_IF_ERROR_SUCCESS;
+    return err;
+}
+
+/* One frame on the bus or idle up to the next tick */
+static void bus_step(void)
+{
+    can_frame_t f;
+    
+    if (bus_num) {
+        f = bus[bus_head];
+        bus_head = (bus_head + 1) % TX_MBOX;
+        bus_num--;
+        bus_us += (can_frame_get_bits(&f) * 1000000UL) / BITRATE;
+        pci[f.f_d_std.data[0] >> 4]++;
+        isotp_input(&f);
+    } else
+        bus_us = tick_us + 1000;
+    
+    while ((bus_us - tick_us) >= 1000) {
+        tick_us += 1000;
+        isotp_tick();
+    }
+    
+    isotp_poll();
+}
+
+/* Until the tester's send ends or 'ms' passed, returns the send status */
+static int run(uint32_t ms)
+{
+    uint32_t t0 = bus_us;
+    int ret;
+    
+    while (((ret = isotp_send_status(CHAN_TESTER)) == 0) && ((bus_us - t0) < (ms * 1000)))
+        bus_step();
+    
+    /* Done means queued, the last frames are still in the mailboxes */
+    if (ret != 0) {
+        while (bus_num)
+            bus_step();
+    }
+    
+    return ret;
+}
+
+/* Flow control of the ECU, sent by hand */
+static void fc_inject(uint8_t fs)
+{
+    can_frame_t f;
+    
+    memset(&f, 0, sizeof(can_frame_t));
+    f.f_type = CAN_TYPE_DATA_STD;
+    f.f_d_std.sid = ID_ECU;
+    f.f_d_std.dlen = 3;
+    f.f_d_std.data[0] = (PCI_FC << 4) | fs;
+    can_if_send(&f);
+}
+
+static void stream(uint8_t chan, uint8_t *data, int len, uint16_t offset, uint16_t total)
+{
+    if ((len < 0) || (offset != stream_len) || (total != ISOTP_MSG_MAX) || 
+        memcmp(data, &msg[offset], len)) {
+        stream_bad++;
+        return;
+    }
+    
+    stream_len += len;
+}
+
+static void setup(uint8_t bs, uint8_t stmin, isotp_stream_t handler)
+{
+    isotp_cfg_t cfg;
+    
+    bus_num = 0;
+    memset(pci, 0, sizeof(pci));
+    isotp_init();
+    memset(&cfg, 0, sizeof(isotp_cfg_t));
+    cfg.ic_tx_id = ID_TESTER;
+    cfg.ic_rx_id = ID_ECU;
+    isotp_open(CHAN_TESTER, &cfg);
+    cfg.ic_tx_id = ID_ECU;
+    cfg.ic_rx_id = ID_TESTER;
+    cfg.ic_bs = bs;
+    cfg.ic_stmin = stmin;
+    cfg.ic_pad = 1;
+    isotp_open(CHAN_ECU, &cfg);
+    isotp_set_stream(CHAN_ECU, handler);
+}
+
+/* The tester sends 'len' bytes, the ECU takes them into its buffer */
+static uint32_t buffered(int len, uint8_t bs, uint8_t stmin, int *ok)
+{
+    uint8_t buf[ISOTP_BUF_LEN];
+    uint32_t t0;
+    int ret;
+    
+    setup(bs, stmin, NULL);
+    t0 = bus_us;
+    isotp_send(CHAN_TESTER, msg, len);
+    ret = run(10000);
+    (*ok) = (ret == 1) && (isotp_recv(CHAN_ECU, buf, ISOTP_BUF_LEN) == len) && !memcmp(buf, msg, len);
+    return bus_us - t0;
+}
+
+/* WAIT frames 'num' times, then CTS, returns the send status */
+static int waits(int num)
+{
+    int ret;
+    int i;
+    
+    setup(0, 0, NULL);
+    isotp_close(CHAN_ECU);
+    isotp_send(CHAN_TESTER, msg, MSG_LEN);
+    ret = run(1);
+    
+    for (i = 0; (i < num) && (ret == 0); i++) {
+        fc_inject(FS_WAIT);
+        ret = run(WAIT_MS);
+    }
+    
+    if (ret == 0) {
+        fc_inject(FS_CTS);
+        ret = run(10000);
+    }
+    
+    return ret;
+}
+
+int main(void)
+{
+    isotp_stats_t st;
+    uint32_t cfs;
+    uint32_t t;
+    uint32_t limit;
+    int ok;
+    int ret;
+    int err;
+    int i;
+    int fail = 0;
+    
+    for (i = 0; i < ISOTP_MSG_MAX; i++)
+        msg[i] = (uint8_t) ((i * 7) + (i >> 8));
+    
+    /* Consecutive frames back to back, 7 bytes in 111 bits */
+    limit = (7 * BITRATE) / 111;
+    printf("%lu kbit/s, %d transmit buffers, CF payload limit %u B/s\n", (BITRATE / 1000), TX_MBOX, limit);
+    
+    /* Block size: a flow control after every 4 consecutive frames */
+    t = buffered(MSG_LEN, 4, 0, &ok);
+    cfs = pci[PCI_CF];
+    printf("%d bytes, BS 4: %u CF, %u FC, %u us, %u B/s\n", MSG_LEN, cfs, pci[PCI_FC], 
+           t, (uint32_t) ((MSG_LEN * 1000000ULL) / t));
+    
+    if (!ok || (pci[PCI_FC] != (1 + ((cfs - 1) / 4))))
+        fail = 1;
+    
+    /* STmin: the sender keeps the gap between consecutive frames */
+    t = buffered(MSG_LEN, 0, STMIN_MS, &ok);
+    printf("%d bytes, STmin %d ms: %u us, %u B/s\n", MSG_LEN, STMIN_MS, 
+           t, (uint32_t) ((MSG_LEN * 1000000ULL) / t));
+    
+    if (!ok || (pci[PCI_FC] != 1) || (t < ((cfs - 1) * STMIN_MS * 1000)))
+        fail = 1;
+    
+    /* Maximum message, streamed since it doesn't fit the buffer */
+    setup(8, 0, stream);
+    stream_len = 0;
+    stream_bad = 0;
+    t = bus_us;
+    isotp_send(CHAN_TESTER, msg, ISOTP_MSG_MAX);
+    ret = run(10000);
+    t = bus_us - t;
+    printf("%d bytes streamed, BS 8: %u CF, %u FC, %u us, %u B/s\n", ISOTP_MSG_MAX, pci[PCI_CF], 
+           pci[PCI_FC], t, (uint32_t) ((ISOTP_MSG_MAX * 1000000ULL) / t));
+    
+    /* Flow control and the padded FC frames cost some of the bus */
+    if ((ret != 1) || (stream_len != ISOTP_MSG_MAX) || stream_bad || 
+        (((ISOTP_MSG_MAX * 1000000ULL) / t) < ((limit * 8) / 10)))
+        fail = 1;
+    
+    /* Too big for the buffer, the ECU answers OVFLW */
+    setup(0, 0, NULL);
+    isotp_send(CHAN_TESTER, msg, (ISOTP_BUF_LEN + 1));
+    ret = run(10000);
+    err = isotp_get_last_error();
+    st = isotp_get_stats();
+    printf("%d bytes to a %d byte buffer: status %d, error %d, %u CF, drops %u\n", 
+           (ISOTP_BUF_LEN + 1), ISOTP_BUF_LEN, ret, err, pci[PCI_CF], st.rx_drop);
+    
+    if ((ret != -1) || (err != ISOTP_ERROR_OVFLW) || pci[PCI_CF] || (st.rx_drop != 1) || (st.tx_err != 1))
+        fail = 1;
+    
+    /* WAIT restarts N_Bs, one more than ISOTP_WFT_MAX aborts */
+    ret = waits(ISOTP_WFT_MAX);
+    printf("%d WAIT, %d ms apart: status %d, %u CF\n", ISOTP_WFT_MAX, WAIT_MS, ret, pci[PCI_CF]);
+    
+    if ((ret != 1) || (pci[PCI_CF] != cfs))
+        fail = 1;
+    
+    ret = waits(ISOTP_WFT_MAX + 1);
+    err = isotp_get_last_error();
+    printf("%d WAIT: status %d, error %d\n", (ISOTP_WFT_MAX + 1), ret, err);
+    
+    if ((ret != -1) || (err != ISOTP_ERROR_WFT) || pci[PCI_CF])
+        fail = 1;
+    
+    /* No flow control at all, N_Bs runs out */
+    setup(0, 0, NULL);
+    isotp_close(CHAN_ECU);
+    t = bus_us;
+    isotp_send(CHAN_TESTER, msg, MSG_LEN);
+    ret = run(10000);
+    t = bus_us - t;
+    err = isotp_get_last_error();
+    printf("no flow control: status %d, error %d after %u ms\n", ret, err, (t / 1000));
+    
+    if ((ret != -1) || (err != ISOTP_ERROR_TIMEO) || (t < ((ISOTP_TIMEOUT - 1) * ISOTP_TICK_MS * 1000)))
+        fail = 1;
+    
+    printf("%s\n", fail ? "FAILED" : "PASSED");
+    return fail;
+}
@@ -0,0 +1,192 @@
+/**
+ *
+ * File Name: example/can_pack/main.c
+ * Title    : Packed CAN frame conversion benchmark on a candump trace
+ * Project  : lib-avr
+ * Author   : Copyright (C) 2026 Johannes Krottmayer <krjdev@gmail.com>
+ * Created  : 2026-10-19
+ * Modified : 
+ * Revised  : 
+ * Version  : 0.1.0.0
+ * License  : ISC (see file LICENSE.txt)
+ * Target   : Linux (host)
+ *
+ * NOTE: This code is currently below version 1.0, and therefore is considered
+ * to be lacking in some functionality or documentation, or may not be fully
+ * tested. Nonetheless, you can expect most functions to work.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+#include "../../can/can.h"
+
+#define FILE_TRACE      "trace.log"     /* candump -l format */
+#define FRAME_MAX       4096
+#define LINE_LEN        128
+#define FRAMES_RUN      50000000UL      /* Converted frames per measurement */
+
+static can_packed_t pkd[FRAME_MAX];
+static can_packed_t pkd_out[FRAME_MAX];
+static can_frame_t frames[FRAME_MAX];
+
+static int hex_val(char c)
+{
+    if ((c >= '0') && (c <= '9'))
+        return c - '0';
+    
+    if ((c >= 'A') && (c <= 'F'))
+        return c - 'A' + 10;
+    
+    if ((c >= 'a') && (c <= 'f'))
+        return c - 'a' + 10;
+    
+    return -1;
+}
+
+/* "(time) iface ID#DATA" or "ID#R", 8 ID digits are an extended frame */
+static int line_parse(char *line, can_packed_t *p)
+{
+    char *s;
+    char *h;
+    int n = 0;
+    int v;
+    
+    s = strchr(line, ')');
+    
+    if (!s || !(s = strchr(s + 2, ' ')))
+        return -1;
+    
+    s++;
+    h = strchr(s, '#');
+    
+    if (!h)
+        return -1;
+    
+    memset(p, 0, sizeof(can_packed_t));
+    
+    for (; s < h; s++, n++) {
+        v = hex_val(*s);
+        
+        if (v == -1)
+            return -1;
+        
+        p->cp_id = (p->cp_id << 4) | v;
+    }
+    
+    if (n == 8)
+        p->cp_id |= CAN_ID_EFF_FLAG;
+    else if (n != 3)
+        return -1;
+    
+    h++;
+    
+    if (*h == 'R') {
+        p->cp_id |= CAN_ID_RTR_FLAG;
+        return 0;
+    }
+    
+    while ((hex_val(h[0]) != -1) && (hex_val(h[1]) != -1)) {
+        if (p->cp_dlen == CAN_DATA_LENMAX)
+            return -1;
+        
+        p->cp_data[p->cp_dlen++] = (hex_val(h[0]) << 4) | hex_val(h[1]);
+        h += 2;
+    }
+    
+    return 0;
+}
+
+static int trace_load(const char *file)
+{
+    char line[LINE_LEN];
+    FILE *fp;
+    int n = 0;
+    
+    fp = fopen(file, "r");
+    
+    if (!fp)
+        return -1;
+    
+    while (fgets(line, sizeof(line), fp) && (n < FRAME_MAX)) {
+        if (line_parse(line, &pkd[n]) == 0)
+            n++;
+    }
+    
+    fclose(fp);
+    return n;
+}
+
+static double elapsed(struct timespec *t0, struct timespec *t1)
+{
+    return (t1->tv_sec - t0->tv_sec) + ((t1->tv_nsec - t0->tv_nsec) / 1e9);
+}
+
+int main(int argc, char *argv[])
+{
+    struct timespec t0;
+    struct timespec t1;
+    const char *file = FILE_TRACE;
+    unsigned long runs;
+    unsigned long i;
+    double sec_unpack;
+    double sec_pack;
+    int num;
+    int fail = 0;
+    
+    if (argc > 1)
+        file = argv[1];
+    
+    num = trace_load(file);
+    
+    if (num < 1) {
+        printf("%s: no frames\n", file);
+        return 1;
+    }
+    
+    /* Whole trace round trip, also the EID mask of can_frame_pack() */
+    if ((can_frame_unpack_batch(pkd, frames, num) != num) || 
+        (can_frame_pack_batch(frames, pkd_out, num) != num) || 
+        memcmp(pkd, pkd_out, (num * sizeof(can_packed_t)))) {
+        printf("%s: round trip differs\n", file);
+        fail = 1;
+    }
+    
+    frames[0].f_type = CAN_TYPE_DATA_EXT;
+    frames[0].f_d_ext.sid = 0x001;
+    frames[0].f_d_ext.eid = 0xFFFFFFFF;
+    frames[0].f_d_ext.dlen = 0;
+    can_frame_pack(&frames[0], &pkd_out[0]);
+    
+    /* Upper eid bits must not reach the SID */
+    if (pkd_out[0].cp_id != (CAN_ID_EFF_FLAG | (1UL << 18) | CAN_ID_EID_MASK)) {
+        printf("eid above 18 bits: id 0x%08X\n", pkd_out[0].cp_id);
+        fail = 1;
+    }
+    
+    runs = FRAMES_RUN / num;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    
+    for (i = 0; i < runs; i++)
+        can_frame_unpack_batch(pkd, frames, num);
+    
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    sec_unpack = elapsed(&t0, &t1);
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    
+    for (i = 0; i < runs; i++)
+        can_frame_pack_batch(frames, pkd_out, num);
+    
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    sec_pack = elapsed(&t0, &t1);
+    
+    printf("%s: %d frames, %lu passes (%lu frames)\n", file, num, runs, (runs * num));
+    printf("unpack: %.3f s, %.1f M frames/s\n", sec_unpack, ((runs * num) / sec_unpack / 1e6));
+    printf("pack:   %.3f s, %.1f M frames/s\n", sec_pack, ((runs * num) / sec_pack / 1e6));
+    printf("%s\n", fail ? "FAILED" : "PASSED");
+    return fail;
+}
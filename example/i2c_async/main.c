@@ -0,0 +1,214 @@
+/**
+ *
+ * File Name: example/i2c_async/main.c
+ * Title    : I2C transaction queue test on the bus simulator
+ * Project  : lib-avr
+ * Author   : Copyright (C) 2026 Johannes Krottmayer <krjdev@gmail.com>
+ * Created  : 2026-10-19
+ * Modified : 
+ * Revised  : 
+ * Version  : 0.1.0.0
+ * License  : ISC (see file LICENSE.txt)
+ * Target   : Linux (host)
+ *
+ * NOTE: This code is currently below version 1.0, and therefore is considered
+ * to be lacking in some functionality or documentation, or may not be fully
+ * tested. Nonetheless, you can expect most functions to work.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "../../i2c/i2c_async.h"
+
+#define ADDR_REG        0x51    /* Register file, 1 byte pointer */
+#define ADDR_MEM        0x50    /* Memory, 1 byte pointer */
+#define ADDR_NONE       0x22
+
+#define REG_LEN         16
+#define SIM_RUN_US      1000000UL
+
+static i2c_xfer_t chained;
+static uint8_t chained_buf[2];
+static int callbacks;
+
+/* Queues the read back of a write from the callback, the bus stays held */
+static void write_done(i2c_xfer_t *xfer)
+{
+    callbacks++;
+    
+    if (xfer->ix_arg)
+        i2c_async_submit(&chained);
+}
+
+static void reg_read_set(i2c_xfer_t *xfer, uint8_t addr, uint8_t *reg, uint8_t *buf, int len)
+{
+    memset(xfer, 0, sizeof(i2c_xfer_t));
+    xfer->ix_addr = addr;
+    xfer->ix_nseg = 2;
+    xfer->ix_seg[0].is_type = I2C_SEG_WRITE;
+    xfer->ix_seg[0].is_buf = reg;
+    xfer->ix_seg[0].is_len = 1;
+    xfer->ix_seg[1].is_type = I2C_SEG_READ;
+    xfer->ix_seg[1].is_buf = buf;
+    xfer->ix_seg[1].is_len = len;
+}
+
+static int run(i2c_xfer_t *xfer)
+{
+    if (i2c_async_submit(xfer) == -1)
+        return -1;
+    
+    return i2c_async_wait(xfer);
+}
+
+int main(void)
+{
+    i2c_xfer_t xfer;
+    i2c_xfer_t wr;
+    i2c_xfer_t poll;
+    i2c_xfer_t q[I2C_ASYNC_QUEUE_LEN];
+    i2c_async_stats_t st;
+    uint8_t regs[REG_LEN];
+    uint8_t out[7];
+    uint8_t reg = 2;
+    uint8_t w[3] = { 0x10, 0xAA, 0xBB };
+    uint32_t t0;
+    uint32_t n;
+    int polls;
+    int i;
+    int fail = 0;
+    
+    for (i = 0; i < REG_LEN; i++)
+        regs[i] = i * 3;
+    
+    i2c_sim_init();
+    i2c_sim_add(ADDR_REG, regs, REG_LEN, 1);
+    i2c_sim_add(ADDR_MEM, NULL, 256, 1);
+    i2c_async_init(100000);
+    
+    /* Pointer write, repeated START, 7 bytes read */
+    reg_read_set(&xfer, ADDR_REG, &reg, out, sizeof(out));
+    
+    if ((run(&xfer) == -1) || memcmp(out, &regs[reg], sizeof(out))) {
+        printf("register read failed\n");
+        fail = 1;
+    }
+    
+    /* A read queued from the callback of the write before */
+    reg_read_set(&chained, ADDR_MEM, &w[0], chained_buf, sizeof(chained_buf));
+    memset(&wr, 0, sizeof(i2c_xfer_t));
+    wr.ix_addr = ADDR_MEM;
+    wr.ix_nseg = 1;
+    wr.ix_seg[0].is_buf = w;
+    wr.ix_seg[0].is_len = sizeof(w);
+    wr.ix_done = write_done;
+    wr.ix_arg = &chained;
+    
+    if ((run(&wr) == -1) || (i2c_async_wait(&chained) == -1) || 
+        (chained_buf[0] != 0xAA) || (chained_buf[1] != 0xBB)) {
+        printf("chained read failed\n");
+        fail = 1;
+    }
+    
+    xfer.ix_addr = ADDR_NONE;
+    
+    if ((run(&xfer) != -1) || (i2c_async_get_last_error() != I2C_ASYNC_ERR_NACK)) {
+        printf("missing device was not NACKed\n");
+        fail = 1;
+    }
+    
+    /* Retried up to I2C_ASYNC_RETRY times */
+    xfer.ix_addr = ADDR_REG;
+    i2c_sim_lose_arb(I2C_ASYNC_RETRY);
+    
+    if (run(&xfer) == -1) {
+        printf("no restart after a lost arbitration\n");
+        fail = 1;
+    }
+    
+    i2c_sim_lose_arb(I2C_ASYNC_RETRY + 1);
+    
+    if ((run(&xfer) != -1) || (xfer.ix_err != I2C_ASYNC_ERR_ARBLOST)) {
+        printf("arbitration loss not reported\n");
+        fail = 1;
+    }
+    
+    i2c_sim_lose_arb(0);
+    
+    /* ACK polling, every START right after the STOP of the poll before */
+    memset(&poll, 0, sizeof(i2c_xfer_t));
+    poll.ix_addr = ADDR_MEM;
+    poll.ix_nseg = 1;
+    i2c_sim_set_busy(ADDR_MEM, 5);
+    
+    for (polls = 1; polls < 10; polls++) {
+        if (run(&poll) == 0)
+            break;
+        
+        if (poll.ix_err != I2C_ASYNC_ERR_NACK)
+            break;
+    }
+    
+    printf("ACK polling: %d polls, last error %d\n", polls, poll.ix_err);
+    
+    if ((polls != 6) || (poll.ix_state != I2C_XFER_DONE)) {
+        printf("ACK polling failed\n");
+        fail = 1;
+    }
+    
+    for (i = 0; i < I2C_ASYNC_QUEUE_LEN; i++) {
+        reg_read_set(&q[i], ADDR_REG, &reg, out, sizeof(out));
+        
+        if (i2c_async_submit(&q[i]) == -1) {
+            printf("submit %d failed\n", i);
+            fail = 1;
+        }
+    }
+    
+    if ((i2c_async_submit(&poll) != -1) || (i2c_async_get_last_error() != I2C_ASYNC_ERR_FULL)) {
+        printf("full queue accepted a transaction\n");
+        fail = 1;
+    }
+    
+    for (i = 0; i < I2C_ASYNC_QUEUE_LEN; i++) {
+        if (i2c_async_wait(&q[i]) == -1)
+            fail = 1;
+    }
+    
+    st = i2c_async_get_stats();
+    printf("xfers %u, failed %u, nacks %u, arbitration lost %u, callbacks %d\n", 
+           st.ias_xfers, st.ias_failed, st.ias_nacks, st.ias_arb_lost, callbacks);
+    
+    if ((st.ias_xfers != (12 + I2C_ASYNC_QUEUE_LEN)) || (st.ias_failed != 7) || 
+        (st.ias_nacks != 6) || (st.ias_arb_lost != ((2 * I2C_ASYNC_RETRY) + 1)) || 
+        (callbacks != 1) || i2c_async_busy())
+        fail = 1;
+    
+    /* Register reads back to back, the queue always full */
+    t0 = i2c_sim_get_time();
+    n = 0;
+    
+    for (i = 0; i < I2C_ASYNC_QUEUE_LEN; i++)
+        i2c_async_submit(&q[i]);
+    
+    for (i = 0; (i2c_sim_get_time() - t0) < SIM_RUN_US; i = (i + 1) % I2C_ASYNC_QUEUE_LEN) {
+        if (i2c_async_wait(&q[i]) == -1) {
+            fail = 1;
+            break;
+        }
+        
+        n++;
+        i2c_async_submit(&q[i]);
+    }
+    
+    for (i = 0; i < I2C_ASYNC_QUEUE_LEN; i++)
+        i2c_async_wait(&q[i]);
+    
+    printf("100 kHz: %u register reads (7 bytes) per simulated second\n", n);
+    printf("%s\n", fail ? "FAILED" : "PASSED");
+    return fail;
+}
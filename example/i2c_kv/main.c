@@ -0,0 +1,118 @@
+/**
+ *
+ * File Name: example/i2c_kv/main.c
+ * Title    : M24Cxx key/value store wear test on the bus simulator
+ * Project  : lib-avr
+ * Author   : Copyright (C) 2026 Johannes Krottmayer <krjdev@gmail.com>
+ * Created  : 2026-10-19
+ * Modified : 
+ * Revised  : 
+ * Version  : 0.1.0.0
+ * License  : ISC (see file LICENSE.txt)
+ * Target   : Linux (host)
+ *
+ * NOTE: This code is currently below version 1.0, and therefore is considered
+ * to be lacking in some functionality or documentation, or may not be fully
+ * tested. Nonetheless, you can expect most functions to work.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "../../i2c/i2c_async.h"
+#include "../../i2c/m24cxx_kv.h"
+
+#define TWR_US          5000
+#define SECTORS         4
+#define AREA_LEN        (SECTORS * M24CXX_KV_SECTOR)
+
+#define KEY_NAME        1
+#define KEY_COUNTER     2
+#define KEY_MODE        3
+
+#define UPDATES         10000   /* Counter updates, a new value each time */
+
+static int kv_check(uint32_t counter, uint8_t mode)
+{
+    uint32_t v = 0;
+    uint8_t m = 0;
+    uint8_t name[M24CXX_KV_VAL_MAX];
+    
+    if ((m24cxx_kv_get(KEY_COUNTER, (uint8_t *) &v, sizeof(v)) != sizeof(v)) || (v != counter))
+        return -1;
+    
+    if ((m24cxx_kv_get(KEY_MODE, &m, 1) != 1) || (m != mode))
+        return -1;
+    
+    if ((m24cxx_kv_get(KEY_NAME, name, sizeof(name)) != 4) || memcmp(name, "node", 4))
+        return -1;
+    
+    return 0;
+}
+
+int main(void)
+{
+    m24cxx_kv_stats_t st;
+    uint32_t wear;
+    uint32_t wear_max = 0;
+    uint32_t wear_sum = 0;
+    uint32_t c;
+    uint8_t mode = 7;
+    int i;
+    int fail = 0;
+    
+    i2c_sim_init();
+    i2c_sim_add(0x50, NULL, m24cxx_get_size(TYPE_M24C32), 2);
+    i2c_sim_set_eeprom(0x50, m24cxx_get_page_size(TYPE_M24C32), TWR_US);
+    memset(i2c_sim_get_mem(0x50), 0xFF, m24cxx_get_size(TYPE_M24C32));
+    m24cxx_init();
+    
+    if ((m24cxx_kv_init(TYPE_M24C32, 0, 0, SECTORS) == -1) || 
+        (m24cxx_kv_set(KEY_NAME, (uint8_t *) "node", 4) == -1)) {
+        printf("init failed, error %d\n", m24cxx_kv_get_last_error());
+        printf("FAILED\n");
+        return 1;
+    }
+    
+    /* The mode is set with every update but never changes */
+    for (c = 1; c <= UPDATES; c++) {
+        if ((m24cxx_kv_set(KEY_COUNTER, (uint8_t *) &c, sizeof(c)) == -1) || 
+            (m24cxx_kv_set(KEY_MODE, &mode, 1) == -1)) {
+            printf("update %u failed, error %d\n", c, m24cxx_kv_get_last_error());
+            fail = 1;
+            break;
+        }
+    }
+    
+    st = m24cxx_kv_get_stats();
+    
+    for (i = 0; i < AREA_LEN; i++) {
+        wear = i2c_sim_get_wear(0x50, i);
+        wear_sum += wear;
+        
+        if (wear > wear_max)
+            wear_max = wear;
+    }
+    
+    printf("%d updates: %u records, %u skipped, %u compactions\n", 
+           UPDATES, st.kvs_appends, st.kvs_skipped, st.kvs_compactions);
+    printf("wear over %d bytes: max %u, mean %.1f writes per byte\n", 
+           AREA_LEN, wear_max, ((double) wear_sum / AREA_LEN));
+    printf("in place the counter bytes would see %d writes\n", UPDATES);
+    
+    /* Unchanged values are skipped, the log spreads over all sectors */
+    if ((st.kvs_skipped != (UPDATES - 1)) || (wear_max > ((2 * wear_sum) / AREA_LEN)))
+        fail = 1;
+    
+    /* Reload from the EEPROM */
+    if ((m24cxx_kv_init(TYPE_M24C32, 0, 0, SECTORS) != 3) || (kv_check(UPDATES, mode) == -1)) {
+        printf("reload lost data\n");
+        fail = 1;
+    }
+    
+    printf("%s\n", fail ? "FAILED" : "PASSED");
+    return fail;
+}
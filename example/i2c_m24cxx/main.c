@@ -0,0 +1,170 @@
+/**
+ *
+ * File Name: example/i2c_m24cxx/main.c
+ * Title    : M24Cxx page write and ACK polling test on the bus simulator
+ * Project  : lib-avr
+ * Author   : Copyright (C) 2026 Johannes Krottmayer <krjdev@gmail.com>
+ * Created  : 2026-10-19
+ * Modified : 
+ * Revised  : 
+ * Version  : 0.1.0.0
+ * License  : ISC (see file LICENSE.txt)
+ * Target   : Linux (host)
+ *
+ * NOTE: This code is currently below version 1.0, and therefore is considered
+ * to be lacking in some functionality or documentation, or may not be fully
+ * tested. Nonetheless, you can expect most functions to work.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "../../i2c/i2c_async.h"
+#include "../../i2c/m24cxx.h"
+
+#define TWR_US          5000    /* Write cycle, datasheet maximum */
+#define BYTE_US         90      /* 9 bits at 100 kHz */
+#define POLL_US         110     /* START, address, STOP */
+#define BLOB_LEN        1024
+#define BLOB_ADDR       10      /* Not page aligned on purpose */
+
+#define C16_ADDR        0x1F0   /* Block 1 up into block 4 */
+#define C16_LEN         600
+
+static uint8_t blob[BLOB_LEN];
+static uint8_t rd[4096];
+
+/* Blob written and everything around it still erased */
+static int mem_check(uint8_t *mem, int size, int addr, uint8_t *buf, int len)
+{
+    int i;
+    
+    for (i = 0; i < size; i++) {
+        if ((i >= addr) && (i < (addr + len))) {
+            if (mem[i] != buf[i - addr])
+                return -1;
+        } else if (mem[i] != 0xFF)
+            return -1;
+    }
+    
+    return 0;
+}
+
+static int m24c32_run(void)
+{
+    uint32_t t0;
+    uint32_t t;
+    uint32_t bus;
+    int pages;
+    int page;
+    int ret = 0;
+    
+    i2c_sim_init();
+    i2c_sim_add(0x50, NULL, m24cxx_get_size(TYPE_M24C32), 2);
+    i2c_sim_set_eeprom(0x50, m24cxx_get_page_size(TYPE_M24C32), TWR_US);
+    memset(i2c_sim_get_mem(0x50), 0xFF, m24cxx_get_size(TYPE_M24C32));
+    m24cxx_init();
+    
+    page = m24cxx_get_page_size(TYPE_M24C32);
+    pages = ((BLOB_ADDR % page) + BLOB_LEN + page - 1) / page;
+    t0 = i2c_sim_get_time();
+    
+    if (m24cxx_write(TYPE_M24C32, 0, BLOB_ADDR, blob, BLOB_LEN) == -1) {
+        printf("M24C32: write failed, error %d\n", i2c_async_get_last_error());
+        return -1;
+    }
+    
+    t = i2c_sim_get_time() - t0;
+    bus = (BLOB_LEN + (pages * 3)) * BYTE_US;
+    printf("M24C32: %d bytes in %d page writes, %u us (tWR %d us)\n", 
+           BLOB_LEN, pages, t, TWR_US);
+    printf("M24C32: %u us on the bus, %u us per page polling\n", 
+           bus, ((t - bus) / pages) - TWR_US);
+    printf("M24C32: byte writes would take %u us\n", BLOB_LEN * (TWR_US + (4 * BYTE_US)));
+    
+    /* Every page is polled ready within two polls after its write cycle */
+    if ((t < (bus + (pages * TWR_US))) || (t > (bus + (pages * (TWR_US + (2 * POLL_US)))))) {
+        printf("M24C32: write time out of range\n");
+        ret = -1;
+    }
+    
+    if (mem_check(i2c_sim_get_mem(0x50), m24cxx_get_size(TYPE_M24C32), BLOB_ADDR, blob, BLOB_LEN) == -1) {
+        printf("M24C32: memory differs\n");
+        ret = -1;
+    }
+    
+    t0 = i2c_sim_get_time();
+    
+    if ((m24cxx_read(TYPE_M24C32, 0, 0, rd, m24cxx_get_size(TYPE_M24C32)) == -1) || 
+        (mem_check(rd, m24cxx_get_size(TYPE_M24C32), BLOB_ADDR, blob, BLOB_LEN) == -1)) {
+        printf("M24C32: sequential read differs\n");
+        ret = -1;
+    }
+    
+    printf("M24C32: %d bytes read in %u us\n", m24cxx_get_size(TYPE_M24C32), 
+           (i2c_sim_get_time() - t0));
+    return ret;
+}
+
+/* Upper address bits in the device address, one 256 byte block each */
+static int m24c16_run(void)
+{
+    int size;
+    int i;
+    int ret = 0;
+    
+    i2c_sim_init();
+    size = m24cxx_get_size(TYPE_M24C16);
+    
+    for (i = 0; i < (size / 256); i++) {
+        i2c_sim_add(0x50 + i, NULL, 256, 1);
+        i2c_sim_set_eeprom(0x50 + i, m24cxx_get_page_size(TYPE_M24C16), TWR_US);
+        memset(i2c_sim_get_mem(0x50 + i), 0xFF, 256);
+    }
+    
+    if (m24cxx_write(TYPE_M24C16, 0, C16_ADDR, blob, C16_LEN) == -1) {
+        printf("M24C16: write failed, error %d\n", i2c_async_get_last_error());
+        return -1;
+    }
+    
+    for (i = 0; i < (size / 256); i++)
+        memcpy(&rd[i * 256], i2c_sim_get_mem(0x50 + i), 256);
+    
+    if (mem_check(rd, size, C16_ADDR, blob, C16_LEN) == -1) {
+        printf("M24C16: memory differs\n");
+        ret = -1;
+    }
+    
+    memset(rd, 0, sizeof(rd));
+    
+    if ((m24cxx_read(TYPE_M24C16, 0, C16_ADDR, rd, 256 - (C16_ADDR % 256)) == -1) || 
+        memcmp(rd, blob, 256 - (C16_ADDR % 256))) {
+        printf("M24C16: read differs\n");
+        ret = -1;
+    }
+    
+    printf("M24C16: %d bytes over %d blocks at 0x%03X\n", C16_LEN, 
+           ((C16_ADDR + C16_LEN - 1) / 256) - (C16_ADDR / 256) + 1, C16_ADDR);
+    return ret;
+}
+
+int main(void)
+{
+    int i;
+    int fail = 0;
+    
+    for (i = 0; i < BLOB_LEN; i++)
+        blob[i] = (uint8_t) ((i * 13) + 7);
+    
+    if (m24c32_run() == -1)
+        fail = 1;
+    
+    if (m24c16_run() == -1)
+        fail = 1;
+    
+    printf("%s\n", fail ? "FAILED" : "PASSED");
+    return fail;
+}
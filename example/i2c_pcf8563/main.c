@@ -0,0 +1,167 @@
+/**
+ *
+ * File Name: example/i2c_pcf8563/main.c
+ * Title    : PCF8563 interpolated clock transfer count test on the bus simulator
+ * Project  : lib-avr
+ * Author   : Copyright (C) 2026 Johannes Krottmayer <krjdev@gmail.com>
+ * Created  : 2026-10-19
+ * Modified : 
+ * Revised  : 
+ * Version  : 0.1.0.0
+ * License  : ISC (see file LICENSE.txt)
+ * Target   : Linux (host)
+ *
+ * NOTE: This code is currently below version 1.0, and therefore is considered
+ * to be lacking in some functionality or documentation, or may not be fully
+ * tested. Nonetheless, you can expect most functions to work.
+ *
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "../../i2c/i2c_async.h"
+#include "../../i2c/pcf8563.h"
+
+#define PCF8563_ADDR    0x51
+#define REG_CONTROL2    0x01
+#define REG_SECONDS     0x02
+#define CONTROL2_AF     0x08
+
+#define HOURS           3
+#define START_SEC       ((12UL * 3600) + (30 * 60) + 10)
+#define PHASE_MS        437     /* RTC seconds edge against the first tick */
+#define DRIFT_PPM       20      /* RTC faster than the tick timer */
+#define ERR_MAX_MS      100
+
+static uint32_t now_ms;         /* Tick timer */
+
+/* RTC time in ms of the day */
+static uint32_t rtc_ms(void)
+{
+    return (START_SEC * 1000) + PHASE_MS + now_ms +
+           (uint32_t) (((uint64_t) now_ms * DRIFT_PPM) / 1000000UL);
+}
+
+static uint8_t bcd(uint32_t v)
+{
+    return (uint8_t) (((v / 10) << 4) | (v % 10));
+}
+
+/* The counters of the simulated RTC */
+static void rtc_update(void)
+{
+    uint8_t *mem;
+    uint32_t sec;
+    
+    mem = i2c_sim_get_mem(PCF8563_ADDR);
+    sec = rtc_ms() / 1000;
+    mem[REG_SECONDS] = bcd(sec % 60);
+    mem[REG_SECONDS + 1] = bcd((sec / 60) % 60);
+    mem[REG_SECONDS + 2] = bcd(sec / 3600);
+}
+
+static uint32_t ts_ms(pcf8563_ts_t *ts)
+{
+    return (ts->pts_time.t_hr * 3600000UL) + (ts->pts_time.t_min * 60000UL) +
+           (ts->pts_time.t_sec * 1000UL) + ts->pts_time.t_msec;
+}
+
+int main(void)
+{
+    pcf8563_ts_t ts;
+    uint8_t mem[16];
+    uint32_t xfers;
+    uint32_t gets = 0;
+    uint32_t syncs = 0;
+    uint32_t back = 0;
+    uint32_t last = 0;
+    int32_t err;
+    int32_t err_max = 0;
+    int32_t err_sync = 0;
+    int ret;
+    int fail = 0;
+    
+    memset(mem, 0, sizeof(mem));
+    mem[5] = 0x19;
+    mem[6] = 0x01;
+    mem[7] = 0x10;
+    mem[8] = 0x26;
+    i2c_sim_init();
+    i2c_sim_add(PCF8563_ADDR, mem, sizeof(mem), 1);
+    pcf8563_init();
+    rtc_update();
+    
+    /* Timestamps every millisecond, the bus only for the hourly resync */
+    for (now_ms = 1; now_ms <= (HOURS * 3600000UL); now_ms++) {
+        rtc_update();
+        pcf8563_clock_tick();
+        ret = pcf8563_clock_poll();
+        
+        while (i2c_async_busy())
+            i2c_sim_step();
+        
+        if (ret == -1) {
+            printf("resync failed\n");
+            fail = 1;
+            break;
+        }
+        
+        if (pcf8563_clock_get(&ts) == -1)
+            continue;
+        
+        gets++;
+        err = (int32_t) (ts_ms(&ts) - rtc_ms());
+        
+        if (err < 0)
+            err = -err;
+        
+        if (err > err_max)
+            err_max = err;
+        
+        if (ret == 1) {
+            syncs++;
+            
+            if (err > err_sync)
+                err_sync = err;
+        }
+        
+        if (ts_ms(&ts) < last)
+            back++;
+        
+        last = ts_ms(&ts);
+    }
+    
+    xfers = i2c_async_get_stats().ias_xfers;
+    printf("%d h, RTC %d ppm fast: %u timestamps, %u resyncs\n", HOURS, DRIFT_PPM, gets, syncs);
+    printf("%u transfers, pcf8563_get_timestamp() each time would take %u\n", xfers, gets);
+    printf("error: max %d ms, right after a resync %d ms, %u steps back\n", err_max, err_sync, back);
+    
+    /* Reads every tick up to the first edge, then only inside the windows */
+    if ((syncs != HOURS) || (xfers > (1000 + (syncs * 2 * PCF8563_SYNC_WIN))) || 
+        (err_max > ERR_MAX_MS) || (err_sync > 5) || back)
+        fail = 1;
+    
+    /* INT: no event, no transfer */
+    ret = pcf8563_poll();
+    
+    if ((ret != 0) || (i2c_async_get_stats().ias_xfers != xfers)) {
+        printf("poll without INT accessed the bus\n");
+        fail = 1;
+    }
+    
+    /* Alarm flag read and cleared, two transfers */
+    i2c_sim_get_mem(PCF8563_ADDR)[REG_CONTROL2] = CONTROL2_AF;
+    pcf8563_isr();
+    ret = pcf8563_poll();
+    xfers = i2c_async_get_stats().ias_xfers - xfers;
+    printf("alarm: event 0x%02X, %u transfers\n", ret, xfers);
+    
+    if ((ret != PCF8563_EVENT_ALARM) || (xfers != 2) || 
+        (i2c_sim_get_mem(PCF8563_ADDR)[REG_CONTROL2] & CONTROL2_AF))
+        fail = 1;
+    
+    printf("%s\n", fail ? "FAILED" : "PASSED");
+    return fail;
+}
@@ -0,0 +1,155 @@
+/**
+ *
+ * File Name: example/i2c_pcf8574/main.c
+ * Title    : PCF8574 transfer count test on the bus simulator
+ * Project  : lib-avr
+ * Author   : Copyright (C) 2026 Johannes Krottmayer <krjdev@gmail.com>
+ * Created  : 2026-10-19
+ * Modified : 
+ * Revised  : 
+ * Version  : 0.1.0.0
+ * License  : ISC (see file LICENSE.txt)
+ * Target   : Linux (host)
+ *
+ * NOTE: This code is currently below version 1.0, and therefore is considered
+ * to be lacking in some functionality or documentation, or may not be fully
+ * tested. Nonetheless, you can expect most functions to work.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "../../i2c/i2c_async.h"
+#include "../../i2c/pcf8574.h"
+
+#define PCF8574_ADDR    0x20
+#define EXP_NUM         PCF8574_SCAN_MAX
+
+static gpio_t *gpios[EXP_NUM];
+static uint32_t xfers_last;
+
+/* Transfers since the last call */
+static uint32_t xfers(void)
+{
+    uint32_t n;
+    
+    n = i2c_async_get_stats().ias_xfers;
+    n -= xfers_last;
+    xfers_last += n;
+    return n;
+}
+
+/* The port as the expander drives it, the simulator has one byte */
+static uint8_t *port(int i)
+{
+    return i2c_sim_get_mem(PCF8574_ADDR + i);
+}
+
+int main(void)
+{
+    uint32_t n;
+    uint32_t t0;
+    int ret;
+    int i;
+    int fail = 0;
+    
+    i2c_sim_init();
+    
+    for (i = 0; i < EXP_NUM; i++)
+        i2c_sim_add(PCF8574_ADDR + i, NULL, 1, 0);
+    
+    for (i = 0; i < EXP_NUM; i++) {
+        gpios[i] = pcf8574_init(TYPE_PCF8574, i);
+        
+        if (!gpios[i]) {
+            printf("FAILED\n");
+            return 1;
+        }
+    }
+    
+    printf("init: %u transfers for %d expanders\n", xfers(), EXP_NUM);
+    
+    /* Eight relays switched on one after the other */
+    for (i = 0; i < NPINS; i++) {
+        pcf8574_set_config(gpios[0], i, GPIO_PIN_OUTPUT);
+        pcf8574_set_pin(gpios[0], i, GPIO_PIN_LOW);
+    }
+    
+    n = xfers();
+    printf("8 x pcf8574_set_pin(): %u transfers\n", n);
+    
+    if ((n != NPINS) || ((*port(0)) != 0x00))
+        fail = 1;
+    
+    /* And off again, staged and written at once */
+    for (i = 0; i < NPINS; i++)
+        pcf8574_stage_pin(gpios[0], i, GPIO_PIN_HIGH);
+    
+    pcf8574_commit(gpios[0]);
+    n = xfers();
+    printf("8 x pcf8574_stage_pin(), commit: %u transfers\n", n);
+    
+    if ((n != 1) || ((*port(0)) != 0xFF))
+        fail = 1;
+    
+    /* Nothing changes, nothing is written */
+    pcf8574_stage_port(gpios[0], 0xFF, 0xFF);
+    pcf8574_commit(gpios[0]);
+    n = xfers();
+    printf("unchanged commit: %u transfers\n", n);
+    
+    if (n != 0)
+        fail = 1;
+    
+    pcf8574_stage_port(gpios[0], 0x0F, 0x05);
+    pcf8574_commit(gpios[0]);
+    xfers();
+    
+    /* No INT, no scan */
+    ret = pcf8574_poll(gpios, EXP_NUM);
+    n = xfers();
+    printf("poll without INT: %u transfers\n", n);
+    
+    if ((ret != 0) || (n != 0))
+        fail = 1;
+    
+    /* Two inputs change, the new outputs of expander 0 do not count */
+    (*port(3)) = 0x7F;
+    (*port(6)) = 0xFE;
+    pcf8574_isr();
+    t0 = i2c_sim_get_time();
+    ret = pcf8574_poll(gpios, EXP_NUM);
+    n = xfers();
+    printf("poll after INT: %d changed, %u transfers in %u us\n", 
+           ret, n, (i2c_sim_get_time() - t0));
+    
+    if ((ret != 2) || (n != EXP_NUM) || 
+        pcf8574_get_changed(gpios[0]) || 
+        (pcf8574_get_changed(gpios[3]) != 0x80) || (pcf8574_get_changed(gpios[6]) != 0x01))
+        fail = 1;
+    
+    /* A missing expander, the scan is short and INT stays pending */
+    i2c_sim_remove(PCF8574_ADDR + 5);
+    pcf8574_isr();
+    
+    if (pcf8574_poll(gpios, EXP_NUM) != -1) {
+        printf("short scan not reported\n");
+        fail = 1;
+    }
+    
+    i2c_sim_add(PCF8574_ADDR + 5, NULL, 1, 0);
+    (*port(5)) = 0xFF;
+    xfers();
+    
+    if (pcf8574_poll(gpios, EXP_NUM) != 0) {
+        printf("INT not kept pending after a short scan\n");
+        fail = 1;
+    }
+    
+    printf("scan again: %u transfers\n", xfers());
+    printf("%s\n", fail ? "FAILED" : "PASSED");
+    return fail;
+}
@@ -0,0 +1,147 @@
+/**
+ *
+ * File Name: example/i2c_pcf8591/main.c
+ * Title    : PCF8591 sampling rate test on the bus simulator
+ * Project  : lib-avr
+ * Author   : Copyright (C) 2026 Johannes Krottmayer <krjdev@gmail.com>
+ * Created  : 2026-10-19
+ * Modified : 
+ * Revised  : 
+ * Version  : 0.1.0.0
+ * License  : ISC (see file LICENSE.txt)
+ * Target   : Linux (host)
+ *
+ * NOTE: This code is currently below version 1.0, and therefore is considered
+ * to be lacking in some functionality or documentation, or may not be fully
+ * tested. Nonetheless, you can expect most functions to work.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "../../i2c/i2c_async.h"
+#include "../../i2c/pcf8591.h"
+
+#define PCF8591_ADDR    0x48
+#define CTRL_DACE       0x40
+
+#define SIM_RUN_US      1000000UL
+#define PERIOD_MS       10
+#define BUF_LEN         64
+
+static uint32_t frames_take(buffer_t *b)
+{
+    uint8_t frame[4];
+    uint32_t n = 0;
+    
+    while (buffer_get_num(b) >= 4) {
+        buffer_rd(b, frame, 4);
+        n++;
+    }
+    
+    return n;
+}
+
+/* Back to back bursts, frames per simulated second */
+static uint32_t burst_run(buffer_t *b)
+{
+    uint32_t t0;
+    uint32_t n = 0;
+    
+    pcf8591_sample_start(0, CONFIG_ADC0, b, 0);
+    t0 = i2c_sim_get_time();
+    
+    while ((i2c_sim_get_time() - t0) < SIM_RUN_US) {
+        pcf8591_sample_poll();
+        i2c_sim_step();
+        n += frames_take(b);
+    }
+    
+    pcf8591_sample_stop();
+    return n;
+}
+
+/* One second of pcf8591_sample_tick(), the bus is idle between bursts */
+static uint32_t timed_run(buffer_t *b, uint16_t period)
+{
+    uint32_t n = 0;
+    int i;
+    
+    pcf8591_sample_start(0, CONFIG_ADC0, b, period);
+    
+    for (i = 0; i < (1000 / PCF8591_TICK_MS); i++) {
+        pcf8591_sample_poll();
+        
+        while (i2c_async_busy())
+            i2c_sim_step();
+        
+        n += frames_take(b);
+        pcf8591_sample_tick();
+    }
+    
+    pcf8591_sample_poll();
+    n += frames_take(b);
+    pcf8591_sample_stop();
+    return n;
+}
+
+int main(void)
+{
+    pcf8591_stats_t st;
+    buffer_t *b;
+    uint32_t single = 0;
+    uint32_t burst;
+    uint32_t timed;
+    uint32_t t0;
+    uint8_t v;
+    int fail = 0;
+    
+    i2c_sim_init();
+    i2c_sim_add(PCF8591_ADDR, NULL, 16, 0);
+    pcf8591_init();
+    b = buffer_init(BUF_LEN);
+    
+    if (!b) {
+        printf("FAILED\n");
+        return 1;
+    }
+    
+    /* One transaction per sample */
+    t0 = i2c_sim_get_time();
+    
+    while ((i2c_sim_get_time() - t0) < SIM_RUN_US) {
+        if (pcf8591_get_adc(0, CONFIG_ADC0, (single & 3), &v) == -1) {
+            fail = 1;
+            break;
+        }
+        
+        single++;
+    }
+    
+    burst = burst_run(b);
+    timed = timed_run(b, PERIOD_MS);
+    st = pcf8591_get_stats();
+    
+    printf("100 kHz, 4 inputs:\n");
+    printf("pcf8591_get_adc(): %u samples/s\n", single);
+    printf("back to back bursts: %u frames/s, %u samples/s\n", burst, (burst * 4));
+    printf("every %d ms: %u frames/s\n", PERIOD_MS, timed);
+    printf("frames %u, dropped %u, errors %u\n", st.ps_frames, st.ps_dropped, st.ps_errors);
+    
+    /* The last control byte the device got still has the DAC enabled */
+    if (!(i2c_sim_get_mem(PCF8591_ADDR)[0] & CTRL_DACE)) {
+        printf("analog output switched off\n");
+        fail = 1;
+    }
+    
+    /* Bursts give at least four times the samples of single reads */
+    if ((burst < single) || (timed != ((1000 / PERIOD_MS) * PCF8591_BURST)) || 
+        st.ps_dropped || st.ps_errors)
+        fail = 1;
+    
+    printf("%s\n", fail ? "FAILED" : "PASSED");
+    return fail;
+}
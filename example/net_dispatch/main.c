@@ -0,0 +1,262 @@
+/**
+ *
+ * File Name: example/net_dispatch/main.c
+ * Title    : Frame dispatcher pcap replay benchmark
+ * Project  : lib-avr
+ * Author   : Copyright (C) 2026 Johannes Krottmayer <krjdev@gmail.com>
+ * Created  : 2026-10-19
+ * Modified : 
+ * Revised  : 
+ * Version  : 0.1.0.0
+ * License  : ISC (see file LICENSE.txt)
+ * Target   : Linux (host)
+ *
+ * NOTE: This code is currently below version 1.0, and therefore is considered
+ * to be lacking in some functionality or documentation, or may not be fully
+ * tested. Nonetheless, you can expect most functions to work.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+#include "../../net/ethernet.h"
+#include "../../net/nic_pcap.h"
+#include "../../net/dispatch.h"
+
+#define FILE_REPLAY     "dispatch_mix.pcap"
+
+#define ROUNDS          20000
+#define UDP_DATA_LEN    512
+#define PKT_LEN         (20 + 8 + UDP_DATA_LEN)
+
+/* Frames of one round, see mix[] */
+#define MIX_GOOD        4
+#define MIX_MAC         2
+#define MIX_ADDR        3
+#define MIX_CHK         1
+
+#define MIX_TYPE_GOOD   0
+#define MIX_TYPE_MAC    1
+#define MIX_TYPE_IP     2
+#define MIX_TYPE_CHK    3
+#define MIX_TYPE_IP6    4
+
+static mac_addr_t mac_me = { 0x02, 0x00, 0x00, 0x00, 0x00, 0x01 };
+static mac_addr_t mac_peer = { 0x02, 0x00, 0x00, 0x00, 0x00, 0x02 };
+static mac_addr_t mac_other = { 0x02, 0x00, 0x00, 0x00, 0x00, 0x03 };
+static ipv4_addr_t ip_me = { 192, 168, 1, 10 };
+static ipv4_addr_t ip_peer = { 192, 168, 1, 20 };
+static ipv4_addr_t ip_other = { 192, 168, 1, 30 };
+static ipv6_addr_t ip6_me = { 0xFE, 0x80, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0x01 };
+
+static const int mix[] = {
+    MIX_TYPE_GOOD, MIX_TYPE_MAC, MIX_TYPE_GOOD, MIX_TYPE_IP, MIX_TYPE_CHK, 
+    MIX_TYPE_GOOD, MIX_TYPE_IP6, MIX_TYPE_MAC, MIX_TYPE_IP, MIX_TYPE_GOOD
+};
+
+static uint32_t udp_rx;
+static uint32_t udp_hwchk;
+
+static uint32_t sum16(uint32_t sum, uint8_t *p, int len)
+{
+    int i;
+    
+    for (i = 0; (i + 1) < len; i += 2)
+        sum += ((uint16_t) p[i] << 8) | p[i + 1];
+    
+    if (len & 1)
+        sum += (uint16_t) p[len - 1] << 8;
+    
+    return sum;
+}
+
+static uint16_t fold(uint32_t sum)
+{
+    sum = (sum & 0xFFFF) + (sum >> 16);
+    sum = (sum & 0xFFFF) + (sum >> 16);
+    return (uint16_t) ~sum;
+}
+
+/* IPv4/UDP packet from the peer, bad_chk corrupts the UDP checksum */
+static void udp_build(uint8_t *p, ipv4_addr_t *dst, int bad_chk)
+{
+    uint8_t pseudo[12];
+    uint16_t chk;
+    int i;
+    
+    memset(p, 0, PKT_LEN);
+    p[0] = 0x45;
+    p[2] = (PKT_LEN >> 8);
+    p[3] = (PKT_LEN & 0xFF);
+    p[8] = 64;
+    p[9] = 17;
+    memcpy(&p[12], &ip_peer, 4);
+    memcpy(&p[16], dst, 4);
+    chk = fold(sum16(0, p, 20));
+    p[10] = (chk >> 8);
+    p[11] = (chk & 0xFF);
+    
+    p[20] = 0x30;
+    p[21] = 0x39;
+    p[22] = 0x04;
+    p[23] = 0xD2;
+    p[24] = ((8 + UDP_DATA_LEN) >> 8);
+    p[25] = ((8 + UDP_DATA_LEN) & 0xFF);
+    
+    for (i = 0; i < UDP_DATA_LEN; i++)
+        p[28 + i] = (uint8_t) i;
+    
+    memcpy(&pseudo[0], &p[12], 8);
+    pseudo[8] = 0;
+    pseudo[9] = 17;
+    pseudo[10] = p[24];
+    pseudo[11] = p[25];
+    chk = fold(sum16(sum16(0, pseudo, 12), &p[20], (8 + UDP_DATA_LEN)));
+    
+    if (bad_chk)
+        chk ^= 0x0101;
+    
+    p[26] = (chk >> 8);
+    p[27] = (chk & 0xFF);
+}
+
+/* Minimal IPv6/UDP header to somebody else's unicast address */
+static int ip6_build(uint8_t *p)
+{
+    memset(p, 0, 48);
+    p[0] = 0x60;
+    p[5] = 8;
+    p[6] = 17;
+    p[7] = 64;
+    p[8] = 0xFE;
+    p[9] = 0x80;
+    p[23] = 0x02;
+    p[24] = 0xFE;
+    p[25] = 0x80;
+    p[39] = 0x03;
+    p[45] = 8;
+    return 48;
+}
+
+static int mix_write(void)
+{
+    uint8_t pkt[PKT_LEN];
+    eth_frame_t frame;
+    uint16_t type;
+    int len;
+    int i;
+    
+    if (nic_pcap_init(NULL, FILE_REPLAY, &mac_peer) == -1)
+        return -1;
+    
+    for (i = 0; i < (int) (sizeof(mix) / sizeof(mix[0])); i++) {
+        memset(&frame, 0, sizeof(eth_frame_t));
+        ethernet_frame_set_dst(&frame, (mix[i] == MIX_TYPE_MAC) ? &mac_other : &mac_me);
+        ethernet_frame_set_src(&frame, &mac_peer);
+        type = ETHERNET_TYPE_IPV4;
+        len = PKT_LEN;
+        
+        if (mix[i] == MIX_TYPE_IP6) {
+            type = ETHERNET_TYPE_IPV6;
+            len = ip6_build(pkt);
+        } else {
+            udp_build(pkt, (mix[i] == MIX_TYPE_IP) ? &ip_other : &ip_me, 
+                      (mix[i] == MIX_TYPE_CHK));
+        }
+        
+        ethernet_frame_set_type(&frame, type);
+        
+        if ((ethernet_frame_set_payload(&frame, pkt, len) == -1) || 
+            (nic_pcap_send(&frame) == -1)) {
+            nic_pcap_close();
+            return -1;
+        }
+    }
+    
+    nic_pcap_close();
+    return 0;
+}
+
+static int udp_handler(eth_frame_t *frame)
+{
+    udp_rx++;
+    
+    if (frame->ef_attr & ETHERNET_ATTR_L4_CHK)
+        udp_hwchk++;
+    
+    return 0;
+}
+
+int main(void)
+{
+    struct timespec t0;
+    struct timespec t1;
+    dispatch_stats_t ds;
+    nic_stats_t ns;
+    uint32_t frames;
+    double sec;
+    int ret;
+    int i;
+    int fail = 0;
+    
+    if (mix_write() == -1) {
+        printf("writing the capture failed\n");
+        return 1;
+    }
+    
+    if (nic_pcap_init(FILE_REPLAY, NULL, &mac_me) == -1) {
+        printf("%s: can't open\n", FILE_REPLAY);
+        return 1;
+    }
+    
+    if ((dispatch_init(&mac_me, &ip_me, &ip6_me) == -1) || 
+        (dispatch_register_prot(ETHERNET_TYPE_IPV4, 17, udp_handler) == -1)) {
+        printf("dispatch setup failed\n");
+        return 1;
+    }
+    
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    
+    for (i = 0; i < ROUNDS; i++) {
+        do {
+            ret = dispatch_poll();
+        } while (ret == 1);
+        
+        if ((ret == -1) || (nic_pcap_rewind() == -1)) {
+            printf("replay failed, error %d\n", dispatch_get_last_error());
+            fail = 1;
+            break;
+        }
+    }
+    
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    nic_pcap_close();
+    
+    sec = (t1.tv_sec - t0.tv_sec) + ((t1.tv_nsec - t0.tv_nsec) / 1e9);
+    ds = dispatch_get_stats();
+    ns = nic_pcap_get_stats();
+    frames = ROUNDS * (uint32_t) (sizeof(mix) / sizeof(mix[0]));
+    
+    printf("%s: %u frames replayed in %.3f s, %.0f frames/s\n", 
+           FILE_REPLAY, frames, sec, (frames / sec));
+    printf("received %u, copied out of the NIC %u\n", ds.rx_frm, ns.rx_frm);
+    printf("dropped: mac %u, addr %u, chk %u\n", ds.drop_mac, ds.drop_addr, ds.drop_chk);
+    printf("udp: %u delivered, %u verified by the NIC\n", udp_rx, udp_hwchk);
+    
+    /* Only good frames may be allocated, the counters are 16 bits wide */
+    if ((ds.rx_frm != frames) || 
+        (ns.rx_frm != (ROUNDS * MIX_GOOD)) || 
+        (udp_rx != (ROUNDS * MIX_GOOD)) || 
+        (udp_hwchk != udp_rx) || 
+        (ds.drop_mac != (uint16_t) (ROUNDS * MIX_MAC)) || 
+        (ds.drop_addr != (uint16_t) (ROUNDS * MIX_ADDR)) || 
+        (ds.drop_chk != (uint16_t) (ROUNDS * MIX_CHK)))
+        fail = 1;
+    
+    printf("%s\n", fail ? "FAILED" : "PASSED");
+    return fail;
+}
@@ -0,0 +1,364 @@
+/**
+ *
+ * File Name: example/net_icmpv6/main.c
+ * Title    : ICMPv6 echo and Neighbor Discovery replayed from pcap
+ * Project  : lib-avr
+ * Author   : Copyright (C) 2026 Johannes Krottmayer <krjdev@gmail.com>
+ * Created  : 2026-10-19
+ * Modified : 
+ * Revised  : 
+ * Version  : 0.1.0.0
+ * License  : ISC (see file LICENSE.txt)
+ * Target   : Linux (host)
+ *
+ * NOTE: This code is currently below version 1.0, and therefore is considered
+ * to be lacking in some functionality or documentation, or may not be fully
+ * tested. Nonetheless, you can expect most functions to work.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "../../net/ethernet.h"
+#include "../../net/ipv6.h"
+#include "../../net/icmpv6.h"
+#include "../../net/nic_pcap.h"
+
+#define FILE_RX         "icmpv6_rx.pcap"
+#define FILE_TX         "icmpv6_tx.pcap"
+
+#define HDR_LEN         40
+#define ECHO_DATA_LEN   32
+#define ND_LEN          32      /* NS/NA with a link-layer address option */
+#define EXT_LEN         8
+
+#define SET_PAYLOAD_RUNS    1000
+
+/* Outstanding allocations, malloc/free are wrapped by the linker (see makefile) */
+static long allocs;
+
+extern void *__real_malloc(size_t size);
+extern void __real_free(void *ptr);
+
+void *__wrap_malloc(size_t size)
+{
+    void *p;
+    
+    p = __real_malloc(size);
+    
+    if (p)
+        allocs++;
+    
+    return p;
+}
+
+void __wrap_free(void *ptr)
+{
+    if (ptr)
+        allocs--;
+    
+    __real_free(ptr);
+}
+
+static mac_addr_t mac_me = { 0x02, 0x00, 0x00, 0x00, 0x00, 0x01 };
+static mac_addr_t mac_peer = { 0x02, 0x00, 0x00, 0x00, 0x00, 0x02 };
+static mac_addr_t mac_peer2 = { 0x02, 0x00, 0x00, 0x00, 0x00, 0x03 };
+static ipv6_addr_t ip_me = { 0xFE, 0x80, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0x01 };
+static ipv6_addr_t ip_peer = { 0xFE, 0x80, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0x02 };
+static ipv6_addr_t ip_peer2 = { 0xFE, 0x80, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0x03 };
+
+static uint16_t sum_fold(uint32_t sum)
+{
+    sum = (sum & 0xFFFF) + (sum >> 16);
+    sum = (sum & 0xFFFF) + (sum >> 16);
+    return (uint16_t) sum;
+}
+
+static uint32_t buf_sum(uint8_t *buf, int len)
+{
+    uint32_t sum = 0;
+    int i;
+    
+    for (i = 0; (i + 1) < len; i += 2)
+        sum += ((uint16_t) buf[i] << 8) | buf[i + 1];
+    
+    if (len & 1)
+        sum += (uint16_t) buf[len - 1] << 8;
+    
+    return sum;
+}
+
+/* 0xFFFF if the ICMPv6 message checksum is good */
+static uint16_t msg_sum(ipv6_addr_t *src, ipv6_addr_t *dst, uint8_t *msg, int len)
+{
+    return sum_fold(ipv6_pseudo_sum(src, dst, len, IPV6_NHDR_ICMPV6) + buf_sum(msg, len));
+}
+
+/* IPv6 header, ext_num extension headers (8 bytes each, ext[-1] is the first type) and the message */
+static int pkt_build(uint8_t *p, ipv6_addr_t *src, ipv6_addr_t *dst, uint8_t hopl, 
+                     const uint8_t *ext, int ext_num, uint8_t *msg, int len)
+{
+    uint16_t chk;
+    int plen;
+    
+    plen = (ext_num * EXT_LEN) + len;
+    memset(p, 0, HDR_LEN);
+    p[0] = 0x60;
+    p[4] = (uint8_t) (plen >> 8);
+    p[5] = (uint8_t) plen;
+    p[6] = ext_num ? ext[-1] : IPV6_NHDR_ICMPV6;
+    p[7] = hopl;
+    memcpy(&p[8], src, IPV6_ADDR_LEN);
+    memcpy(&p[24], dst, IPV6_ADDR_LEN);
+    memcpy(&p[HDR_LEN], ext, (ext_num * EXT_LEN));
+    chk = ~msg_sum(src, dst, msg, len);
+    msg[2] = (uint8_t) (chk >> 8);
+    msg[3] = (uint8_t) chk;
+    memcpy(&p[HDR_LEN + (ext_num * EXT_LEN)], msg, len);
+    return HDR_LEN + plen;
+}
+
+static int frame_write(mac_addr_t *dst, uint8_t *buf, int len)
+{
+    eth_frame_t frame;
+    
+    memset(&frame, 0, sizeof(eth_frame_t));
+    ethernet_frame_set_dst(&frame, dst);
+    ethernet_frame_set_src(&frame, (ethernet_addr_equal(dst, &mac_peer) ? &mac_peer2 : &mac_peer));
+    ethernet_frame_set_type(&frame, ETHERNET_TYPE_IPV6);
+    
+    if (ethernet_frame_set_payload(&frame, buf, len) == -1)
+        return -1;
+    
+    return nic_pcap_send(&frame);
+}
+
+/* Next header of the first extension header in front, see pkt_build() */
+static const uint8_t ext_opts[1 + (2 * EXT_LEN)] = {
+    IPV6_NHDR_HOPOPT, 
+    IPV6_NHDR_DSTOPTS, 0, 1, 4, 0, 0, 0, 0,     /* Hop-by-hop, PadN */
+    IPV6_NHDR_ICMPV6, 0, 1, 4, 0, 0, 0, 0       /* Destination options, PadN */
+};
+
+static const uint8_t ext_frag[1 + EXT_LEN] = {
+    IPV6_NHDR_FRAG, 
+    IPV6_NHDR_ICMPV6, 0, 0x00, 0x01, 0, 0, 0, 7 /* First fragment, more follow */
+};
+
+/* Echo with options, NS, NA, echo with a bad checksum and a fragmented echo */
+static int rx_write(void)
+{
+    uint8_t pkt[HDR_LEN + (2 * EXT_LEN) + 8 + ECHO_DATA_LEN];
+    uint8_t msg[8 + ECHO_DATA_LEN];
+    ipv6_addr_t snm;
+    mac_addr_t mac_snm = { 0x33, 0x33, 0xFF, 0x00, 0x00, 0x01 };
+    int len;
+    int i;
+    
+    if (nic_pcap_init(NULL, FILE_RX, &mac_peer) == -1)
+        return -1;
+    
+    memset(msg, 0, sizeof(msg));
+    msg[0] = ICMPV6_TYPE_ECHOREQ;
+    msg[5] = 0x42;
+    msg[7] = 1;
+    
+    for (i = 0; i < ECHO_DATA_LEN; i++)
+        msg[8 + i] = (uint8_t) i;
+    
+    len = pkt_build(pkt, &ip_peer, &ip_me, 64, &ext_opts[1], 2, msg, sizeof(msg));
+    
+    if (frame_write(&mac_me, pkt, len) == -1)
+        return -1;
+    
+    ipv6_addr_solicited(&ip_me, &snm);
+    memset(msg, 0, ND_LEN);
+    msg[0] = ICMPV6_TYPE_NS;
+    memcpy(&msg[8], &ip_me, IPV6_ADDR_LEN);
+    msg[24] = 1;
+    msg[25] = 1;
+    memcpy(&msg[26], &mac_peer, sizeof(mac_addr_t));
+    len = pkt_build(pkt, &ip_peer, &snm, 255, NULL, 0, msg, ND_LEN);
+    
+    if (frame_write(&mac_snm, pkt, len) == -1)
+        return -1;
+    
+    memset(msg, 0, ND_LEN);
+    msg[0] = ICMPV6_TYPE_NA;
+    msg[4] = 0x60;
+    memcpy(&msg[8], &ip_peer2, IPV6_ADDR_LEN);
+    msg[24] = 2;
+    msg[25] = 1;
+    memcpy(&msg[26], &mac_peer2, sizeof(mac_addr_t));
+    len = pkt_build(pkt, &ip_peer2, &ip_me, 255, NULL, 0, msg, ND_LEN);
+    
+    if (frame_write(&mac_me, pkt, len) == -1)
+        return -1;
+    
+    memset(msg, 0, sizeof(msg));
+    msg[0] = ICMPV6_TYPE_ECHOREQ;
+    len = pkt_build(pkt, &ip_peer, &ip_me, 64, NULL, 0, msg, sizeof(msg));
+    pkt[len - 1] ^= 0xFF;
+    
+    if (frame_write(&mac_me, pkt, len) == -1)
+        return -1;
+    
+    len = pkt_build(pkt, &ip_peer, &ip_me, 64, &ext_frag[1], 1, msg, sizeof(msg));
+    
+    if (frame_write(&mac_me, pkt, len) == -1)
+        return -1;
+    
+    nic_pcap_close();
+    return 0;
+}
+
+static int replay(void)
+{
+    eth_frame_t frame;
+    int ret;
+    
+    if (nic_pcap_init(FILE_RX, FILE_TX, &mac_me) == -1)
+        return -1;
+    
+    icmpv6_init(&mac_me, &ip_me);
+    
+    /* Unknown neighbor, NS goes out first */
+    if (icmpv6_nc_resolve(&ip_peer2, &mac_peer2) != 0)
+        return -1;
+    
+    while (1) {
+        memset(&frame, 0, sizeof(eth_frame_t));
+        ret = nic_pcap_recv(&frame);
+        
+        if (ret == 0)
+            break;
+        
+        if (ret == -1)
+            return -1;
+        
+        icmpv6_input(&frame);
+        ethernet_frame_payload_free(&frame);
+    }
+    
+    nic_pcap_close();
+    return 0;
+}
+
+/* NS, echo reply without extension headers, NA */
+static int tx_check(void)
+{
+    eth_frame_t frame;
+    ipv6_addr_t src;
+    ipv6_addr_t dst;
+    uint8_t expect[3] = { ICMPV6_TYPE_NS, ICMPV6_TYPE_ECHOREP, ICMPV6_TYPE_NA };
+    uint8_t *p;
+    int n = 0;
+    int fail = 0;
+    int len;
+    
+    if (nic_pcap_init(FILE_TX, NULL, &mac_peer) == -1)
+        return -1;
+    
+    while (nic_pcap_recv(&frame) > 0) {
+        len = ethernet_frame_get_payload_len(&frame);
+        ethernet_frame_get_payload(&frame, &p);
+        memcpy(&src, &p[8], IPV6_ADDR_LEN);
+        memcpy(&dst, &p[24], IPV6_ADDR_LEN);
+        
+        if ((n >= 3) || (len < (HDR_LEN + 8)) || (p[6] != IPV6_NHDR_ICMPV6) || 
+            (p[HDR_LEN] != expect[n]) || 
+            (msg_sum(&src, &dst, &p[HDR_LEN], (len - HDR_LEN)) != 0xFFFF)) {
+            printf("tx frame %d: unexpected\n", n);
+            fail = 1;
+        } else if ((p[HDR_LEN] == ICMPV6_TYPE_ECHOREP) && 
+                   (((len - HDR_LEN) != (8 + ECHO_DATA_LEN)) || 
+                    !ethernet_addr_equal(&frame.ef_dst, &mac_peer) || 
+                    (p[HDR_LEN + 8 + ECHO_DATA_LEN - 1] != (ECHO_DATA_LEN - 1)))) {
+            printf("tx frame %d: bad echo reply\n", n);
+            fail = 1;
+        } else if ((p[HDR_LEN] == ICMPV6_TYPE_NA) && 
+                   (!ipv6_addr_equal(&dst, &ip_peer) || (p[HDR_LEN + 4] != 0x60))) {
+            printf("tx frame %d: bad neighbor advertisement\n", n);
+            fail = 1;
+        }
+        
+        ethernet_frame_payload_free(&frame);
+        n++;
+    }
+    
+    nic_pcap_close();
+    
+    if (n != 3)
+        fail = 1;
+    
+    return fail ? -1 : 0;
+}
+
+/* Setting the payload again must not leak the old one */
+static int set_payload_check(void)
+{
+    ipv6_packet_t ip;
+    uint8_t buf[64];
+    long before;
+    int i;
+    
+    memset(buf, 0x5A, sizeof(buf));
+    before = allocs;
+    ipv6_pkt_create_empty(&ip);
+    
+    for (i = 0; i < SET_PAYLOAD_RUNS; i++) {
+        if (ipv6_pkt_set_payload(&ip, buf, (1 + (i % sizeof(buf)))) == -1)
+            return -1;
+    }
+    
+    ipv6_pkt_free(&ip);
+    
+    if (allocs != before) {
+        printf("ipv6_pkt_set_payload: %ld buffers leaked\n", (allocs - before));
+        return -1;
+    }
+    
+    return 0;
+}
+
+int main(void)
+{
+    icmpv6_stats_t st;
+    mac_addr_t mac;
+    int fail = 0;
+    
+    if ((rx_write() == -1) || (replay() == -1)) {
+        printf("replaying %s failed\n", FILE_RX);
+        printf("FAILED\n");
+        return 1;
+    }
+    
+    st = icmpv6_get_stats();
+    printf("%s: echo %u, ns %u, na %u, err %u, tx ns %u, tx na %u\n", FILE_RX, 
+           st.rx_echo, st.rx_ns, st.rx_na, st.rx_err, st.tx_ns, st.tx_na);
+    
+    if ((st.rx_echo != 1) || (st.rx_ns != 1) || (st.rx_na != 1) || 
+        (st.rx_err != 1) || (st.tx_ns != 1) || (st.tx_na != 1))
+        fail = 1;
+    
+    /* Learned from the NS source and the solicited NA */
+    if ((icmpv6_nc_resolve(&ip_peer, &mac) != 1) || !ethernet_addr_equal(&mac, &mac_peer) || 
+        (icmpv6_nc_resolve(&ip_peer2, &mac) != 1) || !ethernet_addr_equal(&mac, &mac_peer2)) {
+        printf("neighbor cache: entries missing\n");
+        fail = 1;
+    }
+    
+    if (tx_check() == -1) {
+        printf("%s: unexpected replies\n", FILE_TX);
+        fail = 1;
+    }
+    
+    if (set_payload_check() == -1)
+        fail = 1;
+    
+    printf("%s\n", fail ? "FAILED" : "PASSED");
+    return fail;
+}
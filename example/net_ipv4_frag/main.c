@@ -0,0 +1,311 @@
+/**
+ *
+ * File Name: example/net_ipv4_frag/main.c
+ * Title    : IPv4 fragmentation and reassembly pcap replay
+ * Project  : lib-avr
+ * Author   : Copyright (C) 2026 Johannes Krottmayer <krjdev@gmail.com>
+ * Created  : 2026-10-19
+ * Modified : 
+ * Revised  : 
+ * Version  : 0.1.0.0
+ * License  : ISC (see file LICENSE.txt)
+ * Target   : Linux (host)
+ *
+ * NOTE: This code is currently below version 1.0, and therefore is considered
+ * to be lacking in some functionality or documentation, or may not be fully
+ * tested. Nonetheless, you can expect most functions to work.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "../../net/ethernet.h"
+#include "../../net/ipv4.h"
+#include "../../net/ipv4_frag.h"
+#include "../../net/udp.h"
+#include "../../net/nic_pcap.h"
+
+#define MTU             1500
+#define FRAG_MAX        16
+#define DGRAM_MAX       4000
+
+#define FILE_INORDER    "frag_inorder.pcap"
+#define FILE_OUTORDER   "frag_outorder.pcap"
+
+/* Datagrams of the generated captures, A needs 3 fragments, B and C 2 */
+#define DGRAM_A_ID      1
+#define DGRAM_A_LEN     4000
+#define DGRAM_B_ID      2
+#define DGRAM_B_LEN     2000
+#define DGRAM_C_ID      3
+#define DGRAM_C_LEN     1800
+
+static mac_addr_t mac_src = { 0x02, 0x00, 0x00, 0x00, 0x00, 0x01 };
+static mac_addr_t mac_dst = { 0x02, 0x00, 0x00, 0x00, 0x00, 0x02 };
+static ipv4_addr_t ip_src = { 192, 168, 1, 1 };
+static ipv4_addr_t ip_dst = { 192, 168, 1, 2 };
+
+static uint8_t frag_buf[FRAG_MAX][ETHERNET_MAX_FRAME_SIZE];
+static int frag_len[FRAG_MAX];
+static int frag_num;
+
+/* Payload pattern depends on the IP ID, so datagrams can be told apart */
+static void pattern(uint16_t id, uint8_t *buf, int len)
+{
+    int i;
+    
+    for (i = 0; i < len; i++)
+        buf[i] = (uint8_t) ((i * 7) + (id * 31));
+}
+
+static int frag_store(ipv4_packet_t *ip)
+{
+    int len;
+    
+    if (frag_num == FRAG_MAX)
+        return -1;
+    
+    len = ipv4_pkt_get_len(ip);
+    
+    if ((len == -1) || (len > (ETHERNET_MAX_FRAME_SIZE - 18)))
+        return -1;
+    
+    if (ipv4_pkt_to_buf(ip, frag_buf[frag_num]) == -1)
+        return -1;
+    
+    frag_len[frag_num] = len;
+    frag_num++;
+    return 0;
+}
+
+/* Fragments a UDP datagram into frag_buf, returns the index of the first */
+static int dgram_fragment(uint16_t id, int len)
+{
+    uint8_t payload[DGRAM_MAX];
+    udp_packet_t udp;
+    ipv4_packet_t ip;
+    int first;
+    
+    pattern(id, payload, len);
+    memset(&udp, 0, sizeof(udp_packet_t));
+    
+    if (udp_pkt_create(5000, 6000, payload, len, &udp) == -1)
+        return -1;
+    
+    ipv4_pkt_create_empty(&ip, 0, 0);
+    ipv4_pkt_set_id(&ip, id);
+    ipv4_pkt_set_prot(&ip, IPV4_PROT_UDP);
+    ipv4_pkt_set_src(&ip, &ip_src);
+    ipv4_pkt_set_dst(&ip, &ip_dst);
+    
+    if (udp_pkt_to_ip(&udp, &ip) == -1) {
+        udp_pkt_free(&udp);
+        return -1;
+    }
+    
+    udp_pkt_free(&udp);
+    first = frag_num;
+    
+    if (ipv4_frag_output(&ip, MTU, frag_store) == -1) {
+        ipv4_pkt_free(&ip);
+        return -1;
+    }
+    
+    ipv4_pkt_free(&ip);
+    return first;
+}
+
+/* Writes the stored fragments in the given order */
+static int pcap_write(const char *file, int *order, int num)
+{
+    eth_frame_t frame;
+    int i;
+    
+    if (nic_pcap_init(NULL, file, &mac_src) == -1)
+        return -1;
+    
+    for (i = 0; i < num; i++) {
+        memset(&frame, 0, sizeof(eth_frame_t));
+        ethernet_frame_set_dst(&frame, &mac_dst);
+        ethernet_frame_set_src(&frame, &mac_src);
+        ethernet_frame_set_type(&frame, ETHERNET_TYPE_IPV4);
+        
+        if (ethernet_frame_set_payload(&frame, frag_buf[order[i]], frag_len[order[i]]) == -1) {
+            nic_pcap_close();
+            return -1;
+        }
+        
+        /* The frame only points to frag_buf, nothing to free */
+        if (nic_pcap_send(&frame) == -1) {
+            nic_pcap_close();
+            return -1;
+        }
+    }
+    
+    nic_pcap_close();
+    return 0;
+}
+
+/* Checks a reassembled datagram against the pattern of its IP ID */
+static int dgram_check(ipv4_packet_t *ip)
+{
+    uint8_t expect[DGRAM_MAX];
+    udp_packet_t udp;
+    uint8_t *buf;
+    int len;
+    int ret;
+    
+    memset(&udp, 0, sizeof(udp_packet_t));
+    
+    if (udp_ip_to_pkt(ip, &udp) == -1)
+        return -1;
+    
+    len = udp_pkt_get_payload_len(&udp);
+    udp_pkt_get_payload(&udp, &buf);
+    ret = -1;
+    
+    if ((len > 0) && (len <= DGRAM_MAX)) {
+        pattern(ip->ip_hdr.ih_id, expect, len);
+        
+        if (memcmp(buf, expect, len) == 0)
+            ret = len;
+    }
+    
+    udp_pkt_free(&udp);
+    return ret;
+}
+
+/* Feeds every IPv4 fragment of a capture to the reassembly */
+static int pcap_replay(const char *file, int verify)
+{
+    eth_frame_t frame;
+    ipv4_packet_t ip;
+    ipv4_packet_t ip_out;
+    ipv4_frag_stats_t stats;
+    uint16_t type;
+    uint8_t *buf;
+    int len;
+    int ret;
+    int good = 0;
+    int bad = 0;
+    
+    if (nic_pcap_init(file, NULL, &mac_dst) == -1) {
+        printf("%s: can't open\n", file);
+        return -1;
+    }
+    
+    ipv4_frag_init();
+    
+    while (1) {
+        memset(&frame, 0, sizeof(eth_frame_t));
+        ret = nic_pcap_recv(&frame);
+        
+        if (ret == 0)
+            break;
+        
+        if (ret == -1)
+            continue;
+        
+        ethernet_frame_get_type(&frame, &type);
+        len = ethernet_frame_get_payload_len(&frame);
+        ethernet_frame_get_payload(&frame, &buf);
+        
+        if ((type != ETHERNET_TYPE_IPV4) || (len < 1) || 
+            (ipv4_buf_to_pkt(buf, len, &ip) == -1)) {
+            ethernet_frame_payload_free(&frame);
+            continue;
+        }
+        
+        ethernet_frame_payload_free(&frame);
+        
+        if (!(ip.ip_hdr.ih_flag & IPV4_FLAG_MF) && !ip.ip_hdr.ih_foff) {
+            ipv4_pkt_free(&ip);
+            continue;
+        }
+        
+        ret = ipv4_frag_input(&ip, &ip_out);
+        ipv4_pkt_free(&ip);
+        
+        if (ret != 1)
+            continue;
+        
+        if (!verify || (dgram_check(&ip_out) != -1))
+            good++;
+        else
+            bad++;
+        
+        ipv4_pkt_free(&ip_out);
+    }
+    
+    nic_pcap_close();
+    stats = ipv4_frag_get_stats();
+    printf("%s: %d datagrams reassembled, %d corrupt, ", file, good, bad);
+    printf("%u fragments, %u dropped, %u evicted\n", 
+           stats.rx_frag, stats.rx_drop, stats.rx_evict);
+    
+    if (bad)
+        return -1;
+    
+    return good;
+}
+
+int main(int argc, char *argv[])
+{
+    int order[FRAG_MAX];
+    int a;
+    int b;
+    int c;
+    int n;
+    int fail = 0;
+    
+    /* Replay a recorded capture, e.g. from the gateway */
+    if (argc > 1)
+        return (pcap_replay(argv[1], 0) == -1) ? 1 : 0;
+    
+    frag_num = 0;
+    a = dgram_fragment(DGRAM_A_ID, DGRAM_A_LEN);
+    b = dgram_fragment(DGRAM_B_ID, DGRAM_B_LEN);
+    c = dgram_fragment(DGRAM_C_ID, DGRAM_C_LEN);
+    
+    if ((a == -1) || (b == -1) || (c == -1)) {
+        printf("fragmentation failed\n");
+        return 1;
+    }
+    
+    /* In order: A, B, C one after the other */
+    for (n = 0; n < frag_num; n++)
+        order[n] = n;
+    
+    if (pcap_write(FILE_INORDER, order, frag_num) == -1) {
+        printf("%s: write failed\n", FILE_INORDER);
+        return 1;
+    }
+    
+    /* Out of order: A reversed with a duplicate, B and C interleaved */
+    n = 0;
+    order[n++] = a + 2;
+    order[n++] = a + 1;
+    order[n++] = a + 1;
+    order[n++] = a + 0;
+    order[n++] = c + 1;
+    order[n++] = b + 1;
+    order[n++] = b + 0;
+    order[n++] = c + 0;
+    
+    if (pcap_write(FILE_OUTORDER, order, n) == -1) {
+        printf("%s: write failed\n", FILE_OUTORDER);
+        return 1;
+    }
+    
+    if (pcap_replay(FILE_INORDER, 1) != 3)
+        fail = 1;
+    
+    if (pcap_replay(FILE_OUTORDER, 1) != 3)
+        fail = 1;
+    
+    printf("%s\n", fail ? "FAILED" : "PASSED");
+    return fail;
+}
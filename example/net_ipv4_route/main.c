@@ -0,0 +1,204 @@
+/**
+ *
+ * File Name: example/net_ipv4_route/main.c
+ * Title    : IPv4 routing table insert check and lookup benchmark
+ * Project  : lib-avr
+ * Author   : Copyright (C) 2026 Johannes Krottmayer <krjdev@gmail.com>
+ * Created  : 2026-10-19
+ * Modified : 
+ * Revised  : 
+ * Version  : 0.1.0.0
+ * License  : ISC (see file LICENSE.txt)
+ * Target   : Linux (host)
+ *
+ * NOTE: This code is currently below version 1.0, and therefore is considered
+ * to be lacking in some functionality or documentation, or may not be fully
+ * tested. Nonetheless, you can expect most functions to work.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+#include "../../net/ipv4.h"
+#include "../../net/ipv4_route.h"
+
+#define LOOKUPS         2000000
+#define ROUTE_NUM       7
+
+typedef struct route {
+    ipv4_addr_t r_dst;      /* Host bits set on purpose */
+    uint8_t r_suf;
+    ipv4_addr_t r_gw;
+} route_t;
+
+/* Full table (IPV4_ROUTE_MAX) with the default route */
+static const route_t routes[ROUTE_NUM] = {
+    { { 192, 168, 1, 77 }, 24, { 0, 0, 0, 0 } },
+    { { 10, 1, 2, 3 }, 8, { 192, 168, 1, 1 } },
+    { { 10, 20, 30, 40 }, 16, { 192, 168, 1, 2 } },
+    { { 10, 20, 30, 41 }, 24, { 192, 168, 1, 3 } },
+    { { 172, 16, 99, 1 }, 12, { 192, 168, 1, 4 } },
+    { { 100, 64, 255, 255 }, 10, { 192, 168, 1, 5 } },
+    { { 198, 51, 100, 9 }, 32, { 192, 168, 1, 6 } }
+};
+
+static ipv4_addr_t gw_default = { 192, 168, 1, 254 };
+
+static uint32_t u32(const ipv4_addr_t *ia)
+{
+    return ((uint32_t) ia->ia_byte0 << 24) | ((uint32_t) ia->ia_byte1 << 16) |
+           ((uint32_t) ia->ia_byte2 << 8) | ia->ia_byte3;
+}
+
+static uint32_t mask(uint8_t suf)
+{
+    return suf ? (0xFFFFFFFFUL << (32 - suf)) : 0;
+}
+
+/* Longest prefix match over routes[], the reference for ipv4_route_lookup() */
+static void ref_lookup(ipv4_addr_t *dst, ipv4_addr_t *nexthop)
+{
+    int best = -1;
+    int i;
+    
+    for (i = 0; i < ROUTE_NUM; i++) {
+        if ((u32(dst) & mask(routes[i].r_suf)) != (u32(&routes[i].r_dst) & mask(routes[i].r_suf)))
+            continue;
+        
+        if ((best == -1) || (routes[i].r_suf > routes[best].r_suf))
+            best = i;
+    }
+    
+    if (best == -1)
+        (*nexthop) = gw_default;
+    else if (routes[best].r_suf && !u32(&routes[best].r_gw))
+        (*nexthop) = (*dst);
+    else
+        (*nexthop) = routes[best].r_gw;
+}
+
+static uint32_t rnd(uint32_t *seed)
+{
+    (*seed) = ((*seed) * 1103515245UL) + 12345UL;
+    return (*seed);
+}
+
+/* Mostly addresses below the configured prefixes, the rest global */
+static void addr_gen(uint32_t *seed, ipv4_addr_t *ia)
+{
+    const route_t *rt;
+    uint32_t r;
+    uint32_t a;
+    
+    r = rnd(seed);
+    a = rnd(seed) ^ (r << 16);
+    
+    if ((r >> 24) < 192) {
+        rt = &routes[(r >> 8) % ROUTE_NUM];
+        a = (u32(&rt->r_dst) & mask(rt->r_suf)) | (a & ~mask(rt->r_suf));
+    }
+    
+    ia->ia_byte0 = (uint8_t) (a >> 24);
+    ia->ia_byte1 = (uint8_t) (a >> 16);
+    ia->ia_byte2 = (uint8_t) (a >> 8);
+    ia->ia_byte3 = (uint8_t) a;
+}
+
+static int table_build(void)
+{
+    ipv4_addr_t dup = { 10, 99, 99, 99 };
+    int i;
+    
+    ipv4_route_init();
+    
+    for (i = 0; i < ROUTE_NUM; i++) {
+        if (ipv4_route_add((ipv4_addr_t *) &routes[i].r_dst, routes[i].r_suf, 
+                           u32(&routes[i].r_gw) ? (ipv4_addr_t *) &routes[i].r_gw : NULL) == -1)
+            return -1;
+    }
+    
+    if (ipv4_route_set_default(&gw_default) == -1)
+        return -1;
+    
+    /* Same network as 10.1.2.3/8, only differs in host bits */
+    if ((ipv4_route_add(&dup, 8, &gw_default) != -1) || 
+        (ipv4_route_get_last_error() != IPV4_ROUTE_ERROR_EXIST)) {
+        printf("10.99.99.99/8 was added next to 10.1.2.3/8\n");
+        return -1;
+    }
+    
+    /* Deleted by any address inside the network */
+    if ((ipv4_route_del(&dup, 8) == -1) || 
+        (ipv4_route_add((ipv4_addr_t *) &routes[1].r_dst, 8, (ipv4_addr_t *) &routes[1].r_gw) == -1))
+        return -1;
+    
+    return 0;
+}
+
+int main(void)
+{
+    struct timespec t0;
+    struct timespec t1;
+    ipv4_addr_t dst;
+    ipv4_addr_t nh;
+    ipv4_addr_t ref;
+    uint32_t seed = 1;
+    uint32_t sink = 0;
+    uint32_t wrong = 0;
+    uint32_t noroute = 0;
+    double sec;
+    int i;
+    int fail = 0;
+    
+    if (table_build() == -1) {
+        printf("building the table failed\n");
+        printf("FAILED\n");
+        return 1;
+    }
+    
+    /* Correctness against the reference, special addresses aside */
+    for (i = 0; i < (LOOKUPS / 10); i++) {
+        addr_gen(&seed, &dst);
+        
+        if (ipv4_addr_classify(&dst) != IPV4_ADDR_GLOBAL)
+            continue;
+        
+        if (ipv4_route_lookup(&dst, &nh) == -1) {
+            noroute++;
+            continue;
+        }
+        
+        ref_lookup(&dst, &ref);
+        
+        if (!ipv4_addr_equal(&nh, &ref))
+            wrong++;
+    }
+    
+    seed = 1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    
+    for (i = 0; i < LOOKUPS; i++) {
+        addr_gen(&seed, &dst);
+        
+        if (ipv4_route_lookup(&dst, &nh) != -1)
+            sink += nh.ia_byte3;
+    }
+    
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    sec = (t1.tv_sec - t0.tv_sec) + ((t1.tv_nsec - t0.tv_nsec) / 1e9);
+    
+    printf("%d routes, %u wrong next hops, %u without a route\n", 
+           ipv4_route_get_num(), wrong, noroute);
+    printf("%d lookups in %.3f s, %.0f lookups/s (%u)\n", 
+           LOOKUPS, sec, (LOOKUPS / sec), (sink & 0x01));
+    
+    if (wrong || noroute || (ipv4_route_get_num() != IPV4_ROUTE_MAX))
+        fail = 1;
+    
+    printf("%s\n", fail ? "FAILED" : "PASSED");
+    return fail;
+}
@@ -0,0 +1,202 @@
+/**
+ *
+ * File Name: example/net_pcap/main.c
+ * Title    : pcap NIC backend replay of oversized records
+ * Project  : lib-avr
+ * Author   : Copyright (C) 2026 Johannes Krottmayer <krjdev@gmail.com>
+ * Created  : 2026-10-19
+ * Modified : 
+ * Revised  : 
+ * Version  : 0.1.0.0
+ * License  : ISC (see file LICENSE.txt)
+ * Target   : Linux (host)
+ *
+ * NOTE: This code is currently below version 1.0, and therefore is considered
+ * to be lacking in some functionality or documentation, or may not be fully
+ * tested. Nonetheless, you can expect most functions to work.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "../../net/ethernet.h"
+#include "../../net/nic_pcap.h"
+
+#define FILE_FRAMES     "pcap_frames.pcap"
+#define FILE_REPLAY     "pcap_oversized.pcap"
+
+#define FRAME_NUM       3
+#define FRAME_LEN       100
+#define JUMBO_LEN       9000    /* GRO/jumbo record, above ETHERNET_MAX_FRAME_SIZE */
+
+#define PCAP_HDR_LEN    24
+#define PCAP_REC_LEN    16
+
+static mac_addr_t mac_src = { 0x02, 0x00, 0x00, 0x00, 0x00, 0x01 };
+static mac_addr_t mac_dst = { 0x02, 0x00, 0x00, 0x00, 0x00, 0x02 };
+
+static uint8_t file_buf[(2 * JUMBO_LEN) + (FRAME_NUM * 2 * ETHERNET_MAX_FRAME_SIZE)];
+
+static void put32(uint8_t *p, uint32_t val)
+{
+    p[0] = (uint8_t) (val & 0xFF);
+    p[1] = (uint8_t) ((val >> 8) & 0xFF);
+    p[2] = (uint8_t) ((val >> 16) & 0xFF);
+    p[3] = (uint8_t) ((val >> 24) & 0xFF);
+}
+
+/* Frame n carries n in every payload byte */
+static int frames_write(void)
+{
+    uint8_t payload[FRAME_LEN];
+    eth_frame_t frame;
+    int i;
+    
+    if (nic_pcap_init(NULL, FILE_FRAMES, &mac_src) == -1)
+        return -1;
+    
+    for (i = 0; i < FRAME_NUM; i++) {
+        memset(payload, i, FRAME_LEN);
+        memset(&frame, 0, sizeof(eth_frame_t));
+        ethernet_frame_set_dst(&frame, &mac_dst);
+        ethernet_frame_set_src(&frame, &mac_src);
+        ethernet_frame_set_type(&frame, ETHERNET_TYPE_IPV4);
+        
+        if ((ethernet_frame_set_payload(&frame, payload, FRAME_LEN) == -1) || 
+            (nic_pcap_send(&frame) == -1)) {
+            nic_pcap_close();
+            return -1;
+        }
+    }
+    
+    nic_pcap_close();
+    return 0;
+}
+
+/* Oversized record, its body is filled with fake record headers */
+static int jumbo_put(uint8_t *p)
+{
+    int i;
+    
+    memset(p, 0, PCAP_REC_LEN);
+    put32(&p[8], JUMBO_LEN);
+    put32(&p[12], JUMBO_LEN);
+    
+    for (i = 0; i < JUMBO_LEN; i += 4)
+        put32(&p[PCAP_REC_LEN + i], 64);
+    
+    return PCAP_REC_LEN + JUMBO_LEN;
+}
+
+/* Copies the frames, with a jumbo record in front of the second and the third */
+static int replay_write(void)
+{
+    FILE *fp;
+    long len;
+    long pos;
+    long out;
+    uint32_t rec_len;
+    int n;
+    
+    fp = fopen(FILE_FRAMES, "rb");
+    
+    if (!fp)
+        return -1;
+    
+    len = fread(file_buf, 1, sizeof(file_buf) / 2, fp);
+    fclose(fp);
+    
+    if (len < PCAP_HDR_LEN)
+        return -1;
+    
+    out = len;
+    memcpy(&file_buf[out], file_buf, PCAP_HDR_LEN);
+    out += PCAP_HDR_LEN;
+    pos = PCAP_HDR_LEN;
+    n = 0;
+    
+    while ((pos + PCAP_REC_LEN) <= len) {
+        rec_len = file_buf[pos + 8] | (file_buf[pos + 9] << 8);
+        
+        if (n > 0)
+            out += jumbo_put(&file_buf[out]);
+        
+        memcpy(&file_buf[out], &file_buf[pos], (PCAP_REC_LEN + rec_len));
+        out += PCAP_REC_LEN + rec_len;
+        pos += PCAP_REC_LEN + rec_len;
+        n++;
+    }
+    
+    fp = fopen(FILE_REPLAY, "wb");
+    
+    if (!fp)
+        return -1;
+    
+    if (fwrite(&file_buf[len], 1, (out - len), fp) != (size_t) (out - len)) {
+        fclose(fp);
+        return -1;
+    }
+    
+    fclose(fp);
+    return n;
+}
+
+int main(void)
+{
+    eth_frame_t frame;
+    nic_stats_t stats;
+    uint8_t *buf;
+    int expect;
+    int ret;
+    int len;
+    int fail = 0;
+    
+    if ((frames_write() == -1) || (replay_write() != FRAME_NUM)) {
+        printf("writing the captures failed\n");
+        return 1;
+    }
+    
+    if (nic_pcap_init(FILE_REPLAY, NULL, &mac_dst) == -1) {
+        printf("%s: can't open\n", FILE_REPLAY);
+        return 1;
+    }
+    
+    expect = 0;
+    
+    while (1) {
+        memset(&frame, 0, sizeof(eth_frame_t));
+        ret = nic_pcap_recv(&frame);
+        
+        if (ret == 0)
+            break;
+        
+        if (ret == -1) {
+            printf("recv failed, error %d\n", nic_pcap_get_last_error());
+            fail = 1;
+            break;
+        }
+        
+        len = ethernet_frame_get_payload_len(&frame);
+        ethernet_frame_get_payload(&frame, &buf);
+        
+        /* Out of sync, a fake record header was taken for a frame */
+        if ((len < FRAME_LEN) || (buf[0] != expect) || (buf[FRAME_LEN - 1] != expect))
+            fail = 1;
+        
+        ethernet_frame_payload_free(&frame);
+        expect++;
+    }
+    
+    nic_pcap_close();
+    stats = nic_pcap_get_stats();
+    printf("%s: %u frames, %u records skipped\n", FILE_REPLAY, stats.rx_frm, stats.rx_err);
+    
+    if ((expect != FRAME_NUM) || (stats.rx_err != (FRAME_NUM - 1)))
+        fail = 1;
+    
+    printf("%s\n", fail ? "FAILED" : "PASSED");
+    return fail;
+}
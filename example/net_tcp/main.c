@@ -0,0 +1,342 @@
+/**
+ *
+ * File Name: example/net_tcp/main.c
+ * Title    : TCP MSS and window scale negotiation throughput over a simulated link
+ * Project  : lib-avr
+ * Author   : Copyright (C) 2026 Johannes Krottmayer <krjdev@gmail.com>
+ * Created  : 2026-10-19
+ * Modified : 
+ * Revised  : 
+ * Version  : 0.1.0.0
+ * License  : ISC (see file LICENSE.txt)
+ * Target   : Linux (host)
+ *
+ * NOTE: This code is currently below version 1.0, and therefore is considered
+ * to be lacking in some functionality or documentation, or may not be fully
+ * tested. Nonetheless, you can expect most functions to work.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "../../net/ipv4.h"
+#include "../../net/tcp.h"
+
+#define LINK_BPS        1250000ULL  /* 10 Mbit/s */
+#define LINK_DELAY_NS   50000000ULL /* One way, 100 ms RTT */
+#define WIRE_MAX        1500
+#define QUEUE_LEN       512
+
+#define RCV_BUF         262144UL
+#define WSCALE          3           /* 0xFFFF << 3 covers RCV_BUF */
+#define XFER_LEN        4000000UL
+
+#define PORT_A          40000
+#define PORT_B          80
+#define ISN_A           0xFFFF0000UL    /* Sequence numbers wrap during the transfer */
+#define ISN_B           0x12345678UL
+
+typedef struct peer {
+    ipv4_addr_t p_ip;
+    uint16_t p_port;
+    uint32_t p_isn;
+    tcp_options_t p_opt;
+    tcp_nego_t p_nego;
+} peer_t;
+
+/* Packets on their way, in the order they arrive */
+typedef struct link {
+    uint8_t l_buf[QUEUE_LEN][WIRE_MAX];
+    int l_len[QUEUE_LEN];
+    uint64_t l_due[QUEUE_LEN];
+    int l_head;
+    int l_num;
+    uint64_t l_busy;    /* Transmitter busy until */
+} link_t;
+
+static link_t fwd;      /* A to B */
+static link_t rev;      /* B to A */
+static uint64_t now;    /* Simulated time in ns */
+
+static peer_t a = { { 192, 168, 1, 1 }, PORT_A, ISN_A, { 0, 0, 0 }, { 0, 0, 0, 0 } };
+static peer_t b = { { 192, 168, 1, 2 }, PORT_B, ISN_B, { 0, 0, 0 }, { 0, 0, 0, 0 } };
+
+/* Transfer data, depends on the offset only */
+static void pattern(uint32_t off, uint8_t *buf, int len)
+{
+    int i;
+    
+    for (i = 0; i < len; i++)
+        buf[i] = (uint8_t) ((off + i) % 251);
+}
+
+/* Encodes the segment to an IPv4 packet and queues it behind the last one */
+static int link_send(link_t *l, peer_t *src, peer_t *dst, tcp_packet_t *tcp)
+{
+    ipv4_packet_t ip;
+    uint64_t start;
+    int len;
+    int i;
+    
+    if (l->l_num == QUEUE_LEN)
+        return -1;
+    
+    ipv4_pkt_create_empty(&ip, IPV4_FLAG_DF, 0);
+    ipv4_pkt_set_prot(&ip, IPV4_PROT_TCP);
+    ipv4_pkt_set_src(&ip, &src->p_ip);
+    ipv4_pkt_set_dst(&ip, &dst->p_ip);
+    
+    if (tcp_pkt_to_ip(tcp, &ip) == -1)
+        return -1;
+    
+    i = (l->l_head + l->l_num) % QUEUE_LEN;
+    len = ipv4_pkt_get_len(&ip);
+    
+    if ((len > WIRE_MAX) || (ipv4_pkt_to_buf(&ip, l->l_buf[i]) == -1)) {
+        ipv4_pkt_free(&ip);
+        return -1;
+    }
+    
+    ipv4_pkt_free(&ip);
+    start = (l->l_busy > now) ? l->l_busy : now;
+    l->l_busy = start + ((len * 1000000000ULL) / LINK_BPS);
+    l->l_due[i] = l->l_busy + LINK_DELAY_NS;
+    l->l_len[i] = len;
+    l->l_num++;
+    return 0;
+}
+
+/* The next packet arrived until now, 1 if one was decoded */
+static int link_recv(link_t *l, tcp_packet_t *tcp)
+{
+    ipv4_packet_t ip;
+    int ret;
+    
+    if (!l->l_num || (l->l_due[l->l_head] > now))
+        return 0;
+    
+    memset(&ip, 0, sizeof(ipv4_packet_t));
+    ret = ipv4_buf_to_pkt(l->l_buf[l->l_head], l->l_len[l->l_head], &ip);
+    l->l_head = (l->l_head + 1) % QUEUE_LEN;
+    l->l_num--;
+    
+    if (ret == -1)
+        return -1;
+    
+    ret = tcp_ip_to_pkt(&ip, tcp);
+    ipv4_pkt_free(&ip);
+    return (ret == -1) ? -1 : 1;
+}
+
+/* Time of the next arrival on either link */
+static int link_next(void)
+{
+    if (!fwd.l_num && !rev.l_num)
+        return -1;
+    
+    if (!rev.l_num || (fwd.l_num && (fwd.l_due[fwd.l_head] < rev.l_due[rev.l_head])))
+        now = fwd.l_due[fwd.l_head];
+    else
+        now = rev.l_due[rev.l_head];
+    
+    return 0;
+}
+
+/* SYN and SYN-ACK, both ends negotiate from the options they got */
+static int handshake(uint32_t *snd_wnd)
+{
+    tcp_options_t got;
+    tcp_packet_t tcp;
+    
+    tcp_pkt_create(a.p_port, b.p_port, a.p_isn, 0, 0, TCP_FLAG_SYN, 0, &tcp);
+    tcp_pkt_set_win_scaled(&tcp, RCV_BUF, 0);
+    tcp_pkt_set_opts(&tcp, &a.p_opt);
+    
+    if (link_send(&fwd, &a, &b, &tcp) == -1) {
+        tcp_pkt_free(&tcp);
+        return -1;
+    }
+    
+    tcp_pkt_free(&tcp);
+    link_next();
+    
+    if (link_recv(&fwd, &tcp) != 1)
+        return -1;
+    
+    tcp_pkt_get_opts(&tcp, &got);
+    tcp_pkt_free(&tcp);
+    tcp_opt_negotiate(&b.p_opt, &got, &b.p_nego);
+    
+    tcp_pkt_create(b.p_port, a.p_port, b.p_isn, (a.p_isn + 1), 0, 
+                   (TCP_FLAG_SYN | TCP_FLAG_ACK), 0, &tcp);
+    tcp_pkt_set_win_scaled(&tcp, RCV_BUF, 0);
+    tcp_pkt_set_opts(&tcp, &b.p_opt);
+    
+    if (link_send(&rev, &b, &a, &tcp) == -1) {
+        tcp_pkt_free(&tcp);
+        return -1;
+    }
+    
+    tcp_pkt_free(&tcp);
+    link_next();
+    
+    if (link_recv(&rev, &tcp) != 1)
+        return -1;
+    
+    /* The window of a SYN is never scaled */
+    tcp_pkt_get_opts(&tcp, &got);
+    tcp_pkt_get_win_scaled(&tcp, a.p_nego.tn_snd_wscale, snd_wnd);
+    tcp_pkt_free(&tcp);
+    return tcp_opt_negotiate(&a.p_opt, &got, &a.p_nego);
+}
+
+/* A sends XFER_LEN bytes to B, B acks every segment, returns the time in ns */
+static uint64_t bulk(uint32_t snd_wnd)
+{
+    uint8_t buf[WIRE_MAX];
+    uint8_t *p;
+    tcp_packet_t tcp;
+    uint32_t snd_una = a.p_isn + 1;
+    uint32_t snd_nxt = a.p_isn + 1;
+    uint32_t rcv_nxt = a.p_isn + 1;
+    uint32_t end = a.p_isn + 1 + XFER_LEN;
+    uint32_t seqn;
+    uint64_t t0 = now;
+    int len;
+    int ret;
+    
+    while (snd_una != end) {
+        /* Sender fills the window the last ACK offered */
+        while (snd_nxt != end) {
+            len = a.p_nego.tn_mss;
+            
+            if ((end - snd_nxt) < len)
+                len = end - snd_nxt;
+            
+            if (((snd_nxt - snd_una) + len) > snd_wnd)
+                break;
+            
+            pattern((snd_nxt - a.p_isn - 1), buf, len);
+            tcp_pkt_create(a.p_port, b.p_port, snd_nxt, (b.p_isn + 1), 0, TCP_FLAG_ACK, 0, &tcp);
+            tcp_pkt_set_win_scaled(&tcp, RCV_BUF, a.p_nego.tn_rcv_wscale);
+            tcp_pkt_set_payload(&tcp, buf, len);
+            ret = link_send(&fwd, &a, &b, &tcp);
+            tcp_pkt_free(&tcp);
+            
+            if (ret == -1)
+                return 0;
+            
+            snd_nxt += len;
+        }
+        
+        if (link_next() == -1)
+            return 0;
+        
+        /* Receiver takes in order data only, the buffer is read at once */
+        while ((ret = link_recv(&fwd, &tcp)) == 1) {
+            tcp_pkt_get_seqn(&tcp, &seqn);
+            len = tcp_pkt_get_payload_len(&tcp);
+            tcp_pkt_get_payload(&tcp, &p);
+            pattern((seqn - a.p_isn - 1), buf, len);
+            
+            if ((seqn != rcv_nxt) || (len > b.p_nego.tn_mss) || memcmp(p, buf, len)) {
+                tcp_pkt_free(&tcp);
+                return 0;
+            }
+            
+            tcp_pkt_free(&tcp);
+            rcv_nxt += len;
+            tcp_pkt_create(b.p_port, a.p_port, (b.p_isn + 1), rcv_nxt, 0, TCP_FLAG_ACK, 0, &tcp);
+            tcp_pkt_set_win_scaled(&tcp, RCV_BUF, b.p_nego.tn_rcv_wscale);
+            ret = link_send(&rev, &b, &a, &tcp);
+            tcp_pkt_free(&tcp);
+            
+            if (ret == -1)
+                return 0;
+        }
+        
+        if (ret == -1)
+            return 0;
+        
+        while ((ret = link_recv(&rev, &tcp)) == 1) {
+            tcp_pkt_get_ackn(&tcp, &snd_una);
+            tcp_pkt_get_win_scaled(&tcp, a.p_nego.tn_snd_wscale, &snd_wnd);
+            tcp_pkt_free(&tcp);
+        }
+        
+        if (ret == -1)
+            return 0;
+    }
+    
+    return now - t0;
+}
+
+int main(void)
+{
+    /* Peer options of A and B, the expected MSS and window scale */
+    static const struct {
+        const char *name;
+        tcp_options_t opt_a;
+        tcp_options_t opt_b;
+        uint16_t mss;
+        uint8_t wscale;
+    } cases[] = {
+        { "no options   ", { (TCP_OPTF_MSS | TCP_OPTF_WSCALE), TCP_MSS_ETHERNET, WSCALE }, 
+          { 0, 0, 0 }, TCP_MSS_DEFAULT, 0 },
+        { "MSS          ", { (TCP_OPTF_MSS | TCP_OPTF_WSCALE), TCP_MSS_ETHERNET, WSCALE }, 
+          { TCP_OPTF_MSS, TCP_MSS_ETHERNET, 0 }, TCP_MSS_ETHERNET, 0 },
+        { "MSS, wscale  ", { (TCP_OPTF_MSS | TCP_OPTF_WSCALE), TCP_MSS_ETHERNET, WSCALE }, 
+          { (TCP_OPTF_MSS | TCP_OPTF_WSCALE), 1400, WSCALE }, 1400, WSCALE },
+    };
+    uint64_t bps[3];
+    uint64_t t;
+    uint32_t snd_wnd;
+    uint64_t goodput;
+    uint64_t unscaled;
+    int i;
+    int fail = 0;
+    
+    unscaled = (0xFFFFULL * 1000000000ULL) / (2 * LINK_DELAY_NS);
+    printf("link %u kB/s, RTT %u ms, receive buffer %lu, %lu bytes:\n", 
+           (uint32_t) (LINK_BPS / 1000), (uint32_t) ((2 * LINK_DELAY_NS) / 1000000), RCV_BUF, XFER_LEN);
+    
+    for (i = 0; i < 3; i++) {
+        memset(&fwd, 0, sizeof(link_t));
+        memset(&rev, 0, sizeof(link_t));
+        now = 0;
+        a.p_opt = cases[i].opt_a;
+        b.p_opt = cases[i].opt_b;
+        
+        if (handshake(&snd_wnd) == -1) {
+            printf("%s handshake failed\n", cases[i].name);
+            fail = 1;
+            continue;
+        }
+        
+        t = bulk(snd_wnd);
+        bps[i] = t ? ((XFER_LEN * 1000000000ULL) / t) : 0;
+        printf("%s MSS %u, wscale %u/%u: %u kB/s\n", cases[i].name, a.p_nego.tn_mss, 
+               a.p_nego.tn_snd_wscale, a.p_nego.tn_rcv_wscale, (uint32_t) (bps[i] / 1000));
+        
+        /* Both ends agree, A sends with the window scale B asked for */
+        if ((a.p_nego.tn_mss != cases[i].mss) || (b.p_nego.tn_mss != cases[i].mss) || 
+            (a.p_nego.tn_snd_wscale != cases[i].wscale) || 
+            (b.p_nego.tn_rcv_wscale != cases[i].wscale) || 
+            (a.p_nego.tn_rcv_wscale != b.p_nego.tn_snd_wscale) || !t)
+            fail = 1;
+    }
+    
+    /* A 64 kB window can't fill the link, the scaled one leaves only the headers */
+    goodput = (LINK_BPS * 1400) / (1400 + 40);
+    printf("64 kB window limit %u kB/s, goodput at MSS 1400 %u kB/s\n", 
+           (uint32_t) (unscaled / 1000), (uint32_t) (goodput / 1000));
+    
+    if ((bps[0] > unscaled) || (bps[1] > unscaled) || (bps[2] < ((goodput * 9) / 10)))
+        fail = 1;
+    
+    printf("%s\n", fail ? "FAILED" : "PASSED");
+    return fail;
+}
@@ -0,0 +1,134 @@
+/**
+ *
+ * File Name: example/onewire_tm/main.c
+ * Title    : Timer driven 1-Wire test on the bus simulator
+ * Project  : lib-avr
+ * Author   : Copyright (C) 2026 Johannes Krottmayer <krjdev@gmail.com>
+ * Created  : 2026-10-19
+ * Modified : 
+ * Revised  : 
+ * Version  : 0.1.0.0
+ * License  : ISC (see file LICENSE.txt)
+ * Target   : Linux (host)
+ *
+ * NOTE: This code is currently below version 1.0, and therefore is considered
+ * to be lacking in some functionality or documentation, or may not be fully
+ * tested. Nonetheless, you can expect most functions to work.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "../../onewire/tm-onewire.h"
+
+#define CMD_ROM_READ        0x33
+#define CMD_ROM_MATCH       0x55
+#define CMD_ROM_SKIP        0xCC
+#define CMD_SCRATCHPAD_READ 0xBE
+
+static uint8_t rom1[8] = { 0x28, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x77 };
+static uint8_t rom2[8] = { 0x28, 0x09, 0x09, 0x09, 0x09, 0x09, 0x09, 0x11 };
+static uint8_t sp1[9] = { 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09 };
+static uint8_t sp2[9] = { 0x50, 0x05, 0x4B, 0x46, 0x7F, 0xFF, 0x0C, 0x10, 0x1C };
+
+static int cb_result;
+static int cb_num;
+
+static void done(int result)
+{
+    cb_result = result;
+    cb_num++;
+}
+
+int main(void)
+{
+    uint8_t cmd[10];
+    uint8_t rx[9];
+    uint8_t and[9];
+    uint32_t t0;
+    int busy;
+    int ret;
+    int i;
+    int fail = 0;
+    
+    ow_sim_init();
+    onewire_tm_init();
+    
+    /* Empty bus */
+    t0 = ow_sim_get_time();
+    onewire_tm_reset(done);
+    ret = onewire_tm_wait();
+    printf("reset, no device: presence %d in %u us\n", ret, (ow_sim_get_time() - t0));
+    
+    if ((ret != 0) || (cb_result != 0))
+        fail = 1;
+    
+    ow_sim_add(rom1, sp1, sizeof(sp1), 0);
+    
+    /* The transfer runs in the background, the call returns at once */
+    cmd[0] = CMD_ROM_READ;
+    t0 = ow_sim_get_time();
+    onewire_tm_xfer(cmd, 1, rx, 8, done);
+    busy = onewire_tm_busy();
+    ret = onewire_tm_wait();
+    printf("READ ROM: presence %d in %u us\n", ret, (ow_sim_get_time() - t0));
+    
+    if (!busy || (ret != 1) || (cb_result != 1) || memcmp(rx, rom1, 8))
+        fail = 1;
+    
+    ow_sim_add(rom2, sp2, sizeof(sp2), 0);
+    
+    /* MATCH ROM of the second device, READ SCRATCHPAD */
+    cmd[0] = CMD_ROM_MATCH;
+    memcpy(&cmd[1], rom2, 8);
+    cmd[9] = CMD_SCRATCHPAD_READ;
+    t0 = ow_sim_get_time();
+    onewire_tm_xfer(cmd, 10, rx, 9, done);
+    ret = onewire_tm_wait();
+    printf("MATCH ROM, READ SCRATCHPAD: presence %d in %u us\n", ret, (ow_sim_get_time() - t0));
+    
+    if ((ret != 1) || memcmp(rx, sp2, 9))
+        fail = 1;
+    
+    /* Both devices answer, the bus is a wired AND */
+    cmd[0] = CMD_ROM_READ;
+    onewire_tm_xfer(cmd, 1, rx, 8, done);
+    onewire_tm_wait();
+    
+    for (i = 0; i < 8; i++)
+        and[i] = rom1[i] & rom2[i];
+    
+    if (memcmp(rx, and, 8)) {
+        printf("READ ROM of two devices is no wired AND\n");
+        fail = 1;
+    }
+    
+    /* The same with the single step calls */
+    cmd[0] = CMD_ROM_SKIP;
+    cmd[1] = CMD_SCRATCHPAD_READ;
+    onewire_tm_reset(done);
+    onewire_tm_wait();
+    onewire_tm_send(cmd, 2, done);
+    onewire_tm_wait();
+    onewire_tm_recv(rx, 9, done);
+    onewire_tm_wait();
+    
+    for (i = 0; i < 9; i++)
+        and[i] = sp1[i] & sp2[i];
+    
+    if (memcmp(rx, and, 9)) {
+        printf("SKIP ROM, READ SCRATCHPAD differs\n");
+        fail = 1;
+    }
+    
+    printf("%d callbacks\n", cb_num);
+    
+    if (cb_num != 7)
+        fail = 1;
+    
+    printf("%s\n", fail ? "FAILED" : "PASSED");
+    return fail;
+}
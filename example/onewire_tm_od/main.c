@@ -0,0 +1,151 @@
+/**
+ *
+ * File Name: example/onewire_tm_od/main.c
+ * Title    : 1-Wire Overdrive speed and interrupt latency test on the bus simulator
+ * Project  : lib-avr
+ * Author   : Copyright (C) 2026 Johannes Krottmayer <krjdev@gmail.com>
+ * Created  : 2026-10-19
+ * Modified : 
+ * Revised  : 
+ * Version  : 0.1.0.0
+ * License  : ISC (see file LICENSE.txt)
+ * Target   : Linux (host)
+ *
+ * NOTE: This code is currently below version 1.0, and therefore is considered
+ * to be lacking in some functionality or documentation, or may not be fully
+ * tested. Nonetheless, you can expect most functions to work.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "../../onewire/tm-onewire.h"
+
+#define CMD_ROM_MATCH       0x55
+#define CMD_MEMORY_READ     0xF0
+
+#define TAGS                8
+#define MEM_LEN             32
+#define LATENCY_MAX_US      20
+
+static uint8_t roms[TAGS][8];
+static uint8_t mem[MEM_LEN];
+
+/* Select, READ MEMORY from address 0, closing reset, returns its presence */
+static int tag_read(int i, int od, uint8_t *buf)
+{
+    uint8_t cmd[9];
+    
+    if (od)
+        onewire_tm_od_select(roms[i], NULL);
+    else {
+        cmd[0] = CMD_ROM_MATCH;
+        memcpy(&cmd[1], roms[i], 8);
+        onewire_tm_set_speed(ONEWIRE_TM_SPEED_STD);
+        onewire_tm_xfer(cmd, 9, NULL, 0, NULL);
+    }
+    
+    if (onewire_tm_wait() != 1)
+        return -1;
+    
+    cmd[0] = CMD_MEMORY_READ;
+    cmd[1] = 0;
+    onewire_tm_send(cmd, 2, NULL);
+    onewire_tm_wait();
+    onewire_tm_recv(buf, MEM_LEN, NULL);
+    onewire_tm_wait();
+    onewire_tm_reset(NULL);
+    return onewire_tm_wait();
+}
+
+/* All tags, bus time in us or 0 on a wrong read */
+static uint32_t tags_read(int od)
+{
+    uint8_t buf[MEM_LEN];
+    uint32_t t0;
+    int i;
+    
+    t0 = ow_sim_get_time();
+    
+    for (i = 0; i < TAGS; i++) {
+        memset(buf, 0, MEM_LEN);
+        
+        if ((tag_read(i, od, buf) != 1) || (buf[0] != i) || memcmp(&buf[1], &mem[1], (MEM_LEN - 1)))
+            return 0;
+    }
+    
+    return ow_sim_get_time() - t0;
+}
+
+static void bus_setup(int od_cap)
+{
+    int i;
+    
+    ow_sim_init();
+    
+    for (i = 0; i < TAGS; i++) {
+        mem[0] = i;
+        ow_sim_add(roms[i], mem, MEM_LEN, od_cap);
+    }
+    
+    onewire_tm_init();
+}
+
+int main(void)
+{
+    uint8_t buf[MEM_LEN];
+    uint32_t t_std;
+    uint32_t t_od;
+    int lat;
+    int ret;
+    int i;
+    int fail = 0;
+    
+    for (i = 0; i < MEM_LEN; i++)
+        mem[i] = (i * 7) + 1;
+    
+    for (i = 0; i < TAGS; i++) {
+        memset(roms[i], 0, 8);
+        roms[i][0] = 0x14;
+        roms[i][1] = i + 1;
+    }
+    
+    bus_setup(1);
+    t_std = tags_read(0);
+    t_od = tags_read(1);
+    printf("%d tags, %d bytes each: standard %u us, Overdrive %u us\n", TAGS, MEM_LEN, t_std, t_od);
+    
+    if (!t_std || !t_od) {
+        printf("read failed\n");
+        fail = 1;
+    } else
+        printf("Overdrive is %.1fx faster\n", ((double) t_std / t_od));
+    
+    /* Interrupt latency stretches the low times, Overdrive allows 16 us */
+    for (lat = 0; lat <= LATENCY_MAX_US; lat += 5) {
+        bus_setup(1);
+        ow_sim_set_latency(lat * 1000);
+        t_od = tags_read(1);
+        printf("latency %2d us: Overdrive %s\n", lat, t_od ? "ok" : "FAILED");
+        
+        if (!t_od)
+            fail = 1;
+    }
+    
+    /* A tag without Overdrive misses the select, the bus drops to standard speed */
+    bus_setup(0);
+    onewire_tm_od_select(roms[3], NULL);
+    onewire_tm_wait();
+    onewire_tm_reset(NULL);
+    ret = onewire_tm_wait();
+    printf("Overdrive reset of a standard tag: presence %d, speed %d\n", ret, onewire_tm_get_speed());
+    
+    if ((ret != 0) || (tag_read(3, 0, buf) != 1) || (buf[0] != 3))
+        fail = 1;
+    
+    printf("%s\n", fail ? "FAILED" : "PASSED");
+    return fail;
+}
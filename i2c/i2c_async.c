@@ -0,0 +1,339 @@
+/**
+ *
+ * File Name: i2c_async.c
+ * Title    : Interrupt driven I2C (TWI) master with transaction queue
+ * Project  : lib-avr
+ * Author   : Copyright (C) 2026 Johannes Krottmayer <krjdev@gmail.com>
+ * Created  : 2026-10-19
+ * Modified : 
+ * Revised  : 
+ * Version  : 0.1.0.0
+ * License  : ISC (see file LICENSE.txt)
+ * Target   : Atmel AVR Series
+ *
+ * NOTE: This code is currently below version 1.0, and therefore is considered
+ * to be lacking in some functionality or documentation, or may not be fully
+ * tested. Nonetheless, you can expect most functions to work.
+ *
+ */
+
+#include <stdlib.h>
+
+#include "i2c_async.h"
+
+#ifndef I2C_SIM
+#include <avr/interrupt.h>
+
+#define LOCK(sreg)          do { sreg = SREG; cli(); } while (0)
+#define UNLOCK(sreg)        (SREG = sreg)
+#else
+#define LOCK(sreg)          (sreg = 0)
+#define UNLOCK(sreg)        ((void) sreg)
+#endif
+
+/* TWI status codes, master mode */
+#define ST_START            0x08
+#define ST_REP_START        0x10
+#define ST_SLAW_ACK         0x18
+#define ST_SLAW_NACK        0x20
+#define ST_DATA_TX_ACK      0x28
+#define ST_DATA_TX_NACK     0x30
+#define ST_ARB_LOST         0x38
+#define ST_SLAR_ACK         0x40
+#define ST_SLAR_NACK        0x48
+#define ST_DATA_RX_ACK      0x50
+#define ST_DATA_RX_NACK     0x58
+
+#define CR_RUN              ((1 << TWINT) | (1 << TWEN) | (1 << TWIE))
+#define CR_STOP             ((1 << TWINT) | (1 << TWEN) | (1 << TWSTO))
+
+static int error = I2C_ASYNC_ERR_NOERR;
+static i2c_xfer_t *queue[I2C_ASYNC_QUEUE_LEN];
+static volatile uint8_t q_head = 0;
+static volatile uint8_t q_cnt = 0;
+static volatile uint8_t running = 0;
+static uint8_t seg;
+static int pos;
+static uint8_t retries;
+static i2c_async_stats_t stats;
+static uint8_t initialized = 0;
+
+static void xfer_start(uint8_t ctrl)
+{
+    queue[q_head]->ix_state = I2C_XFER_ACTIVE;
+    seg = 0;
+    pos = 0;
+    retries = 0;
+    
+    /* A START written before the last STOP has gone out is lost */
+    if (!(ctrl & (1 << TWSTO))) {
+        while (TWI_STOP_PENDING)
+            ;
+    }
+    
+    TWI_CONTROL(ctrl | (1 << TWSTA));
+}
+
+/* The callback may queue the next transaction, the bus is still held */
+static void xfer_finish(uint8_t err)
+{
+    i2c_xfer_t *xfer;
+    
+    xfer = queue[q_head];
+    q_head = (q_head + 1) % I2C_ASYNC_QUEUE_LEN;
+    q_cnt--;
+    xfer->ix_err = err;
+    stats.ias_xfers++;
+    
+    if (err) {
+        xfer->ix_state = I2C_XFER_FAILED;
+        stats.ias_failed++;
+    } else
+        xfer->ix_state = I2C_XFER_DONE;
+    
+    if (xfer->ix_done)
+        xfer->ix_done(xfer);
+    
+    /* STOP and START in one go if more is queued */
+    if (q_cnt)
+        xfer_start(CR_RUN | (1 << TWSTO));
+    else {
+        running = 0;
+        TWI_CONTROL(CR_STOP);
+    }
+}
+
+static void next_seg(void)
+{
+    seg++;
+    
+    if (seg < queue[q_head]->ix_nseg)
+        TWI_CONTROL(CR_RUN | (1 << TWSTA));
+    else
+        xfer_finish(I2C_ASYNC_ERR_NOERR);
+}
+
+/* ACK all but the last byte of a read */
+static void read_next(i2c_seg_t *s)
+{
+    if ((pos + 1) < s->is_len)
+        TWI_CONTROL(CR_RUN | (1 << TWEA));
+    else
+        TWI_CONTROL(CR_RUN);
+}
+
+#ifndef I2C_SIM
+ISR(TWI_vect)
+{
+    i2c_async_isr();
+}
+#endif
+
+void i2c_async_isr(void)
+{
+    i2c_xfer_t *xfer;
+    i2c_seg_t *s;
+    
+    if (!running)
+        return;
+    
+    xfer = queue[q_head];
+    s = &xfer->ix_seg[seg];
+    
+    switch (TWI_STATUS) {
+    case ST_START:
+    case ST_REP_START:
+        pos = 0;
+        
+        if (s->is_type == I2C_SEG_READ)
+            TWI_DATA_WRITE((xfer->ix_addr << 1) | 1);
+        else
+            TWI_DATA_WRITE(xfer->ix_addr << 1);
+        
+        TWI_CONTROL(CR_RUN);
+        break;
+    case ST_SLAW_ACK:
+    case ST_DATA_TX_ACK:
+        if (pos < s->is_len) {
+            TWI_DATA_WRITE(s->is_buf[pos]);
+            pos++;
+            TWI_CONTROL(CR_RUN);
+        } else
+            next_seg();
+        
+        break;
+    case ST_SLAR_ACK:
+        read_next(s);
+        break;
+    case ST_DATA_RX_ACK:
+        s->is_buf[pos] = TWI_DATA_READ;
+        pos++;
+        read_next(s);
+        break;
+    case ST_DATA_RX_NACK:
+        s->is_buf[pos] = TWI_DATA_READ;
+        pos++;
+        next_seg();
+        break;
+    case ST_SLAW_NACK:
+    case ST_DATA_TX_NACK:
+    case ST_SLAR_NACK:
+        stats.ias_nacks++;
+        xfer_finish(I2C_ASYNC_ERR_NACK);
+        break;
+    case ST_ARB_LOST:
+        /* The TWI has released the bus, START again once it is free */
+        stats.ias_arb_lost++;
+        
+        if (retries >= I2C_ASYNC_RETRY) {
+            xfer_finish(I2C_ASYNC_ERR_ARBLOST);
+            break;
+        }
+        
+        retries++;
+        seg = 0;
+        pos = 0;
+        TWI_CONTROL(CR_RUN | (1 << TWSTA));
+        break;
+    default:
+        xfer_finish(I2C_ASYNC_ERR_BUS);
+    }
+}
+
+int i2c_async_init(uint32_t speed)
+{
+    if ((speed == 0) || (speed > 400000)) {
+        error = I2C_ASYNC_ERR_INVAL;
+        return -1;
+    }
+    
+    /* Every driver init calls it, only the first one configures the TWI */
+    if (initialized)
+        return 0;
+    
+    q_head = 0;
+    q_cnt = 0;
+    running = 0;
+    stats.ias_xfers = 0;
+    stats.ias_failed = 0;
+    stats.ias_nacks = 0;
+    stats.ias_arb_lost = 0;
+    TWI_BITRATE(speed);
+    TWI_CONTROL(1 << TWEN);
+    initialized = 1;
+    return 0;
+}
+
+int i2c_async_submit(i2c_xfer_t *xfer)
+{
+    uint8_t sreg;
+    int i;
+    
+    if (!xfer) {
+        error = I2C_ASYNC_ERR_INVAL;
+        return -1;
+    }
+    
+    if ((xfer->ix_nseg < 1) || (xfer->ix_nseg > I2C_ASYNC_SEG_MAX)) {
+        error = I2C_ASYNC_ERR_INVAL;
+        return -1;
+    }
+    
+    if (xfer->ix_addr > 0x7F) {
+        error = I2C_ASYNC_ERR_INVAL;
+        return -1;
+    }
+    
+    if ((xfer->ix_state == I2C_XFER_QUEUED) || 
+        (xfer->ix_state == I2C_XFER_ACTIVE)) {
+        error = I2C_ASYNC_ERR_INVAL;
+        return -1;
+    }
+    
+    for (i = 0; i < xfer->ix_nseg; i++) {
+        if ((xfer->ix_seg[i].is_len > 0) && !xfer->ix_seg[i].is_buf) {
+            error = I2C_ASYNC_ERR_INVAL;
+            return -1;
+        }
+        
+        if ((xfer->ix_seg[i].is_type == I2C_SEG_READ) && 
+            (xfer->ix_seg[i].is_len < 1)) {
+            error = I2C_ASYNC_ERR_INVAL;
+            return -1;
+        }
+        
+        if (xfer->ix_seg[i].is_len < 0) {
+            error = I2C_ASYNC_ERR_INVAL;
+            return -1;
+        }
+    }
+    
+    LOCK(sreg);
+    
+    if (q_cnt == I2C_ASYNC_QUEUE_LEN) {
+        UNLOCK(sreg);
+        error = I2C_ASYNC_ERR_FULL;
+        return -1;
+    }
+    
+    xfer->ix_state = I2C_XFER_QUEUED;
+    xfer->ix_err = I2C_ASYNC_ERR_NOERR;
+    queue[(q_head + q_cnt) % I2C_ASYNC_QUEUE_LEN] = xfer;
+    q_cnt++;
+    
+    if (!running) {
+        running = 1;
+        xfer_start(CR_RUN);
+    }
+    
+    UNLOCK(sreg);
+    return 0;
+}
+
+int i2c_async_busy(void)
+{
+    return running;
+}
+
+/* Blocking wrapper, the transaction itself still runs in the ISR */
+int i2c_async_wait(i2c_xfer_t *xfer)
+{
+    if (!xfer) {
+        error = I2C_ASYNC_ERR_INVAL;
+        return -1;
+    }
+    
+    while ((xfer->ix_state == I2C_XFER_QUEUED) || 
+           (xfer->ix_state == I2C_XFER_ACTIVE)) {
+#ifdef I2C_SIM
+        i2c_sim_step();
+#endif
+    }
+    
+    if (xfer->ix_state != I2C_XFER_DONE) {
+        error = xfer->ix_err;
+        return -1;
+    }
+    
+    return 0;
+}
+
+i2c_async_stats_t i2c_async_get_stats(void)
+{
+    i2c_async_stats_t ret;
+    uint8_t sreg;
+    
+    LOCK(sreg);
+    ret = stats;
+    UNLOCK(sreg);
+    return ret;
+}
+
+int i2c_async_get_last_error(void)
+{
+    int err;
+    
+    err = error;
+    error = I2C_ASYNC_ERR_NOERR;
+    return err;
+}
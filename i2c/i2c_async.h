@@ -0,0 +1,110 @@
+/**
+ *
+ * File Name: i2c_async.h
+ * Title    : Interrupt driven I2C (TWI) master with transaction queue
+ * Project  : lib-avr
+ * Author   : Copyright (C) 2026 Johannes Krottmayer <krjdev@gmail.com>
+ * Created  : 2026-10-19
+ * Modified : 
+ * Revised  : 
+ * Version  : 0.1.0.0
+ * License  : ISC (see file LICENSE.txt)
+ * Target   : Atmel AVR Series
+ *
+ * NOTE: This code is currently below version 1.0, and therefore is considered
+ * to be lacking in some functionality or documentation, or may not be fully
+ * tested. Nonetheless, you can expect most functions to work.
+ *
+ */
+
+#ifndef LIBAVR_I2C_I2C_ASYNC_H
+#define LIBAVR_I2C_I2C_ASYNC_H
+
+#include <stdint.h>
+
+#ifndef I2C_SIM
+#include <avr/io.h>
+
+#define TWI_CONTROL(val)            (TWCR = (val))
+#define TWI_STOP_PENDING            (TWCR & (1 << TWSTO))
+#define TWI_STATUS                  (TWSR & 0xF8)
+#define TWI_DATA_WRITE(val)         (TWDR = (val))
+#define TWI_DATA_READ               TWDR
+#define TWI_BITRATE(speed)          (TWSR = 0, TWBR = (((F_CPU / (speed)) - 16) / 2))
+#else
+#include "i2c_sim.h"
+
+/* Host simulation, see i2c_sim.c */
+#define TWI_CONTROL(val)            i2c_sim_control(val)
+#define TWI_STOP_PENDING            i2c_sim_stop_pending()
+#define TWI_STATUS                  i2c_sim_status()
+#define TWI_DATA_WRITE(val)         i2c_sim_data_write(val)
+#define TWI_DATA_READ               i2c_sim_data_read()
+#define TWI_BITRATE(speed)          i2c_sim_set_speed(speed)
+#endif
+
+/* Queued transactions */
+#define I2C_ASYNC_QUEUE_LEN         8
+
+/* Segments of one transaction, a repeated start between them */
+#define I2C_ASYNC_SEG_MAX           3
+
+/* Restarts after an arbitration loss */
+#define I2C_ASYNC_RETRY             3
+
+#define I2C_SEG_WRITE               0
+#define I2C_SEG_READ                1
+
+/* Transaction states */
+#define I2C_XFER_IDLE               0
+#define I2C_XFER_QUEUED             1
+#define I2C_XFER_ACTIVE             2
+#define I2C_XFER_DONE               3
+#define I2C_XFER_FAILED             4
+
+/* I2C async Error codes */
+#define I2C_ASYNC_ERR_NOERR         0
+#define I2C_ASYNC_ERR_INVAL         1
+#define I2C_ASYNC_ERR_FULL          2
+#define I2C_ASYNC_ERR_NACK          3
+#define I2C_ASYNC_ERR_ARBLOST       4
+#define I2C_ASYNC_ERR_BUS           5
+
+typedef struct i2c_seg {
+    uint8_t is_type;
+    uint8_t *is_buf;
+    int is_len;         /* A write may be empty, e.g. ACK polling */
+} i2c_seg_t;
+
+struct i2c_xfer;
+
+/* Runs in the ISR */
+typedef void (*i2c_done_t)(struct i2c_xfer *xfer);
+
+/* Owned by the caller, untouched until the callback or a final state */
+typedef struct i2c_xfer {
+    uint8_t ix_addr;
+    uint8_t ix_nseg;
+    i2c_seg_t ix_seg[I2C_ASYNC_SEG_MAX];
+    i2c_done_t ix_done;
+    void *ix_arg;
+    volatile uint8_t ix_state;
+    uint8_t ix_err;
+} i2c_xfer_t;
+
+typedef struct i2c_async_stats {
+    uint32_t ias_xfers;
+    uint32_t ias_failed;
+    uint32_t ias_nacks;
+    uint32_t ias_arb_lost;
+} i2c_async_stats_t;
+
+extern int i2c_async_init(uint32_t speed);
+extern int i2c_async_submit(i2c_xfer_t *xfer);
+extern int i2c_async_busy(void);
+extern int i2c_async_wait(i2c_xfer_t *xfer);
+extern void i2c_async_isr(void);
+extern i2c_async_stats_t i2c_async_get_stats(void);
+extern int i2c_async_get_last_error(void);
+
+#endif
@@ -0,0 +1,377 @@
+/**
+ *
+ * File Name: i2c_sim.c
+ * Title    : I2C (TWI) bus simulator
+ * Project  : lib-avr
+ * Author   : Copyright (C) 2026 Johannes Krottmayer <krjdev@gmail.com>
+ * Created  : 2026-10-19
+ * Modified : 2026-10-19
+ * Revised  : 
+ * Version  : 0.2.0.0
+ * License  : ISC (see file LICENSE.txt)
+ * Target   : Linux (host)
+ *
+ * NOTE: This code is currently below version 1.0, and therefore is considered
+ * to be lacking in some functionality or documentation, or may not be fully
+ * tested. Nonetheless, you can expect most functions to work.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "i2c_sim.h"
+#include "i2c_async.h"
+
+/* TWI status codes, master mode */
+#define ST_START            0x08
+#define ST_REP_START        0x10
+#define ST_SLAW_ACK         0x18
+#define ST_SLAW_NACK        0x20
+#define ST_DATA_TX_ACK      0x28
+#define ST_ARB_LOST         0x38
+#define ST_SLAR_ACK         0x40
+#define ST_SLAR_NACK        0x48
+#define ST_DATA_RX_ACK      0x50
+#define ST_DATA_RX_NACK     0x58
+#define ST_NONE             0xF8
+
+typedef struct sim_dev {
+    uint8_t sd_used;
+    uint8_t sd_addr;
+    uint8_t sd_mem[I2C_SIM_MEM_LEN];
+    uint32_t sd_wear[I2C_SIM_MEM_LEN];  /* Writes per byte */
+    int sd_len;
+    int sd_ptr_len;
+    int sd_ptr_cnt;         /* Pointer bytes received in this write */
+    uint16_t sd_ptr;
+    int sd_busy;            /* Address phases still NACKed */
+    int sd_page;            /* EEPROM: writes wrap inside a page */
+    uint64_t sd_twr;        /* EEPROM: write cycle after STOP */
+    uint64_t sd_busy_until;
+    uint8_t sd_written;
+} sim_dev_t;
+
+static sim_dev_t devs[I2C_SIM_DEV_MAX];
+static sim_dev_t *sel = NULL;
+static uint8_t status = ST_NONE;
+static uint8_t data = 0;
+static int owner = 0;
+static int pending = 0;
+static int stopping = 0;
+static int arb_lose = 0;
+static uint32_t bit_ns = 10000;
+static uint64_t now = 0;
+
+static sim_dev_t *dev_find(uint8_t addr)
+{
+    int i;
+    
+    for (i = 0; i < I2C_SIM_DEV_MAX; i++) {
+        if (devs[i].sd_used && (devs[i].sd_addr == addr))
+            return &devs[i];
+    }
+    
+    return NULL;
+}
+
+static void addr_phase(void)
+{
+    now += 9 * bit_ns;
+    
+    if (arb_lose) {
+        arb_lose--;
+        owner = 0;
+        status = ST_ARB_LOST;
+        return;
+    }
+    
+    sel = dev_find(data >> 1);
+    
+    if (sel && sel->sd_busy) {
+        sel->sd_busy--;
+        sel = NULL;
+    }
+    
+    if (sel && (now < sel->sd_busy_until))
+        sel = NULL;
+    
+    if (!sel) {
+        status = (data & 0x01) ? ST_SLAR_NACK : ST_SLAW_NACK;
+        return;
+    }
+    
+    sel->sd_ptr_cnt = 0;
+    sel->sd_written = 0;
+    status = (data & 0x01) ? ST_SLAR_ACK : ST_SLAW_ACK;
+}
+
+/* Pointer bytes MSB first, then data with auto increment */
+static void write_phase(void)
+{
+    now += 9 * bit_ns;
+    
+    if (sel->sd_ptr_cnt < sel->sd_ptr_len) {
+        if (sel->sd_ptr_cnt == 0)
+            sel->sd_ptr = 0;
+        
+        sel->sd_ptr = (sel->sd_ptr << 8) | data;
+        sel->sd_ptr %= sel->sd_len;
+        sel->sd_ptr_cnt++;
+    } else {
+        sel->sd_mem[sel->sd_ptr] = data;
+        sel->sd_wear[sel->sd_ptr]++;
+        sel->sd_written = 1;
+        
+        if (sel->sd_page)
+            sel->sd_ptr = (sel->sd_ptr - (sel->sd_ptr % sel->sd_page)) + 
+                          ((sel->sd_ptr + 1) % sel->sd_page);
+        else
+            sel->sd_ptr = (sel->sd_ptr + 1) % sel->sd_len;
+    }
+    
+    status = ST_DATA_TX_ACK;
+}
+
+static void read_phase(int ack)
+{
+    now += 9 * bit_ns;
+    data = sel->sd_mem[sel->sd_ptr];
+    sel->sd_ptr = (sel->sd_ptr + 1) % sel->sd_len;
+    status = ack ? ST_DATA_RX_ACK : ST_DATA_RX_NACK;
+}
+
+void i2c_sim_init(void)
+{
+    memset(devs, 0, sizeof(devs));
+    sel = NULL;
+    status = ST_NONE;
+    data = 0;
+    owner = 0;
+    pending = 0;
+    stopping = 0;
+    arb_lose = 0;
+    now = 0;
+}
+
+int i2c_sim_add(uint8_t addr, uint8_t *mem, int len, int ptr_len)
+{
+    int i;
+    
+    if ((len < 1) || (len > I2C_SIM_MEM_LEN))
+        return -1;
+    
+    if ((ptr_len < 0) || (ptr_len > 2))
+        return -1;
+    
+    if (dev_find(addr))
+        return -1;
+    
+    for (i = 0; i < I2C_SIM_DEV_MAX; i++) {
+        if (devs[i].sd_used)
+            continue;
+        
+        memset(&devs[i], 0, sizeof(sim_dev_t));
+        devs[i].sd_addr = addr;
+        devs[i].sd_len = len;
+        devs[i].sd_ptr_len = ptr_len;
+        
+        if (mem)
+            memcpy(devs[i].sd_mem, mem, len);
+        
+        devs[i].sd_used = 1;
+        return i;
+    }
+    
+    return -1;
+}
+
+int i2c_sim_remove(uint8_t addr)
+{
+    sim_dev_t *dev;
+    
+    dev = dev_find(addr);
+    
+    if (!dev)
+        return -1;
+    
+    if (dev == sel)
+        sel = NULL;
+    
+    dev->sd_used = 0;
+    return 0;
+}
+
+/* Register file of a device, for tests to inspect or change */
+uint8_t *i2c_sim_get_mem(uint8_t addr)
+{
+    sim_dev_t *dev;
+    
+    dev = dev_find(addr);
+    
+    if (!dev)
+        return NULL;
+    
+    return dev->sd_mem;
+}
+
+/* Bytes written to one location since the device was added */
+uint32_t i2c_sim_get_wear(uint8_t addr, int off)
+{
+    sim_dev_t *dev;
+    
+    dev = dev_find(addr);
+    
+    if (!dev || (off < 0) || (off >= dev->sd_len))
+        return 0;
+    
+    return dev->sd_wear[off];
+}
+
+/* NACK the next address phases, like an EEPROM in its write cycle */
+int i2c_sim_set_busy(uint8_t addr, int num)
+{
+    sim_dev_t *dev;
+    
+    dev = dev_find(addr);
+    
+    if (!dev)
+        return -1;
+    
+    dev->sd_busy = num;
+    return 0;
+}
+
+/* Page wrap and a write cycle of twr microseconds started by STOP */
+int i2c_sim_set_eeprom(uint8_t addr, int page, uint32_t twr)
+{
+    sim_dev_t *dev;
+    
+    dev = dev_find(addr);
+    
+    if (!dev)
+        return -1;
+    
+    if ((page < 0) || (page > dev->sd_len))
+        return -1;
+    
+    dev->sd_page = page;
+    dev->sd_twr = (uint64_t) twr * 1000;
+    return 0;
+}
+
+/* Another master wins the next address phases */
+void i2c_sim_lose_arb(int num)
+{
+    arb_lose = num;
+}
+
+void i2c_sim_set_speed(uint32_t speed)
+{
+    if (speed)
+        bit_ns = 1000000000UL / speed;
+}
+
+void i2c_sim_control(uint8_t val)
+{
+    if (!(val & (1 << TWINT)))
+        return;
+    
+    pending = 0;
+    
+    /* The TWI ignores a START while its STOP is still on the bus */
+    if (stopping && (val & (1 << TWSTA)) && !(val & (1 << TWSTO))) {
+        stopping = 0;
+        status = ST_NONE;
+        pending = 1;
+        return;
+    }
+    
+    if (val & (1 << TWSTO)) {
+        if (owner)
+            now += bit_ns;
+        
+        if (sel && sel->sd_written)
+            sel->sd_busy_until = now + sel->sd_twr;
+        
+        owner = 0;
+        sel = NULL;
+        status = ST_NONE;
+        stopping = !(val & (1 << TWSTA));
+    }
+    
+    if (val & (1 << TWSTA)) {
+        if (sel)
+            sel->sd_written = 0;
+        
+        now += bit_ns;
+        status = owner ? ST_REP_START : ST_START;
+        owner = 1;
+        sel = NULL;
+        pending = 1;
+        return;
+    }
+    
+    if (!owner)
+        return;
+    
+    switch (status) {
+    case ST_START:
+    case ST_REP_START:
+        addr_phase();
+        break;
+    case ST_SLAW_ACK:
+    case ST_DATA_TX_ACK:
+        write_phase();
+        break;
+    case ST_SLAR_ACK:
+    case ST_DATA_RX_ACK:
+        read_phase(val & (1 << TWEA));
+        break;
+    default:
+        return;
+    }
+    
+    pending = 1;
+}
+
+/* TWSTO reads back set until the first poll after a STOP */
+int i2c_sim_stop_pending(void)
+{
+    int ret;
+    
+    ret = stopping;
+    stopping = 0;
+    return ret;
+}
+
+uint8_t i2c_sim_status(void)
+{
+    return status;
+}
+
+void i2c_sim_data_write(uint8_t val)
+{
+    data = val;
+}
+
+uint8_t i2c_sim_data_read(void)
+{
+    return data;
+}
+
+/* Runs the ISR if the TWI has raised TWINT */
+void i2c_sim_step(void)
+{
+    if (!pending)
+        return;
+    
+    pending = 0;
+    i2c_async_isr();
+}
+
+/* Microseconds */
+uint32_t i2c_sim_get_time(void)
+{
+    return (uint32_t) (now / 1000);
+}
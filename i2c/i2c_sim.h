@@ -0,0 +1,57 @@
+/**
+ *
+ * File Name: i2c_sim.h
+ * Title    : I2C (TWI) bus simulator
+ * Project  : lib-avr
+ * Author   : Copyright (C) 2026 Johannes Krottmayer <krjdev@gmail.com>
+ * Created  : 2026-10-19
+ * Modified : 2026-10-19
+ * Revised  : 
+ * Version  : 0.2.0.0
+ * License  : ISC (see file LICENSE.txt)
+ * Target   : Linux (host)
+ *
+ * NOTE: This code is currently below version 1.0, and therefore is considered
+ * to be lacking in some functionality or documentation, or may not be fully
+ * tested. Nonetheless, you can expect most functions to work.
+ *
+ */
+
+#ifndef LIBAVR_I2C_I2C_SIM_H
+#define LIBAVR_I2C_I2C_SIM_H
+
+#include <stdint.h>
+
+#define I2C_SIM_DEV_MAX             8
+#define I2C_SIM_MEM_LEN             8192
+
+/* TWCR bits, same as the ATmega */
+#define TWINT                       7
+#define TWEA                        6
+#define TWSTA                       5
+#define TWSTO                       4
+#define TWWC                        3
+#define TWEN                        2
+#define TWIE                        0
+
+/* Simulated devices, a register file behind a 0, 1 or 2 byte address pointer */
+extern void i2c_sim_init(void);
+extern int i2c_sim_add(uint8_t addr, uint8_t *mem, int len, int ptr_len);
+extern int i2c_sim_remove(uint8_t addr);
+extern uint8_t *i2c_sim_get_mem(uint8_t addr);
+extern uint32_t i2c_sim_get_wear(uint8_t addr, int off);
+extern int i2c_sim_set_busy(uint8_t addr, int num);
+extern int i2c_sim_set_eeprom(uint8_t addr, int page, uint32_t twr);
+extern void i2c_sim_lose_arb(int num);
+
+/* Hooks of i2c_async, built with -DI2C_SIM */
+extern void i2c_sim_set_speed(uint32_t speed);
+extern void i2c_sim_control(uint8_t val);
+extern int i2c_sim_stop_pending(void);
+extern uint8_t i2c_sim_status(void);
+extern void i2c_sim_data_write(uint8_t val);
+extern uint8_t i2c_sim_data_read(void);
+extern void i2c_sim_step(void);
+extern uint32_t i2c_sim_get_time(void);
+
+#endif
@@ -5,9 +5,9 @@
  * Project  : lib-avr
  * Author   : Copyright (C) 2018-2019 Johannes Krottmayer <krjdev@gmail.com>
  * Created  : 2018-12-04
- * Modified : 2019-04-04
+ * Modified : 2026-10-19
  * Revised  : 
- * Version  : 0.1.1.0
+ * Version  : 0.2.0.0
  * License  : ISC (see file LICENSE.txt)
  * Target   : Atmel AVR Series
  *
@@ -18,8 +18,9 @@
  */
 
 #include <stdlib.h>
+#include <string.h>
 
-#include "i2c.h"
+#include "i2c_async.h"
 #include "m24cxx.h"
 
 #define M24CXX_ADDR            0x50
@@ -30,113 +31,197 @@
 #define M24C01_16_PAGE_SIZE    16
 #define M24C32_64_PAGE_SIZE    32
 
-#define M24C01_SIZE             16
-#define M24C02_SIZE             32
-#define M24C04_SIZE             64
-#define M24C08_SIZE             128
-#define M24C16_SIZE             256
-#define M24C32_SIZE             512
-#define M24C64_SIZE             1024
+#define M24C01_SIZE             128
+#define M24C02_SIZE             256
+#define M24C04_SIZE             512
+#define M24C08_SIZE             1024
+#define M24C16_SIZE             2048
+#define M24C32_SIZE             4096
+#define M24C64_SIZE             8192
 
 #define _HIGH(u16)              ((uint8_t) (((u16) & 0xFF00) >> 8))
 #define _LOW(u16)               ((uint8_t) ((u16) & 0x00FF))
 
-void mc24cxx_init(void)
+static int get_geometry(int type, int *subtype, int *size, int *page)
 {
-    i2c_master_init(100000);
-}
-
-int m24cxx_write(int type, uint8_t subaddr, uint16_t addr, uint8_t *buf, int len)
-{
-    uint8_t i2c_addr;
-    int subtype;
-    int size;
-    int ret;
-    int i;
-    uint8_t addr_buf[2];
-    
-    i2c_addr = M24CXX_ADDR | subaddr;
-    
-    if (!buf)
-        return -1;
-    
-    if (len < 1)
-        return -1;
-    
     switch (type) {
     case TYPE_M24C01:
-        subtype = M24C01_16_SUBTYPE;
-        size = M24C01_SIZE;
+        (*size) = M24C01_SIZE;
         break;
     case TYPE_M24C02:
-        subtype = M24C01_16_SUBTYPE;
-        size = M24C02_SIZE;
+        (*size) = M24C02_SIZE;
         break;
     case TYPE_M24C04:
-        subtype = M24C01_16_SUBTYPE;
-        size = M24C04_SIZE;
+        (*size) = M24C04_SIZE;
         break;
     case TYPE_M24C08:
-        subtype = M24C01_16_SUBTYPE;
-        size = M24C08_SIZE;
+        (*size) = M24C08_SIZE;
         break;
     case TYPE_M24C16:
-        subtype = M24C01_16_SUBTYPE;
-        size = M24C01_SIZE;
+        (*size) = M24C16_SIZE;
         break;
     case TYPE_M24C32:
-        subtype = M24C32_64_SUBTYPE;
-        size = M24C32_SIZE;
+        (*size) = M24C32_SIZE;
         break;
     case TYPE_M24C64:
-        subtype = M24C32_64_SUBTYPE;
-        size = M24C64_SIZE;
+        (*size) = M24C64_SIZE;
         break;
     default:
         return -1;
     }
     
+    if (type < TYPE_M24C32) {
+        (*subtype) = M24C01_16_SUBTYPE;
+        (*page) = M24C01_16_PAGE_SIZE;
+    } else {
+        (*subtype) = M24C32_64_SUBTYPE;
+        (*page) = M24C32_64_PAGE_SIZE;
+    }
+    
+    return 0;
+}
+
+/* M24C04 - M24C16 take the upper address bits in the device address */
+static int set_addr(int subtype, uint8_t subaddr, uint16_t addr, uint8_t *buf, uint8_t *i2c_addr)
+{
+    if (subtype == M24C01_16_SUBTYPE) {
+        (*i2c_addr) = M24CXX_ADDR | subaddr | _HIGH(addr);
+        buf[0] = _LOW(addr);
+        return 1;
+    }
+    
+    (*i2c_addr) = M24CXX_ADDR | subaddr;
+    buf[0] = _HIGH(addr);
+    buf[1] = _LOW(addr);
+    return 2;
+}
+
+/* The device does not answer until its write cycle (tWR) is finished */
+static int ack_poll(uint8_t i2c_addr)
+{
+    i2c_xfer_t xfer;
+    int i;
+    
+    memset(&xfer, 0, sizeof(i2c_xfer_t));
+    xfer.ix_addr = i2c_addr;
+    xfer.ix_nseg = 1;
+    xfer.ix_seg[0].is_type = I2C_SEG_WRITE;
+    
+    for (i = 0; i < M24CXX_POLL_MAX; i++) {
+        if (i2c_async_submit(&xfer) == -1)
+            return -1;
+        
+        if (i2c_async_wait(&xfer) == 0)
+            return 0;
+        
+        if (xfer.ix_err != I2C_ASYNC_ERR_NACK)
+            return -1;
+    }
+    
+    return -1;
+}
+
+void m24cxx_init(void)
+{
+    i2c_async_init(100000);
+}
+
+int m24cxx_get_size(int type)
+{
+    int subtype;
+    int size;
+    int page;
+    
+    if (get_geometry(type, &subtype, &size, &page) == -1)
+        return -1;
+    
+    return size;
+}
+
+int m24cxx_get_page_size(int type)
+{
+    int subtype;
+    int size;
+    int page;
+    
+    if (get_geometry(type, &subtype, &size, &page) == -1)
+        return -1;
+    
+    return page;
+}
+
+/* Split at page boundaries, the device would wrap inside a page */
+int m24cxx_write(int type, uint8_t subaddr, uint16_t addr, uint8_t *buf, int len)
+{
+    uint8_t page_buf[2 + M24C32_64_PAGE_SIZE];
+    uint8_t i2c_addr;
+    i2c_xfer_t xfer;
+    int subtype;
+    int size;
+    int page;
+    int alen;
+    int cnt;
+    
+    if (!buf)
+        return -1;
+    
+    if (len < 1)
+        return -1;
+    
+    if (subaddr > 0x07)
+        return -1;
+    
+    if (get_geometry(type, &subtype, &size, &page) == -1)
+        return -1;
+    
     if (addr > (size - 1))
         return -1;
     
     if ((addr + len) > size)
         return -1;
     
-    if (subtype == M24C01_16_SUBTYPE) {
-        addr_buf[0] = _LOW(addr);
-        ret = i2c_master_send(I2C_OPT_NOSTOP, i2c_addr, addr_buf, 1, NULL, 0);
+    memset(&xfer, 0, sizeof(i2c_xfer_t));
+    xfer.ix_nseg = 1;
+    xfer.ix_seg[0].is_type = I2C_SEG_WRITE;
+    xfer.ix_seg[0].is_buf = page_buf;
+    
+    while (len > 0) {
+        cnt = page - (addr % page);
+        
+        if (cnt > len)
+            cnt = len;
         
-        if (ret == -1)
+        alen = set_addr(subtype, subaddr, addr, page_buf, &i2c_addr);
+        memcpy(&page_buf[alen], buf, cnt);
+        xfer.ix_addr = i2c_addr;
+        xfer.ix_seg[0].is_len = alen + cnt;
+        
+        if (i2c_async_submit(&xfer) == -1)
             return -1;
-    } else {
-        addr_buf[0] = _HIGH(addr);
-        addr_buf[1] = _LOW(addr);
-        ret = i2c_master_send(I2C_OPT_NOSTOP, i2c_addr, addr_buf, 2, NULL, 0);
         
-        if (ret == -1)
+        if (i2c_async_wait(&xfer) == -1)
             return -1;
-    }
-    
-    for (i = 0; i < len; i++) {
-        ret = i2c_master_send(I2C_OPT_NORMAL, i2c_addr, NULL, 0, &buf[i], len);
         
-        if (ret == -1)
+        if (ack_poll(i2c_addr) == -1)
             return -1;
+        
+        addr += cnt;
+        buf += cnt;
+        len -= cnt;
     }
     
     return 0;
 }
 
+/* Random address read, the address counter runs over the whole array */
 int m24cxx_read(int type, uint8_t subaddr, uint16_t addr, uint8_t *buf, int len)
 {
+    uint8_t addr_buf[2];
     uint8_t i2c_addr;
+    i2c_xfer_t xfer;
     int subtype;
     int size;
-    int i;
-    int ret;
-    uint8_t addr_buf[2];
-    
-    i2c_addr = M24CXX_ADDR | subaddr;
+    int page;
     
     if (!buf)
         return -1;
@@ -144,38 +229,11 @@ int m24cxx_read(int type, uint8_t subaddr, uint16_t addr, uint8_t *buf, int len)
     if (len < 1)
         return -1;
     
-    switch (type) {
-    case TYPE_M24C01:
-        subtype = M24C01_16_SUBTYPE;
-        size = M24C01_SIZE;
-        break;
-    case TYPE_M24C02:
-        subtype = M24C01_16_SUBTYPE;
-        size = M24C02_SIZE;
-        break;
-    case TYPE_M24C04:
-        subtype = M24C01_16_SUBTYPE;
-        size = M24C04_SIZE;
-        break;
-    case TYPE_M24C08:
-        subtype = M24C01_16_SUBTYPE;
-        size = M24C08_SIZE;
-        break;
-    case TYPE_M24C16:
-        subtype = M24C01_16_SUBTYPE;
-        size = M24C01_SIZE;
-        break;
-    case TYPE_M24C32:
-        subtype = M24C32_64_SUBTYPE;
-        size = M24C32_SIZE;
-        break;
-    case TYPE_M24C64:
-        subtype = M24C32_64_SUBTYPE;
-        size = M24C64_SIZE;
-        break;
-    default:
+    if (subaddr > 0x07)
+        return -1;
+    
+    if (get_geometry(type, &subtype, &size, &page) == -1)
         return -1;
-    }
     
     if (addr > (size - 1))
         return -1;
@@ -183,27 +241,18 @@ int m24cxx_read(int type, uint8_t subaddr, uint16_t addr, uint8_t *buf, int len)
     if ((addr + len) > size)
         return -1;
     
-    if (subtype == M24C01_16_SUBTYPE) {
-        addr_buf[0] = _LOW(addr);
-        ret = i2c_master_send(I2C_OPT_NOSTOP, i2c_addr, addr_buf, 1, NULL, 0);
-        
-        if (ret == -1)
-            return -1;
-    } else {
-        addr_buf[0] = _HIGH(addr);
-        addr_buf[1] = _LOW(addr);
-        ret = i2c_master_send(I2C_OPT_NOSTOP, i2c_addr, addr_buf, 2, NULL, 0);
-        
-        if (ret == -1)
-            return -1;
-    }
+    memset(&xfer, 0, sizeof(i2c_xfer_t));
+    xfer.ix_seg[0].is_type = I2C_SEG_WRITE;
+    xfer.ix_seg[0].is_buf = addr_buf;
+    xfer.ix_seg[0].is_len = set_addr(subtype, subaddr, addr, addr_buf, &i2c_addr);
+    xfer.ix_seg[1].is_type = I2C_SEG_READ;
+    xfer.ix_seg[1].is_buf = buf;
+    xfer.ix_seg[1].is_len = len;
+    xfer.ix_addr = i2c_addr;
+    xfer.ix_nseg = 2;
     
-    for (i = 0; i < len; i++) {
-        ret = i2c_master_recv(I2C_OPT_NORMAL, i2c_addr, NULL, 0, &buf[i], len);
-        
-        if (ret == -1)
-            return -1;
-    }
+    if (i2c_async_submit(&xfer) == -1)
+        return -1;
     
-    return 0;
+    return i2c_async_wait(&xfer);
 }
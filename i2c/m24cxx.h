@@ -5,9 +5,9 @@
  * Project  : lib-avr
  * Author   : Copyright (C) 2018-2019 Johannes Krottmayer <krjdev@gmail.com>
  * Created  : 2018-12-04
- * Modified : 2019-04-04
+ * Modified : 2026-10-19
  * Revised  : 
- * Version  : 0.1.1.0
+ * Version  : 0.2.0.0
  * License  : ISC (see file LICENSE.txt)
  * Target   : Atmel AVR Series
  *
@@ -30,8 +30,13 @@
 #define TYPE_M24C32         5
 #define TYPE_M24C64         6
 
+/* ACK polls after a page write, about 110 us each at 100 kHz (tWR max 5 ms) */
+#define M24CXX_POLL_MAX     100
+
 extern void m24cxx_init(void);
 extern int m24cxx_write(int type, uint8_t subaddr, uint16_t addr, uint8_t *buf, int len);
 extern int m24cxx_read(int type, uint8_t subaddr, uint16_t addr, uint8_t *buf, int len);
+extern int m24cxx_get_size(int type);
+extern int m24cxx_get_page_size(int type);
 
 #endif
@@ -0,0 +1,439 @@
+/**
+ *
+ * File Name: m24cxx_kv.c
+ * Title    : Wear leveled key/value store on M24Cxx I2C EEPROM source
+ * Project  : lib-avr
+ * Author   : Copyright (C) 2026 Johannes Krottmayer <krjdev@gmail.com>
+ * Created  : 2026-10-19
+ * Modified : 
+ * Revised  : 
+ * Version  : 0.1.0.0
+ * License  : ISC (see file LICENSE.txt)
+ * Target   : Atmel AVR Series
+ *
+ * NOTE: This code is currently below version 1.0, and therefore is considered
+ * to be lacking in some functionality or documentation, or may not be fully
+ * tested. Nonetheless, you can expect most functions to work.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "../lib/crc16_ccitt.h"
+#include "m24cxx_kv.h"
+
+/* Sector header: magic (2), sequence (2, LE), CRC-16 (2, BE) */
+#define HDR_MAGIC0              0x4B
+#define HDR_MAGIC1              0x56
+#define HDR_LEN                 6
+
+/* Record: key, length, value, CRC-16 (2, BE), length 0 deletes the key */
+#define REC_OVH                 4
+
+#define SEQ_NEWER(a, b)         ((int16_t) ((a) - (b)) > 0)
+
+typedef struct kv_ent {
+    uint8_t ke_key;
+    uint8_t ke_len;
+    uint8_t ke_val[M24CXX_KV_VAL_MAX];
+} kv_ent_t;
+
+static int error = M24CXX_KV_ERR_NOERR;
+static kv_ent_t ents[M24CXX_KV_KEY_MAX];
+static int ent_num = 0;
+static int kv_type;
+static uint8_t kv_subaddr;
+static uint16_t kv_addr;
+static int kv_sectors = 0;
+static int active = -1;
+static uint16_t seq;
+static int used;
+static m24cxx_kv_stats_t stats;
+
+static uint16_t sector_addr(int sector)
+{
+    return kv_addr + ((uint16_t) sector * M24CXX_KV_SECTOR);
+}
+
+/* The sequence is part of the record CRC, old records of a sector fail */
+static uint16_t rec_crc(uint16_t rseq, uint8_t *rec)
+{
+    uint8_t buf[2 + REC_OVH + M24CXX_KV_VAL_MAX];
+    
+    buf[0] = (uint8_t) (rseq & 0xFF);
+    buf[1] = (uint8_t) (rseq >> 8);
+    memcpy(&buf[2], rec, (2 + rec[1]));
+    return crc16_ccitt_calc(buf, (4 + rec[1]));
+}
+
+static int write_record(int sector, int off, uint16_t rseq, uint8_t key, uint8_t *val, int len)
+{
+    uint8_t rec[REC_OVH + M24CXX_KV_VAL_MAX];
+    uint16_t crc;
+    
+    rec[0] = key;
+    rec[1] = (uint8_t) len;
+    
+    if (len > 0)
+        memcpy(&rec[2], val, len);
+    
+    crc = rec_crc(rseq, rec);
+    rec[2 + len] = (uint8_t) (crc >> 8);
+    rec[3 + len] = (uint8_t) (crc & 0xFF);
+    
+    if (m24cxx_write(kv_type, kv_subaddr, (sector_addr(sector) + off), rec, (REC_OVH + len)) == -1) {
+        error = M24CXX_KV_ERR_IO;
+        return -1;
+    }
+    
+    stats.kvs_appends++;
+    return 0;
+}
+
+static int write_header(int sector, uint16_t hseq)
+{
+    uint8_t hdr[HDR_LEN];
+    uint16_t crc;
+    
+    hdr[0] = HDR_MAGIC0;
+    hdr[1] = HDR_MAGIC1;
+    hdr[2] = (uint8_t) (hseq & 0xFF);
+    hdr[3] = (uint8_t) (hseq >> 8);
+    crc = crc16_ccitt_calc(hdr, 4);
+    hdr[4] = (uint8_t) (crc >> 8);
+    hdr[5] = (uint8_t) (crc & 0xFF);
+    
+    if (m24cxx_write(kv_type, kv_subaddr, sector_addr(sector), hdr, HDR_LEN) == -1) {
+        error = M24CXX_KV_ERR_IO;
+        return -1;
+    }
+    
+    return 0;
+}
+
+static int parse_header(uint8_t *hdr, uint16_t *hseq)
+{
+    if ((hdr[0] != HDR_MAGIC0) || (hdr[1] != HDR_MAGIC1))
+        return -1;
+    
+    if (!crc16_ccitt_check(hdr, 4, (((uint16_t) hdr[4] << 8) | hdr[5])))
+        return -1;
+    
+    (*hseq) = hdr[2] | ((uint16_t) hdr[3] << 8);
+    return 0;
+}
+
+static kv_ent_t *ent_find(uint8_t key)
+{
+    int i;
+    
+    for (i = 0; i < ent_num; i++) {
+        if (ents[i].ke_key == key)
+            return &ents[i];
+    }
+    
+    return NULL;
+}
+
+static void ent_remove(kv_ent_t *ent)
+{
+    ent_num--;
+    
+    if (ent != &ents[ent_num])
+        memcpy(ent, &ents[ent_num], sizeof(kv_ent_t));
+}
+
+static int ent_put(uint8_t key, uint8_t *val, int len)
+{
+    kv_ent_t *ent;
+    
+    ent = ent_find(key);
+    
+    if (!ent) {
+        if (ent_num == M24CXX_KV_KEY_MAX)
+            return -1;
+        
+        ent = &ents[ent_num];
+        ent_num++;
+    }
+    
+    ent->ke_key = key;
+    ent->ke_len = (uint8_t) len;
+    memcpy(ent->ke_val, val, len);
+    return 0;
+}
+
+/* Whole sector in one sequential read, the log ends at the first bad record */
+static int load(void)
+{
+    uint8_t buf[M24CXX_KV_SECTOR];
+    kv_ent_t *ent;
+    int off;
+    int len;
+    
+    if (m24cxx_read(kv_type, kv_subaddr, sector_addr(active), buf, M24CXX_KV_SECTOR) == -1) {
+        error = M24CXX_KV_ERR_IO;
+        return -1;
+    }
+    
+    ent_num = 0;
+    off = HDR_LEN;
+    
+    while ((off + REC_OVH) <= M24CXX_KV_SECTOR) {
+        if (buf[off] == M24CXX_KV_KEY_NONE)
+            break;
+        
+        len = buf[off + 1];
+        
+        if ((len > M24CXX_KV_VAL_MAX) || ((off + REC_OVH + len) > M24CXX_KV_SECTOR))
+            break;
+        
+        if (rec_crc(seq, &buf[off]) != (((uint16_t) buf[off + 2 + len] << 8) | buf[off + 3 + len]))
+            break;
+        
+        if (len == 0) {
+            ent = ent_find(buf[off]);
+            
+            if (ent)
+                ent_remove(ent);
+        } else
+            ent_put(buf[off], &buf[off + 2], len);
+        
+        off += REC_OVH + len;
+    }
+    
+    used = off;
+    return 0;
+}
+
+/* Live keys into the next sector, its header last so a power fail keeps the old one */
+static int compact(void)
+{
+    uint16_t nseq;
+    int next;
+    int off;
+    int i;
+    
+    next = (active + 1) % kv_sectors;
+    nseq = seq + 1;
+    off = HDR_LEN;
+    
+    for (i = 0; i < ent_num; i++) {
+        if ((off + REC_OVH + ents[i].ke_len) > M24CXX_KV_SECTOR) {
+            error = M24CXX_KV_ERR_FULL;
+            return -1;
+        }
+        
+        if (write_record(next, off, nseq, ents[i].ke_key, ents[i].ke_val, ents[i].ke_len) == -1)
+            return -1;
+        
+        off += REC_OVH + ents[i].ke_len;
+    }
+    
+    if (write_header(next, nseq) == -1)
+        return -1;
+    
+    active = next;
+    seq = nseq;
+    used = off;
+    stats.kvs_compactions++;
+    return 0;
+}
+
+/* RAM index is already updated, the record goes to the log or a new sector */
+static int append(uint8_t key, uint8_t *val, int len)
+{
+    if ((used + REC_OVH + len) > M24CXX_KV_SECTOR)
+        return compact();
+    
+    if (write_record(active, used, seq, key, val, len) == -1)
+        return -1;
+    
+    used += REC_OVH + len;
+    return 0;
+}
+
+int m24cxx_kv_init(int type, uint8_t subaddr, uint16_t addr, int sectors)
+{
+    uint8_t hdr[HDR_LEN];
+    uint16_t hseq;
+    int size;
+    int page;
+    int i;
+    
+    size = m24cxx_get_size(type);
+    page = m24cxx_get_page_size(type);
+    
+    if ((size == -1) || (sectors < 2)) {
+        error = M24CXX_KV_ERR_INVAL;
+        return -1;
+    }
+    
+    if ((addr % page) || (((uint32_t) addr + ((uint32_t) sectors * M24CXX_KV_SECTOR)) > (uint32_t) size)) {
+        error = M24CXX_KV_ERR_INVAL;
+        return -1;
+    }
+    
+    kv_type = type;
+    kv_subaddr = subaddr;
+    kv_addr = addr;
+    kv_sectors = sectors;
+    active = -1;
+    ent_num = 0;
+    memset(&stats, 0, sizeof(m24cxx_kv_stats_t));
+    
+    for (i = 0; i < sectors; i++) {
+        if (m24cxx_read(type, subaddr, sector_addr(i), hdr, HDR_LEN) == -1) {
+            error = M24CXX_KV_ERR_IO;
+            return -1;
+        }
+        
+        if (parse_header(hdr, &hseq) == -1)
+            continue;
+        
+        if ((active == -1) || SEQ_NEWER(hseq, seq)) {
+            active = i;
+            seq = hseq;
+        }
+    }
+    
+    /* Blank device */
+    if (active == -1) {
+        active = sectors - 1;
+        seq = 0;
+        return m24cxx_kv_format();
+    }
+    
+    if (load() == -1)
+        return -1;
+    
+    return ent_num;
+}
+
+int m24cxx_kv_get(uint8_t key, uint8_t *buf, int len)
+{
+    kv_ent_t *ent;
+    
+    if (!buf) {
+        error = M24CXX_KV_ERR_INVAL;
+        return -1;
+    }
+    
+    ent = ent_find(key);
+    
+    if (!ent) {
+        error = M24CXX_KV_ERR_NOKEY;
+        return -1;
+    }
+    
+    if (len < ent->ke_len) {
+        error = M24CXX_KV_ERR_INVAL;
+        return -1;
+    }
+    
+    memcpy(buf, ent->ke_val, ent->ke_len);
+    return ent->ke_len;
+}
+
+int m24cxx_kv_set(uint8_t key, uint8_t *buf, int len)
+{
+    kv_ent_t *ent;
+    kv_ent_t old;
+    int found;
+    
+    if (!kv_sectors || !buf || (key == M24CXX_KV_KEY_NONE)) {
+        error = M24CXX_KV_ERR_INVAL;
+        return -1;
+    }
+    
+    if ((len < 1) || (len > M24CXX_KV_VAL_MAX)) {
+        error = M24CXX_KV_ERR_INVAL;
+        return -1;
+    }
+    
+    ent = ent_find(key);
+    found = 0;
+    
+    if (ent) {
+        if ((ent->ke_len == len) && !memcmp(ent->ke_val, buf, len)) {
+            stats.kvs_skipped++;
+            return 0;
+        }
+        
+        memcpy(&old, ent, sizeof(kv_ent_t));
+        found = 1;
+    }
+    
+    if (ent_put(key, buf, len) == -1) {
+        error = M24CXX_KV_ERR_FULL;
+        return -1;
+    }
+    
+    if (append(key, buf, len) == -1) {
+        if (found)
+            ent_put(old.ke_key, old.ke_val, old.ke_len);
+        else
+            ent_remove(ent_find(key));
+        
+        return -1;
+    }
+    
+    return 0;
+}
+
+int m24cxx_kv_del(uint8_t key)
+{
+    kv_ent_t *ent;
+    kv_ent_t old;
+    
+    if (!kv_sectors) {
+        error = M24CXX_KV_ERR_INVAL;
+        return -1;
+    }
+    
+    ent = ent_find(key);
+    
+    if (!ent) {
+        error = M24CXX_KV_ERR_NOKEY;
+        return -1;
+    }
+    
+    memcpy(&old, ent, sizeof(kv_ent_t));
+    ent_remove(ent);
+    
+    if (append(key, NULL, 0) == -1) {
+        ent_put(old.ke_key, old.ke_val, old.ke_len);
+        return -1;
+    }
+    
+    return 0;
+}
+
+/* Empty next sector, the old data stays behind its older sequence */
+int m24cxx_kv_format(void)
+{
+    if (!kv_sectors) {
+        error = M24CXX_KV_ERR_INVAL;
+        return -1;
+    }
+    
+    ent_num = 0;
+    return compact();
+}
+
+m24cxx_kv_stats_t m24cxx_kv_get_stats(void)
+{
+    stats.kvs_seq = seq;
+    stats.kvs_used = (uint16_t) used;
+    return stats;
+}
+
+int m24cxx_kv_get_last_error(void)
+{
+    int err;
+    
+    err = error;
+    error = M24CXX_KV_ERR_NOERR;
+    return err;
+}
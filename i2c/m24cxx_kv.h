@@ -0,0 +1,57 @@
+/**
+ *
+ * File Name: m24cxx_kv.h
+ * Title    : Wear leveled key/value store on M24Cxx I2C EEPROM header
+ * Project  : lib-avr
+ * Author   : Copyright (C) 2026 Johannes Krottmayer <krjdev@gmail.com>
+ * Created  : 2026-10-19
+ * Modified : 
+ * Revised  : 
+ * Version  : 0.1.0.0
+ * License  : ISC (see file LICENSE.txt)
+ * Target   : Atmel AVR Series
+ *
+ * NOTE: This code is currently below version 1.0, and therefore is considered
+ * to be lacking in some functionality or documentation, or may not be fully
+ * tested. Nonetheless, you can expect most functions to work.
+ *
+ */
+
+#ifndef LIBAVR_I2C_M24CXX_KV_H
+#define LIBAVR_I2C_M24CXX_KV_H
+
+#include <stdint.h>
+
+#include "m24cxx.h"
+
+#define M24CXX_KV_KEY_MAX       16  /* Keys in the RAM index */
+#define M24CXX_KV_VAL_MAX       8   /* Value length */
+#define M24CXX_KV_SECTOR        256 /* Log sector (multiple of the page size) */
+
+/* Keys 0x00 - 0xFE, 0xFF is erased EEPROM */
+#define M24CXX_KV_KEY_NONE      0xFF
+
+/* M24Cxx KV Error codes */
+#define M24CXX_KV_ERR_NOERR     0
+#define M24CXX_KV_ERR_INVAL     1
+#define M24CXX_KV_ERR_IO        2
+#define M24CXX_KV_ERR_NOKEY     3
+#define M24CXX_KV_ERR_FULL      4
+
+typedef struct m24cxx_kv_stats {
+    uint32_t kvs_appends;       /* Records written */
+    uint32_t kvs_skipped;       /* Writes of an unchanged value */
+    uint16_t kvs_compactions;
+    uint16_t kvs_seq;           /* Sequence of the active sector */
+    uint16_t kvs_used;          /* Bytes used in the active sector */
+} m24cxx_kv_stats_t;
+
+extern int m24cxx_kv_init(int type, uint8_t subaddr, uint16_t addr, int sectors);
+extern int m24cxx_kv_get(uint8_t key, uint8_t *buf, int len);
+extern int m24cxx_kv_set(uint8_t key, uint8_t *buf, int len);
+extern int m24cxx_kv_del(uint8_t key);
+extern int m24cxx_kv_format(void);
+extern m24cxx_kv_stats_t m24cxx_kv_get_stats(void);
+extern int m24cxx_kv_get_last_error(void);
+
+#endif
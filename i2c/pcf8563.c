@@ -5,9 +5,9 @@
  * Project  : lib-avr
  * Author   : Copyright (C) 2019 Johannes Krottmayer <krjdev@gmail.com>
  * Created  : 2019-04-04
- * Modified : 2019-05-06
+ * Modified : 2026-10-19
  * Revised  : 
- * Version  : 0.1.0.1
+ * Version  : 0.2.0.0
  * License  : ISC (see file LICENSE.txt)
  * Target   : Atmel AVR Series
  *
@@ -17,10 +17,22 @@
  *
  */
 
-#include "i2c.h"
+#include <string.h>
+
+#include "i2c_async.h"
 #include "../lib/bcd.h"
 #include "pcf8563.h"
 
+#ifndef I2C_SIM
+#include <avr/interrupt.h>
+
+#define LOCK(sreg)                  do { sreg = SREG; cli(); } while (0)
+#define UNLOCK(sreg)                (SREG = sreg)
+#else
+#define LOCK(sreg)                  (sreg = 0)
+#define UNLOCK(sreg)                ((void) sreg)
+#endif
+
 #define _ISCLR(reg, bit)            (((reg) | (1 << (bit))) ^ (reg))
 #define _ISSET(reg, bit)            ((reg) & (1 << (bit)))
 
@@ -101,7 +113,43 @@
 
 #define PCF8563_REG_TIMER           0x0F
 
-inline int dec_lsh(int x, int y)
+/* Valid bits of the time and date registers */
+#define PCF8563_MASK_SECONDS        0x7F
+#define PCF8563_MASK_MINUTES        0x7F
+#define PCF8563_MASK_HOURS          0x3F
+#define PCF8563_MASK_DAYS           0x3F
+#define PCF8563_MASK_WEEKDAYS       0x07
+#define PCF8563_MASK_MONTHS         0x1F
+
+/* Resync of the interpolated clock, see pcf8563_clock_poll() */
+#define SYNC_IDLE                   0
+#define SYNC_WAIT                   1
+#define SYNC_READ                   2
+
+#define SYNC_GAP_MS                 4   /* Max. read spacing for an accepted edge */
+#define SYNC_MISS_MAX               2   /* Windows without an edge, then every tick is read */
+
+static volatile uint8_t int_pending = 0;
+static volatile uint32_t clk_elapsed = 0;
+static pcf8563_ts_t clk_base;
+static uint8_t clk_valid = 0;
+
+/* Last timestamp of pcf8563_clock_get(), a resync never goes behind it */
+static pcf8563_ts_t clk_last;
+static uint8_t clk_last_valid = 0;
+
+static uint8_t sync_state = SYNC_IDLE;
+static i2c_xfer_t sync_xfer;
+static uint8_t sync_reg = PCF8563_REG_SECONDS;
+static uint8_t sync_val[7];
+static volatile uint32_t sync_done;    /* clk_elapsed when the last read finished */
+static uint32_t sync_prev;
+static uint32_t sync_sub;               /* clk_elapsed of the last submit, one read per tick */
+static uint8_t sync_sec = 0xFF;         /* Seconds of the previous read, 0xFF none */
+static uint8_t sync_miss;
+static uint8_t sync_stale;
+
+static inline int dec_lsh(int x, int y)
 {
     int i;
     int tmp = x;
@@ -139,262 +187,553 @@ static int dec_cat(int val, int num)
     return tmp;
 }
 
-void pcf8563_init(void)
+/* Register address and data in one segment, a second one would be a repeated START */
+static int reg_write(uint8_t reg, uint8_t *val, int len)
 {
-    i2c_master_init(100000);
-}
-
-int pcf8563_set_time(time_t *time)
-{
-    uint8_t cmd;
-    uint8_t val[3];
+    i2c_xfer_t xfer;
+    uint8_t buf[8];
     
-    cmd = PCF8563_REG_SECONDS;
-    val[0] = int_to_bcd(time->t_sec);
-    val[1] = int_to_bcd(time->t_min);
-    val[2] = int_to_bcd(time->t_hr);
-    i2c_master_send(I2C_OPT_NORMAL, PCF8563_ADDR, &cmd, 1, val, 3);
-    return 0;
-}
-
-int pcf8563_get_time(time_t *time)
-{
-    uint8_t cmd;
-    uint8_t val[3];
+    if ((len < 1) || (len > 7))
+        return -1;
     
-    cmd = PCF8563_REG_SECONDS;
-    i2c_master_recv(I2C_OPT_NORMAL, PCF8563_ADDR, &cmd, 1, val, 3);
+    buf[0] = reg;
+    memcpy(&buf[1], val, len);
+    memset(&xfer, 0, sizeof(i2c_xfer_t));
+    xfer.ix_addr = PCF8563_ADDR;
+    xfer.ix_nseg = 1;
+    xfer.ix_seg[0].is_type = I2C_SEG_WRITE;
+    xfer.ix_seg[0].is_buf = buf;
+    xfer.ix_seg[0].is_len = len + 1;
     
-    if (_ISSET(val[0], PCF8563_REG_SECONDS_VL))
+    if (i2c_async_submit(&xfer) == -1)
         return -1;
     
-    time->t_sec = bcd_to_int(val[0]);
-    time->t_min = bcd_to_int(val[1]);
-    time->t_hr = bcd_to_int(val[2]);
-    return 0;
+    return i2c_async_wait(&xfer);
 }
 
-int pcf8563_set_date(date_t *date)
+/* The PCF8563 freezes its counters during an access, a burst read is consistent */
+static int reg_read(uint8_t reg, uint8_t *val, int len)
 {
-    uint8_t cmd;
-    uint8_t val[4];
-    
-    cmd = PCF8563_REG_DAYS;
-    val[0] = int_to_bcd(date->d_day);
+    i2c_xfer_t xfer;
+    
+    memset(&xfer, 0, sizeof(i2c_xfer_t));
+    xfer.ix_addr = PCF8563_ADDR;
+    xfer.ix_nseg = 2;
+    xfer.ix_seg[0].is_type = I2C_SEG_WRITE;
+    xfer.ix_seg[0].is_buf = &reg;
+    xfer.ix_seg[0].is_len = 1;
+    xfer.ix_seg[1].is_type = I2C_SEG_READ;
+    xfer.ix_seg[1].is_buf = val;
+    xfer.ix_seg[1].is_len = len;
+    
+    if (i2c_async_submit(&xfer) == -1)
+        return -1;
     
-    switch (date->d_weekday) {
+    return i2c_async_wait(&xfer);
+}
+
+static int wday_to_reg(uint8_t wday, uint8_t *val)
+{
+    switch (wday) {
     case MON:
-        val[1] = PCF8563_WEEKDAY_MON;
+        (*val) = PCF8563_WEEKDAY_MON;
         break;
     case TUE:
-        val[1] = PCF8563_WEEKDAY_TUE;
+        (*val) = PCF8563_WEEKDAY_TUE;
         break;
     case WED:
-        val[1] = PCF8563_WEEKDAY_WED;
+        (*val) = PCF8563_WEEKDAY_WED;
         break;
     case THU:
-        val[1] = PCF8563_WEEKDAY_THU;
+        (*val) = PCF8563_WEEKDAY_THU;
         break;
     case FRI:
-        val[1] = PCF8563_WEEKDAY_FRI;
+        (*val) = PCF8563_WEEKDAY_FRI;
         break;
     case SAT:
-        val[1] = PCF8563_WEEKDAY_SAT;
+        (*val) = PCF8563_WEEKDAY_SAT;
         break;
     case SUN:
-        val[1] = PCF8563_WEEKDAY_SUN;
+        (*val) = PCF8563_WEEKDAY_SUN;
         break;
     default:
         return -1;
     }
     
-    switch (date->d_month) {
+    return 0;
+}
+
+static int reg_to_wday(uint8_t val, uint8_t *wday)
+{
+    switch (val & PCF8563_MASK_WEEKDAYS) {
+    case PCF8563_WEEKDAY_MON:
+        (*wday) = MON;
+        break;
+    case PCF8563_WEEKDAY_TUE:
+        (*wday) = TUE;
+        break;
+    case PCF8563_WEEKDAY_WED:
+        (*wday) = WED;
+        break;
+    case PCF8563_WEEKDAY_THU:
+        (*wday) = THU;
+        break;
+    case PCF8563_WEEKDAY_FRI:
+        (*wday) = FRI;
+        break;
+    case PCF8563_WEEKDAY_SAT:
+        (*wday) = SAT;
+        break;
+    case PCF8563_WEEKDAY_SUN:
+        (*wday) = SUN;
+        break;
+    default:
+        return -1;
+    }
+    
+    return 0;
+}
+
+/* Month register is BCD */
+static int month_to_reg(uint8_t month, uint8_t *val)
+{
+    switch (month) {
     case JAN:
-        val[2] = PCF8563_MONTH_JAN;
+        (*val) = PCF8563_MONTH_JAN;
         break;
     case FEB:
-        val[2] = PCF8563_MONTH_FEB;
+        (*val) = PCF8563_MONTH_FEB;
         break;
     case MAR:
-        val[2] = PCF8563_MONTH_MAR;
+        (*val) = PCF8563_MONTH_MAR;
         break;
     case APR:
-        val[2] = PCF8563_MONTH_APR;
+        (*val) = PCF8563_MONTH_APR;
         break;
     case MAY:
-        val[2] = PCF8563_MONTH_MAY;
+        (*val) = PCF8563_MONTH_MAY;
         break;
     case JUN:
-        val[2] = PCF8563_MONTH_JUN;
+        (*val) = PCF8563_MONTH_JUN;
         break;
     case JUL:
-        val[2] = PCF8563_MONTH_JUL;
+        (*val) = PCF8563_MONTH_JUL;
         break;
     case AUG:
-        val[2] = PCF8563_MONTH_AUG;
+        (*val) = PCF8563_MONTH_AUG;
         break;
     case SEP:
-        val[2] = PCF8563_MONTH_SEP;
+        (*val) = PCF8563_MONTH_SEP;
         break;
     case OCT:
-        val[2] = PCF8563_MONTH_OCT;
+        (*val) = PCF8563_MONTH_OCT;
         break;
     case NOV:
-        val[2] = PCF8563_MONTH_NOV;
+        (*val) = PCF8563_MONTH_NOV;
         break;
     case DEC:
-        val[2] = PCF8563_MONTH_DEC;
+        (*val) = PCF8563_MONTH_DEC;
         break;
     default:
         return -1;
     }
     
-    val[3] = int_to_bcd(dec_cat(date->d_year, 2));
-    i2c_master_send(I2C_OPT_NORMAL, PCF8563_ADDR, &cmd, 1, val, 4);
+    (*val) = int_to_bcd(*val);
     return 0;
 }
 
-int pcf8563_get_date(date_t *date)
+static int reg_to_month(uint8_t val, uint8_t *month)
 {
-    uint8_t cmd;
-    uint8_t val[4];
-    
-    cmd = PCF8563_REG_DAYS;
-    i2c_master_recv(I2C_OPT_NORMAL, PCF8563_ADDR, &cmd, 1, val, 4);
-    date->d_day = bcd_to_int(val[0]);
-    
-    switch (val[1]) {
-    case PCF8563_WEEKDAY_MON:
-        date->d_weekday = MON;
-        break;
-    case PCF8563_WEEKDAY_TUE:
-        date->d_weekday = TUE;
-        break;
-    case PCF8563_WEEKDAY_WED:
-        date->d_weekday = WED;
-        break;
-    case PCF8563_WEEKDAY_THU:
-        date->d_weekday = THU;
-        break;
-    case PCF8563_WEEKDAY_FRI:
-        date->d_weekday = FRI;
-        break;
-    case PCF8563_WEEKDAY_SAT:
-        date->d_weekday = SAT;
-        break;
-    case PCF8563_WEEKDAY_SUN:
-        date->d_weekday = SUN;
-        break;
-    default:
-        return -1;
-    }
-    
-    switch (val[2]) {
+    switch (bcd_to_int(val & PCF8563_MASK_MONTHS)) {
     case PCF8563_MONTH_JAN:
-        date->d_month = JAN;
+        (*month) = JAN;
         break;
     case PCF8563_MONTH_FEB:
-        date->d_month = FEB;
+        (*month) = FEB;
         break;
     case PCF8563_MONTH_MAR:
-        date->d_month = MAR;
+        (*month) = MAR;
         break;
     case PCF8563_MONTH_APR:
-        date->d_month = APR;
+        (*month) = APR;
         break;
     case PCF8563_MONTH_MAY:
-        date->d_month = MAY;
+        (*month) = MAY;
         break;
     case PCF8563_MONTH_JUN:
-        date->d_month = JUN;
+        (*month) = JUN;
         break;
     case PCF8563_MONTH_JUL:
-        date->d_month = JUL;
+        (*month) = JUL;
         break;
     case PCF8563_MONTH_AUG:
-        date->d_month = AUG;
+        (*month) = AUG;
         break;
     case PCF8563_MONTH_SEP:
-        date->d_month = SEP;
+        (*month) = SEP;
         break;
     case PCF8563_MONTH_OCT:
-        date->d_month = OCT;
+        (*month) = OCT;
         break;
     case PCF8563_MONTH_NOV:
-        date->d_month = NOV;
+        (*month) = NOV;
         break;
     case PCF8563_MONTH_DEC:
-        date->d_month = DEC;
+        (*month) = DEC;
         break;
     default:
         return -1;
     }
     
-    date->d_year = 2000 + bcd_to_int(val[3]);
     return 0;
 }
 
+/* Registers seconds, minutes, hours */
+static int time_decode(uint8_t *val, time_t *time)
+{
+    if (_ISSET(val[0], PCF8563_REG_SECONDS_VL))
+        return -1;
+    
+    time->t_sec = bcd_to_int(val[0] & PCF8563_MASK_SECONDS);
+    time->t_min = bcd_to_int(val[1] & PCF8563_MASK_MINUTES);
+    time->t_hr = bcd_to_int(val[2] & PCF8563_MASK_HOURS);
+    time->t_msec = 0;
+    return 0;
+}
+
+static void time_encode(time_t *time, uint8_t *val)
+{
+    val[0] = int_to_bcd(time->t_sec);
+    val[1] = int_to_bcd(time->t_min);
+    val[2] = int_to_bcd(time->t_hr);
+}
+
+/* Registers days, weekdays, months, years */
+static int date_decode(uint8_t *val, date_t *date)
+{
+    uint8_t wday;
+    uint8_t month;
+    
+    if (reg_to_wday(val[1], &wday) == -1)
+        return -1;
+    
+    if (reg_to_month(val[2], &month) == -1)
+        return -1;
+    
+    date->d_day = bcd_to_int(val[0] & PCF8563_MASK_DAYS);
+    date->d_weekday = wday;
+    date->d_month = month;
+    
+    if (_ISSET(val[2], PCF8563_REG_MONTHS_C))
+        date->d_year = 2100 + bcd_to_int(val[3]);
+    else
+        date->d_year = 2000 + bcd_to_int(val[3]);
+    
+    return 0;
+}
+
+static int date_encode(date_t *date, uint8_t *val)
+{
+    val[0] = int_to_bcd(date->d_day);
+    
+    if (wday_to_reg(date->d_weekday, &val[1]) == -1)
+        return -1;
+    
+    if (month_to_reg(date->d_month, &val[2]) == -1)
+        return -1;
+    
+    if (date->d_year >= 2100)
+        val[2] |= (1 << PCF8563_REG_MONTHS_C);
+    
+    val[3] = int_to_bcd(dec_cat(date->d_year, 2));
+    return 0;
+}
+
+static uint8_t month_days(date_t *date)
+{
+    uint16_t y;
+    
+    switch (date->d_month) {
+    case FEB:
+        y = date->d_year;
+        
+        if (((y % 4) == 0) && (((y % 100) != 0) || ((y % 400) == 0)))
+            return 29;
+        
+        return 28;
+    case APR:
+    case JUN:
+    case SEP:
+    case NOV:
+        return 30;
+    default:
+        return 31;
+    }
+}
+
+/* Advance a timestamp by ms, carries into the date */
+static void ts_advance(pcf8563_ts_t *ts, uint32_t ms)
+{
+    uint32_t sec;
+    uint32_t days;
+    
+    ms += ts->pts_time.t_msec;
+    ts->pts_time.t_msec = ms % 1000;
+    sec = (ms / 1000) + ts->pts_time.t_sec + 
+          (60UL * ts->pts_time.t_min) + (3600UL * ts->pts_time.t_hr);
+    days = sec / 86400UL;
+    sec %= 86400UL;
+    ts->pts_time.t_hr = sec / 3600;
+    ts->pts_time.t_min = (sec % 3600) / 60;
+    ts->pts_time.t_sec = sec % 60;
+    
+    while (days--) {
+        ts->pts_date.d_weekday = (ts->pts_date.d_weekday + 1) % 7;
+        ts->pts_date.d_day++;
+        
+        if (ts->pts_date.d_day <= month_days(&ts->pts_date))
+            continue;
+        
+        ts->pts_date.d_day = 1;
+        
+        if (ts->pts_date.d_month == DEC) {
+            ts->pts_date.d_month = JAN;
+            ts->pts_date.d_year++;
+        } else
+            ts->pts_date.d_month++;
+    }
+}
+
+/* Time or date changed, a running resync read may hold the old value */
+static void clock_restart(void)
+{
+    clk_valid = 0;
+    clk_last_valid = 0;
+    sync_sec = 0xFF;
+    sync_miss = 0;
+    
+    if (sync_state == SYNC_READ)
+        sync_stale = 1;
+    else
+        sync_state = SYNC_WAIT;
+}
+
+/* Completion in ISR context, timestamps the read for the edge phase */
+static void sync_finish(i2c_xfer_t *xfer)
+{
+    sync_done = clk_elapsed;
+}
+
+/* The edge is expected where the interpolated milliseconds wrap */
+static int sync_window(uint32_t ms)
+{
+    uint16_t pos;
+    
+    if (!clk_valid || (sync_miss >= SYNC_MISS_MAX))
+        return 1;
+    
+    pos = (uint16_t) ((clk_base.pts_time.t_msec + ms) % 1000);
+    return ((pos >= (1000 - PCF8563_SYNC_WIN)) || (pos < PCF8563_SYNC_WIN));
+}
+
+static int ts_cmp(pcf8563_ts_t *a, pcf8563_ts_t *b)
+{
+    if (a->pts_date.d_year != b->pts_date.d_year)
+        return (a->pts_date.d_year < b->pts_date.d_year) ? -1 : 1;
+    
+    if (a->pts_date.d_month != b->pts_date.d_month)
+        return (a->pts_date.d_month < b->pts_date.d_month) ? -1 : 1;
+    
+    if (a->pts_date.d_day != b->pts_date.d_day)
+        return (a->pts_date.d_day < b->pts_date.d_day) ? -1 : 1;
+    
+    if (a->pts_time.t_hr != b->pts_time.t_hr)
+        return (a->pts_time.t_hr < b->pts_time.t_hr) ? -1 : 1;
+    
+    if (a->pts_time.t_min != b->pts_time.t_min)
+        return (a->pts_time.t_min < b->pts_time.t_min) ? -1 : 1;
+    
+    if (a->pts_time.t_sec != b->pts_time.t_sec)
+        return (a->pts_time.t_sec < b->pts_time.t_sec) ? -1 : 1;
+    
+    if (a->pts_time.t_msec != b->pts_time.t_msec)
+        return (a->pts_time.t_msec < b->pts_time.t_msec) ? -1 : 1;
+    
+    return 0;
+}
+
+#ifndef I2C_SIM
+ISR(PCF8563_INT_vect)
+{
+    pcf8563_isr();
+}
+#endif
+
+void pcf8563_init(void)
+{
+    i2c_async_init(100000);
+    clock_restart();
+}
+
+int pcf8563_set_time(time_t *time)
+{
+    uint8_t val[3];
+    
+    if (!time)
+        return -1;
+    
+    time_encode(time, val);
+    clock_restart();
+    return reg_write(PCF8563_REG_SECONDS, val, 3);
+}
+
+int pcf8563_get_time(time_t *time)
+{
+    uint8_t val[3];
+    
+    if (!time)
+        return -1;
+    
+    if (reg_read(PCF8563_REG_SECONDS, val, 3) == -1)
+        return -1;
+    
+    return time_decode(val, time);
+}
+
+int pcf8563_set_date(date_t *date)
+{
+    uint8_t val[4];
+    
+    if (!date)
+        return -1;
+    
+    if (date_encode(date, val) == -1)
+        return -1;
+    
+    clock_restart();
+    return reg_write(PCF8563_REG_DAYS, val, 4);
+}
+
+int pcf8563_get_date(date_t *date)
+{
+    uint8_t val[4];
+    
+    if (!date)
+        return -1;
+    
+    if (reg_read(PCF8563_REG_DAYS, val, 4) == -1)
+        return -1;
+    
+    return date_decode(val, date);
+}
+
+/* Time and date in one write, all counters start together */
+int pcf8563_set_timestamp(pcf8563_ts_t *ts)
+{
+    uint8_t val[7];
+    
+    if (!ts)
+        return -1;
+    
+    time_encode(&ts->pts_time, &val[0]);
+    
+    if (date_encode(&ts->pts_date, &val[3]) == -1)
+        return -1;
+    
+    clock_restart();
+    return reg_write(PCF8563_REG_SECONDS, val, 7);
+}
+
+/* Time and date in one read, can not tear across a rollover */
+int pcf8563_get_timestamp(pcf8563_ts_t *ts)
+{
+    uint8_t val[7];
+    
+    if (!ts)
+        return -1;
+    
+    if (reg_read(PCF8563_REG_SECONDS, val, 7) == -1)
+        return -1;
+    
+    if (time_decode(&val[0], &ts->pts_time) == -1)
+        return -1;
+    
+    return date_decode(&val[3], &ts->pts_date);
+}
+
+/* AE set disables the compare of a field */
 int pcf8563_set_alarm(time_t *time, date_t *date, uint8_t flags)
 {
-    uint8_t cmd;
     uint8_t val[4];
     
-    cmd = PCF8563_REG_ALARM_MINUTE;
+    if (!time || !date)
+        return -1;
+    
     val[0] = int_to_bcd(time->t_min);
     val[1] = int_to_bcd(time->t_hr);
     val[2] = int_to_bcd(date->d_day);
     
-    switch (date->d_weekday) {
-    case MON:
-        val[3] = PCF8563_WEEKDAY_MON;
-        break;
-    case TUE:
-        val[3] = PCF8563_WEEKDAY_TUE;
-        break;
-    case WED:
-        val[3] = PCF8563_WEEKDAY_WED;
-        break;
-    case THU:
-        val[3] = PCF8563_WEEKDAY_THU;
-        break;
-    case FRI:
-        val[3] = PCF8563_WEEKDAY_FRI;
-        break;
-    case SAT:
-        val[3] = PCF8563_WEEKDAY_SAT;
-        break;
-    case SUN:
-        val[3] = PCF8563_WEEKDAY_SUN;
-        break;
-    default:
+    if (wday_to_reg(date->d_weekday, &val[3]) == -1)
         return -1;
-    }
     
-    if (flags & ALARM_MIN)
-        val[0] |= PCF8563_REG_ALARM_MINUTE_AE;
+    if (!(flags & ALARM_MIN))
+        val[0] |= (1 << PCF8563_REG_ALARM_MINUTE_AE);
     
-    if (flags & ALARM_HR)
-        val[1] |= PCF8563_REG_ALARM_HOUR_AE;
+    if (!(flags & ALARM_HR))
+        val[1] |= (1 << PCF8563_REG_ALARM_HOUR_AE);
     
-    if (flags & ALARM_DAY)
-        val[2] |= PCF8563_REG_ALARM_DAY_AE;
+    if (!(flags & ALARM_DAY))
+        val[2] |= (1 << PCF8563_REG_ALARM_DAY_AE);
     
-    if (flags & ALARM_WDAY)
-        val[3] |= PCF8563_REG_ALARM_WEEKDAY_AE;
+    if (!(flags & ALARM_WDAY))
+        val[3] |= (1 << PCF8563_REG_ALARM_WEEKDAY_AE);
     
-    i2c_master_send(I2C_OPT_NORMAL, PCF8563_ADDR, &cmd, 1, val, 4);
-    return 0;
+    return reg_write(PCF8563_REG_ALARM_MINUTE, val, 4);
+}
+
+/* Reads and clears the flags in events, returns the ones that were set */
+static int flags_clear(uint8_t events)
+{
+    uint8_t val;
+    uint8_t set = 0;
+    
+    if (reg_read(PCF8563_REG_CONTROL2, &val, 1) == -1)
+        return -1;
+    
+    if ((events & PCF8563_EVENT_ALARM) && _ISSET(val, PCF8563_REG_CONTROL2_AF))
+        set |= PCF8563_EVENT_ALARM;
+    
+    if ((events & PCF8563_EVENT_TIMER) && _ISSET(val, PCF8563_REG_CONTROL2_TF))
+        set |= PCF8563_EVENT_TIMER;
+    
+    if (!set)
+        return 0;
+    
+    /* Writing 1 to a flag leaves it unchanged */
+    val |= (1 << PCF8563_REG_CONTROL2_AF) | (1 << PCF8563_REG_CONTROL2_TF);
+    
+    if (set & PCF8563_EVENT_ALARM)
+        val &= ~(1 << PCF8563_REG_CONTROL2_AF);
+    
+    if (set & PCF8563_EVENT_TIMER)
+        val &= ~(1 << PCF8563_REG_CONTROL2_TF);
+    
+    if (reg_write(PCF8563_REG_CONTROL2, &val, 1) == -1)
+        return -1;
+    
+    return set;
 }
 
 int pcf8563_check_alarm(void)
 {
-    uint8_t cmd;
-    uint8_t val[1];
+    int ret;
     
-    cmd = PCF8563_REG_CONTROL2;
-    i2c_master_recv(I2C_OPT_NORMAL, PCF8563_ADDR, &cmd, 1, val, 1);
+    ret = flags_clear(PCF8563_EVENT_ALARM);
     
-    if (_ISSET(val[0], PCF8563_REG_CONTROL2_AF))
+    if (ret == -1)
+        return -1;
+    
+    if (ret)
         return 1;
     else
         return 0;
@@ -402,11 +741,8 @@ int pcf8563_check_alarm(void)
 
 int pcf8563_set_timer(int freq, uint8_t value)
 {
-    uint8_t cmd;
     uint8_t val[2];
     
-    cmd = PCF8563_REG_TIMERCTRL;
-    
     switch (freq) {
     case FREQ_4096HZ:
         val[0] = (1 << PCF8563_REG_TIMERCTRL_TE) | FREQ_4096HZ;
@@ -425,19 +761,19 @@ int pcf8563_set_timer(int freq, uint8_t value)
     }
     
     val[1] = value;
-    i2c_master_send(I2C_OPT_NORMAL, PCF8563_ADDR, &cmd, 1, val, 2);
-    return 0;
+    return reg_write(PCF8563_REG_TIMERCTRL, val, 2);
 }
 
 int pcf8563_check_timer(void)
 {
-    uint8_t cmd;
-    uint8_t val[1];
+    int ret;
     
-    cmd = PCF8563_REG_CONTROL2;
-    i2c_master_recv(I2C_OPT_NORMAL, PCF8563_ADDR, &cmd, 1, val, 1);
+    ret = flags_clear(PCF8563_EVENT_TIMER);
     
-    if (_ISSET(val[0], PCF8563_REG_CONTROL2_TF))
+    if (ret == -1)
+        return -1;
+    
+    if (ret)
         return 1;
     else
         return 0;
@@ -445,28 +781,229 @@ int pcf8563_check_timer(void)
 
 int pcf8563_set_clkout(int freq, int enable)
 {
-    uint8_t cmd;
     uint8_t val[1];
     
-    cmd = PCF8563_REG_CLKOUT;
-    
     switch (freq) {
     case FREQ_4096HZ:
-        val[0] = (1 << PCF8563_REG_CLKOUT_FE) | FREQ_4096HZ;
+        val[0] = FREQ_4096HZ;
         break;
     case FREQ_64HZ:
-        val[0] = (1 << PCF8563_REG_CLKOUT_FE) | FREQ_64HZ;
+        val[0] = FREQ_64HZ;
         break;
     case FREQ_1HZ:
-        val[0] = (1 << PCF8563_REG_CLKOUT_FE) | FREQ_1HZ;
+        val[0] = FREQ_1HZ;
         break;
     case FREQ_1DIV60HZ:
-        val[0] = (1 << PCF8563_REG_CLKOUT_FE) | FREQ_1DIV60HZ;
+        val[0] = FREQ_1DIV60HZ;
         break;
     default:
         return -1;
     }
     
-    i2c_master_send(I2C_OPT_NORMAL, PCF8563_ADDR, &cmd, 1, val, 1);
+    if (enable)
+        val[0] |= (1 << PCF8563_REG_CLKOUT_FE);
+    
+    return reg_write(PCF8563_REG_CLKOUT, val, 1);
+}
+
+/* Alarm and timer on the INT pin, flags of old events are cleared */
+int pcf8563_int_enable(uint8_t events)
+{
+    uint8_t val;
+    
+    if (events & ~(PCF8563_EVENT_ALARM | PCF8563_EVENT_TIMER))
+        return -1;
+    
+    val = 0x00;
+    
+    if (events & PCF8563_EVENT_ALARM)
+        val |= (1 << PCF8563_REG_CONTROL2_AIE);
+    
+    if (events & PCF8563_EVENT_TIMER)
+        val |= (1 << PCF8563_REG_CONTROL2_TIE);
+    
+    if (reg_write(PCF8563_REG_CONTROL2, &val, 1) == -1)
+        return -1;
+    
+    int_pending = 0;
+    PCF8563_INT_CONFIG;
+    PCF8563_INT_ENABLE;
+    return 0;
+}
+
+int pcf8563_int_disable(void)
+{
+    uint8_t val = 0x00;
+    
+    PCF8563_INT_DISABL;
+    int_pending = 0;
+    return reg_write(PCF8563_REG_CONTROL2, &val, 1);
+}
+
+void pcf8563_isr(void)
+{
+    int_pending = 1;
+}
+
+/* Bus access only after INT, returns the PCF8563_EVENT_* that occurred */
+int pcf8563_poll(void)
+{
+    int ret;
+    
+    if (!int_pending)
+        return 0;
+    
+    int_pending = 0;
+    ret = flags_clear(PCF8563_EVENT_ALARM | PCF8563_EVENT_TIMER);
+    
+    /* Only the falling edge interrupts, INT stays low while a flag is set */
+    if ((ret == -1) || PCF8563_INT_LOW)
+        int_pending = 1;
+    
+    return ret;
+}
+
+/* Requests a resync, done by pcf8563_clock_poll() */
+int pcf8563_clock_sync(void)
+{
+    if (sync_state != SYNC_IDLE)
+        return 0;
+    
+    sync_sec = 0xFF;
+    sync_miss = 0;
+    sync_state = SYNC_WAIT;
+    return 0;
+}
+
+/* Main loop, never waits for the bus, returns 1 when a resync finished */
+int pcf8563_clock_poll(void)
+{
+    pcf8563_ts_t ts;
+    uint32_t ms;
+    uint32_t at;
+    uint8_t sreg;
+    
+    LOCK(sreg);
+    ms = clk_elapsed;
+    UNLOCK(sreg);
+    
+    switch (sync_state) {
+    case SYNC_IDLE:
+        if (clk_valid && (ms < (PCF8563_RESYNC * 1000UL)))
+            return 0;
+        
+        sync_sec = 0xFF;
+        sync_miss = 0;
+        sync_state = SYNC_WAIT;
+        /* fall through */
+    case SYNC_WAIT:
+        /* One read per tick around the expected edge */
+        if (!sync_window(ms)) {
+            /* Window passed without an edge */
+            if (sync_sec != 0xFF) {
+                sync_sec = 0xFF;
+                sync_miss++;
+            }
+            
+            return 0;
+        }
+        
+        if ((sync_sec != 0xFF) && (ms == sync_sub))
+            return 0;
+        
+        memset(&sync_xfer, 0, sizeof(i2c_xfer_t));
+        sync_xfer.ix_addr = PCF8563_ADDR;
+        sync_xfer.ix_nseg = 2;
+        sync_xfer.ix_seg[0].is_type = I2C_SEG_WRITE;
+        sync_xfer.ix_seg[0].is_buf = &sync_reg;
+        sync_xfer.ix_seg[0].is_len = 1;
+        sync_xfer.ix_seg[1].is_type = I2C_SEG_READ;
+        sync_xfer.ix_seg[1].is_buf = sync_val;
+        sync_xfer.ix_seg[1].is_len = 7;
+        sync_xfer.ix_done = sync_finish;
+        
+        if (i2c_async_submit(&sync_xfer) == -1)
+            return -1;
+        
+        sync_sub = ms;
+        sync_state = SYNC_READ;
+        return 0;
+    case SYNC_READ:
+        if ((sync_xfer.ix_state == I2C_XFER_QUEUED) || 
+            (sync_xfer.ix_state == I2C_XFER_ACTIVE))
+            return 0;
+        
+        sync_state = SYNC_WAIT;
+        
+        if (sync_stale) {
+            sync_stale = 0;
+            return 0;
+        }
+        
+        if (sync_xfer.ix_state != I2C_XFER_DONE) {
+            sync_sec = 0xFF;
+            return -1;
+        }
+        
+        if ((time_decode(&sync_val[0], &ts.pts_time) == -1) || 
+            (date_decode(&sync_val[3], &ts.pts_date) == -1)) {
+            sync_sec = 0xFF;
+            return -1;
+        }
+        
+        LOCK(sreg);
+        at = sync_done;
+        UNLOCK(sreg);
+        
+        /* Edge between two close reads, the phase error is below the gap */
+        if ((sync_sec == 0xFF) || (ts.pts_time.t_sec == sync_sec) || 
+            (((at - sync_prev) > SYNC_GAP_MS) && (sync_miss < SYNC_MISS_MAX))) {
+            sync_sec = ts.pts_time.t_sec;
+            sync_prev = at;
+            return 0;
+        }
+        
+        LOCK(sreg);
+        clk_elapsed -= at;
+        UNLOCK(sreg);
+        clk_base = ts;
+        clk_valid = 1;
+        sync_state = SYNC_IDLE;
+        return 1;
+    }
+    
+    return 0;
+}
+
+void pcf8563_clock_tick(void)
+{
+    clk_elapsed += PCF8563_TICK_MS;
+}
+
+/* Last seconds edge plus the ticks since, no bus access, -1 before the first sync */
+int pcf8563_clock_get(pcf8563_ts_t *ts)
+{
+    uint32_t ms;
+    uint8_t sreg;
+    
+    if (!ts)
+        return -1;
+    
+    if (!clk_valid)
+        return -1;
+    
+    LOCK(sreg);
+    ms = clk_elapsed;
+    UNLOCK(sreg);
+    
+    (*ts) = clk_base;
+    ts_advance(ts, ms);
+    
+    /* Tick drift against the RTC, hold the clock until it caught up */
+    if (clk_last_valid && (ts_cmp(ts, &clk_last) < 0))
+        (*ts) = clk_last;
+    
+    clk_last = (*ts);
+    clk_last_valid = 1;
     return 0;
 }
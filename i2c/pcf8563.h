@@ -5,9 +5,9 @@
  * Project  : lib-avr
  * Author   : Copyright (C) 2019 Johannes Krottmayer <krjdev@gmail.com>
  * Created  : 2019-04-04
- * Modified : 2019-05-06
+ * Modified : 2026-10-19
  * Revised  : 
- * Version  : 0.1.0.1
+ * Version  : 0.2.0.0
  * License  : ISC (see file LICENSE.txt)
  * Target   : Atmel AVR Series
  *
@@ -19,6 +19,10 @@
 
 #include <stdint.h>
 
+#ifndef I2C_SIM
+#include <avr/io.h>
+#endif
+
 #include "../lib/date.h"
 #include "../lib/time.h"
 
@@ -35,6 +39,33 @@
 #define ALARM_DAY       0x04
 #define ALARM_WDAY      0x08
 
+/* Events on the INT pin */
+#define PCF8563_EVENT_ALARM 0x01
+#define PCF8563_EVENT_TIMER 0x02
+
+#define PCF8563_TICK_MS     1       /* Interval of pcf8563_clock_tick() calls */
+#define PCF8563_RESYNC      3600    /* Seconds between resyncs of the interpolated clock */
+#define PCF8563_SYNC_WIN    100     /* Resync reads within +/- ms of the expected seconds edge */
+
+#ifndef I2C_SIM
+/* PCF8563 INT pin (open drain, active low), external interrupt INT6 */
+#define PCF8563_INT_CONFIG  (EICRB |= (1 << ISC61))
+#define PCF8563_INT_ENABLE  (EIMSK |= (1 << INT6))
+#define PCF8563_INT_DISABL  (EIMSK &= ~(1 << INT6))
+#define PCF8563_INT_vect    INT6_vect
+#define PCF8563_INT_LOW     (!(PINE & (1 << PINE6)))
+#else
+#define PCF8563_INT_CONFIG  ((void) 0)
+#define PCF8563_INT_ENABLE  ((void) 0)
+#define PCF8563_INT_DISABL  ((void) 0)
+#define PCF8563_INT_LOW     (0)
+#endif
+
+typedef struct pcf8563_ts {
+    time_t pts_time;
+    date_t pts_date;
+} pcf8563_ts_t;
+
 extern void pcf8563_init(void);
 extern int pcf8563_set_time(time_t *time);
 extern int pcf8563_get_time(time_t *time);
@@ -45,5 +76,15 @@ extern int pcf8563_check_alarm(void);
 extern int pcf8563_set_timer(int freq, uint8_t value);
 extern int pcf8563_check_timer(void);
 extern int pcf8563_set_clkout(int freq, int enable);
+extern int pcf8563_set_timestamp(pcf8563_ts_t *ts);
+extern int pcf8563_get_timestamp(pcf8563_ts_t *ts);
+extern int pcf8563_int_enable(uint8_t events);
+extern int pcf8563_int_disable(void);
+extern void pcf8563_isr(void);
+extern int pcf8563_poll(void);
+extern int pcf8563_clock_sync(void);
+extern int pcf8563_clock_poll(void);
+extern void pcf8563_clock_tick(void);
+extern int pcf8563_clock_get(pcf8563_ts_t *ts);
 
 #endif
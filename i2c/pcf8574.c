@@ -5,9 +5,9 @@
  * Project  : lib-avr
  * Author   : Copyright (C) 2018 Johannes Krottmayer <krjdev@gmail.com>
  * Created  : 2018-09-22
- * Modified : 2018-12-03
+ * Modified : 2026-10-19
  * Revised  : 
- * Version  : 0.1.1.0
+ * Version  : 0.2.0.0
  * License  : ISC (see file LICENSE.txt)
  * Target   : Atmel AVR Series
  *
@@ -18,52 +18,123 @@
  */
 
 #include <stdlib.h>
+#include <string.h>
 
-#include "i2c.h"
+#include "i2c_async.h"
 #include "pcf8574.h"
 
+#ifndef I2C_SIM
+#include <avr/interrupt.h>
+#endif
+
 #define PCF8574_ADDR    0x20
 #define PCF8574A_ADDR   0x38
 
+static volatile uint8_t int_pending = 0;
+
+static void xfer_setup(i2c_xfer_t *xfer, gpio_t *gpio, int type, uint8_t *data)
+{
+    memset(xfer, 0, sizeof(i2c_xfer_t));
+    xfer->ix_addr = gpio->addr;
+    xfer->ix_nseg = 1;
+    xfer->ix_seg[0].is_type = type;
+    xfer->ix_seg[0].is_buf = data;
+    xfer->ix_seg[0].is_len = 1;
+}
+
+/* Input pins have to stay high (quasi-bidirectional port) */
+static uint8_t latch_calc(gpio_t *gpio)
+{
+    uint8_t tmp = 0x00;
+    int i;
+    
+    for (i = 0; i < gpio->npins; i++) {
+        if ((gpio->pin_config[i] == GPIO_PIN_INPUT) || 
+            (gpio->pin_state[i] == GPIO_PIN_HIGH))
+            tmp |= (1 << i);
+    }
+    
+    return tmp;
+}
+
+/* Returns the input pins that changed, output pins follow the latch */
+static uint8_t input_update(gpio_t *gpio, uint8_t data)
+{
+    uint8_t mask = 0x00;
+    int i;
+    
+    for (i = 0; i < gpio->npins; i++) {
+        if (gpio->pin_config[i] != GPIO_PIN_INPUT)
+            continue;
+        
+        mask |= (1 << i);
+        
+        if (data & (1 << i))
+            gpio->pin_state[i] = GPIO_PIN_HIGH;
+        else
+            gpio->pin_state[i] = GPIO_PIN_LOW;
+    }
+    
+    mask &= gpio->input ^ data;
+    gpio->changed |= mask;
+    gpio->input = data;
+    return mask;
+}
+
+#ifndef I2C_SIM
+ISR(PCF8574_INT_vect)
+{
+    pcf8574_isr();
+}
+#endif
+
 int pcf8574_write(gpio_t *gpio, uint8_t data)
 {
-    int ret;
+    i2c_xfer_t xfer;
     uint8_t tmp = data;
     
     if (!gpio)
         return -1;
     
-    ret = i2c_master_send(I2C_OPT_NORMAL, gpio->addr, NULL, 0, &tmp, 1);
+    xfer_setup(&xfer, gpio, I2C_SEG_WRITE, &tmp);
+    
+    if (i2c_async_submit(&xfer) == -1)
+        return -1;
     
-    if (ret == -1)
+    if (i2c_async_wait(&xfer) == -1)
         return -1;
     
+    gpio->latch = data;
+    gpio->dirty = 0;
     return 0;
 }
 
 int pcf8574_read(gpio_t *gpio, uint8_t *data)
 {
-    int ret;
+    i2c_xfer_t xfer;
     
     if (!gpio)
         return -1;
     
-    ret = i2c_master_recv(I2C_OPT_NORMAL, gpio->addr, NULL, 0, data, 1);
+    if (!data)
+        return -1;
+    
+    xfer_setup(&xfer, gpio, I2C_SEG_READ, data);
     
-    if (ret == -1)
+    if (i2c_async_submit(&xfer) == -1)
         return -1;
     
-    return 0;
+    return i2c_async_wait(&xfer);
 }
 
 gpio_t *pcf8574_init(int type, uint8_t subaddr)
 {
     gpio_t *p;
     uint8_t addr;
+    uint8_t tmp;
     int i;
-    int value;
     
-    if (subaddr > 8)
+    if (subaddr > 7)
         return NULL;
     
     switch (type) {
@@ -82,19 +153,22 @@ gpio_t *pcf8574_init(int type, uint8_t subaddr)
     if (!p)
         return NULL;
     
+    memset(p, 0, sizeof(gpio_t));
     p->addr = addr;
     p->npins = NPINS;
-    i2c_master_init(100000);
+    
+    i2c_async_init(100000);
+    
+    for (i = 0; i < p->npins; i++)
+        p->pin_config[i] = GPIO_PIN_INPUT;
     
     /* set initial state of pins to input */
     pcf8574_write(p, 0xFF);
     
-    for (i = 0; i < p->npins; i++) {
-        p->pin_config[i] = GPIO_PIN_INPUT;
-        pcf8574_get_pin(p, i, &value);
-        p->pin_state[i] = value;
-    }
+    if (pcf8574_read(p, &tmp) == 0)
+        input_update(p, tmp);
     
+    p->changed = 0x00;
     return p;
 }
 
@@ -109,18 +183,18 @@ int pcf8574_set_config(gpio_t *gpio, int pin, int config)
     if (!gpio)
         return -1;
     
-    if (pin >= gpio->npins)
+    if ((pin < 0) || (pin >= gpio->npins))
         return -1;
     
-    if (config != GPIO_PIN_INPUT || config != GPIO_PIN_OUTPUT)
+    if ((config != GPIO_PIN_INPUT) && (config != GPIO_PIN_OUTPUT))
         return -1;
     
-    gpio->pin_config[pin] = config;
-    
-    if (config == GPIO_PIN_INPUT)
-        pcf8574_set_pin(gpio, pin, GPIO_PIN_HIGH);
+    if (gpio->pin_config[pin] == config)
+        return 0;
     
-    return 0;
+    gpio->pin_config[pin] = config;
+    gpio->dirty = 1;
+    return pcf8574_commit(gpio);
 }
 
 int pcf8574_get_config(gpio_t *gpio, int pin, int *config)
@@ -143,34 +217,70 @@ int pcf8574_get_npins(gpio_t *gpio)
     return gpio->npins;
 }
 
-int pcf8574_set_pin(gpio_t *gpio, int pin, int value)
+/* Shadow state only, pcf8574_commit() writes all staged pins at once */
+int pcf8574_stage_pin(gpio_t *gpio, int pin, int value)
+{
+    if (!gpio)
+        return -1;
+    
+    if ((pin < 0) || (pin >= gpio->npins))
+        return -1;
+    
+    gpio->pin_config[pin] = GPIO_PIN_OUTPUT;
+    
+    if (value == GPIO_PIN_HIGH)
+        gpio->pin_state[pin] = GPIO_PIN_HIGH;
+    else
+        gpio->pin_state[pin] = GPIO_PIN_LOW;
+    
+    gpio->dirty = 1;
+    return 0;
+}
+
+/* Pins in mask become outputs with the bits of value */
+int pcf8574_stage_port(gpio_t *gpio, uint8_t mask, uint8_t value)
 {
     int i;
-    uint8_t tmp = 0x00;
     
     if (!gpio)
         return -1;
     
-    if (pin >= gpio->npins)
+    for (i = 0; i < gpio->npins; i++) {
+        if (!(mask & (1 << i)))
+            continue;
+        
+        pcf8574_stage_pin(gpio, i, ((value & (1 << i)) ? GPIO_PIN_HIGH : GPIO_PIN_LOW));
+    }
+    
+    return 0;
+}
+
+/* One write, skipped if the port latch would not change */
+int pcf8574_commit(gpio_t *gpio)
+{
+    uint8_t tmp;
+    
+    if (!gpio)
         return -1;
     
-    for (i = 0; i < gpio->npins; i++)
-		if (gpio->pin_state[i] == GPIO_PIN_LOW)
-			tmp |= (1 << i);
-        
-    pcf8574_set_config(gpio, pin, GPIO_PIN_OUTPUT);
-        
-	if (value == GPIO_PIN_HIGH) {
-		tmp &= ~(1 << pin);
-		pcf8574_write(gpio, tmp);
-		gpio->pin_state[pin] = GPIO_PIN_HIGH;
-	} else {
-		tmp |= 1 << pin;
-		pcf8574_write(gpio, tmp);
-		gpio->pin_state[pin] = GPIO_PIN_LOW;
-	}
-	
-	return 0;
+    if (!gpio->dirty)
+        return 0;
+    
+    tmp = latch_calc(gpio);
+    gpio->dirty = 0;
+    
+    if (tmp == gpio->latch)
+        return 0;
+    
+    return pcf8574_write(gpio, tmp);
+}
+
+int pcf8574_set_pin(gpio_t *gpio, int pin, int value)
+{
+    if (pcf8574_stage_pin(gpio, pin, value) == -1)
+        return -1;
+    
+    return pcf8574_commit(gpio);
 }
 
 int pcf8574_get_pin(gpio_t *gpio, int pin, int *value)
@@ -180,19 +290,128 @@ int pcf8574_get_pin(gpio_t *gpio, int pin, int *value)
     if (!gpio)
         return -1;
     
-    if (pin >= gpio->npins)
+    if ((pin < 0) || (pin >= gpio->npins))
         return -1;
     
     if (!value)
         return -1;
     
-    pcf8574_read(gpio, &tmp);
-    
-	if (tmp & (1 << pin))
-		gpio->pin_state[pin] = GPIO_PIN_HIGH;
-	else
-		gpio->pin_state[pin] = GPIO_PIN_LOW;
+    if (pcf8574_read(gpio, &tmp) == -1)
+        return -1;
     
+    input_update(gpio, tmp);
     (*value) = gpio->pin_state[pin];
     return 0;
 }
+
+static int scan_result(gpio_t *gpio, i2c_xfer_t *xfer, uint8_t *data, int ret)
+{
+    if (i2c_async_wait(xfer) == -1)
+        return -1;
+    
+    if (input_update(gpio, (*data)) && (ret != -1))
+        ret++;
+    
+    return ret;
+}
+
+/* Reads of all expanders queued back to back, returns the ones that changed */
+int pcf8574_scan(gpio_t **gpios, int num)
+{
+    i2c_xfer_t xfer[PCF8574_SCAN_MAX];
+    uint8_t data[PCF8574_SCAN_MAX];
+    int queued;
+    int done;
+    int ret;
+    int i;
+    
+    if (!gpios)
+        return -1;
+    
+    if ((num < 1) || (num > PCF8574_SCAN_MAX))
+        return -1;
+    
+    for (i = 0; i < num; i++) {
+        if (!gpios[i])
+            return -1;
+    }
+    
+    ret = 0;
+    done = 0;
+    
+    for (i = 0; i < num; i++) {
+        xfer_setup(&xfer[i], gpios[i], I2C_SEG_READ, &data[i]);
+        
+        /* Queue full, finish an own read to make room and resubmit */
+        while ((queued = i2c_async_submit(&xfer[i])) == -1) {
+            if ((done == i) || 
+                (i2c_async_get_last_error() != I2C_ASYNC_ERR_FULL))
+                break;
+            
+            ret = scan_result(gpios[done], &xfer[done], &data[done], ret);
+            done++;
+        }
+        
+        if (queued == -1)
+            break;
+    }
+    
+    /* Not all expanders read, the caller has to scan again */
+    if (i < num)
+        ret = -1;
+    
+    num = i;
+    
+    for (; done < num; done++)
+        ret = scan_result(gpios[done], &xfer[done], &data[done], ret);
+    
+    return ret;
+}
+
+void pcf8574_int_enable(void)
+{
+    PCF8574_INT_CONFIG;
+    PCF8574_INT_ENABLE;
+}
+
+void pcf8574_int_disable(void)
+{
+    PCF8574_INT_DISABL;
+}
+
+/* INT is shared by all expanders and released by reading them */
+void pcf8574_isr(void)
+{
+    int_pending = 1;
+}
+
+/* Scan only after INT, else no bus traffic */
+int pcf8574_poll(gpio_t **gpios, int num)
+{
+    int ret;
+    
+    if (!int_pending)
+        return 0;
+    
+    int_pending = 0;
+    ret = pcf8574_scan(gpios, num);
+    
+    /* Only the falling edge interrupts, INT may still be held low */
+    if ((ret == -1) || PCF8574_INT_LOW)
+        int_pending = 1;
+    
+    return ret;
+}
+
+/* Pins changed since the last call */
+uint8_t pcf8574_get_changed(gpio_t *gpio)
+{
+    uint8_t tmp;
+    
+    if (!gpio)
+        return 0;
+    
+    tmp = gpio->changed;
+    gpio->changed = 0x00;
+    return tmp;
+}
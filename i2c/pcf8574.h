@@ -5,9 +5,9 @@
  * Project  : lib-avr
  * Author   : Copyright (C) 2018 Johannes Krottmayer <krjdev@gmail.com>
  * Created  : 2018-09-22
- * Modified : 2018-12-03
+ * Modified : 2026-10-19
  * Revised  : 
- * Version  : 0.1.1.0
+ * Version  : 0.2.0.0
  * License  : ISC (see file LICENSE.txt)
  * Target   : Atmel AVR Series
  *
@@ -22,6 +22,10 @@
 
 #include <stdint.h>
 
+#ifndef I2C_SIM
+#include <avr/io.h>
+#endif
+
 #define TYPE_PCF8574    0
 #define TYPE_PCF8574A   1
 
@@ -33,11 +37,32 @@
 
 #define NPINS           8
 
+/* Expanders per pcf8574_scan() */
+#define PCF8574_SCAN_MAX    8
+
+#ifndef I2C_SIM
+/* PCF8574 INT pin (open drain, active low, shared), external interrupt INT5 */
+#define PCF8574_INT_CONFIG  (EICRB |= (1 << ISC51))
+#define PCF8574_INT_ENABLE  (EIMSK |= (1 << INT5))
+#define PCF8574_INT_DISABL  (EIMSK &= ~(1 << INT5))
+#define PCF8574_INT_vect    INT5_vect
+#define PCF8574_INT_LOW     (!(PINE & (1 << PINE5)))
+#else
+#define PCF8574_INT_CONFIG  ((void) 0)
+#define PCF8574_INT_ENABLE  ((void) 0)
+#define PCF8574_INT_DISABL  ((void) 0)
+#define PCF8574_INT_LOW     (0)
+#endif
+
 typedef struct gpio_s {
     uint8_t addr;
     int npins;
     int pin_config[NPINS];
     int pin_state[NPINS];
+    uint8_t latch;      /* Last written port value */
+    uint8_t input;      /* Last read port value */
+    uint8_t changed;    /* Inputs changed, see pcf8574_get_changed() */
+    uint8_t dirty;      /* Staged changes not written yet */
 } gpio_t;
 
 extern gpio_t *pcf8574_init(int type, uint8_t subaddr);
@@ -49,5 +74,14 @@ extern int pcf8574_get_config(gpio_t *gpio, int pin, int *config);
 extern int pcf8574_get_npins(gpio_t *gpio);
 extern int pcf8574_set_pin(gpio_t *gpio, int pin, int value);
 extern int pcf8574_get_pin(gpio_t *gpio, int pin, int *value);
+extern int pcf8574_stage_pin(gpio_t *gpio, int pin, int value);
+extern int pcf8574_stage_port(gpio_t *gpio, uint8_t mask, uint8_t value);
+extern int pcf8574_commit(gpio_t *gpio);
+extern int pcf8574_scan(gpio_t **gpios, int num);
+extern void pcf8574_int_enable(void);
+extern void pcf8574_int_disable(void);
+extern void pcf8574_isr(void);
+extern int pcf8574_poll(gpio_t **gpios, int num);
+extern uint8_t pcf8574_get_changed(gpio_t *gpio);
 
 #endif
@@ -5,9 +5,9 @@
  * Project  : lib-avr
  * Author   : Copyright (C) 2018 Johannes Krottmayer <krjdev@gmail.com>
  * Created  : 2018-12-03
- * Modified : 
+ * Modified : 2026-10-19
  * Revised  : 
- * Version  : 0.1.0.0
+ * Version  : 0.2.0.0
  * License  : ISC (see file LICENSE.txt)
  * Target   : Atmel AVR Series
  *
@@ -17,7 +17,10 @@
  *
  */
 
-#include "i2c.h"
+#include <stdlib.h>
+#include <string.h>
+
+#include "i2c_async.h"
 #include "pcf8591.h"
 
 #define PCF8591_ADDR        0x48
@@ -40,36 +43,94 @@
 /* DAC enable bit */
 #define PCF8591_CTRL_DACE   0x40
 
-void pcf8591_init(void)
+static buffer_t *smp_buf = NULL;
+static i2c_xfer_t smp_xfer;
+static uint8_t smp_ctrl;
+static uint8_t smp_rx[1 + (PCF8591_BURST * 4)];
+static int smp_nch;
+static uint16_t smp_period;
+static volatile uint16_t smp_timer = 0;
+static pcf8591_stats_t stats;
+
+/* Analog output enabled, per subaddress, every control byte has to keep it */
+static uint8_t dac_on = 0;
+
+static uint8_t dac_flag(uint8_t subaddr)
 {
-    i2c_master_init(100000);
+    if (dac_on & (1 << (subaddr & 0x07)))
+        return PCF8591_CTRL_DACE;
+    
+    return 0;
 }
 
-int pcf8591_get_adc(uint8_t subaddr, int config, int channel, uint8_t *value)
+static int get_config(int config, uint8_t *ctrl)
 {
-    uint8_t addr;
-    uint8_t cmd;
-    int ret;
-    
-    addr = PCF8591_ADDR | subaddr;
-    
     switch (config) {
     case CONFIG_ADC0:
-        cmd = PCF8591_CTRL_CFG0;
+        (*ctrl) = PCF8591_CTRL_CFG0;
         break;
     case CONFIG_ADC1:
-        cmd = PCF8591_CTRL_CFG1;
+        (*ctrl) = PCF8591_CTRL_CFG1;
         break;
     case CONFIG_ADC2:
-        cmd = PCF8591_CTRL_CFG2;
+        (*ctrl) = PCF8591_CTRL_CFG2;
         break;
     case CONFIG_ADC3:
-        cmd = PCF8591_CTRL_CFG3;
+        (*ctrl) = PCF8591_CTRL_CFG3;
         break;
     default:
         return -1;
     }
     
+    return 0;
+}
+
+/* Control byte, repeated start, then the first byte is the previous conversion */
+static void setup_read(i2c_xfer_t *xfer, uint8_t addr, uint8_t *ctrl, uint8_t *rx, int len)
+{
+    memset(xfer, 0, sizeof(i2c_xfer_t));
+    xfer->ix_addr = addr;
+    xfer->ix_nseg = 2;
+    xfer->ix_seg[0].is_type = I2C_SEG_WRITE;
+    xfer->ix_seg[0].is_buf = ctrl;
+    xfer->ix_seg[0].is_len = 1;
+    xfer->ix_seg[1].is_type = I2C_SEG_READ;
+    xfer->ix_seg[1].is_buf = rx;
+    xfer->ix_seg[1].is_len = len;
+}
+
+void pcf8591_init(void)
+{
+    i2c_async_init(100000);
+}
+
+int pcf8591_get_channels(int config)
+{
+    switch (config) {
+    case CONFIG_ADC0:
+        return 4;
+    case CONFIG_ADC1:
+    case CONFIG_ADC2:
+        return 3;
+    case CONFIG_ADC3:
+        return 2;
+    default:
+        return -1;
+    }
+}
+
+int pcf8591_get_adc(uint8_t subaddr, int config, int channel, uint8_t *value)
+{
+    i2c_xfer_t xfer;
+    uint8_t rx[2];
+    uint8_t cmd;
+    
+    if (!value)
+        return -1;
+    
+    if (get_config(config, &cmd) == -1)
+        return -1;
+    
     switch (channel) {
     case CHANNEL_ADC0:
         cmd |= PCF8591_CTRL_CH0;
@@ -86,27 +147,133 @@ int pcf8591_get_adc(uint8_t subaddr, int config, int channel, uint8_t *value)
     default:
         return -1;
     }
-
-    ret = i2c_master_recv(addr, I2C_OPT_NORMAL, &cmd, 1, value, 1);
     
-    if (ret == -1)
+    cmd |= dac_flag(subaddr);
+    setup_read(&xfer, (PCF8591_ADDR | subaddr), &cmd, rx, 2);
+    
+    if (i2c_async_submit(&xfer) == -1)
         return -1;
     
+    if (i2c_async_wait(&xfer) == -1)
+        return -1;
+    
+    (*value) = rx[1];
     return 0;
 }
 
 int pcf8591_set_dac(uint8_t subaddr, uint8_t *value)
 {
-    uint8_t addr;
-    uint8_t cmd;
-    int ret;
+    i2c_xfer_t xfer;
+    uint8_t cmd[2];
     
-    addr = PCF8591_ADDR | subaddr;
-    cmd = PCF8591_CTRL_DACE;
-    ret = i2c_master_send(addr, I2C_OPT_NORMAL, &cmd, 1, value, 1);
+    if (!value)
+        return -1;
+    
+    cmd[0] = PCF8591_CTRL_DACE;
+    cmd[1] = (*value);
+    memset(&xfer, 0, sizeof(i2c_xfer_t));
+    xfer.ix_addr = PCF8591_ADDR | subaddr;
+    xfer.ix_nseg = 1;
+    xfer.ix_seg[0].is_type = I2C_SEG_WRITE;
+    xfer.ix_seg[0].is_buf = cmd;
+    xfer.ix_seg[0].is_len = 2;
     
-    if (ret == -1)
+    if (i2c_async_submit(&xfer) == -1)
         return -1;
     
+    if (i2c_async_wait(&xfer) == -1)
+        return -1;
+    
+    dac_on |= (1 << (subaddr & 0x07));
     return 0;
 }
+
+/* Auto increment, PCF8591_BURST frames of all channels per transaction */
+int pcf8591_sample_start(uint8_t subaddr, int config, buffer_t *buf, uint16_t period)
+{
+    if (!buf)
+        return -1;
+    
+    if (smp_buf)
+        return -1;
+    
+    if (get_config(config, &smp_ctrl) == -1)
+        return -1;
+    
+    /* Auto increment needs the analog output enabled (oscillator running) */
+    smp_ctrl |= PCF8591_CTRL_DACE | PCF8591_CTRL_AINC | PCF8591_CTRL_CH0;
+    dac_on |= (1 << (subaddr & 0x07));
+    smp_nch = pcf8591_get_channels(config);
+    setup_read(&smp_xfer, (PCF8591_ADDR | subaddr), &smp_ctrl, smp_rx, (1 + (PCF8591_BURST * smp_nch)));
+    smp_period = period;
+    smp_timer = 0;
+    smp_buf = buf;
+    return 0;
+}
+
+void pcf8591_sample_stop(void)
+{
+    if (!smp_buf)
+        return;
+    
+    /* A running transaction still reads into smp_rx */
+    if ((smp_xfer.ix_state == I2C_XFER_QUEUED) || (smp_xfer.ix_state == I2C_XFER_ACTIVE))
+        i2c_async_wait(&smp_xfer);
+    
+    smp_buf = NULL;
+}
+
+/* Main loop: frames of a finished transaction into the buffer, next one if due */
+int pcf8591_sample_poll(void)
+{
+    int cnt;
+    int i;
+    
+    if (!smp_buf)
+        return -1;
+    
+    if ((smp_xfer.ix_state == I2C_XFER_QUEUED) || (smp_xfer.ix_state == I2C_XFER_ACTIVE))
+        return 0;
+    
+    cnt = 0;
+    
+    if (smp_xfer.ix_state == I2C_XFER_DONE) {
+        for (i = 0; i < PCF8591_BURST; i++) {
+            if (buffer_get_free(smp_buf) < smp_nch) {
+                stats.ps_dropped++;
+                continue;
+            }
+            
+            buffer_wr(smp_buf, &smp_rx[1 + (i * smp_nch)], smp_nch);
+            cnt++;
+        }
+        
+        stats.ps_frames += cnt;
+        smp_xfer.ix_state = I2C_XFER_IDLE;
+    } else if (smp_xfer.ix_state == I2C_XFER_FAILED) {
+        stats.ps_errors++;
+        smp_xfer.ix_state = I2C_XFER_IDLE;
+    }
+    
+    if (smp_timer != 0)
+        return cnt;
+    
+    smp_timer = smp_period;
+    
+    if (i2c_async_submit(&smp_xfer) == -1)
+        stats.ps_errors++;
+    
+    return cnt;
+}
+
+/* Every PCF8591_TICK_MS, a period of 0 samples back to back */
+void pcf8591_sample_tick(void)
+{
+    if (smp_timer)
+        smp_timer--;
+}
+
+pcf8591_stats_t pcf8591_get_stats(void)
+{
+    return stats;
+}
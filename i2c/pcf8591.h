@@ -5,9 +5,9 @@
  * Project  : lib-avr
  * Author   : Copyright (C) 2018 Johannes Krottmayer <krjdev@gmail.com>
  * Created  : 2018-12-03
- * Modified : 
+ * Modified : 2026-10-19
  * Revised  : 
- * Version  : 0.1.0.0
+ * Version  : 0.2.0.0
  * License  : ISC (see file LICENSE.txt)
  * Target   : Atmel AVR Series
  *
@@ -22,6 +22,8 @@
 #ifndef LIBAVR_I2C_PCF8591_H
 #define LIBAVR_I2C_PCF8591_H
 
+#include "../lib/buffer.h"
+
 #define CONFIG_ADC0         0 /* Four single-ended inputs */
 #define CONFIG_ADC1         1 /* Three differential inputs */
 #define CONFIG_ADC2         2 /* Two single-ended and one differential input */
@@ -32,8 +34,23 @@
 #define CHANNEL_ADC2        2
 #define CHANNEL_ADC3        3
 
+#define PCF8591_TICK_MS     1   /* Interval of pcf8591_sample_tick() calls */
+#define PCF8591_BURST       4   /* Frames per sampling transaction */
+
+typedef struct pcf8591_stats {
+    uint32_t ps_frames;     /* Frames (one sample of every channel) buffered */
+    uint32_t ps_dropped;    /* Frames lost to a full buffer */
+    uint32_t ps_errors;
+} pcf8591_stats_t;
+
 extern void pcf8591_init(void);
 extern int pcf8591_get_adc(uint8_t subaddr, int config, int channel, uint8_t *value);
 extern int pcf8591_set_dac(uint8_t subaddr, uint8_t *value);
+extern int pcf8591_get_channels(int config);
+extern int pcf8591_sample_start(uint8_t subaddr, int config, buffer_t *buf, uint16_t period);
+extern void pcf8591_sample_stop(void);
+extern int pcf8591_sample_poll(void);
+extern void pcf8591_sample_tick(void);
+extern pcf8591_stats_t pcf8591_get_stats(void);
 
 #endif
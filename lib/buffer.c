@@ -5,9 +5,9 @@
  * Project  : lib-avr
  * Author   : Copyright (C) 2019 Johannes Krottmayer <krjdev@gmail.com>
  * Created  : 2019-08-12
- * Modified : 
+ * Modified : 2026-10-19
  * Revised  : 
- * Version  : 0.1.0.0
+ * Version  : 0.1.0.1
  * License  : ISC (see file LICENSE.txt)
  * Target   : Atmel AVR Series
  *
@@ -57,7 +57,7 @@ buffer_t *buffer_init(int len)
     return b;
 }
 
-void buffer_free(buffer_t *buf)
+void buffer_close(buffer_t *buf)
 {
     if (!buf) {
         error = BUFFER_ERROR_INVAL;
@@ -0,0 +1,628 @@
+/**
+ *
+ * File Name: dispatch.c
+ * Title    : Packet input dispatcher library
+ * Project  : lib-avr
+ * Author   : Copyright (C) 2026 Johannes Krottmayer <krjdev@gmail.com>
+ * Created  : 2026-10-19
+ * Modified : 2026-10-19
+ * Revised  : 
+ * Version  : 0.2.0.0
+ * License  : ISC (see file LICENSE.txt)
+ * Target   : Atmel AVR Series
+ *
+ * NOTE: This code is currently below version 1.0, and therefore is considered
+ * to be lacking in some functionality or documentation, or may not be fully
+ * tested. Nonetheless, you can expect most functions to work.
+ *
+ */
+
+#include <string.h>
+
+#include "nic.h"
+#include "dispatch.h"
+
+#define IPV4_HDR_LEN        20
+#define IPV4_OFF_VER        0
+#define IPV4_OFF_TLEN       2
+#define IPV4_OFF_FOFF       6
+#define IPV4_OFF_PROT       9
+#define IPV4_OFF_SRC        12
+#define IPV4_OFF_DST        16
+
+#define ETH_HDR_LEN         14
+#define UDP_OFF_CHK         6
+
+#define IPV6_HDR_LEN        40
+#define IPV6_OFF_PLEN       4
+#define IPV6_OFF_NHDR       6
+#define IPV6_OFF_DST        24
+
+typedef struct type_entry {
+    uint16_t te_type;
+    dispatch_handler_t te_handler;
+    dispatch_prot_stats_t te_stats;
+} type_entry_t;
+
+typedef struct prot_entry {
+    uint16_t pe_type;
+    uint8_t pe_prot;
+    dispatch_handler_t pe_handler;
+    dispatch_prot_stats_t pe_stats;
+} prot_entry_t;
+
+static int error = DISPATCH_ERROR_SUCCESS;
+static mac_addr_t me_mac;
+static ipv4_addr_t me_ip;
+static ipv6_addr_t me_ip6;
+static int me_ip6_valid;
+static type_entry_t type_tbl[DISPATCH_TYPE_MAX];
+static prot_entry_t prot_tbl[DISPATCH_PROT_MAX];
+static dispatch_handler_t frag_handler;
+static dispatch_stats_t stats;
+
+static type_entry_t *type_find(uint16_t type)
+{
+    int i;
+    
+    for (i = 0; i < DISPATCH_TYPE_MAX; i++) {
+        if (type_tbl[i].te_handler && (type_tbl[i].te_type == type))
+            return &type_tbl[i];
+    }
+    
+    return NULL;
+}
+
+static prot_entry_t *prot_find(uint16_t type, uint8_t prot)
+{
+    int i;
+    
+    for (i = 0; i < DISPATCH_PROT_MAX; i++) {
+        if (prot_tbl[i].pe_handler && 
+            (prot_tbl[i].pe_type == type) && 
+            (prot_tbl[i].pe_prot == prot))
+            return &prot_tbl[i];
+    }
+    
+    return NULL;
+}
+
+static int call(dispatch_handler_t handler, 
+                dispatch_prot_stats_t *st, 
+                eth_frame_t *frame)
+{
+    int ret;
+    
+    st->rx++;
+    ret = handler(frame);
+    
+    if (ret == -1)
+        st->drop++;
+    
+    return ret;
+}
+
+static int mac_accept(mac_addr_t *mac)
+{
+    /* Group bit covers broadcast and IPv4/IPv6 multicast */
+    if (mac->ma_byte0 & 0x01)
+        return 1;
+    
+    return ethernet_addr_equal(mac, &me_mac);
+}
+
+static int ipv4_accept(uint8_t *dst)
+{
+    /* Unconfigured (e.g. during DHCP), accept everything */
+    if ((me_ip.ia_byte0 | me_ip.ia_byte1 | me_ip.ia_byte2 | me_ip.ia_byte3) == 0)
+        return 1;
+    
+    /* Multicast */
+    if ((dst[0] & 0xF0) == 0xE0)
+        return 1;
+    
+    /* Limited broadcast */
+    if ((dst[0] & dst[1] & dst[2] & dst[3]) == 0xFF)
+        return 1;
+    
+    return ((dst[0] == me_ip.ia_byte0) && 
+            (dst[1] == me_ip.ia_byte1) && 
+            (dst[2] == me_ip.ia_byte2) && 
+            (dst[3] == me_ip.ia_byte3));
+}
+
+/* Multicast covers all-nodes and solicited-node addresses */
+static int ipv6_accept(uint8_t *dst)
+{
+    if ((dst[0] == 0xFF) || !me_ip6_valid)
+        return 1;
+    
+    return !memcmp(dst, &me_ip6, sizeof(ipv6_addr_t));
+}
+
+/* Returns the IP protocol, or -1 if the frame was dropped */
+static int ipv4_check(uint8_t *p, int len)
+{
+    uint32_t sum = 0;
+    uint16_t tlen;
+    int hlen;
+    int i;
+    
+    if ((len < IPV4_HDR_LEN) || ((p[IPV4_OFF_VER] >> 4) != 4)) {
+        stats.drop_hdr++;
+        return -1;
+    }
+    
+    hlen = (p[IPV4_OFF_VER] & 0x0F) * 4;
+    tlen = ((uint16_t) p[IPV4_OFF_TLEN] << 8) | p[IPV4_OFF_TLEN + 1];
+    
+    /* Frames may carry Ethernet padding, so tlen < len is fine */
+    if ((hlen < IPV4_HDR_LEN) || (tlen < hlen) || (tlen > len)) {
+        stats.drop_hdr++;
+        return -1;
+    }
+    
+    if (!ipv4_accept(&p[IPV4_OFF_DST])) {
+        stats.drop_addr++;
+        return -1;
+    }
+    
+    for (i = 0; i < hlen; i += 2)
+        sum += ((uint16_t) p[i] << 8) | p[i + 1];
+    
+    sum = (sum & 0xFFFF) + (sum >> 16);
+    sum = (sum & 0xFFFF) + (sum >> 16);
+    
+    if ((uint16_t) sum != 0xFFFF) {
+        stats.drop_chk++;
+        return -1;
+    }
+    
+    return p[IPV4_OFF_PROT];
+}
+
+/* Returns the upper-layer protocol, or -1 if the frame was dropped */
+static int ipv6_check(uint8_t *p, int len)
+{
+    uint16_t plen;
+    uint8_t prot;
+    
+    if ((len < IPV6_HDR_LEN) || ((p[0] >> 4) != 6)) {
+        stats.drop_hdr++;
+        return -1;
+    }
+    
+    plen = ((uint16_t) p[IPV6_OFF_PLEN] << 8) | p[IPV6_OFF_PLEN + 1];
+    
+    if (plen > (len - IPV6_HDR_LEN)) {
+        stats.drop_hdr++;
+        return -1;
+    }
+    
+    if (!ipv6_accept(&p[IPV6_OFF_DST])) {
+        stats.drop_addr++;
+        return -1;
+    }
+    
+    if (ipv6_ext_walk(&p[IPV6_HDR_LEN], plen, p[IPV6_OFF_NHDR], &prot) == -1) {
+        stats.drop_hdr++;
+        return -1;
+    }
+    
+    return prot;
+}
+
+#ifdef NIC_HAS_RX_OFFLOAD
+static int offload_drop(uint16_t *cnt)
+{
+    stats.rx_frm++;
+    (*cnt)++;
+    
+    if (nic_rx_drop() == -1)
+        return -1;
+    
+    return 1;
+}
+
+/* Address filter and UDP/TCP over IPv4 checksum in NIC memory, 1 if dropped there */
+static int offload_check(int len, uint8_t *attr)
+{
+    uint8_t p[ETH_HDR_LEN + IPV6_HDR_LEN];
+    mac_addr_t mac;
+    ipv4_addr_t src;
+    ipv4_addr_t dst;
+    uint32_t sum;
+    uint16_t chk;
+    uint16_t tlen;
+    int hlen;
+    int n;
+    
+    if (len < ETH_HDR_LEN)
+        return 0;
+    
+    n = (len < (int) sizeof(p)) ? len : (int) sizeof(p);
+    
+    if (nic_rx_read(0, p, n) == -1)
+        return -1;
+    
+    /* Frames for others are dropped before nic_recv() allocates them */
+    memcpy(&mac, p, sizeof(mac_addr_t));
+    
+    if (!mac_accept(&mac))
+        return offload_drop(&stats.drop_mac);
+    
+    if ((p[12] == 0x86) && (p[13] == 0xDD)) {
+        if ((n >= (ETH_HDR_LEN + IPV6_HDR_LEN)) && 
+            ((p[ETH_HDR_LEN] >> 4) == 6) && 
+            !ipv6_accept(&p[ETH_HDR_LEN + IPV6_OFF_DST]))
+            return offload_drop(&stats.drop_addr);
+        
+        return 0;
+    }
+    
+    if ((p[12] != 0x08) || (p[13] != 0x00))
+        return 0;
+    
+    if ((n >= (ETH_HDR_LEN + IPV4_HDR_LEN)) && 
+        ((p[ETH_HDR_LEN] >> 4) == 4) && 
+        !ipv4_accept(&p[ETH_HDR_LEN + IPV4_OFF_DST]))
+        return offload_drop(&stats.drop_addr);
+    
+    if (len < (ETH_HDR_LEN + IPV4_HDR_LEN + UDP_OFF_CHK + 2))
+        return 0;
+    
+    hlen = (p[ETH_HDR_LEN + IPV4_OFF_VER] & 0x0F) * 4;
+    tlen = ((uint16_t) p[ETH_HDR_LEN + IPV4_OFF_TLEN] << 8) | 
+           p[ETH_HDR_LEN + IPV4_OFF_TLEN + 1];
+    
+    /* Anything unusual is left to the software checks */
+    if (((p[ETH_HDR_LEN + IPV4_OFF_VER] >> 4) != 4) || 
+        (hlen < IPV4_HDR_LEN) || 
+        (tlen < (hlen + UDP_OFF_CHK + 2)) || 
+        ((ETH_HDR_LEN + tlen) > len) || 
+        (p[ETH_HDR_LEN + IPV4_OFF_FOFF] & 0x3F) || 
+        p[ETH_HDR_LEN + IPV4_OFF_FOFF + 1])
+        return 0;
+    
+    if ((p[ETH_HDR_LEN + IPV4_OFF_PROT] != IPV4_PROT_UDP) && 
+        (p[ETH_HDR_LEN + IPV4_OFF_PROT] != IPV4_PROT_TCP))
+        return 0;
+    
+    if (p[ETH_HDR_LEN + IPV4_OFF_PROT] == IPV4_PROT_UDP) {
+        if (nic_rx_read((ETH_HDR_LEN + hlen + UDP_OFF_CHK), 
+                        &p[ETH_HDR_LEN + IPV4_HDR_LEN], 2) == -1)
+            return -1;
+        
+        /* UDP checksum disabled by the sender */
+        if (!p[ETH_HDR_LEN + IPV4_HDR_LEN] && !p[ETH_HDR_LEN + IPV4_HDR_LEN + 1])
+            return 0;
+    }
+    
+    memcpy(&src, &p[ETH_HDR_LEN + IPV4_OFF_SRC], sizeof(ipv4_addr_t));
+    memcpy(&dst, &p[ETH_HDR_LEN + IPV4_OFF_DST], sizeof(ipv4_addr_t));
+    
+    if (nic_rx_checksum((ETH_HDR_LEN + hlen), (tlen - hlen), &chk) == -1)
+        return -1;
+    
+    /* The NIC returns the complemented sum of the segment */
+    sum = ipv4_pseudo_sum(&src, &dst, (tlen - hlen), p[ETH_HDR_LEN + IPV4_OFF_PROT]);
+    sum += (uint16_t) ~chk;
+    sum = (sum & 0xFFFF) + (sum >> 16);
+    sum = (sum & 0xFFFF) + (sum >> 16);
+    stats.rx_hwchk++;
+    
+    /* Good, the UDP/TCP decoders skip their software pass */
+    if ((uint16_t) sum == 0xFFFF) {
+        (*attr) |= ETHERNET_ATTR_L4_CHK;
+        return 0;
+    }
+    
+    return offload_drop(&stats.drop_chk);
+}
+#endif
+
+int dispatch_init(mac_addr_t *mac, ipv4_addr_t *ip, ipv6_addr_t *ip6)
+{
+    if (!mac) {
+        error = DISPATCH_ERROR_INVAL;
+        return -1;
+    }
+    
+    ethernet_addr_cpy(&me_mac, mac);
+    memset(&me_ip, 0, sizeof(ipv4_addr_t));
+    me_ip6_valid = 0;
+    
+    if (ip)
+        ipv4_addr_cpy(&me_ip, ip);
+    
+    if (ip6) {
+        ipv6_addr_cpy(&me_ip6, ip6);
+        me_ip6_valid = 1;
+    }
+    
+    memset(type_tbl, 0, sizeof(type_tbl));
+    memset(prot_tbl, 0, sizeof(prot_tbl));
+    memset(&stats, 0, sizeof(dispatch_stats_t));
+    frag_handler = NULL;
+    return 0;
+}
+
+int dispatch_register_type(uint16_t type, dispatch_handler_t handler)
+{
+    type_entry_t *te;
+    int i;
+    
+    te = type_find(type);
+    
+    /* NULL handler removes the entry */
+    if (!handler) {
+        if (!te) {
+            error = DISPATCH_ERROR_NOENT;
+            return -1;
+        }
+        
+        te->te_handler = NULL;
+        return 0;
+    }
+    
+    if (!te) {
+        for (i = 0; i < DISPATCH_TYPE_MAX; i++) {
+            if (!type_tbl[i].te_handler) {
+                te = &type_tbl[i];
+                break;
+            }
+        }
+        
+        if (!te) {
+            error = DISPATCH_ERROR_NOSLOT;
+            return -1;
+        }
+        
+        memset(te, 0, sizeof(type_entry_t));
+        te->te_type = type;
+    }
+    
+    te->te_handler = handler;
+    return 0;
+}
+
+int dispatch_register_prot(uint16_t type, uint8_t prot, dispatch_handler_t handler)
+{
+    prot_entry_t *pe;
+    int i;
+    
+    if ((type != ETHERNET_TYPE_IPV4) && (type != ETHERNET_TYPE_IPV6)) {
+        error = DISPATCH_ERROR_INVAL;
+        return -1;
+    }
+    
+    pe = prot_find(type, prot);
+    
+    /* NULL handler removes the entry */
+    if (!handler) {
+        if (!pe) {
+            error = DISPATCH_ERROR_NOENT;
+            return -1;
+        }
+        
+        pe->pe_handler = NULL;
+        return 0;
+    }
+    
+    if (!pe) {
+        for (i = 0; i < DISPATCH_PROT_MAX; i++) {
+            if (!prot_tbl[i].pe_handler) {
+                pe = &prot_tbl[i];
+                break;
+            }
+        }
+        
+        if (!pe) {
+            error = DISPATCH_ERROR_NOSLOT;
+            return -1;
+        }
+        
+        memset(pe, 0, sizeof(prot_entry_t));
+        pe->pe_type = type;
+        pe->pe_prot = prot;
+    }
+    
+    pe->pe_handler = handler;
+    return 0;
+}
+
+int dispatch_register_frag(dispatch_handler_t handler)
+{
+    frag_handler = handler;
+    return 0;
+}
+
+int dispatch_input(eth_frame_t *frame)
+{
+    type_entry_t *te;
+    prot_entry_t *pe;
+    uint8_t *p;
+    int len;
+    int prot = -1;
+    
+    if (!frame) {
+        error = DISPATCH_ERROR_INVAL;
+        return -1;
+    }
+    
+    stats.rx_frm++;
+    
+    if (!mac_accept(&frame->ef_dst)) {
+        stats.drop_mac++;
+        return 0;
+    }
+    
+    p = frame->ef_payload_buf;
+    len = frame->ef_payload_len;
+    
+    if (!p)
+        len = 0;
+    
+    /* Everything below works on the received buffer, nothing is decoded */
+    if (frame->ef_type == ETHERNET_TYPE_IPV4) {
+        prot = ipv4_check(p, len);
+        
+        if (prot == -1)
+            return 0;
+        
+        /* MF flag or fragment offset set */
+        if ((p[IPV4_OFF_FOFF] & 0x3F) || p[IPV4_OFF_FOFF + 1]) {
+            if (!frag_handler) {
+                stats.drop_frag++;
+                return 0;
+            }
+            
+            return frag_handler(frame);
+        }
+    } else if (frame->ef_type == ETHERNET_TYPE_IPV6) {
+        prot = ipv6_check(p, len);
+        
+        if (prot == -1)
+            return 0;
+    }
+    
+    if (prot != -1) {
+        pe = prot_find(frame->ef_type, (uint8_t) prot);
+        
+        if (pe)
+            return call(pe->pe_handler, &pe->pe_stats, frame);
+    }
+    
+    /* EtherType handler also catches unregistered IP protocols */
+    te = type_find(frame->ef_type);
+    
+    if (!te) {
+        stats.drop_prot++;
+        return 0;
+    }
+    
+    return call(te->te_handler, &te->te_stats, frame);
+}
+
+int dispatch_poll(void)
+{
+    eth_frame_t frame;
+    uint8_t attr = 0;
+    int ret;
+    
+#ifdef NIC_HAS_RX_OFFLOAD
+    ret = nic_rx_peek();
+    
+    if (ret == -1) {
+        error = DISPATCH_ERROR_NIC;
+        return -1;
+    }
+    
+    if (ret == 0)
+        return 0;
+    
+    /* Bad segments never leave the NIC */
+    ret = offload_check(ret, &attr);
+    
+    if (ret == -1) {
+        error = DISPATCH_ERROR_NIC;
+        return -1;
+    }
+    
+    if (ret == 1)
+        return 1;
+#endif
+
+    ret = nic_recv(&frame);
+    
+    if (ret == -1) {
+        error = DISPATCH_ERROR_NIC;
+        return -1;
+    }
+    
+    if (ret == 0)
+        return 0;
+    
+    frame.ef_attr |= attr;
+    dispatch_input(&frame);
+    ethernet_frame_payload_free(&frame);
+    return 1;
+}
+
+/* IPv4 packet of a handler's frame, keeps the NIC checksum result */
+int dispatch_frame_to_ipv4(eth_frame_t *frame, ipv4_packet_t *ip)
+{
+    if (!frame || !ip) {
+        error = DISPATCH_ERROR_INVAL;
+        return -1;
+    }
+    
+    if ((frame->ef_type != ETHERNET_TYPE_IPV4) || !frame->ef_payload_buf) {
+        error = DISPATCH_ERROR_INVAL;
+        return -1;
+    }
+    
+    if (ipv4_buf_to_pkt(frame->ef_payload_buf, frame->ef_payload_len, ip) == -1) {
+        error = DISPATCH_ERROR_IPLIB;
+        return -1;
+    }
+    
+    if (frame->ef_attr & ETHERNET_ATTR_L4_CHK)
+        ip->ip_attr |= IPV4_ATTR_L4_CHK;
+    
+    return 0;
+}
+
+dispatch_stats_t dispatch_get_stats(void)
+{
+    return stats;
+}
+
+int dispatch_get_type_stats(uint16_t type, dispatch_prot_stats_t *st)
+{
+    type_entry_t *te;
+    
+    if (!st) {
+        error = DISPATCH_ERROR_INVAL;
+        return -1;
+    }
+    
+    te = type_find(type);
+    
+    if (!te) {
+        error = DISPATCH_ERROR_NOENT;
+        return -1;
+    }
+    
+    (*st) = te->te_stats;
+    return 0;
+}
+
+int dispatch_get_prot_stats(uint16_t type, uint8_t prot, dispatch_prot_stats_t *st)
+{
+    prot_entry_t *pe;
+    
+    if (!st) {
+        error = DISPATCH_ERROR_INVAL;
+        return -1;
+    }
+    
+    pe = prot_find(type, prot);
+    
+    if (!pe) {
+        error = DISPATCH_ERROR_NOENT;
+        return -1;
+    }
+    
+    (*st) = pe->pe_stats;
+    return 0;
+}
+
+int dispatch_get_last_error(void)
+{
+    int err;
+    
+    err = error;
+    error = DISPATCH_ERROR_SUCCESS;
+    return err;
+}
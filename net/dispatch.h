@@ -0,0 +1,70 @@
+/**
+ *
+ * File Name: dispatch.h
+ * Title    : Packet input dispatcher library
+ * Project  : lib-avr
+ * Author   : Copyright (C) 2026 Johannes Krottmayer <krjdev@gmail.com>
+ * Created  : 2026-10-19
+ * Modified : 2026-10-19
+ * Revised  : 
+ * Version  : 0.2.0.0
+ * License  : ISC (see file LICENSE.txt)
+ * Target   : Atmel AVR Series
+ *
+ * NOTE: This code is currently below version 1.0, and therefore is considered
+ * to be lacking in some functionality or documentation, or may not be fully
+ * tested. Nonetheless, you can expect most functions to work.
+ *
+ */
+
+#ifndef LIBAVR_NET_DISPATCH_H
+#define LIBAVR_NET_DISPATCH_H
+
+#include <stdint.h>
+
+#include "ethernet.h"
+#include "ipv4.h"
+#include "ipv6.h"
+
+#define DISPATCH_TYPE_MAX           4   /* EtherType handlers */
+#define DISPATCH_PROT_MAX           8   /* IPv4/IPv6 protocol handlers */
+
+#define DISPATCH_ERROR_SUCCESS      0
+#define DISPATCH_ERROR_INVAL        1
+#define DISPATCH_ERROR_NOSLOT       2
+#define DISPATCH_ERROR_NOENT        3
+#define DISPATCH_ERROR_NIC          4
+#define DISPATCH_ERROR_IPLIB        5
+
+typedef struct dispatch_stats {
+    uint32_t rx_frm;        /* Frames passed to dispatch_input() */
+    uint16_t drop_mac;      /* Not for our MAC address */
+    uint16_t drop_addr;     /* Not for our IP address */
+    uint16_t drop_hdr;      /* Malformed IP header */
+    uint16_t drop_chk;      /* Bad IPv4 header checksum */
+    uint16_t drop_frag;     /* IPv4 fragment, no fragment handler */
+    uint16_t drop_prot;     /* No handler registered */
+    uint32_t rx_hwchk;      /* UDP/TCP checksums verified in the NIC */
+} dispatch_stats_t;
+
+typedef struct dispatch_prot_stats {
+    uint32_t rx;            /* Frames passed to the handler */
+    uint16_t drop;          /* Handler returned -1 */
+} dispatch_prot_stats_t;
+
+/* Input handler, the frame is already validated and freed by the caller */
+typedef int (*dispatch_handler_t)(eth_frame_t *frame);
+
+extern int dispatch_init(mac_addr_t *mac, ipv4_addr_t *ip, ipv6_addr_t *ip6);
+extern int dispatch_register_type(uint16_t type, dispatch_handler_t handler);
+extern int dispatch_register_prot(uint16_t type, uint8_t prot, dispatch_handler_t handler);
+extern int dispatch_register_frag(dispatch_handler_t handler);
+extern int dispatch_input(eth_frame_t *frame);
+extern int dispatch_poll(void);
+extern int dispatch_frame_to_ipv4(eth_frame_t *frame, ipv4_packet_t *ip);
+extern dispatch_stats_t dispatch_get_stats(void);
+extern int dispatch_get_type_stats(uint16_t type, dispatch_prot_stats_t *st);
+extern int dispatch_get_prot_stats(uint16_t type, uint8_t prot, dispatch_prot_stats_t *st);
+extern int dispatch_get_last_error(void);
+
+#endif
@@ -425,6 +425,7 @@ int ethernet_buf_to_frm(uint8_t *buf, int len, eth_frame_t *frame)
     
     /* Type */
     frame->ef_type = buf_to_uint16_be(&buf[i]);
+    frame->ef_attr = 0;
     i += 2;
     
     /* Payload/Data */
@@ -28,6 +28,9 @@
 #define ETHERNET_TYPE_IPV6          0x86DD
 #define ETHERNET_TYPE_ARP           0x0806
 
+/* Receive attributes (ef_attr) */
+#define ETHERNET_ATTR_L4_CHK        0x01    /* UDP/TCP checksum verified by the NIC */
+
 #define ETHERNET_ERROR_SUCCESS      0
 #define ETHERNET_ERROR_INVAL        1
 #define ETHERNET_ERROR_NOMEM        2
@@ -50,6 +53,7 @@ typedef struct eth_frame {
     uint16_t ef_type;
     uint8_t *ef_payload_buf;
     int ef_payload_len;
+    uint8_t ef_attr;
 } eth_frame_t;
 
 extern void ethernet_crc_enable(void);
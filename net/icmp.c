@@ -5,9 +5,9 @@
  * Project  : lib-avr
  * Author   : Copyright (C) 2019 Johannes Krottmayer <krjdev@gmail.com>
  * Created  : 2019-02-09
- * Modified : 2019-08-11
+ * Modified : 2026-10-19
  * Revised  : 
- * Version  : 0.4.0.1
+ * Version  : 0.5.0.0
  * License  : ISC (see file LICENSE.txt)
  * Target   : Atmel AVR Series
  *
@@ -29,6 +29,16 @@
 #define ICMP_UNREACH_PROT   2
 #define ICMP_UNREACH_PORT   3
 
+/* Offsets into a raw IPv4 datagram without options */
+#define IP_OFF_TTL          8
+#define IP_OFF_CHK          10
+#define IP_OFF_SRC          12
+#define IP_OFF_DST          16
+#define IP_HDR_LEN          20
+#define ICMP_OFF_CHK        2
+
+#define IP_TTL_DEFAULT      64
+
 #define HI(val)             ((uint8_t) (((val) & 0xFF00) >> 8))
 #define LO(val)             ((uint8_t) ((val) & 0x00FF))
 
@@ -95,6 +105,30 @@ static int pkt_verify_checksum(icmp_packet_t *icmp)
     return 0;
 }
 
+/* Incremental checksum update, HC' = ~(~HC + ~m + m') (RFC 1624) */
+static uint16_t chk_update(uint16_t chk, uint16_t old, uint16_t new)
+{
+    uint32_t sum;
+    
+    sum = (uint16_t) ~chk;
+    sum += (uint16_t) ~old;
+    sum += new;
+    sum = (sum & 0xFFFF) + (sum >> 16);
+    sum = (sum & 0xFFFF) + (sum >> 16);
+    return (uint16_t) ~sum;
+}
+
+static uint16_t buf_get16(uint8_t *buf)
+{
+    return (((uint16_t) buf[0] << 8) | buf[1]);
+}
+
+static void buf_set16(uint8_t *buf, uint16_t val)
+{
+    buf[0] = HI(val);
+    buf[1] = LO(val);
+}
+
 int icmp_pkt_set_type(icmp_packet_t *icmp, uint8_t type)
 {
     if (!icmp) {
@@ -420,6 +454,61 @@ int icmp_create_unreachable_port(uint8_t *buf, int len, uint16_t mtu, icmp_packe
     return 0;
 }
 
+int icmp_echo_reflect(uint8_t *buf, int len)
+{
+    uint16_t old;
+    uint16_t tlen;
+    uint8_t tmp;
+    int i;
+    
+    if (!buf) {
+        error = ICMP_ERROR_INVAL;
+        return -1;
+    }
+    
+    if (len < (IP_HDR_LEN + ICMP_HDR_LEN))
+        return 0;
+    
+    /* Plain IPv4 (no options), unfragmented, ICMP echo request only */
+    if (buf[0] != 0x45)
+        return 0;
+    
+    tlen = buf_get16(&buf[2]);
+    
+    if ((tlen < (IP_HDR_LEN + ICMP_HDR_LEN)) || (tlen > len))
+        return 0;
+    
+    if ((buf[6] & 0x3F) || buf[7])
+        return 0;
+    
+    if (buf[9] != 1)
+        return 0;
+    
+    if (buf[IP_HDR_LEN] != ICMP_TYPE_ECHOREQ)
+        return 0;
+    
+    /* Swapping the addresses doesn't change the header checksum */
+    for (i = 0; i < 4; i++) {
+        tmp = buf[IP_OFF_SRC + i];
+        buf[IP_OFF_SRC + i] = buf[IP_OFF_DST + i];
+        buf[IP_OFF_DST + i] = tmp;
+    }
+    
+    old = buf_get16(&buf[IP_OFF_TTL]);
+    buf[IP_OFF_TTL] = IP_TTL_DEFAULT;
+    buf_set16(&buf[IP_OFF_CHK], 
+              chk_update(buf_get16(&buf[IP_OFF_CHK]), old, 
+                         buf_get16(&buf[IP_OFF_TTL])));
+    
+    /* The request's checksum isn't verified, an error survives the update */
+    old = buf_get16(&buf[IP_HDR_LEN]);
+    buf[IP_HDR_LEN] = ICMP_TYPE_ECHOREP;
+    buf_set16(&buf[IP_HDR_LEN + ICMP_OFF_CHK], 
+              chk_update(buf_get16(&buf[IP_HDR_LEN + ICMP_OFF_CHK]), old, 
+                         buf_get16(&buf[IP_HDR_LEN])));
+    return 1;
+}
+
 int icmp_pkt_free(icmp_packet_t *icmp)
 {
     if (!icmp) {
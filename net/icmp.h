@@ -5,9 +5,9 @@
  * Project  : lib-avr
  * Author   : Copyright (C) 2019 Johannes Krottmayer <krjdev@gmail.com>
  * Created  : 2019-02-09
- * Modified : 2019-08-11
+ * Modified : 2026-10-19
  * Revised  : 
- * Version  : 0.4.0.1
+ * Version  : 0.5.0.0
  * License  : ISC (see file LICENSE.txt)
  * Target   : Atmel AVR Series
  *
@@ -61,6 +61,7 @@ extern int icmp_pkt_to_buf(icmp_packet_t *icmp, uint8_t *buf);
 extern int icmp_create_echo_reply(icmp_packet_t *icmp_in, icmp_packet_t *icmp_out);
 extern int icmp_create_unreachable_prot(uint8_t *buf, int len, uint16_t mtu, icmp_packet_t *icmp_out);
 extern int icmp_create_unreachable_port(uint8_t *buf, int len, uint16_t mtu, icmp_packet_t *icmp_out);
+extern int icmp_echo_reflect(uint8_t *buf, int len);
 extern int icmp_pkt_free(icmp_packet_t *icmp);
 extern int icmp_get_last_error(void);
 
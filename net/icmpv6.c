@@ -0,0 +1,544 @@
+/**
+ *
+ * File Name: icmpv6.c
+ * Title    : ICMPv6 and Neighbor Discovery library
+ * Project  : lib-avr
+ * Author   : Copyright (C) 2026 Johannes Krottmayer <krjdev@gmail.com>
+ * Created  : 2026-10-19
+ * Modified : 
+ * Revised  : 
+ * Version  : 0.1.0.0
+ * License  : ISC (see file LICENSE.txt)
+ * Target   : Atmel AVR Series
+ *
+ * NOTE: This code is currently below version 1.0, and therefore is considered
+ * to be lacking in some functionality or documentation, or may not be fully
+ * tested. Nonetheless, you can expect most functions to work.
+ *
+ */
+
+#include <string.h>
+
+#include "nic.h"
+#include "icmpv6.h"
+
+#define IPV6_HDR_LEN        40
+#define IPV6_OFF_PLEN       4
+#define IPV6_OFF_NHDR       6
+#define IPV6_OFF_HOPL       7
+#define IPV6_OFF_SRC        8
+#define IPV6_OFF_DST        24
+
+#define ICMPV6_OFF_CHK      2
+#define ND_MSG_LEN          24      /* NS/NA without options */
+#define ND_OPT_LEN          8       /* Link-layer address option */
+#define ND_OPT_SLLA         1
+#define ND_OPT_TLLA         2
+#define ND_HOPL             255
+#define ND_NA_FLAG_S        0x40
+#define ND_NA_FLAG_O        0x20
+
+#define NC_STATE_FREE       0
+#define NC_STATE_INCOMPLETE 1
+#define NC_STATE_REACHABLE  2
+#define NC_STATE_STALE      3
+
+#define HI16(val)           ((uint8_t) (((val) & 0xFF00) >> 8))
+#define LO16(val)           ((uint8_t) ((val) & 0x00FF))
+
+typedef struct nc_entry {
+    uint8_t ne_state;
+    uint8_t ne_timer;
+    uint8_t ne_probes;
+    ipv6_addr_t ne_ip;
+    mac_addr_t ne_mac;
+} nc_entry_t;
+
+static int error = ICMPV6_ERROR_SUCCESS;
+static mac_addr_t me_mac;
+static ipv6_addr_t me_ip;
+static nc_entry_t nc[ICMPV6_NC_SIZE];
+static icmpv6_stats_t stats;
+
+static const ipv6_addr_t all_nodes = {
+    0xFF, 0x02, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0x01
+};
+
+static uint32_t buf_sum(uint8_t *buf, int len)
+{
+    uint32_t sum = 0;
+    int i;
+    
+    for (i = 0; i < (len - 1); i += 2)
+        sum += ((uint16_t) buf[i] << 8) | buf[i + 1];
+    
+    if (len & 1)
+        sum += ((uint16_t) buf[len - 1] << 8);
+    
+    return sum;
+}
+
+static uint16_t sum_fold(uint32_t sum)
+{
+    sum = (sum & 0xFFFF) + (sum >> 16);
+    sum = (sum & 0xFFFF) + (sum >> 16);
+    return (uint16_t) sum;
+}
+
+/* Checksum over pseudo header and message, checksum field included */
+static uint16_t msg_sum(uint8_t *ip, uint8_t *msg, int len)
+{
+    uint32_t sum;
+    
+    sum = ipv6_pseudo_sum((ipv6_addr_t *) &ip[IPV6_OFF_SRC], 
+                          (ipv6_addr_t *) &ip[IPV6_OFF_DST],
+                          len, IPV6_NHDR_ICMPV6);
+    sum += buf_sum(msg, len);
+    return sum_fold(sum);
+}
+
+static void msg_append_checksum(uint8_t *ip, uint8_t *msg, int len)
+{
+    uint16_t chk;
+    
+    msg[ICMPV6_OFF_CHK] = 0;
+    msg[ICMPV6_OFF_CHK + 1] = 0;
+    chk = ~msg_sum(ip, msg, len);
+    msg[ICMPV6_OFF_CHK] = HI16(chk);
+    msg[ICMPV6_OFF_CHK + 1] = LO16(chk);
+}
+
+static void hdr_build(uint8_t *ip, ipv6_addr_t *src, ipv6_addr_t *dst, uint16_t plen, uint8_t hopl)
+{
+    ip[0] = 0x60;
+    ip[1] = 0;
+    ip[2] = 0;
+    ip[3] = 0;
+    ip[IPV6_OFF_PLEN] = HI16(plen);
+    ip[IPV6_OFF_PLEN + 1] = LO16(plen);
+    ip[IPV6_OFF_NHDR] = IPV6_NHDR_ICMPV6;
+    ip[IPV6_OFF_HOPL] = hopl;
+    memmove(&ip[IPV6_OFF_SRC], src, IPV6_ADDR_LEN);
+    memmove(&ip[IPV6_OFF_DST], dst, IPV6_ADDR_LEN);
+}
+
+/* 33:33 followed by the low 32 bits of the group (RFC 2464) */
+static void mac_multicast(ipv6_addr_t *ip, mac_addr_t *mac)
+{
+    mac->ma_byte0 = 0x33;
+    mac->ma_byte1 = 0x33;
+    mac->ma_byte2 = ip->ia_byte12;
+    mac->ma_byte3 = ip->ia_byte13;
+    mac->ma_byte4 = ip->ia_byte14;
+    mac->ma_byte5 = ip->ia_byte15;
+}
+
+static int frame_send(mac_addr_t *dst, uint8_t *buf, int len)
+{
+    eth_frame_t frame;
+    
+    ethernet_addr_cpy(&frame.ef_dst, dst);
+    ethernet_addr_cpy(&frame.ef_src, &me_mac);
+    frame.ef_type = ETHERNET_TYPE_IPV6;
+    frame.ef_payload_buf = buf;
+    frame.ef_payload_len = len;
+    
+    if (nic_send(&frame) == -1) {
+        error = ICMPV6_ERROR_NIC;
+        return -1;
+    }
+    
+    return 0;
+}
+
+static nc_entry_t *nc_find(ipv6_addr_t *ip)
+{
+    int i;
+    
+    for (i = 0; i < ICMPV6_NC_SIZE; i++) {
+        if ((nc[i].ne_state != NC_STATE_FREE) && 
+            (ipv6_addr_equal(&nc[i].ne_ip, ip) == 1))
+            return &nc[i];
+    }
+    
+    return NULL;
+}
+
+static nc_entry_t *nc_alloc(ipv6_addr_t *ip)
+{
+    nc_entry_t *ne = NULL;
+    int i;
+    
+    /* Free slot first, then the stale entry closest to expiry */
+    for (i = 0; i < ICMPV6_NC_SIZE; i++) {
+        if (nc[i].ne_state == NC_STATE_FREE) {
+            ne = &nc[i];
+            break;
+        }
+        
+        if ((nc[i].ne_state == NC_STATE_STALE) && 
+            (!ne || (nc[i].ne_timer < ne->ne_timer)))
+            ne = &nc[i];
+    }
+    
+    if (!ne)
+        return NULL;
+    
+    memset(ne, 0, sizeof(nc_entry_t));
+    ipv6_addr_cpy(&ne->ne_ip, ip);
+    return ne;
+}
+
+static void nc_update(ipv6_addr_t *ip, uint8_t *lla, int create)
+{
+    nc_entry_t *ne;
+    
+    ne = nc_find(ip);
+    
+    if (!ne) {
+        if (!create)
+            return;
+        
+        ne = nc_alloc(ip);
+        
+        if (!ne)
+            return;
+    }
+    
+    memcpy(&ne->ne_mac, lla, sizeof(mac_addr_t));
+    ne->ne_state = NC_STATE_REACHABLE;
+    ne->ne_timer = ICMPV6_NC_REACHABLE_TIME;
+}
+
+/* Returns the link-layer address carried in option 'type', or NULL */
+static uint8_t *nd_opt_find(uint8_t *opt, int len, uint8_t type)
+{
+    int olen;
+    
+    while (len >= 2) {
+        olen = opt[1] * 8;
+        
+        if ((olen == 0) || (olen > len))
+            return NULL;
+        
+        if ((opt[0] == type) && (olen >= ND_OPT_LEN))
+            return &opt[2];
+        
+        opt += olen;
+        len -= olen;
+    }
+    
+    return NULL;
+}
+
+static int input_echo(eth_frame_t *frame, uint8_t *ip, uint8_t *msg, int len)
+{
+    uint32_t sum;
+    uint16_t chk;
+    
+    /* Unicast only, like the IPv4 responder */
+    if (ipv6_addr_equal((ipv6_addr_t *) &ip[IPV6_OFF_DST], &me_ip) != 1)
+        return 0;
+    
+    stats.rx_echo++;
+    
+    /* Drop extension headers, the reply carries the bare message */
+    if (msg != &ip[IPV6_HDR_LEN])
+        memmove(&ip[IPV6_HDR_LEN], msg, len);
+    
+    msg = &ip[IPV6_HDR_LEN];
+    memmove(&ip[IPV6_OFF_DST], &ip[IPV6_OFF_SRC], IPV6_ADDR_LEN);
+    memmove(&ip[IPV6_OFF_SRC], &me_ip, IPV6_ADDR_LEN);
+    ip[IPV6_OFF_PLEN] = HI16(len);
+    ip[IPV6_OFF_PLEN + 1] = LO16(len);
+    ip[IPV6_OFF_NHDR] = IPV6_NHDR_ICMPV6;
+    ip[IPV6_OFF_HOPL] = 64;
+    
+    /* Swapped addresses keep the pseudo header sum, patch the type only */
+    chk = ((uint16_t) msg[ICMPV6_OFF_CHK] << 8) | msg[ICMPV6_OFF_CHK + 1];
+    sum = (uint16_t) ~chk;
+    sum += (uint16_t) ~(((uint16_t) msg[0] << 8) | msg[1]);
+    msg[0] = ICMPV6_TYPE_ECHOREP;
+    sum += ((uint16_t) msg[0] << 8) | msg[1];
+    chk = ~sum_fold(sum);
+    msg[ICMPV6_OFF_CHK] = HI16(chk);
+    msg[ICMPV6_OFF_CHK + 1] = LO16(chk);
+    ethernet_addr_cpy(&frame->ef_dst, &frame->ef_src);
+    ethernet_addr_cpy(&frame->ef_src, &me_mac);
+    frame->ef_payload_len = IPV6_HDR_LEN + len;
+    
+    if (nic_send(frame) == -1) {
+        error = ICMPV6_ERROR_NIC;
+        return -1;
+    }
+    
+    return 1;
+}
+
+static int input_ns(eth_frame_t *frame, uint8_t *ip, uint8_t *msg, int len)
+{
+    uint8_t na[IPV6_HDR_LEN + ND_MSG_LEN + ND_OPT_LEN];
+    uint8_t *p = &na[IPV6_HDR_LEN];
+    ipv6_addr_t dst;
+    mac_addr_t mac;
+    uint8_t *lla;
+    int dad;
+    
+    if ((len < ND_MSG_LEN) || (ip[IPV6_OFF_HOPL] != ND_HOPL) || msg[1])
+        return 0;
+    
+    if (ipv6_addr_equal((ipv6_addr_t *) &msg[8], &me_ip) != 1)
+        return 0;
+    
+    stats.rx_ns++;
+    dad = ipv6_addr_is_unspecified((ipv6_addr_t *) &ip[IPV6_OFF_SRC]);
+    lla = nd_opt_find(&msg[ND_MSG_LEN], len - ND_MSG_LEN, ND_OPT_SLLA);
+    
+    if (!dad && lla)
+        nc_update((ipv6_addr_t *) &ip[IPV6_OFF_SRC], lla, 1);
+    
+    /* Duplicate address detection is answered to all-nodes (RFC 4861 7.2.4) */
+    if (dad) {
+        memcpy(&dst, &all_nodes, sizeof(ipv6_addr_t));
+        mac_multicast(&dst, &mac);
+    } else {
+        memcpy(&dst, &ip[IPV6_OFF_SRC], sizeof(ipv6_addr_t));
+        ethernet_addr_cpy(&mac, &frame->ef_src);
+    }
+    
+    hdr_build(na, &me_ip, &dst, ND_MSG_LEN + ND_OPT_LEN, ND_HOPL);
+    memset(p, 0, ND_MSG_LEN + ND_OPT_LEN);
+    p[0] = ICMPV6_TYPE_NA;
+    p[4] = dad ? ND_NA_FLAG_O : (ND_NA_FLAG_S | ND_NA_FLAG_O);
+    memcpy(&p[8], &me_ip, IPV6_ADDR_LEN);
+    p[ND_MSG_LEN] = ND_OPT_TLLA;
+    p[ND_MSG_LEN + 1] = 1;
+    memcpy(&p[ND_MSG_LEN + 2], &me_mac, sizeof(mac_addr_t));
+    msg_append_checksum(na, p, ND_MSG_LEN + ND_OPT_LEN);
+    
+    if (frame_send(&mac, na, sizeof(na)) == -1)
+        return -1;
+    
+    stats.tx_na++;
+    return 1;
+}
+
+static int input_na(uint8_t *ip, uint8_t *msg, int len)
+{
+    uint8_t *lla;
+    
+    if ((len < ND_MSG_LEN) || (ip[IPV6_OFF_HOPL] != ND_HOPL) || msg[1])
+        return 0;
+    
+    stats.rx_na++;
+    lla = nd_opt_find(&msg[ND_MSG_LEN], len - ND_MSG_LEN, ND_OPT_TLLA);
+    
+    /* Unsolicited advertisements don't create entries */
+    if (lla)
+        nc_update((ipv6_addr_t *) &msg[8], lla, 0);
+    
+    return 1;
+}
+
+int icmpv6_init(mac_addr_t *src_mac, ipv6_addr_t *src_ip)
+{
+    if (!src_mac) {
+        error = ICMPV6_ERROR_INVAL;
+        return -1;
+    }
+    
+    if (!src_ip) {
+        error = ICMPV6_ERROR_INVAL;
+        return -1;
+    }
+    
+    ethernet_addr_cpy(&me_mac, src_mac);
+    ipv6_addr_cpy(&me_ip, src_ip);
+    memset(nc, 0, sizeof(nc));
+    memset(&stats, 0, sizeof(icmpv6_stats_t));
+    return 0;
+}
+
+int icmpv6_input(eth_frame_t *frame)
+{
+    ipv6_addr_t snm;
+    uint8_t *ip;
+    uint8_t *msg;
+    uint8_t proto;
+    int plen;
+    int off;
+    int len;
+    
+    if (!frame) {
+        error = ICMPV6_ERROR_INVAL;
+        return -1;
+    }
+    
+    if (frame->ef_type != ETHERNET_TYPE_IPV6)
+        return 0;
+    
+    ip = frame->ef_payload_buf;
+    
+    if (!ip || (frame->ef_payload_len < IPV6_HDR_LEN))
+        return 0;
+    
+    if ((ip[0] >> 4) != 6)
+        return 0;
+    
+    plen = ((int) ip[IPV6_OFF_PLEN] << 8) | ip[IPV6_OFF_PLEN + 1];
+    
+    if ((IPV6_HDR_LEN + plen) > frame->ef_payload_len)
+        return 0;
+    
+    /* For us: unicast, solicited-node or all-nodes */
+    ipv6_addr_solicited(&me_ip, &snm);
+    
+    if ((ipv6_addr_equal((ipv6_addr_t *) &ip[IPV6_OFF_DST], &me_ip) != 1) && 
+        (ipv6_addr_equal((ipv6_addr_t *) &ip[IPV6_OFF_DST], &snm) != 1) && 
+        (ipv6_addr_equal((ipv6_addr_t *) &ip[IPV6_OFF_DST], (ipv6_addr_t *) &all_nodes) != 1))
+        return 0;
+    
+    off = ipv6_ext_walk(&ip[IPV6_HDR_LEN], plen, ip[IPV6_OFF_NHDR], &proto);
+    
+    if ((off == -1) || (proto != IPV6_NHDR_ICMPV6))
+        return 0;
+    
+    msg = &ip[IPV6_HDR_LEN + off];
+    len = plen - off;
+    
+    if (len < 4)
+        return 0;
+    
+    if (msg_sum(ip, msg, len) != 0xFFFF) {
+        stats.rx_err++;
+        error = ICMPV6_ERROR_CHKSUM;
+        return -1;
+    }
+    
+    switch (msg[0]) {
+    case ICMPV6_TYPE_ECHOREQ:
+        return input_echo(frame, ip, msg, len);
+    case ICMPV6_TYPE_NS:
+        return input_ns(frame, ip, msg, len);
+    case ICMPV6_TYPE_NA:
+        return input_na(ip, msg, len);
+    default:
+        break;
+    }
+    
+    return 0;
+}
+
+int icmpv6_solicit(ipv6_addr_t *target)
+{
+    uint8_t ns[IPV6_HDR_LEN + ND_MSG_LEN + ND_OPT_LEN];
+    uint8_t *p = &ns[IPV6_HDR_LEN];
+    ipv6_addr_t snm;
+    mac_addr_t mac;
+    
+    if (!target) {
+        error = ICMPV6_ERROR_INVAL;
+        return -1;
+    }
+    
+    ipv6_addr_solicited(target, &snm);
+    mac_multicast(&snm, &mac);
+    hdr_build(ns, &me_ip, &snm, ND_MSG_LEN + ND_OPT_LEN, ND_HOPL);
+    memset(p, 0, ND_MSG_LEN + ND_OPT_LEN);
+    p[0] = ICMPV6_TYPE_NS;
+    memcpy(&p[8], target, IPV6_ADDR_LEN);
+    p[ND_MSG_LEN] = ND_OPT_SLLA;
+    p[ND_MSG_LEN + 1] = 1;
+    memcpy(&p[ND_MSG_LEN + 2], &me_mac, sizeof(mac_addr_t));
+    msg_append_checksum(ns, p, ND_MSG_LEN + ND_OPT_LEN);
+    
+    if (frame_send(&mac, ns, sizeof(ns)) == -1)
+        return -1;
+    
+    stats.tx_ns++;
+    return 0;
+}
+
+int icmpv6_nc_resolve(ipv6_addr_t *ip, mac_addr_t *mac)
+{
+    nc_entry_t *ne;
+    
+    if (!ip) {
+        error = ICMPV6_ERROR_INVAL;
+        return -1;
+    }
+    
+    if (!mac) {
+        error = ICMPV6_ERROR_INVAL;
+        return -1;
+    }
+    
+    if (ipv6_addr_is_multicast(ip) == 1) {
+        mac_multicast(ip, mac);
+        return 1;
+    }
+    
+    ne = nc_find(ip);
+    
+    if (ne) {
+        if (ne->ne_state == NC_STATE_INCOMPLETE)
+            return 0;
+        
+        ethernet_addr_cpy(mac, &ne->ne_mac);
+        return 1;
+    }
+    
+    /* Unknown, start resolution; the caller retries */
+    ne = nc_alloc(ip);
+    
+    if (!ne) {
+        error = ICMPV6_ERROR_UNKNOWN;
+        return -1;
+    }
+    
+    ne->ne_state = NC_STATE_INCOMPLETE;
+    ne->ne_timer = ICMPV6_NC_RETRANS_TIME;
+    ne->ne_probes = 1;
+    
+    if (icmpv6_solicit(ip) == -1)
+        return -1;
+    
+    return 0;
+}
+
+void icmpv6_tick(void)
+{
+    int i;
+    
+    for (i = 0; i < ICMPV6_NC_SIZE; i++) {
+        if ((nc[i].ne_state == NC_STATE_FREE) || (nc[i].ne_state == NC_STATE_STALE))
+            continue;
+        
+        if (nc[i].ne_timer && --nc[i].ne_timer)
+            continue;
+        
+        if (nc[i].ne_state == NC_STATE_REACHABLE) {
+            nc[i].ne_state = NC_STATE_STALE;
+        } else if (nc[i].ne_probes < ICMPV6_NC_MAX_SOLICIT) {
+            nc[i].ne_probes++;
+            nc[i].ne_timer = ICMPV6_NC_RETRANS_TIME;
+            icmpv6_solicit(&nc[i].ne_ip);
+        } else {
+            nc[i].ne_state = NC_STATE_FREE;
+        }
+    }
+}
+
+icmpv6_stats_t icmpv6_get_stats(void)
+{
+    return stats;
+}
+
+int icmpv6_get_last_error(void)
+{
+    int err;
+    
+    err = error;
+    error = ICMPV6_ERROR_SUCCESS;
+    return err;
+}
@@ -0,0 +1,61 @@
+/**
+ *
+ * File Name: icmpv6.h
+ * Title    : ICMPv6 and Neighbor Discovery library
+ * Project  : lib-avr
+ * Author   : Copyright (C) 2026 Johannes Krottmayer <krjdev@gmail.com>
+ * Created  : 2026-10-19
+ * Modified : 
+ * Revised  : 
+ * Version  : 0.1.0.0
+ * License  : ISC (see file LICENSE.txt)
+ * Target   : Atmel AVR Series
+ *
+ * NOTE: This code is currently below version 1.0, and therefore is considered
+ * to be lacking in some functionality or documentation, or may not be fully
+ * tested. Nonetheless, you can expect most functions to work.
+ *
+ */
+
+#ifndef LIBAVR_NET_ICMPV6_H
+#define LIBAVR_NET_ICMPV6_H
+
+#include <stdint.h>
+
+#include "ethernet.h"
+#include "ipv6.h"
+
+#define ICMPV6_ERROR_SUCCESS        0
+#define ICMPV6_ERROR_INVAL          1
+#define ICMPV6_ERROR_CHKSUM         2
+#define ICMPV6_ERROR_UNKNOWN        3
+#define ICMPV6_ERROR_NIC            4
+
+#define ICMPV6_TYPE_ECHOREQ         128
+#define ICMPV6_TYPE_ECHOREP         129
+#define ICMPV6_TYPE_NS              135
+#define ICMPV6_TYPE_NA              136
+
+#define ICMPV6_NC_SIZE              4       /* Neighbor cache entries */
+#define ICMPV6_NC_REACHABLE_TIME    30      /* Ticks (icmpv6_tick) */
+#define ICMPV6_NC_RETRANS_TIME      1       /* Ticks between solicitations */
+#define ICMPV6_NC_MAX_SOLICIT       3
+
+typedef struct icmpv6_stats {
+    uint16_t rx_echo;
+    uint16_t rx_ns;
+    uint16_t rx_na;
+    uint16_t rx_err;
+    uint16_t tx_ns;
+    uint16_t tx_na;
+} icmpv6_stats_t;
+
+extern int icmpv6_init(mac_addr_t *src_mac, ipv6_addr_t *src_ip);
+extern int icmpv6_input(eth_frame_t *frame);
+extern int icmpv6_solicit(ipv6_addr_t *target);
+extern int icmpv6_nc_resolve(ipv6_addr_t *ip, mac_addr_t *mac);
+extern void icmpv6_tick(void);
+extern icmpv6_stats_t icmpv6_get_stats(void);
+extern int icmpv6_get_last_error(void);
+
+#endif
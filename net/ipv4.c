@@ -5,9 +5,9 @@
  * Project  : lib-avr
  * Author   : Copyright (C) 2018-2019 Johannes Krottmayer <krjdev@gmail.com>
  * Created  : 2018-09-24
- * Modified : 2019-08-11
+ * Modified : 2026-10-19
  * Revised  : 
- * Version  : 0.7.0.0
+ * Version  : 0.8.1.0
  * License  : ISC (see file LICENSE.txt)
  * Target   : Atmel AVR Series
  *
@@ -31,26 +31,68 @@
 
 static int error = IPV4_ERROR_SUCCESS;
 
+/* RFC 6890 special-purpose ranges, sorted by descending prefix length */
 ipv4_range_t rfc6890[] = {
-    { { 0, 0, 0, 0 }, 8 }, 
-    { { 10, 0, 0, 0 }, 8 }, 
-    { { 100, 64, 0, 0 }, 10 }, 
-    { { 127, 0, 0, 0 }, 8 }, 
-    { { 169, 254, 0, 0 }, 16 }, 
-    { { 172, 16, 0, 0 }, 12 }, 
-    { { 192, 0, 0, 0 }, 24 }, 
+    { { 255, 255, 255, 255 }, 32 }, 
     { { 192, 0, 0, 0 }, 29 }, 
+    { { 192, 0, 0, 0 }, 24 }, 
     { { 192, 0, 2, 0 }, 24 }, 
     { { 192, 88, 99, 0 }, 24 }, 
-    { { 192, 168, 0, 0 }, 16 }, 
-    { { 198, 18, 0, 0 }, 15 },
     { { 198, 51, 100, 0 }, 24 }, 
     { { 203, 0, 113, 0 }, 24 }, 
+    { { 169, 254, 0, 0 }, 16 }, 
+    { { 192, 168, 0, 0 }, 16 }, 
+    { { 198, 18, 0, 0 }, 15 }, 
+    { { 172, 16, 0, 0 }, 12 }, 
+    { { 100, 64, 0, 0 }, 10 }, 
+    { { 0, 0, 0, 0 }, 8 }, 
+    { { 10, 0, 0, 0 }, 8 }, 
+    { { 127, 0, 0, 0 }, 8 }, 
     { { 224, 0, 0, 0 }, 4 }, 
-    { { 240, 0, 0, 0 }, 4 },
-    { { 255, 255, 255, 255 }, 32 }
+    { { 240, 0, 0, 0 }, 4 }
 };
 
+static const uint8_t rfc6890_class[] = {
+    IPV4_ADDR_BROADCAST, 
+    IPV4_ADDR_IETF, 
+    IPV4_ADDR_IETF, 
+    IPV4_ADDR_DOC, 
+    IPV4_ADDR_6TO4, 
+    IPV4_ADDR_DOC, 
+    IPV4_ADDR_DOC, 
+    IPV4_ADDR_LINKLOCAL, 
+    IPV4_ADDR_PRIVATE, 
+    IPV4_ADDR_BENCH, 
+    IPV4_ADDR_PRIVATE, 
+    IPV4_ADDR_SHARED, 
+    IPV4_ADDR_THIS_NET, 
+    IPV4_ADDR_PRIVATE, 
+    IPV4_ADDR_LOOPBACK, 
+    IPV4_ADDR_MULTICAST, 
+    IPV4_ADDR_RESERVED
+};
+
+#define RFC6890_NUM     (sizeof(rfc6890) / sizeof(ipv4_range_t))
+
+static uint32_t addr_to_u32(ipv4_addr_t *ia)
+{
+    return (((uint32_t) ia->ia_byte0 << 24) | 
+            ((uint32_t) ia->ia_byte1 << 16) | 
+            ((uint32_t) ia->ia_byte2 << 8) | 
+            (uint32_t) ia->ia_byte3);
+}
+
+static uint32_t suf_to_mask(uint8_t suf)
+{
+    if (suf == 0)
+        return 0;
+    
+    if (suf >= 32)
+        return 0xFFFFFFFF;
+    
+    return (0xFFFFFFFF << (32 - suf));
+}
+
 static uint32_t pkt_hdr_sum(ipv4_packet_t *ip)
 {
     int i = 0;
@@ -285,6 +327,93 @@ int ipv4_addr_is_localhost(ipv4_addr_t *ia)
     return 0;
 }
 
+int ipv4_range_match(ipv4_range_t *ir, ipv4_addr_t *ia)
+{
+    uint32_t mask;
+    
+    if (!ir) {
+        error = IPV4_ERROR_INVAL;
+        return -1;
+    }
+    
+    if (!ia) {
+        error = IPV4_ERROR_INVAL;
+        return -1;
+    }
+    
+    mask = suf_to_mask(ir->ir_suf);
+    
+    if ((addr_to_u32(ia) & mask) == (addr_to_u32(&ir->ir_ip) & mask))
+        return 1;
+    
+    return 0;
+}
+
+int ipv4_range_lookup(ipv4_range_t *tbl, int num, ipv4_addr_t *ia)
+{
+    uint32_t addr;
+    uint32_t mask;
+    int i;
+    
+    if (!tbl) {
+        error = IPV4_ERROR_INVAL;
+        return -1;
+    }
+    
+    if (!ia) {
+        error = IPV4_ERROR_INVAL;
+        return -1;
+    }
+    
+    addr = addr_to_u32(ia);
+    
+    /* Table is sorted by descending prefix length, first hit is longest */
+    for (i = 0; i < num; i++) {
+        mask = suf_to_mask(tbl[i].ir_suf);
+        
+        if ((addr & mask) == (addr_to_u32(&tbl[i].ir_ip) & mask))
+            return i;
+    }
+    
+    return -1;
+}
+
+int ipv4_addr_classify(ipv4_addr_t *ia)
+{
+    int i;
+    
+    if (!ia) {
+        error = IPV4_ERROR_INVAL;
+        return -1;
+    }
+    
+    i = ipv4_range_lookup(rfc6890, RFC6890_NUM, ia);
+    
+    if (i == -1)
+        return IPV4_ADDR_GLOBAL;
+    
+    return rfc6890_class[i];
+}
+
+uint32_t ipv4_pseudo_sum(ipv4_addr_t *src, 
+                         ipv4_addr_t *dst, 
+                         uint16_t len, 
+                         uint8_t prot)
+{
+    uint32_t sum = 0;
+    
+    if (!src || !dst)
+        return 0;
+    
+    sum += ((uint16_t) src->ia_byte0 << 8) | src->ia_byte1;
+    sum += ((uint16_t) src->ia_byte2 << 8) | src->ia_byte3;
+    sum += ((uint16_t) dst->ia_byte0 << 8) | dst->ia_byte1;
+    sum += ((uint16_t) dst->ia_byte2 << 8) | dst->ia_byte3;
+    sum += prot;
+    sum += len;
+    return sum;
+}
+
 int ipv4_pkt_create_empty(ipv4_packet_t *ip, uint8_t flag, uint16_t foff)
 {
     if (!ip) {
@@ -306,6 +435,7 @@ int ipv4_pkt_create_empty(ipv4_packet_t *ip, uint8_t flag, uint16_t foff)
     ip->ip_options_len = 0;
     ip->ip_payload_buf = NULL;
     ip->ip_payload_len = 0;
+    ip->ip_attr = 0;
     pkt_hdr_append_checksum(ip);
     return 0;
 }
@@ -733,6 +863,7 @@ int ipv4_buf_to_pkt(uint8_t *buf, int len, ipv4_packet_t *ip)
     }
     
     /* Header */
+    ip->ip_attr = 0;
     ip->ip_hdr.ih_ver = (buf[i] >> 4);
     ip->ip_hdr.ih_ihl = buf[i++] & 0x0F;
     ip->ip_hdr.ih_dscp = (buf[i] >> 6);
@@ -5,9 +5,9 @@
  * Project  : lib-avr
  * Author   : Copyright (C) 2018-2019 Johannes Krottmayer <krjdev@gmail.com>
  * Created  : 2018-09-24
- * Modified : 2019-08-11
+ * Modified : 2026-10-19
  * Revised  : 
- * Version  : 0.7.0.0
+ * Version  : 0.8.1.0
  * License  : ISC (see file LICENSE.txt)
  * Target   : Atmel AVR Series
  *
@@ -34,7 +34,25 @@
 #define IPV4_PROT_UDP           17
 
 #define IPV4_FLAG_DF            0x2
-#define IPV4_FLAG_MF            0x4
+#define IPV4_FLAG_MF            0x1
+
+/* Receive attributes (ip_attr) */
+#define IPV4_ATTR_L4_CHK        0x01    /* UDP/TCP checksum verified by the NIC */
+
+/* Address classes (RFC 6890) */
+#define IPV4_ADDR_GLOBAL        0
+#define IPV4_ADDR_THIS_NET      1
+#define IPV4_ADDR_PRIVATE       2
+#define IPV4_ADDR_SHARED        3
+#define IPV4_ADDR_LOOPBACK      4
+#define IPV4_ADDR_LINKLOCAL     5
+#define IPV4_ADDR_IETF          6
+#define IPV4_ADDR_DOC           7
+#define IPV4_ADDR_6TO4          8
+#define IPV4_ADDR_BENCH         9
+#define IPV4_ADDR_MULTICAST     10
+#define IPV4_ADDR_RESERVED      11
+#define IPV4_ADDR_BROADCAST     12
 
 typedef struct ipv4_addr {
     uint8_t ia_byte0;
@@ -70,6 +88,7 @@ typedef struct ipv4_packet {
     int ip_options_len;
     uint8_t *ip_payload_buf;
     int ip_payload_len;
+    uint8_t ip_attr;
 } ipv4_packet_t;
 
 extern int ipv4_addr_aton(const char *str, ipv4_addr_t *ia);
@@ -78,6 +97,10 @@ extern int ipv4_addr_equal(ipv4_addr_t *ia1, ipv4_addr_t *ia2);
 extern int ipv4_addr_cpy(ipv4_addr_t *ia_dst, ipv4_addr_t *ia_src);
 extern int ipv4_addr_is_broadcast(ipv4_addr_t *ia);
 extern int ipv4_addr_is_localhost(ipv4_addr_t *ia);
+extern int ipv4_addr_classify(ipv4_addr_t *ia);
+extern int ipv4_range_match(ipv4_range_t *ir, ipv4_addr_t *ia);
+extern int ipv4_range_lookup(ipv4_range_t *tbl, int num, ipv4_addr_t *ia);
+extern uint32_t ipv4_pseudo_sum(ipv4_addr_t *src, ipv4_addr_t *dst, uint16_t len, uint8_t prot);
 extern int ipv4_pkt_create_empty(ipv4_packet_t *ip, uint8_t flag, uint16_t foff);
 extern int ipv4_pkt_free(ipv4_packet_t *ip);
 extern int ipv4_pkt_is_df(ipv4_packet_t *ip);
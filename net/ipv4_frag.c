@@ -0,0 +1,467 @@
+/**
+ *
+ * File Name: ipv4_frag.c
+ * Title    : IPv4 fragmentation and reassembly library
+ * Project  : lib-avr
+ * Author   : Copyright (C) 2026 Johannes Krottmayer <krjdev@gmail.com>
+ * Created  : 2026-10-19
+ * Modified : 
+ * Revised  : 
+ * Version  : 0.1.0.0
+ * License  : ISC (see file LICENSE.txt)
+ * Target   : Atmel AVR Series
+ *
+ * NOTE: This code is currently below version 1.0, and therefore is considered
+ * to be lacking in some functionality or documentation, or may not be fully
+ * tested. Nonetheless, you can expect most functions to work.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "ipv4_frag.h"
+
+#define IPV4_HDR_LEN    20
+
+#define HOLE_INF        0xFFFF
+
+typedef struct frag_hole {
+    uint16_t fh_first;
+    uint16_t fh_last;
+} frag_hole_t;
+
+typedef struct frag_ctx {
+    uint8_t fc_used;
+    uint8_t fc_timer;
+    uint16_t fc_id;
+    uint8_t fc_prot;
+    ipv4_addr_t fc_src;
+    ipv4_addr_t fc_dst;
+    uint8_t fc_ttl;
+    uint8_t fc_dscp;
+    uint8_t *fc_buf;
+    uint16_t fc_size;       /* Allocated bytes */
+    uint16_t fc_len;        /* Total payload length, 0 = last not seen */
+    uint8_t fc_nholes;
+    frag_hole_t fc_hole[IPV4_FRAG_HOLE_MAX];
+} frag_ctx_t;
+
+static int error = IPV4_FRAG_ERROR_SUCCESS;
+static frag_ctx_t ctx[IPV4_FRAG_CTX_MAX];
+static uint16_t mem_used = 0;
+static uint16_t frag_id = 0;
+static ipv4_frag_stats_t stats;
+
+static void ctx_free(frag_ctx_t *fc)
+{
+    if (fc->fc_buf) {
+        free(fc->fc_buf);
+        mem_used -= fc->fc_size;
+    }
+    
+    fc->fc_buf = NULL;
+    fc->fc_size = 0;
+    fc->fc_used = 0;
+}
+
+static frag_ctx_t *ctx_find(ipv4_packet_t *ip)
+{
+    frag_ctx_t *fc_free = NULL;
+    int i;
+    
+    for (i = 0; i < IPV4_FRAG_CTX_MAX; i++) {
+        if (!ctx[i].fc_used) {
+            if (!fc_free)
+                fc_free = &ctx[i];
+            
+            continue;
+        }
+        
+        if ((ctx[i].fc_id == ip->ip_hdr.ih_id) && 
+            (ctx[i].fc_prot == ip->ip_hdr.ih_prot) && 
+            ipv4_addr_equal(&ctx[i].fc_src, &ip->ip_hdr.ih_src) && 
+            ipv4_addr_equal(&ctx[i].fc_dst, &ip->ip_hdr.ih_dst))
+            return &ctx[i];
+    }
+    
+    if (!fc_free)
+        return NULL;
+    
+    /* New reassembly, one hole covering everything (RFC 815) */
+    fc_free->fc_used = 1;
+    fc_free->fc_timer = IPV4_FRAG_TIMEOUT;
+    fc_free->fc_id = ip->ip_hdr.ih_id;
+    fc_free->fc_prot = ip->ip_hdr.ih_prot;
+    ipv4_addr_cpy(&fc_free->fc_src, &ip->ip_hdr.ih_src);
+    ipv4_addr_cpy(&fc_free->fc_dst, &ip->ip_hdr.ih_dst);
+    fc_free->fc_ttl = ip->ip_hdr.ih_ttl;
+    fc_free->fc_dscp = ip->ip_hdr.ih_dscp;
+    fc_free->fc_buf = NULL;
+    fc_free->fc_size = 0;
+    fc_free->fc_len = 0;
+    fc_free->fc_nholes = 1;
+    fc_free->fc_hole[0].fh_first = 0;
+    fc_free->fc_hole[0].fh_last = HOLE_INF;
+    return fc_free;
+}
+
+/* Memory cap reached, drop the other reassembly closest to its timeout */
+static int ctx_evict(frag_ctx_t *keep)
+{
+    frag_ctx_t *fc = NULL;
+    int i;
+    
+    for (i = 0; i < IPV4_FRAG_CTX_MAX; i++) {
+        if (!ctx[i].fc_used || (&ctx[i] == keep) || !ctx[i].fc_buf)
+            continue;
+        
+        if (!fc || (ctx[i].fc_timer < fc->fc_timer))
+            fc = &ctx[i];
+    }
+    
+    if (!fc)
+        return -1;
+    
+    ctx_free(fc);
+    stats.rx_evict++;
+    return 0;
+}
+
+/* One buffer per datagram, exact if the last fragment came first, else the bound */
+static int ctx_alloc(frag_ctx_t *fc)
+{
+    uint16_t size;
+    
+    if (fc->fc_buf)
+        return 0;
+    
+    size = fc->fc_len ? fc->fc_len : IPV4_FRAG_DGRAM_MAX;
+    
+    while ((mem_used + size) > IPV4_FRAG_MEM_MAX) {
+        if (ctx_evict(fc) == -1)
+            return -1;
+    }
+    
+    fc->fc_buf = (uint8_t *) malloc(size);
+    
+    if (!fc->fc_buf)
+        return -1;
+    
+    mem_used += size;
+    fc->fc_size = size;
+    return 0;
+}
+
+static int hole_update(frag_ctx_t *fc, uint16_t first, uint16_t last, int mf)
+{
+    frag_hole_t h;
+    int i;
+    
+    for (i = 0; i < fc->fc_nholes; i++) {
+        h = fc->fc_hole[i];
+        
+        if ((first > h.fh_last) || (last < h.fh_first))
+            continue;
+        
+        /* Fragment overlaps hole: delete it, re-add the uncovered parts */
+        fc->fc_hole[i] = fc->fc_hole[--fc->fc_nholes];
+        i--;
+        
+        if (first > h.fh_first) {
+            if (fc->fc_nholes == IPV4_FRAG_HOLE_MAX)
+                return -1;
+            
+            fc->fc_hole[fc->fc_nholes].fh_first = h.fh_first;
+            fc->fc_hole[fc->fc_nholes].fh_last = first - 1;
+            fc->fc_nholes++;
+        }
+        
+        if ((last < h.fh_last) && mf) {
+            if (fc->fc_nholes == IPV4_FRAG_HOLE_MAX)
+                return -1;
+            
+            fc->fc_hole[fc->fc_nholes].fh_first = last + 1;
+            fc->fc_hole[fc->fc_nholes].fh_last = h.fh_last;
+            fc->fc_nholes++;
+        }
+    }
+    
+    return 0;
+}
+
+static int frag_send(ipv4_packet_t *ip, 
+                     uint8_t flag, 
+                     uint16_t off, 
+                     uint8_t *buf, 
+                     int len, 
+                     ipv4_frag_output_t output)
+{
+    ipv4_packet_t frag;
+    int ret;
+    
+    ipv4_pkt_create_empty(&frag, flag, off / 8);
+    frag.ip_hdr.ih_dscp = ip->ip_hdr.ih_dscp;
+    frag.ip_hdr.ih_ecn = ip->ip_hdr.ih_ecn;
+    ipv4_pkt_set_id(&frag, ip->ip_hdr.ih_id);
+    ipv4_pkt_set_ttl(&frag, ip->ip_hdr.ih_ttl);
+    ipv4_pkt_set_prot(&frag, ip->ip_hdr.ih_prot);
+    ipv4_pkt_set_src(&frag, &ip->ip_hdr.ih_src);
+    ipv4_pkt_set_dst(&frag, &ip->ip_hdr.ih_dst);
+    
+    /* Options are only carried in the first fragment */
+    if ((off == 0) && (ip->ip_options_len > 0)) {
+        if (ipv4_pkt_set_options(&frag, ip->ip_options_buf, ip->ip_options_len) == -1) {
+            error = IPV4_FRAG_ERROR_NOMEM;
+            return -1;
+        }
+    }
+    
+    if (ipv4_pkt_set_payload(&frag, buf, len) == -1) {
+        ipv4_pkt_free(&frag);
+        error = IPV4_FRAG_ERROR_NOMEM;
+        return -1;
+    }
+    
+    ret = output(&frag);
+    ipv4_pkt_free(&frag);
+    
+    if (ret == -1) {
+        error = IPV4_FRAG_ERROR_OUTPUT;
+        return -1;
+    }
+    
+    stats.tx_frag++;
+    return 0;
+}
+
+void ipv4_frag_init(void)
+{
+    int i;
+    
+    for (i = 0; i < IPV4_FRAG_CTX_MAX; i++) {
+        if (ctx[i].fc_used)
+            ctx_free(&ctx[i]);
+    }
+    
+    mem_used = 0;
+    memset(&stats, 0, sizeof(ipv4_frag_stats_t));
+}
+
+int ipv4_frag_output(ipv4_packet_t *ip, int mtu, ipv4_frag_output_t output)
+{
+    int hlen;
+    int chunk;
+    int off = 0;
+    int len;
+    int n = 0;
+    
+    if (!ip) {
+        error = IPV4_FRAG_ERROR_INVAL;
+        return -1;
+    }
+    
+    if (!output) {
+        error = IPV4_FRAG_ERROR_INVAL;
+        return -1;
+    }
+    
+    /* Fits, send unmodified */
+    if (ip->ip_hdr.ih_tlen <= mtu) {
+        if (output(ip) == -1) {
+            error = IPV4_FRAG_ERROR_OUTPUT;
+            return -1;
+        }
+        
+        return 1;
+    }
+    
+    if (ip->ip_hdr.ih_flag & IPV4_FLAG_DF) {
+        error = IPV4_FRAG_ERROR_DF;
+        return -1;
+    }
+    
+    /* Worst case is the first fragment carrying the options */
+    hlen = IPV4_HDR_LEN + ip->ip_options_len;
+    chunk = (mtu - hlen) & ~7;
+    
+    if (chunk < 8) {
+        error = IPV4_FRAG_ERROR_INVAL;
+        return -1;
+    }
+    
+    if (!ip->ip_payload_buf) {
+        error = IPV4_FRAG_ERROR_INTERNAL;
+        return -1;
+    }
+    
+    if (!ip->ip_hdr.ih_id)
+        ip->ip_hdr.ih_id = ++frag_id;
+    
+    while (off < ip->ip_payload_len) {
+        len = ip->ip_payload_len - off;
+        
+        if (len > chunk) {
+            if (frag_send(ip, IPV4_FLAG_MF, off, &ip->ip_payload_buf[off], chunk, output) == -1)
+                return -1;
+            
+            off += chunk;
+        } else {
+            if (frag_send(ip, 0, off, &ip->ip_payload_buf[off], len, output) == -1)
+                return -1;
+            
+            off += len;
+        }
+        
+        n++;
+    }
+    
+    return n;
+}
+
+int ipv4_frag_input(ipv4_packet_t *ip, ipv4_packet_t *ip_out)
+{
+    frag_ctx_t *fc;
+    uint16_t first;
+    uint16_t last;
+    int mf;
+    
+    if (!ip) {
+        error = IPV4_FRAG_ERROR_INVAL;
+        return -1;
+    }
+    
+    if (!ip_out) {
+        error = IPV4_FRAG_ERROR_INVAL;
+        return -1;
+    }
+    
+    mf = (ip->ip_hdr.ih_flag & IPV4_FLAG_MF) ? 1 : 0;
+    
+    /* Not a fragment */
+    if (!mf && !ip->ip_hdr.ih_foff) {
+        error = IPV4_FRAG_ERROR_INVAL;
+        return -1;
+    }
+    
+    if ((ip->ip_payload_len < 1) || !ip->ip_payload_buf) {
+        error = IPV4_FRAG_ERROR_INVAL;
+        stats.rx_drop++;
+        return -1;
+    }
+    
+    /* Every fragment but the last carries a multiple of 8 bytes */
+    if (mf && (ip->ip_payload_len & 7)) {
+        error = IPV4_FRAG_ERROR_INVAL;
+        stats.rx_drop++;
+        return -1;
+    }
+    
+    first = ip->ip_hdr.ih_foff * 8;
+    
+    if (((uint32_t) first + ip->ip_payload_len) > IPV4_FRAG_DGRAM_MAX) {
+        error = IPV4_FRAG_ERROR_TOOBIG;
+        stats.rx_drop++;
+        return -1;
+    }
+    
+    last = first + ip->ip_payload_len - 1;
+    fc = ctx_find(ip);
+    
+    if (!fc) {
+        error = IPV4_FRAG_ERROR_NOCTX;
+        stats.rx_drop++;
+        return -1;
+    }
+    
+    if (!mf) {
+        if (fc->fc_len && (fc->fc_len != (last + 1))) {
+            ctx_free(fc);
+            error = IPV4_FRAG_ERROR_INVAL;
+            stats.rx_drop++;
+            return -1;
+        }
+        
+        fc->fc_len = last + 1;
+    } else if (fc->fc_len && (last >= fc->fc_len)) {
+        /* Beyond the end set by the last fragment, also beyond an exact buffer */
+        ctx_free(fc);
+        error = IPV4_FRAG_ERROR_INVAL;
+        stats.rx_drop++;
+        return -1;
+    }
+    
+    if (ctx_alloc(fc) == -1) {
+        ctx_free(fc);
+        error = IPV4_FRAG_ERROR_NOMEM;
+        stats.rx_drop++;
+        return -1;
+    }
+    
+    if (hole_update(fc, first, last, mf) == -1) {
+        ctx_free(fc);
+        error = IPV4_FRAG_ERROR_HOLES;
+        stats.rx_drop++;
+        return -1;
+    }
+    
+    memcpy(&fc->fc_buf[first], ip->ip_payload_buf, ip->ip_payload_len);
+    stats.rx_frag++;
+    
+    if (first == 0) {
+        fc->fc_ttl = ip->ip_hdr.ih_ttl;
+        fc->fc_dscp = ip->ip_hdr.ih_dscp;
+    }
+    
+    if (fc->fc_nholes > 0)
+        return 0;
+    
+    /* Complete, hand the buffer over to the caller */
+    ipv4_pkt_create_empty(ip_out, 0, 0);
+    ip_out->ip_hdr.ih_dscp = fc->fc_dscp;
+    ipv4_pkt_set_id(ip_out, fc->fc_id);
+    ipv4_pkt_set_ttl(ip_out, fc->fc_ttl);
+    ipv4_pkt_set_prot(ip_out, fc->fc_prot);
+    ipv4_pkt_set_src(ip_out, &fc->fc_src);
+    ip_out->ip_payload_buf = fc->fc_buf;
+    ip_out->ip_payload_len = fc->fc_len;
+    ip_out->ip_hdr.ih_tlen += fc->fc_len;
+    
+    /* Last setter updates the header checksum */
+    ipv4_pkt_set_dst(ip_out, &fc->fc_dst);
+    mem_used -= fc->fc_size;
+    fc->fc_buf = NULL;
+    fc->fc_size = 0;
+    fc->fc_used = 0;
+    stats.rx_reasm++;
+    return 1;
+}
+
+void ipv4_frag_tick(void)
+{
+    int i;
+    
+    for (i = 0; i < IPV4_FRAG_CTX_MAX; i++) {
+        if (!ctx[i].fc_used)
+            continue;
+        
+        if (--ctx[i].fc_timer == 0) {
+            ctx_free(&ctx[i]);
+            stats.rx_timeout++;
+        }
+    }
+}
+
+ipv4_frag_stats_t ipv4_frag_get_stats(void)
+{
+    return stats;
+}
+
+int ipv4_frag_get_last_error(void)
+{
+    int err;
+    
+    err = error;
+    error = IPV4_FRAG_ERROR_SUCCESS;
+    return err;
+}
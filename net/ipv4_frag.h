@@ -0,0 +1,73 @@
+/**
+ *
+ * File Name: ipv4_frag.h
+ * Title    : IPv4 fragmentation and reassembly library
+ * Project  : lib-avr
+ * Author   : Copyright (C) 2026 Johannes Krottmayer <krjdev@gmail.com>
+ * Created  : 2026-10-19
+ * Modified : 
+ * Revised  : 
+ * Version  : 0.1.0.0
+ * License  : ISC (see file LICENSE.txt)
+ * Target   : Atmel AVR Series
+ *
+ * NOTE: This code is currently below version 1.0, and therefore is considered
+ * to be lacking in some functionality or documentation, or may not be fully
+ * tested. Nonetheless, you can expect most functions to work.
+ *
+ */
+
+#ifndef LIBAVR_NET_IPV4_FRAG_H
+#define LIBAVR_NET_IPV4_FRAG_H
+
+#include <stdint.h>
+
+#include "ipv4.h"
+
+#define IPV4_FRAG_CTX_MAX           2       /* Concurrent reassemblies */
+#define IPV4_FRAG_HOLE_MAX          8       /* Hole descriptors per context */
+#define IPV4_FRAG_TIMEOUT           15      /* Ticks (ipv4_frag_tick) */
+
+/* Heap limits, sized for 8 KB SRAM; override with -D for bigger datagrams */
+#ifndef IPV4_FRAG_DGRAM_MAX
+#define IPV4_FRAG_DGRAM_MAX         1480    /* Max. reassembled payload, allocated per reassembly */
+#endif
+
+#ifndef IPV4_FRAG_MEM_MAX
+#define IPV4_FRAG_MEM_MAX           2960    /* Max. heap, above it the oldest other reassembly is dropped */
+#endif
+
+#if IPV4_FRAG_DGRAM_MAX > IPV4_FRAG_MEM_MAX
+#error "IPV4_FRAG_DGRAM_MAX must not exceed IPV4_FRAG_MEM_MAX"
+#endif
+
+#define IPV4_FRAG_ERROR_SUCCESS     0
+#define IPV4_FRAG_ERROR_INVAL       1
+#define IPV4_FRAG_ERROR_NOMEM       2
+#define IPV4_FRAG_ERROR_NOCTX       3
+#define IPV4_FRAG_ERROR_TOOBIG      4
+#define IPV4_FRAG_ERROR_HOLES       5
+#define IPV4_FRAG_ERROR_DF          6
+#define IPV4_FRAG_ERROR_OUTPUT      7
+#define IPV4_FRAG_ERROR_INTERNAL    8
+
+typedef struct ipv4_frag_stats {
+    uint16_t rx_frag;       /* Fragments accepted */
+    uint16_t rx_reasm;      /* Datagrams reassembled */
+    uint16_t rx_drop;       /* Fragments dropped (no context, memory, ...) */
+    uint16_t rx_timeout;    /* Reassemblies timed out */
+    uint16_t rx_evict;      /* Reassemblies dropped for memory */
+    uint16_t tx_frag;       /* Fragments sent */
+} ipv4_frag_stats_t;
+
+/* Transmit hook, sends a complete IPv4 packet (e.g. Ethernet + nic_send) */
+typedef int (*ipv4_frag_output_t)(ipv4_packet_t *ip);
+
+extern void ipv4_frag_init(void);
+extern int ipv4_frag_output(ipv4_packet_t *ip, int mtu, ipv4_frag_output_t output);
+extern int ipv4_frag_input(ipv4_packet_t *ip, ipv4_packet_t *ip_out);
+extern void ipv4_frag_tick(void);
+extern ipv4_frag_stats_t ipv4_frag_get_stats(void);
+extern int ipv4_frag_get_last_error(void);
+
+#endif
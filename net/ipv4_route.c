@@ -0,0 +1,224 @@
+/**
+ *
+ * File Name: ipv4_route.c
+ * Title    : IPv4 routing table library
+ * Project  : lib-avr
+ * Author   : Copyright (C) 2026 Johannes Krottmayer <krjdev@gmail.com>
+ * Created  : 2026-10-19
+ * Modified : 
+ * Revised  : 
+ * Version  : 0.1.0.0
+ * License  : ISC (see file LICENSE.txt)
+ * Target   : Atmel AVR Series
+ *
+ * NOTE: This code is currently below version 1.0, and therefore is considered
+ * to be lacking in some functionality or documentation, or may not be fully
+ * tested. Nonetheless, you can expect most functions to work.
+ *
+ */
+
+#include <string.h>
+
+#include "ipv4_route.h"
+
+static int error = IPV4_ROUTE_ERROR_SUCCESS;
+
+/* Sorted by descending prefix length, see ipv4_range_lookup() */
+static ipv4_range_t rt_dst[IPV4_ROUTE_MAX];
+static ipv4_addr_t rt_gw[IPV4_ROUTE_MAX];
+static uint8_t rt_flags[IPV4_ROUTE_MAX];
+static int rt_num = 0;
+
+static int route_find(ipv4_addr_t *dst, uint8_t suf)
+{
+    int i;
+    
+    for (i = 0; i < rt_num; i++) {
+        if ((rt_dst[i].ir_suf == suf) && 
+            ipv4_addr_equal(&rt_dst[i].ir_ip, dst))
+            return i;
+    }
+    
+    return -1;
+}
+
+/* Network address of dst/suf, host bits cleared */
+static void net_mask(ipv4_addr_t *net, ipv4_addr_t *dst, uint8_t suf)
+{
+    uint8_t *p;
+    int i;
+    
+    ipv4_addr_cpy(net, dst);
+    p = (uint8_t *) net;
+    
+    for (i = 0; i < 4; i++) {
+        if (suf >= 8) {
+            suf -= 8;
+            continue;
+        }
+        
+        p[i] &= (uint8_t) (0xFF << (8 - suf));
+        suf = 0;
+    }
+}
+
+void ipv4_route_init(void)
+{
+    rt_num = 0;
+}
+
+int ipv4_route_add(ipv4_addr_t *dst, uint8_t suf, ipv4_addr_t *gw)
+{
+    ipv4_addr_t net;
+    int i;
+    
+    if (!dst) {
+        error = IPV4_ROUTE_ERROR_INVAL;
+        return -1;
+    }
+    
+    if (suf > 32) {
+        error = IPV4_ROUTE_ERROR_INVAL;
+        return -1;
+    }
+    
+    /* 10.1.2.3/8 is stored as 10.0.0.0/8, no duplicates per network */
+    net_mask(&net, dst, suf);
+    
+    if (route_find(&net, suf) != -1) {
+        error = IPV4_ROUTE_ERROR_EXIST;
+        return -1;
+    }
+    
+    if (rt_num == IPV4_ROUTE_MAX) {
+        error = IPV4_ROUTE_ERROR_FULL;
+        return -1;
+    }
+    
+    /* Insertion sort, keep longer prefixes in front */
+    for (i = rt_num; (i > 0) && (rt_dst[i - 1].ir_suf < suf); i--) {
+        rt_dst[i] = rt_dst[i - 1];
+        rt_gw[i] = rt_gw[i - 1];
+        rt_flags[i] = rt_flags[i - 1];
+    }
+    
+    ipv4_addr_cpy(&rt_dst[i].ir_ip, &net);
+    rt_dst[i].ir_suf = suf;
+    
+    if (gw) {
+        ipv4_addr_cpy(&rt_gw[i], gw);
+        rt_flags[i] = IPV4_ROUTE_GATEWAY;
+    } else {
+        memset(&rt_gw[i], 0, sizeof(ipv4_addr_t));
+        rt_flags[i] = IPV4_ROUTE_ONLINK;
+    }
+    
+    rt_num++;
+    return 0;
+}
+
+int ipv4_route_del(ipv4_addr_t *dst, uint8_t suf)
+{
+    ipv4_addr_t net;
+    int i;
+    
+    if (!dst) {
+        error = IPV4_ROUTE_ERROR_INVAL;
+        return -1;
+    }
+    
+    if (suf > 32) {
+        error = IPV4_ROUTE_ERROR_INVAL;
+        return -1;
+    }
+    
+    net_mask(&net, dst, suf);
+    i = route_find(&net, suf);
+    
+    if (i == -1) {
+        error = IPV4_ROUTE_ERROR_NOENT;
+        return -1;
+    }
+    
+    for (rt_num--; i < rt_num; i++) {
+        rt_dst[i] = rt_dst[i + 1];
+        rt_gw[i] = rt_gw[i + 1];
+        rt_flags[i] = rt_flags[i + 1];
+    }
+    
+    return 0;
+}
+
+int ipv4_route_set_default(ipv4_addr_t *gw)
+{
+    ipv4_addr_t any = { 0, 0, 0, 0 };
+    
+    if (!gw) {
+        error = IPV4_ROUTE_ERROR_INVAL;
+        return -1;
+    }
+    
+    if (route_find(&any, 0) != -1)
+        ipv4_route_del(&any, 0);
+    
+    return ipv4_route_add(&any, 0, gw);
+}
+
+int ipv4_route_lookup(ipv4_addr_t *dst, ipv4_addr_t *nexthop)
+{
+    int i;
+    
+    if (!dst) {
+        error = IPV4_ROUTE_ERROR_INVAL;
+        return -1;
+    }
+    
+    if (!nexthop) {
+        error = IPV4_ROUTE_ERROR_INVAL;
+        return -1;
+    }
+    
+    /* Never forwarded to a gateway */
+    switch (ipv4_addr_classify(dst)) {
+    case IPV4_ADDR_BROADCAST:
+    case IPV4_ADDR_MULTICAST:
+    case IPV4_ADDR_LINKLOCAL:
+    case IPV4_ADDR_LOOPBACK:
+        ipv4_addr_cpy(nexthop, dst);
+        return IPV4_ROUTE_ONLINK;
+    case IPV4_ADDR_THIS_NET:
+    case IPV4_ADDR_RESERVED:
+        error = IPV4_ROUTE_ERROR_NOROUTE;
+        return -1;
+    default:
+        break;
+    }
+    
+    i = ipv4_range_lookup(rt_dst, rt_num, dst);
+    
+    if (i == -1) {
+        error = IPV4_ROUTE_ERROR_NOROUTE;
+        return -1;
+    }
+    
+    if (rt_flags[i] == IPV4_ROUTE_GATEWAY)
+        ipv4_addr_cpy(nexthop, &rt_gw[i]);
+    else
+        ipv4_addr_cpy(nexthop, dst);
+    
+    return rt_flags[i];
+}
+
+int ipv4_route_get_num(void)
+{
+    return rt_num;
+}
+
+int ipv4_route_get_last_error(void)
+{
+    int err;
+    
+    err = error;
+    error = IPV4_ROUTE_ERROR_SUCCESS;
+    return err;
+}
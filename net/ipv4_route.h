@@ -0,0 +1,48 @@
+/**
+ *
+ * File Name: ipv4_route.h
+ * Title    : IPv4 routing table library
+ * Project  : lib-avr
+ * Author   : Copyright (C) 2026 Johannes Krottmayer <krjdev@gmail.com>
+ * Created  : 2026-10-19
+ * Modified : 
+ * Revised  : 
+ * Version  : 0.1.0.0
+ * License  : ISC (see file LICENSE.txt)
+ * Target   : Atmel AVR Series
+ *
+ * NOTE: This code is currently below version 1.0, and therefore is considered
+ * to be lacking in some functionality or documentation, or may not be fully
+ * tested. Nonetheless, you can expect most functions to work.
+ *
+ */
+
+#ifndef LIBAVR_NET_IPV4_ROUTE_H
+#define LIBAVR_NET_IPV4_ROUTE_H
+
+#include <stdint.h>
+
+#include "ipv4.h"
+
+#define IPV4_ROUTE_MAX              8
+
+#define IPV4_ROUTE_ERROR_SUCCESS    0
+#define IPV4_ROUTE_ERROR_INVAL      1
+#define IPV4_ROUTE_ERROR_FULL       2
+#define IPV4_ROUTE_ERROR_EXIST      3
+#define IPV4_ROUTE_ERROR_NOENT      4
+#define IPV4_ROUTE_ERROR_NOROUTE    5
+
+/* ipv4_route_lookup() return values */
+#define IPV4_ROUTE_ONLINK           0
+#define IPV4_ROUTE_GATEWAY          1
+
+extern void ipv4_route_init(void);
+extern int ipv4_route_add(ipv4_addr_t *dst, uint8_t suf, ipv4_addr_t *gw);
+extern int ipv4_route_del(ipv4_addr_t *dst, uint8_t suf);
+extern int ipv4_route_set_default(ipv4_addr_t *gw);
+extern int ipv4_route_lookup(ipv4_addr_t *dst, ipv4_addr_t *nexthop);
+extern int ipv4_route_get_num(void);
+extern int ipv4_route_get_last_error(void);
+
+#endif
@@ -5,9 +5,9 @@
  * Project  : lib-avr
  * Author   : Copyright (C) 2019 Johannes Krottmayer <krjdev@gmail.com>
  * Created  : 2019-08-04
- * Modified : 2019-08-05
+ * Modified : 2026-10-19
  * Revised  : 
- * Version  : 0.1.1.0
+ * Version  : 0.2.0.0
  * License  : ISC (see file LICENSE.txt)
  * Target   : Atmel AVR Series
  *
@@ -65,24 +65,151 @@ int ipv6_addr_cpy(ipv6_addr_t *ia_dst, ipv6_addr_t *ia_src)
         return -1;
     
     ia_dst->ia_byte00 = ia_src->ia_byte00;
-    ia_dst->ia_byte00 = ia_src->ia_byte01;
-    ia_dst->ia_byte00 = ia_src->ia_byte02;
-    ia_dst->ia_byte00 = ia_src->ia_byte03;
-    ia_dst->ia_byte00 = ia_src->ia_byte04;
-    ia_dst->ia_byte00 = ia_src->ia_byte05;
-    ia_dst->ia_byte00 = ia_src->ia_byte06;
-    ia_dst->ia_byte00 = ia_src->ia_byte07;
-    ia_dst->ia_byte00 = ia_src->ia_byte08;
-    ia_dst->ia_byte00 = ia_src->ia_byte09;
-    ia_dst->ia_byte00 = ia_src->ia_byte10;
-    ia_dst->ia_byte00 = ia_src->ia_byte11;
-    ia_dst->ia_byte00 = ia_src->ia_byte12;
-    ia_dst->ia_byte00 = ia_src->ia_byte13;
-    ia_dst->ia_byte00 = ia_src->ia_byte14;
-    ia_dst->ia_byte00 = ia_src->ia_byte15;
+    ia_dst->ia_byte01 = ia_src->ia_byte01;
+    ia_dst->ia_byte02 = ia_src->ia_byte02;
+    ia_dst->ia_byte03 = ia_src->ia_byte03;
+    ia_dst->ia_byte04 = ia_src->ia_byte04;
+    ia_dst->ia_byte05 = ia_src->ia_byte05;
+    ia_dst->ia_byte06 = ia_src->ia_byte06;
+    ia_dst->ia_byte07 = ia_src->ia_byte07;
+    ia_dst->ia_byte08 = ia_src->ia_byte08;
+    ia_dst->ia_byte09 = ia_src->ia_byte09;
+    ia_dst->ia_byte10 = ia_src->ia_byte10;
+    ia_dst->ia_byte11 = ia_src->ia_byte11;
+    ia_dst->ia_byte12 = ia_src->ia_byte12;
+    ia_dst->ia_byte13 = ia_src->ia_byte13;
+    ia_dst->ia_byte14 = ia_src->ia_byte14;
+    ia_dst->ia_byte15 = ia_src->ia_byte15;
     return 0;
 }
 
+int ipv6_addr_is_multicast(ipv6_addr_t *ia)
+{
+    if (!ia)
+        return -1;
+    
+    if (ia->ia_byte00 == 0xFF)
+        return 1;
+    
+    return 0;
+}
+
+int ipv6_addr_is_unspecified(ipv6_addr_t *ia)
+{
+    uint8_t *p;
+    int i;
+    
+    if (!ia)
+        return -1;
+    
+    p = (uint8_t *) ia;
+    
+    for (i = 0; i < IPV6_ADDR_LEN; i++) {
+        if (p[i])
+            return 0;
+    }
+    
+    return 1;
+}
+
+int ipv6_addr_solicited(ipv6_addr_t *ia, ipv6_addr_t *ia_snm)
+{
+    if (!ia)
+        return -1;
+    
+    if (!ia_snm)
+        return -1;
+    
+    /* ff02::1:ffXX:XXXX, low 24 bits of the unicast address (RFC 4291) */
+    memset(ia_snm, 0, sizeof(ipv6_addr_t));
+    ia_snm->ia_byte00 = 0xFF;
+    ia_snm->ia_byte01 = 0x02;
+    ia_snm->ia_byte11 = 0x01;
+    ia_snm->ia_byte12 = 0xFF;
+    ia_snm->ia_byte13 = ia->ia_byte13;
+    ia_snm->ia_byte14 = ia->ia_byte14;
+    ia_snm->ia_byte15 = ia->ia_byte15;
+    return 0;
+}
+
+uint32_t ipv6_pseudo_sum(ipv6_addr_t *src, 
+                         ipv6_addr_t *dst, 
+                         uint32_t len, 
+                         uint8_t nhdr)
+{
+    uint32_t sum = 0;
+    uint8_t *p;
+    int i;
+    
+    if (!src || !dst)
+        return 0;
+    
+    p = (uint8_t *) src;
+    
+    for (i = 0; i < IPV6_ADDR_LEN; i += 2)
+        sum += ((uint16_t) p[i] << 8) | p[i + 1];
+    
+    p = (uint8_t *) dst;
+    
+    for (i = 0; i < IPV6_ADDR_LEN; i += 2)
+        sum += ((uint16_t) p[i] << 8) | p[i + 1];
+    
+    sum += (uint16_t) (len >> 16);
+    sum += (uint16_t) (len & 0xFFFF);
+    sum += nhdr;
+    return sum;
+}
+
+int ipv6_ext_walk(uint8_t *buf, int len, uint8_t nhdr, uint8_t *proto)
+{
+    int off = 0;
+    int hlen;
+    
+    if (!buf)
+        return -1;
+    
+    if (!proto)
+        return -1;
+    
+    for (;;) {
+        switch (nhdr) {
+        case IPV6_NHDR_HOPOPT:
+            /* Only allowed directly after the IPv6 header (RFC 8200) */
+            if (off != 0)
+                return -1;
+            /* fall through */
+        case IPV6_NHDR_ROUTING:
+        case IPV6_NHDR_DSTOPTS:
+            if ((off + 2) > len)
+                return -1;
+            
+            hlen = (buf[off + 1] + 1) * 8;
+            break;
+        case IPV6_NHDR_FRAG:
+            if ((off + 8) > len)
+                return -1;
+            
+            /* Offset or M flag set, not an atomic fragment: stop here */
+            if (buf[off + 2] || (buf[off + 3] & 0xF9)) {
+                (*proto) = IPV6_NHDR_FRAG;
+                return off;
+            }
+            
+            hlen = 8;
+            break;
+        default:
+            (*proto) = nhdr;
+            return off;
+        }
+        
+        if ((off + hlen) > len)
+            return -1;
+        
+        nhdr = buf[off];
+        off += hlen;
+    }
+}
+
 int ipv6_pkt_set_flow(ipv6_packet_t *ip, uint32_t flow)
 {
     if (!ip)
@@ -130,6 +257,8 @@ int ipv6_pkt_set_dst(ipv6_packet_t *ip, ipv6_addr_t *dst)
 
 int ipv6_pkt_set_payload(ipv6_packet_t *ip, uint8_t *buf, int len)
 {
+    uint8_t *p;
+    
     if (!ip)
         return -1;
     
@@ -139,9 +268,20 @@ int ipv6_pkt_set_payload(ipv6_packet_t *ip, uint8_t *buf, int len)
     if (len < 1)
         return -1;
     
+    p = (uint8_t *) malloc(len);
+    
+    if (!p)
+        return -1;
+    
+    memcpy(p, buf, len);
+    
+    /* Replaces the payload of a reused packet */
+    if (ip->ip_payload_buf)
+        free(ip->ip_payload_buf);
+    
     ip->ip_hdr.ih_plen = len;
+    ip->ip_payload_buf = p;
     ip->ip_payload_len = len;
-    memcpy(ip->ip_payload_buf, buf, ip->ip_payload_len); 
     return 0;
 }
 
@@ -215,6 +355,10 @@ int ipv6_pkt_create_empty(ipv6_packet_t *ip)
     ip->ip_hdr.ih_ver = 6;
     ip->ip_hdr.ih_ecn = 0;
     ip->ip_hdr.ih_dscp = 0;
+    ip->ip_hdr.ih_flow = 0;
+    ip->ip_hdr.ih_plen = 0;
+    ip->ip_hdr.ih_nhdr = IPV6_NHDR_NONE;
+    ip->ip_hdr.ih_hopl = 64;
     ip->ip_payload_buf = NULL;
     ip->ip_payload_len = 0;
     return 0;
@@ -267,9 +411,11 @@ int ipv6_buf_to_pkt(uint8_t *buf, int len, ipv6_packet_t *ip)
     if (ip->ip_hdr.ih_ver != 6)
         return -1;
     
-    ip->ip_hdr.ih_ecn = ((tmp8 >> 2) & 0x03);
     tmp32 = buf[i++];
-    ip->ip_hdr.ih_dscp = (((tmp8 << 4) & 0x30) | ((uint8_t) tmp32 >> 4));
+    
+    /* Traffic class spans both bytes: DSCP (6 bit), ECN (2 bit) */
+    ip->ip_hdr.ih_dscp = (((tmp8 << 2) & 0x3C) | ((uint8_t) tmp32 >> 6));
+    ip->ip_hdr.ih_ecn = (((uint8_t) tmp32 >> 4) & 0x03);
     tmp32 = ((tmp32 << 16) & 0x0F0000);
     tmp8 = buf[i++];
     tmp32 |= ((uint32_t) tmp8 << 8);
@@ -338,15 +484,15 @@ int ipv6_pkt_to_buf(ipv6_packet_t *ip, uint8_t *buf)
 {
     int i = 0;
     
-    if (ip)
+    if (!ip)
         return -1;
     
-    if (buf)
+    if (!buf)
         return -1;
     
     /* Header */
-    buf[i++] = ((ip->ip_hdr.ih_ver << 4) | (ip->ip_hdr.ih_ecn << 2) | (ip->ip_hdr.ih_dscp >> 4));
-    buf[i++] = ((ip->ip_hdr.ih_dscp << 6) | (ip->ip_hdr.ih_flow >> 16));
+    buf[i++] = ((ip->ip_hdr.ih_ver << 4) | (ip->ip_hdr.ih_dscp >> 2));
+    buf[i++] = ((ip->ip_hdr.ih_dscp << 6) | (ip->ip_hdr.ih_ecn << 4) | (ip->ip_hdr.ih_flow >> 16));
     buf[i++] = ((ip->ip_hdr.ih_flow >> 8) & 0xFF);
     buf[i++] = (ip->ip_hdr.ih_flow & 0xFF);
     buf[i++] = HI16(ip->ip_hdr.ih_plen);
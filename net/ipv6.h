@@ -5,9 +5,9 @@
  * Project  : lib-avr
  * Author   : Copyright (C) 2019 Johannes Krottmayer <krjdev@gmail.com>
  * Created  : 2019-08-04
- * Modified : 2019-08-05
+ * Modified : 2026-10-19
  * Revised  : 
- * Version  : 0.1.1.0
+ * Version  : 0.2.0.0
  * License  : ISC (see file LICENSE.txt)
  * Target   : Atmel AVR Series
  *
@@ -22,8 +22,16 @@
 
 #include <stdint.h>
 
-#define IPV6_NHDR_TCP   6
-#define IPV6_NHDR_UDP   17
+#define IPV6_ADDR_LEN       16
+
+#define IPV6_NHDR_HOPOPT    0
+#define IPV6_NHDR_TCP       6
+#define IPV6_NHDR_UDP       17
+#define IPV6_NHDR_ROUTING   43
+#define IPV6_NHDR_FRAG      44
+#define IPV6_NHDR_ICMPV6    58
+#define IPV6_NHDR_NONE      59
+#define IPV6_NHDR_DSTOPTS   60
 
 typedef struct ipv6_addr {
     uint8_t ia_byte00;
@@ -64,6 +72,11 @@ typedef struct ipv6_packet {
 
 extern int ipv6_addr_equal(ipv6_addr_t *ia1, ipv6_addr_t *ia2);
 extern int ipv6_addr_cpy(ipv6_addr_t *ia_dst, ipv6_addr_t *ia_src);
+extern int ipv6_addr_is_multicast(ipv6_addr_t *ia);
+extern int ipv6_addr_is_unspecified(ipv6_addr_t *ia);
+extern int ipv6_addr_solicited(ipv6_addr_t *ia, ipv6_addr_t *ia_snm);
+extern uint32_t ipv6_pseudo_sum(ipv6_addr_t *src, ipv6_addr_t *dst, uint32_t len, uint8_t nhdr);
+extern int ipv6_ext_walk(uint8_t *buf, int len, uint8_t nhdr, uint8_t *proto);
 extern int ipv6_pkt_set_flow(ipv6_packet_t *ip, uint32_t flow);
 extern int ipv6_pkt_set_nhdr(ipv6_packet_t *ip, uint8_t nhdr);
 extern int ipv6_pkt_set_hopl(ipv6_packet_t *ip, uint8_t hopl);
@@ -5,9 +5,9 @@
  * Project  : lib-avr
  * Author   : Copyright (C) 2019 Johannes Krottmayer <krjdev@gmail.com>
  * Created  : 2019-06-02
- * Modified : 
+ * Modified : 2026-10-19
  * Revised  : 
- * Version  : 0.1.0.0
+ * Version  : 0.3.0.0
  * License  : ISC (see file LICENSE.txt)
  * Target   : Atmel AVR Series
  *
@@ -19,7 +19,11 @@
 
 #include "nic.h"
 
-#ifdef NIC_DEVICE_ENC28J60
+#if defined(NIC_DEVICE_TAP)
+#include "nic_tap.h"
+#elif defined(NIC_DEVICE_PCAP)
+#include "nic_pcap.h"
+#elif defined(NIC_DEVICE_ENC28J60)
 #include "../spi/enc28j60.h"
 #endif
 
@@ -29,7 +33,31 @@ int nic_init(mac_addr_t *addr)
 {
     int ret;
     
-#ifdef NIC_DEVICE_ENC28J60
+#if defined(NIC_DEVICE_TAP)
+    ret = nic_tap_init(NIC_TAP_IFNAME, addr);
+    
+    if (ret == -1) {
+        switch (nic_tap_get_last_error()) {
+        case NIC_TAP_ERROR_INVAL:
+            error = NIC_ERROR_INVAL;
+            break;
+        default:
+            error = NIC_ERROR_DRIVER;
+        }
+    }
+#elif defined(NIC_DEVICE_PCAP)
+    ret = nic_pcap_init(NIC_PCAP_FILE_RX, NIC_PCAP_FILE_TX, addr);
+    
+    if (ret == -1) {
+        switch (nic_pcap_get_last_error()) {
+        case NIC_PCAP_ERROR_INVAL:
+            error = NIC_ERROR_INVAL;
+            break;
+        default:
+            error = NIC_ERROR_DRIVER;
+        }
+    }
+#elif defined(NIC_DEVICE_ENC28J60)
     ret = enc28j60_init(ENC28J60_MODE_FDPX, addr);
     
     if (ret == -1) {
@@ -50,7 +78,14 @@ int nic_is_link_up(void)
 {
     int ret;
     
-#ifdef NIC_DEVICE_ENC28J60
+#if defined(NIC_DEVICE_TAP)
+    ret = nic_tap_is_link_up();
+    
+    if (ret == -1)
+        error = NIC_ERROR_DRIVER;
+#elif defined(NIC_DEVICE_PCAP)
+    ret = nic_pcap_is_link_up();
+#elif defined(NIC_DEVICE_ENC28J60)
     ret = enc28j60_is_link_up();
     
     if (ret == -1)
@@ -64,7 +99,49 @@ int nic_send(eth_frame_t *frame)
 {
     int ret;
     
-#ifdef NIC_DEVICE_ENC28J60
+#if defined(NIC_DEVICE_TAP)
+    ret = nic_tap_send(frame);
+    
+    if (ret == -1) {
+        switch (nic_tap_get_last_error()) {
+        case NIC_TAP_ERROR_INVAL:
+            error = NIC_ERROR_INVAL;
+            break;
+        case NIC_TAP_ERROR_NOMEM:
+            error = NIC_ERROR_NOMEM;
+            break;
+        case NIC_TAP_ERROR_ETHLIB:
+            error = NIC_ERROR_ETHLIB;
+            break;
+        case NIC_TAP_ERROR_FRMTB:
+            error = NIC_ERROR_TX_TOBIG;
+            break;
+        default:
+            error = NIC_ERROR_DRIVER;
+        }
+    }
+#elif defined(NIC_DEVICE_PCAP)
+    ret = nic_pcap_send(frame);
+    
+    if (ret == -1) {
+        switch (nic_pcap_get_last_error()) {
+        case NIC_PCAP_ERROR_INVAL:
+            error = NIC_ERROR_INVAL;
+            break;
+        case NIC_PCAP_ERROR_NOMEM:
+            error = NIC_ERROR_NOMEM;
+            break;
+        case NIC_PCAP_ERROR_ETHLIB:
+            error = NIC_ERROR_ETHLIB;
+            break;
+        case NIC_PCAP_ERROR_FRMTB:
+            error = NIC_ERROR_TX_TOBIG;
+            break;
+        default:
+            error = NIC_ERROR_DRIVER;
+        }
+    }
+#elif defined(NIC_DEVICE_ENC28J60)
     ret = enc28j60_send(frame);
     
     if (ret == -1) {
@@ -91,7 +168,49 @@ int nic_recv(eth_frame_t *frame)
 {
     int ret;
     
-#ifdef NIC_DEVICE_ENC28J60
+#if defined(NIC_DEVICE_TAP)
+    ret = nic_tap_recv(frame);
+    
+    if (ret == -1) {
+        switch (nic_tap_get_last_error()) {
+        case NIC_TAP_ERROR_INVAL:
+            error = NIC_ERROR_INVAL;
+            break;
+        case NIC_TAP_ERROR_NOMEM:
+            error = NIC_ERROR_NOMEM;
+            break;
+        case NIC_TAP_ERROR_ETHLIB:
+            error = NIC_ERROR_ETHLIB;
+            break;
+        case NIC_TAP_ERROR_FRMTB:
+            error = NIC_ERROR_RX_TOBIG;
+            break;
+        default:
+            error = NIC_ERROR_DRIVER;
+        }
+    }
+#elif defined(NIC_DEVICE_PCAP)
+    ret = nic_pcap_recv(frame);
+    
+    if (ret == -1) {
+        switch (nic_pcap_get_last_error()) {
+        case NIC_PCAP_ERROR_INVAL:
+            error = NIC_ERROR_INVAL;
+            break;
+        case NIC_PCAP_ERROR_NOMEM:
+            error = NIC_ERROR_NOMEM;
+            break;
+        case NIC_PCAP_ERROR_ETHLIB:
+            error = NIC_ERROR_ETHLIB;
+            break;
+        case NIC_PCAP_ERROR_FRMTB:
+            error = NIC_ERROR_RX_TOBIG;
+            break;
+        default:
+            error = NIC_ERROR_DRIVER;
+        }
+    }
+#elif defined(NIC_DEVICE_ENC28J60)
     ret = enc28j60_recv(frame);
     
     if (ret == -1) {
@@ -117,16 +236,140 @@ int nic_recv(eth_frame_t *frame)
     return ret;
 }
 
+int nic_rx_peek(void)
+{
+    int ret;
+    
+#if defined(NIC_DEVICE_PCAP)
+    ret = nic_pcap_rx_peek();
+    
+    if (ret == -1)
+        error = NIC_ERROR_DRIVER;
+#elif defined(NIC_DEVICE_ENC28J60)
+    ret = enc28j60_rx_peek();
+    
+    if (ret == -1)
+        error = NIC_ERROR_DRIVER;
+#else
+    ret = -1;
+    error = NIC_ERROR_NOTSUP;
+#endif
+    
+    return ret;
+}
+
+int nic_rx_read(int off, uint8_t *buf, int len)
+{
+    int ret;
+    
+#if defined(NIC_DEVICE_PCAP)
+    ret = nic_pcap_rx_read(off, buf, len);
+    
+    if (ret == -1) {
+        switch (nic_pcap_get_last_error()) {
+        case NIC_PCAP_ERROR_INVAL:
+            error = NIC_ERROR_INVAL;
+            break;
+        default:
+            error = NIC_ERROR_DRIVER;
+        }
+    }
+#elif defined(NIC_DEVICE_ENC28J60)
+    ret = enc28j60_rx_read(off, buf, len);
+    
+    if (ret == -1) {
+        switch (enc28j60_get_last_error()) {
+        case ENC28J60_ERR_INVAL:
+            error = NIC_ERROR_INVAL;
+            break;
+        default:
+            error = NIC_ERROR_DRIVER;
+        }
+    }
+#else
+    ret = -1;
+    error = NIC_ERROR_NOTSUP;
+#endif
+    
+    return ret;
+}
+
+int nic_rx_checksum(int off, int len, uint16_t *sum)
+{
+    int ret;
+    
+#if defined(NIC_DEVICE_PCAP)
+    ret = nic_pcap_rx_checksum(off, len, sum);
+    
+    if (ret == -1) {
+        switch (nic_pcap_get_last_error()) {
+        case NIC_PCAP_ERROR_INVAL:
+            error = NIC_ERROR_INVAL;
+            break;
+        default:
+            error = NIC_ERROR_DRIVER;
+        }
+    }
+#elif defined(NIC_DEVICE_ENC28J60)
+    ret = enc28j60_rx_checksum(off, len, sum);
+    
+    if (ret == -1) {
+        switch (enc28j60_get_last_error()) {
+        case ENC28J60_ERR_INVAL:
+            error = NIC_ERROR_INVAL;
+            break;
+        default:
+            error = NIC_ERROR_DRIVER;
+        }
+    }
+#else
+    ret = -1;
+    error = NIC_ERROR_NOTSUP;
+#endif
+    
+    return ret;
+}
+
+int nic_rx_drop(void)
+{
+    int ret;
+    
+#if defined(NIC_DEVICE_PCAP)
+    ret = nic_pcap_rx_drop();
+    
+    if (ret == -1)
+        error = NIC_ERROR_DRIVER;
+#elif defined(NIC_DEVICE_ENC28J60)
+    ret = enc28j60_rx_drop();
+    
+    if (ret == -1)
+        error = NIC_ERROR_DRIVER;
+#else
+    ret = -1;
+    error = NIC_ERROR_NOTSUP;
+#endif
+    
+    return ret;
+}
+
 char *nic_get_driver_name(void)
 {
-#ifdef NIC_DEVICE_ENC28J60
+#if defined(NIC_DEVICE_TAP)
+    return nic_tap_get_driver_name();
+#elif defined(NIC_DEVICE_PCAP)
+    return nic_pcap_get_driver_name();
+#elif defined(NIC_DEVICE_ENC28J60)
     return enc28j60_get_driver_name();
 #endif
 }
 
 char *nic_get_driver_vers(void)
 {
-#ifdef NIC_DEVICE_ENC28J60
+#if defined(NIC_DEVICE_TAP)
+    return nic_tap_get_driver_vers();
+#elif defined(NIC_DEVICE_PCAP)
+    return nic_pcap_get_driver_vers();
+#elif defined(NIC_DEVICE_ENC28J60)
     return enc28j60_get_driver_vers();
 #endif
 }
@@ -135,7 +378,11 @@ nic_stats_t nic_get_stats(void)
 {
     nic_stats_t ret;
     
-#ifdef NIC_DEVICE_ENC28J60
+#if defined(NIC_DEVICE_TAP)
+    ret = nic_tap_get_stats();
+#elif defined(NIC_DEVICE_PCAP)
+    ret = nic_pcap_get_stats();
+#elif defined(NIC_DEVICE_ENC28J60)
     ret = enc28j60_get_stats();
 #endif
     
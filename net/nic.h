@@ -5,9 +5,9 @@
  * Project  : lib-avr
  * Author   : Copyright (C) 2019 Johannes Krottmayer <krjdev@gmail.com>
  * Created  : 2019-01-08
- * Modified : 2019-06-02
+ * Modified : 2026-10-19
  * Revised  : 
- * Version  : 0.1.0.0
+ * Version  : 0.3.0.0
  * License  : ISC (see file LICENSE.txt)
  * Target   : Atmel AVR Series
  *
@@ -24,8 +24,28 @@
 
 #include "ethernet.h"
 
-/* Ethernet devices */
+/* Ethernet devices, the host backends are selected with -DNIC_DEVICE_... */
+#if !defined(NIC_DEVICE_TAP) && !defined(NIC_DEVICE_PCAP)
 #define NIC_DEVICE_ENC28J60
+#endif
+
+/* Frames can be inspected and checksummed in NIC memory (nic_rx_...) */
+#if defined(NIC_DEVICE_ENC28J60) || defined(NIC_DEVICE_PCAP)
+#define NIC_HAS_RX_OFFLOAD
+#endif
+
+/* TAP backend, interface must exist (ip tuntap add tap0 mode tap) */
+#ifndef NIC_TAP_IFNAME
+#define NIC_TAP_IFNAME          "tap0"
+#endif
+
+/* pcap backend, frames are replayed from RX and captured to TX */
+#ifndef NIC_PCAP_FILE_RX
+#define NIC_PCAP_FILE_RX        "nic_rx.pcap"
+#endif
+#ifndef NIC_PCAP_FILE_TX
+#define NIC_PCAP_FILE_TX        "nic_tx.pcap"
+#endif
 
 /* Error codes */
 #define NIC_ERROR_SUCCESS       0
@@ -36,6 +56,7 @@
 #define NIC_ERROR_TX_TOBIG      5
 #define NIC_ERROR_RX_TOBIG      6
 #define NIC_ERROR_RX_CRC        7
+#define NIC_ERROR_NOTSUP        8
 
 typedef struct nic_stats {
     uint32_t tx_frm;
@@ -50,6 +71,10 @@ extern int nic_init(mac_addr_t *addr);
 extern int nic_is_link_up(void);
 extern int nic_send(eth_frame_t *frame);
 extern int nic_recv(eth_frame_t *frame);
+extern int nic_rx_peek(void);
+extern int nic_rx_read(int off, uint8_t *buf, int len);
+extern int nic_rx_checksum(int off, int len, uint16_t *sum);
+extern int nic_rx_drop(void);
 extern char *nic_get_driver_name(void);
 extern char *nic_get_driver_vers(void);
 extern nic_stats_t nic_get_stats(void);
@@ -0,0 +1,405 @@
+/**
+ *
+ * File Name: nic_pcap.c
+ * Title    : pcap file replay/capture NIC backend
+ * Project  : lib-avr
+ * Author   : Copyright (C) 2026 Johannes Krottmayer <krjdev@gmail.com>
+ * Created  : 2026-10-19
+ * Modified : 
+ * Revised  : 
+ * Version  : 0.1.0.0
+ * License  : ISC (see file LICENSE.txt)
+ * Target   : Linux (host)
+ *
+ * NOTE: This code is currently below version 1.0, and therefore is considered
+ * to be lacking in some functionality or documentation, or may not be fully
+ * tested. Nonetheless, you can expect most functions to work.
+ *
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <sys/time.h>
+
+#include "nic_pcap.h"
+
+#define DRIVER_NAME         "pcap"
+#define DRIVER_VERSION      "0.1.0.0"
+
+#define PCAP_MAGIC_US       0xA1B2C3D4
+#define PCAP_MAGIC_NS       0xA1B23C4D
+#define PCAP_VERS_MAJOR     2
+#define PCAP_VERS_MINOR     4
+#define PCAP_LINKTYPE_ETH   1
+#define PCAP_HDR_LEN        24
+#define PCAP_REC_LEN        16
+
+static int error = NIC_PCAP_ERROR_SUCCESS;
+static FILE *fp_rx;
+static FILE *fp_tx;
+static int swap;
+static nic_stats_t stats;
+static uint8_t frm_buf[ETHERNET_MAX_FRAME_SIZE];
+static int rx_pend;
+
+static uint32_t get32(uint8_t *p)
+{
+    /* Files are in the byte order of the writer, see magic */
+    if (swap)
+        return ((uint32_t) p[0] << 24) | ((uint32_t) p[1] << 16) | 
+               ((uint32_t) p[2] << 8) | p[3];
+    
+    return ((uint32_t) p[3] << 24) | ((uint32_t) p[2] << 16) | 
+           ((uint32_t) p[1] << 8) | p[0];
+}
+
+static void put32(uint8_t *p, uint32_t val)
+{
+    /* Written little endian, readers detect it by the magic */
+    p[0] = (uint8_t) (val & 0xFF);
+    p[1] = (uint8_t) ((val >> 8) & 0xFF);
+    p[2] = (uint8_t) ((val >> 16) & 0xFF);
+    p[3] = (uint8_t) ((val >> 24) & 0xFF);
+}
+
+static int rx_open(const char *file)
+{
+    uint8_t hdr[PCAP_HDR_LEN];
+    uint32_t magic;
+    
+    fp_rx = fopen(file, "rb");
+    
+    if (!fp_rx) {
+        error = NIC_PCAP_ERROR_OPEN;
+        return -1;
+    }
+    
+    if (fread(hdr, 1, PCAP_HDR_LEN, fp_rx) != PCAP_HDR_LEN) {
+        error = NIC_PCAP_ERROR_FORMAT;
+        return -1;
+    }
+    
+    swap = 0;
+    magic = get32(hdr);
+    
+    if ((magic != PCAP_MAGIC_US) && (magic != PCAP_MAGIC_NS)) {
+        swap = 1;
+        magic = get32(hdr);
+        
+        if ((magic != PCAP_MAGIC_US) && (magic != PCAP_MAGIC_NS)) {
+            error = NIC_PCAP_ERROR_FORMAT;
+            return -1;
+        }
+    }
+    
+    if (get32(&hdr[20]) != PCAP_LINKTYPE_ETH) {
+        error = NIC_PCAP_ERROR_FORMAT;
+        return -1;
+    }
+    
+    return 0;
+}
+
+static int tx_open(const char *file)
+{
+    uint8_t hdr[PCAP_HDR_LEN];
+    
+    fp_tx = fopen(file, "wb");
+    
+    if (!fp_tx) {
+        error = NIC_PCAP_ERROR_OPEN;
+        return -1;
+    }
+    
+    memset(hdr, 0, PCAP_HDR_LEN);
+    put32(&hdr[0], PCAP_MAGIC_US);
+    hdr[4] = PCAP_VERS_MAJOR;
+    hdr[6] = PCAP_VERS_MINOR;
+    put32(&hdr[16], ETHERNET_MAX_FRAME_SIZE);
+    put32(&hdr[20], PCAP_LINKTYPE_ETH);
+    
+    if (fwrite(hdr, 1, PCAP_HDR_LEN, fp_tx) != PCAP_HDR_LEN) {
+        error = NIC_PCAP_ERROR_IO;
+        return -1;
+    }
+    
+    return 0;
+}
+
+int nic_pcap_init(const char *file_rx, const char *file_tx, mac_addr_t *addr)
+{
+    if (!addr) {
+        error = NIC_PCAP_ERROR_INVAL;
+        return -1;
+    }
+    
+    nic_pcap_close();
+    
+    /* Either file is optional, e.g. replay only or capture only */
+    if (file_rx && (rx_open(file_rx) == -1)) {
+        nic_pcap_close();
+        return -1;
+    }
+    
+    if (file_tx && (tx_open(file_tx) == -1)) {
+        nic_pcap_close();
+        return -1;
+    }
+    
+    ethernet_crc_disable();
+    memset(&stats, 0, sizeof(nic_stats_t));
+    return 0;
+}
+
+int nic_pcap_rewind(void)
+{
+    if (!fp_rx) {
+        error = NIC_PCAP_ERROR_INVAL;
+        return -1;
+    }
+    
+    if (fseek(fp_rx, PCAP_HDR_LEN, SEEK_SET) == -1) {
+        error = NIC_PCAP_ERROR_IO;
+        return -1;
+    }
+    
+    rx_pend = 0;
+    return 0;
+}
+
+void nic_pcap_close(void)
+{
+    if (fp_rx)
+        fclose(fp_rx);
+    
+    if (fp_tx)
+        fclose(fp_tx);
+    
+    fp_rx = NULL;
+    fp_tx = NULL;
+    rx_pend = 0;
+}
+
+int nic_pcap_is_link_up(void)
+{
+    return 1;
+}
+
+int nic_pcap_send(eth_frame_t *frame)
+{
+    struct timeval tv;
+    uint8_t rec[PCAP_REC_LEN];
+    int len;
+    
+    if (!frame) {
+        error = NIC_PCAP_ERROR_INVAL;
+        return -1;
+    }
+    
+    len = ethernet_frame_get_len(frame);
+    
+    if (len == -1) {
+        error = NIC_PCAP_ERROR_ETHLIB;
+        return -1;
+    }
+    
+    if (len > ETHERNET_MAX_FRAME_SIZE) {
+        stats.tx_err++;
+        error = NIC_PCAP_ERROR_FRMTB;
+        return -1;
+    }
+    
+    /* No capture file, transmitted frames are discarded */
+    if (fp_tx) {
+        if (ethernet_frm_to_buf(frame, frm_buf) == -1) {
+            error = NIC_PCAP_ERROR_ETHLIB;
+            return -1;
+        }
+        
+        gettimeofday(&tv, NULL);
+        put32(&rec[0], (uint32_t) tv.tv_sec);
+        put32(&rec[4], (uint32_t) tv.tv_usec);
+        put32(&rec[8], (uint32_t) len);
+        put32(&rec[12], (uint32_t) len);
+        
+        if ((fwrite(rec, 1, PCAP_REC_LEN, fp_tx) != PCAP_REC_LEN) || 
+            (fwrite(frm_buf, 1, len, fp_tx) != (size_t) len)) {
+            stats.tx_err++;
+            error = NIC_PCAP_ERROR_IO;
+            return -1;
+        }
+    }
+    
+    stats.tx_frm++;
+    stats.tx_byt += len;
+    return len;
+}
+
+/* Next record into frm_buf, returns the length or 0 at the end of the file */
+static int rec_next(void)
+{
+    uint8_t rec[PCAP_REC_LEN];
+    uint32_t len;
+    uint32_t len_orig;
+    
+    if (rx_pend)
+        return rx_pend;
+    
+    if (!fp_rx)
+        return 0;
+    
+    /* Records are replayed back to back, timestamps are ignored */
+    while (1) {
+        if (fread(rec, 1, PCAP_REC_LEN, fp_rx) != PCAP_REC_LEN)
+            return 0;
+        
+        len = get32(&rec[8]);
+        len_orig = get32(&rec[12]);
+        
+        if (len <= ETHERNET_MAX_FRAME_SIZE)
+            break;
+        
+        /* GRO or jumbo frame, skip the body to stay on the record headers */
+        stats.rx_err++;
+        
+        if (fseek(fp_rx, (long) len, SEEK_CUR) == -1) {
+            error = NIC_PCAP_ERROR_IO;
+            return -1;
+        }
+    }
+    
+    if (fread(frm_buf, 1, len, fp_rx) != len) {
+        stats.rx_err++;
+        error = NIC_PCAP_ERROR_IO;
+        return -1;
+    }
+    
+    /* Truncated by the capture's snaplen */
+    if (len != len_orig) {
+        stats.rx_err++;
+        error = NIC_PCAP_ERROR_FORMAT;
+        return -1;
+    }
+    
+    rx_pend = (int) len;
+    return rx_pend;
+}
+
+int nic_pcap_recv(eth_frame_t *frame)
+{
+    int len;
+    
+    if (!frame) {
+        error = NIC_PCAP_ERROR_INVAL;
+        return -1;
+    }
+    
+    len = rec_next();
+    
+    if (len < 1)
+        return len;
+    
+    rx_pend = 0;
+    
+    if (ethernet_buf_to_frm(frm_buf, len, frame) == -1) {
+        stats.rx_err++;
+        
+        if (ethernet_get_last_error() == ETHERNET_ERROR_NOMEM)
+            error = NIC_PCAP_ERROR_NOMEM;
+        else
+            error = NIC_PCAP_ERROR_ETHLIB;
+        
+        return -1;
+    }
+    
+    stats.rx_frm++;
+    stats.rx_byt += len;
+    return len;
+}
+
+/* RX offload like the ENC28J60, the record stays pending until recv or drop */
+int nic_pcap_rx_peek(void)
+{
+    return rec_next();
+}
+
+int nic_pcap_rx_read(int off, uint8_t *buf, int len)
+{
+    if (!buf || (off < 0) || (len < 0)) {
+        error = NIC_PCAP_ERROR_INVAL;
+        return -1;
+    }
+    
+    if (!rx_pend || ((off + len) > rx_pend)) {
+        error = NIC_PCAP_ERROR_INVAL;
+        return -1;
+    }
+    
+    memcpy(buf, &frm_buf[off], len);
+    return len;
+}
+
+/* Complemented one's complement sum, as the ENC28J60 DMA returns it */
+int nic_pcap_rx_checksum(int off, int len, uint16_t *sum)
+{
+    uint32_t acc = 0;
+    int i;
+    
+    if (!sum || (off < 0) || (len < 1)) {
+        error = NIC_PCAP_ERROR_INVAL;
+        return -1;
+    }
+    
+    if (!rx_pend || ((off + len) > rx_pend)) {
+        error = NIC_PCAP_ERROR_INVAL;
+        return -1;
+    }
+    
+    for (i = 0; (i + 1) < len; i += 2)
+        acc += ((uint16_t) frm_buf[off + i] << 8) | frm_buf[off + i + 1];
+    
+    if (len & 1)
+        acc += (uint16_t) frm_buf[off + len - 1] << 8;
+    
+    acc = (acc & 0xFFFF) + (acc >> 16);
+    acc = (acc & 0xFFFF) + (acc >> 16);
+    (*sum) = (uint16_t) ~acc;
+    return 0;
+}
+
+int nic_pcap_rx_drop(void)
+{
+    int ret;
+    
+    ret = rec_next();
+    
+    if (ret < 1)
+        return ret;
+    
+    rx_pend = 0;
+    return 1;
+}
+
+char *nic_pcap_get_driver_name(void)
+{
+    return DRIVER_NAME;
+}
+
+char *nic_pcap_get_driver_vers(void)
+{
+    return DRIVER_VERSION;
+}
+
+nic_stats_t nic_pcap_get_stats(void)
+{
+    return stats;
+}
+
+int nic_pcap_get_last_error(void)
+{
+    int err;
+    
+    err = error;
+    error = NIC_PCAP_ERROR_SUCCESS;
+    return err;
+}
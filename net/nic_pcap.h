@@ -0,0 +1,52 @@
+/**
+ *
+ * File Name: nic_pcap.h
+ * Title    : pcap file replay/capture NIC backend
+ * Project  : lib-avr
+ * Author   : Copyright (C) 2026 Johannes Krottmayer <krjdev@gmail.com>
+ * Created  : 2026-10-19
+ * Modified : 
+ * Revised  : 
+ * Version  : 0.1.0.0
+ * License  : ISC (see file LICENSE.txt)
+ * Target   : Linux (host)
+ *
+ * NOTE: This code is currently below version 1.0, and therefore is considered
+ * to be lacking in some functionality or documentation, or may not be fully
+ * tested. Nonetheless, you can expect most functions to work.
+ *
+ */
+
+#ifndef LIBAVR_NET_NIC_PCAP_H
+#define LIBAVR_NET_NIC_PCAP_H
+
+#include <stdint.h>
+
+#include "ethernet.h"
+#include "nic.h"
+
+#define NIC_PCAP_ERROR_SUCCESS  0
+#define NIC_PCAP_ERROR_INVAL    1
+#define NIC_PCAP_ERROR_NOMEM    2
+#define NIC_PCAP_ERROR_OPEN     3
+#define NIC_PCAP_ERROR_IO       4
+#define NIC_PCAP_ERROR_FORMAT   5
+#define NIC_PCAP_ERROR_ETHLIB   6
+#define NIC_PCAP_ERROR_FRMTB    7
+
+extern int nic_pcap_init(const char *file_rx, const char *file_tx, mac_addr_t *addr);
+extern int nic_pcap_rewind(void);
+extern void nic_pcap_close(void);
+extern int nic_pcap_is_link_up(void);
+extern int nic_pcap_send(eth_frame_t *frame);
+extern int nic_pcap_recv(eth_frame_t *frame);
+extern int nic_pcap_rx_peek(void);
+extern int nic_pcap_rx_read(int off, uint8_t *buf, int len);
+extern int nic_pcap_rx_checksum(int off, int len, uint16_t *sum);
+extern int nic_pcap_rx_drop(void);
+extern char *nic_pcap_get_driver_name(void);
+extern char *nic_pcap_get_driver_vers(void);
+extern nic_stats_t nic_pcap_get_stats(void);
+extern int nic_pcap_get_last_error(void);
+
+#endif
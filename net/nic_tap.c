@@ -0,0 +1,182 @@
+/**
+ *
+ * File Name: nic_tap.c
+ * Title    : Linux TAP NIC backend
+ * Project  : lib-avr
+ * Author   : Copyright (C) 2026 Johannes Krottmayer <krjdev@gmail.com>
+ * Created  : 2026-10-19
+ * Modified : 
+ * Revised  : 
+ * Version  : 0.1.0.0
+ * License  : ISC (see file LICENSE.txt)
+ * Target   : Linux (host)
+ *
+ * NOTE: This code is currently below version 1.0, and therefore is considered
+ * to be lacking in some functionality or documentation, or may not be fully
+ * tested. Nonetheless, you can expect most functions to work.
+ *
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <net/if.h>
+#include <linux/if_tun.h>
+
+#include "nic_tap.h"
+
+#define DRIVER_NAME         "Linux TAP"
+#define DRIVER_VERSION      "0.1.0.0"
+
+static int error = NIC_TAP_ERROR_SUCCESS;
+static int fd = -1;
+static nic_stats_t stats;
+
+/* Frames are handled without FCS, the kernel neither adds nor expects one */
+static uint8_t frm_buf[ETHERNET_MAX_FRAME_SIZE];
+
+int nic_tap_init(const char *ifname, mac_addr_t *addr)
+{
+    struct ifreq ifr;
+    
+    if (!ifname || !addr) {
+        error = NIC_TAP_ERROR_INVAL;
+        return -1;
+    }
+    
+    if (fd != -1)
+        close(fd);
+    
+    fd = open("/dev/net/tun", O_RDWR | O_NONBLOCK);
+    
+    if (fd == -1) {
+        error = NIC_TAP_ERROR_OPEN;
+        return -1;
+    }
+    
+    memset(&ifr, 0, sizeof(struct ifreq));
+    ifr.ifr_flags = IFF_TAP | IFF_NO_PI;
+    strncpy(ifr.ifr_name, ifname, IFNAMSIZ - 1);
+    
+    if (ioctl(fd, TUNSETIFF, &ifr) == -1) {
+        close(fd);
+        fd = -1;
+        error = NIC_TAP_ERROR_OPEN;
+        return -1;
+    }
+    
+    ethernet_crc_disable();
+    memset(&stats, 0, sizeof(nic_stats_t));
+    return 0;
+}
+
+int nic_tap_is_link_up(void)
+{
+    if (fd == -1) {
+        error = NIC_TAP_ERROR_IO;
+        return -1;
+    }
+    
+    return 1;
+}
+
+int nic_tap_send(eth_frame_t *frame)
+{
+    int len;
+    
+    if (!frame) {
+        error = NIC_TAP_ERROR_INVAL;
+        return -1;
+    }
+    
+    len = ethernet_frame_get_len(frame);
+    
+    if (len == -1) {
+        error = NIC_TAP_ERROR_ETHLIB;
+        return -1;
+    }
+    
+    if (len > ETHERNET_MAX_FRAME_SIZE) {
+        stats.tx_err++;
+        error = NIC_TAP_ERROR_FRMTB;
+        return -1;
+    }
+    
+    if (ethernet_frm_to_buf(frame, frm_buf) == -1) {
+        error = NIC_TAP_ERROR_ETHLIB;
+        return -1;
+    }
+    
+    if (write(fd, frm_buf, len) != len) {
+        stats.tx_err++;
+        error = NIC_TAP_ERROR_IO;
+        return -1;
+    }
+    
+    stats.tx_frm++;
+    stats.tx_byt += len;
+    return len;
+}
+
+int nic_tap_recv(eth_frame_t *frame)
+{
+    ssize_t len;
+    
+    if (!frame) {
+        error = NIC_TAP_ERROR_INVAL;
+        return -1;
+    }
+    
+    len = read(fd, frm_buf, sizeof(frm_buf));
+    
+    if (len == -1) {
+        /* Non-blocking, nothing received */
+        if ((errno == EAGAIN) || (errno == EWOULDBLOCK))
+            return 0;
+        
+        stats.rx_err++;
+        error = NIC_TAP_ERROR_IO;
+        return -1;
+    }
+    
+    if (ethernet_buf_to_frm(frm_buf, (int) len, frame) == -1) {
+        stats.rx_err++;
+        
+        if (ethernet_get_last_error() == ETHERNET_ERROR_NOMEM)
+            error = NIC_TAP_ERROR_NOMEM;
+        else
+            error = NIC_TAP_ERROR_ETHLIB;
+        
+        return -1;
+    }
+    
+    stats.rx_frm++;
+    stats.rx_byt += len;
+    return (int) len;
+}
+
+char *nic_tap_get_driver_name(void)
+{
+    return DRIVER_NAME;
+}
+
+char *nic_tap_get_driver_vers(void)
+{
+    return DRIVER_VERSION;
+}
+
+nic_stats_t nic_tap_get_stats(void)
+{
+    return stats;
+}
+
+int nic_tap_get_last_error(void)
+{
+    int err;
+    
+    err = error;
+    error = NIC_TAP_ERROR_SUCCESS;
+    return err;
+}
@@ -0,0 +1,45 @@
+/**
+ *
+ * File Name: nic_tap.h
+ * Title    : Linux TAP NIC backend
+ * Project  : lib-avr
+ * Author   : Copyright (C) 2026 Johannes Krottmayer <krjdev@gmail.com>
+ * Created  : 2026-10-19
+ * Modified : 
+ * Revised  : 
+ * Version  : 0.1.0.0
+ * License  : ISC (see file LICENSE.txt)
+ * Target   : Linux (host)
+ *
+ * NOTE: This code is currently below version 1.0, and therefore is considered
+ * to be lacking in some functionality or documentation, or may not be fully
+ * tested. Nonetheless, you can expect most functions to work.
+ *
+ */
+
+#ifndef LIBAVR_NET_NIC_TAP_H
+#define LIBAVR_NET_NIC_TAP_H
+
+#include <stdint.h>
+
+#include "ethernet.h"
+#include "nic.h"
+
+#define NIC_TAP_ERROR_SUCCESS   0
+#define NIC_TAP_ERROR_INVAL     1
+#define NIC_TAP_ERROR_NOMEM     2
+#define NIC_TAP_ERROR_OPEN      3
+#define NIC_TAP_ERROR_IO        4
+#define NIC_TAP_ERROR_ETHLIB    5
+#define NIC_TAP_ERROR_FRMTB     6
+
+extern int nic_tap_init(const char *ifname, mac_addr_t *addr);
+extern int nic_tap_is_link_up(void);
+extern int nic_tap_send(eth_frame_t *frame);
+extern int nic_tap_recv(eth_frame_t *frame);
+extern char *nic_tap_get_driver_name(void);
+extern char *nic_tap_get_driver_vers(void);
+extern nic_stats_t nic_tap_get_stats(void);
+extern int nic_tap_get_last_error(void);
+
+#endif
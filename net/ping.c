@@ -0,0 +1,105 @@
+/**
+ *
+ * File Name: ping.c
+ * Title    : ICMP echo responder (fast path)
+ * Project  : lib-avr
+ * Author   : Copyright (C) 2026 Johannes Krottmayer <krjdev@gmail.com>
+ * Created  : 2026-10-19
+ * Modified : 
+ * Revised  : 
+ * Version  : 0.1.0.0
+ * License  : ISC (see file LICENSE.txt)
+ * Target   : Atmel AVR Series
+ *
+ * NOTE: This code is currently below version 1.0, and therefore is considered
+ * to be lacking in some functionality or documentation, or may not be fully
+ * tested. Nonetheless, you can expect most functions to work.
+ *
+ */
+
+#include <string.h>
+
+#include "icmp.h"
+#include "nic.h"
+#include "ping.h"
+
+#define IP_OFF_DST      16
+
+static int error = PING_ERROR_SUCCESS;
+static ipv4_addr_t ip_local;
+static ping_stats_t stats;
+
+int ping_init(ipv4_addr_t *ip)
+{
+    if (!ip) {
+        error = PING_ERROR_INVAL;
+        return -1;
+    }
+    
+    ipv4_addr_cpy(&ip_local, ip);
+    memset(&stats, 0, sizeof(ping_stats_t));
+    return 0;
+}
+
+int ping_input(eth_frame_t *frame)
+{
+    mac_addr_t mac;
+    uint8_t *p;
+    int ret;
+    
+    if (!frame) {
+        error = PING_ERROR_INVAL;
+        return -1;
+    }
+    
+    if (frame->ef_type != ETHERNET_TYPE_IPV4)
+        return 0;
+    
+    p = frame->ef_payload_buf;
+    
+    if (!p || (frame->ef_payload_len < 20))
+        return 0;
+    
+    /* Unicast to us only, no broadcast pings */
+    if (ethernet_addr_is_broadcast(&frame->ef_dst))
+        return 0;
+    
+    if ((p[IP_OFF_DST] != ip_local.ia_byte0) || 
+        (p[IP_OFF_DST + 1] != ip_local.ia_byte1) || 
+        (p[IP_OFF_DST + 2] != ip_local.ia_byte2) || 
+        (p[IP_OFF_DST + 3] != ip_local.ia_byte3))
+        return 0;
+    
+    /* Rewrites the request into the reply, in the received buffer */
+    ret = icmp_echo_reflect(p, frame->ef_payload_len);
+    
+    if (ret != 1)
+        return ret;
+    
+    ethernet_addr_cpy(&mac, &frame->ef_dst);
+    ethernet_addr_cpy(&frame->ef_dst, &frame->ef_src);
+    ethernet_addr_cpy(&frame->ef_src, &mac);
+    stats.rx_req++;
+    
+    if (nic_send(frame) == -1) {
+        stats.tx_err++;
+        error = PING_ERROR_NIC;
+        return -1;
+    }
+    
+    return 1;
+}
+
+ping_stats_t ping_get_stats(void)
+{
+    return stats;
+}
+
+int ping_get_last_error(void)
+{
+    int err;
+    
+    err = error;
+    error = PING_ERROR_SUCCESS;
+    return err;
+}
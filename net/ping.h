@@ -0,0 +1,42 @@
+/**
+ *
+ * File Name: ping.h
+ * Title    : ICMP echo responder (fast path)
+ * Project  : lib-avr
+ * Author   : Copyright (C) 2026 Johannes Krottmayer <krjdev@gmail.com>
+ * Created  : 2026-10-19
+ * Modified : 
+ * Revised  : 
+ * Version  : 0.1.0.0
+ * License  : ISC (see file LICENSE.txt)
+ * Target   : Atmel AVR Series
+ *
+ * NOTE: This code is currently below version 1.0, and therefore is considered
+ * to be lacking in some functionality or documentation, or may not be fully
+ * tested. Nonetheless, you can expect most functions to work.
+ *
+ */
+
+#ifndef LIBAVR_NET_PING_H
+#define LIBAVR_NET_PING_H
+
+#include <stdint.h>
+
+#include "ethernet.h"
+#include "ipv4.h"
+
+#define PING_ERROR_SUCCESS      0
+#define PING_ERROR_INVAL        1
+#define PING_ERROR_NIC          2
+
+typedef struct ping_stats {
+    uint32_t rx_req;    /* Echo requests reflected */
+    uint16_t tx_err;    /* nic_send() failures */
+} ping_stats_t;
+
+extern int ping_init(ipv4_addr_t *ip);
+extern int ping_input(eth_frame_t *frame);
+extern ping_stats_t ping_get_stats(void);
+extern int ping_get_last_error(void);
+
+#endif
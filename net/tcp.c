@@ -5,9 +5,9 @@
  * Project  : lib-avr
  * Author   : Copyright (C) 2019 Johannes Krottmayer <krjdev@gmail.com>
  * Created  : 2019-08-09
- * Modified : 2019-08-11
+ * Modified : 2026-10-19
  * Revised  : 
- * Version  : 0.1.0.2
+ * Version  : 0.3.0.0
  * License  : ISC (see file LICENSE.txt)
  * Target   : Atmel AVR Series
  *
@@ -25,36 +25,15 @@
 
 #define TCP_HDR_LEN     20
 
+#define TCP_OPT_LEN_MSS     4
+#define TCP_OPT_LEN_WSCALE  3
+#define TCP_OPT_LEN_SACKP   2
+
 #define HI16(val)       ((uint8_t) (((val) & 0xFF00) >> 8))
 #define LO16(val)       ((uint8_t) ((val) & 0x00FF))
 
 static int error = TCP_ERROR_SUCCESS;
 
-static uint32_t ipv4_sum(ipv4_packet_t *ip)
-{
-    uint32_t sum = 0;
-    uint16_t tmp;
-    
-    if (!ip)
-        return 0;
-    
-    tmp = ((uint16_t) ip->ip_hdr.ih_src.ia_byte0 << 8);
-    tmp |= (uint16_t) ip->ip_hdr.ih_src.ia_byte1;
-    sum += tmp;
-    tmp = ((uint16_t) ip->ip_hdr.ih_src.ia_byte2 << 8);
-    tmp |= (uint16_t) ip->ip_hdr.ih_src.ia_byte3;
-    sum += tmp;
-    tmp = ((uint16_t) ip->ip_hdr.ih_dst.ia_byte0 << 8);
-    tmp |= (uint16_t) ip->ip_hdr.ih_dst.ia_byte1;
-    sum += tmp;
-    tmp = ((uint16_t) ip->ip_hdr.ih_dst.ia_byte2 << 8);
-    tmp |= (uint16_t) ip->ip_hdr.ih_dst.ia_byte3;
-    sum += tmp;
-    sum += ip->ip_hdr.ih_prot;
-    sum += (ip->ip_hdr.ih_tlen - (ip->ip_hdr.ih_ihl * 4));
-    return sum;
-}
-
 static uint32_t tcp_sum(tcp_packet_t *tcp)
 {
     int i = 0;
@@ -192,6 +171,17 @@ int tcp_pkt_set_urgp(tcp_packet_t *tcp, uint16_t urgp)
     return 0;
 }
 
+/* Drops options set before, the header shrinks back to TCP_HDR_LEN */
+static void options_clear(tcp_packet_t *tcp)
+{
+    if (tcp->tp_options_buf)
+        free(tcp->tp_options_buf);
+    
+    tcp->tp_options_buf = NULL;
+    tcp->tp_options_len = 0;
+    tcp->tp_hdr.th_off = (TCP_HDR_LEN / 4);
+}
+
 int tcp_pkt_set_options(tcp_packet_t *tcp, uint8_t *buf, int len)
 {
     uint8_t *p;
@@ -212,11 +202,12 @@ int tcp_pkt_set_options(tcp_packet_t *tcp, uint8_t *buf, int len)
         return -1;
     }
     
-    if (len > 4)
-        padding = len % 4;
-    else
-        padding = 4 - len;
+    if (len > TCP_OPT_LEN_MAX) {
+        error = TCP_ERROR_INVAL;
+        return -1;
+    }
     
+    padding = (4 - (len % 4)) % 4;
     p = (uint8_t *) malloc(len + padding);
     
     if (!p) {
@@ -224,7 +215,8 @@ int tcp_pkt_set_options(tcp_packet_t *tcp, uint8_t *buf, int len)
         return -1;
     }
     
-    tcp->tp_hdr.th_off += ((len / 4) + 1);
+    options_clear(tcp);
+    tcp->tp_hdr.th_off = ((TCP_HDR_LEN + len + padding) / 4);
     tcp->tp_options_buf = p;
     tcp->tp_options_len = len + padding;
     memcpy(tcp->tp_options_buf, buf, len);
@@ -447,9 +439,14 @@ int tcp_pkt_create(uint16_t srcp, uint16_t dstp,
     tcp->tp_hdr.th_seqn = seqn;
     tcp->tp_hdr.th_ackn = ackn;
     tcp->tp_hdr.th_flags = flags;
+    tcp->tp_hdr.th_win = win;
     tcp->tp_hdr.th_urgp = urgp;
     tcp->tp_hdr.th_off = (TCP_HDR_LEN / 4);
     tcp->tp_hdr.th_res = 0;
+    tcp->tp_options_buf = NULL;
+    tcp->tp_options_len = 0;
+    tcp->tp_payload_buf = NULL;
+    tcp->tp_payload_len = 0;
     return 0;
 }
 
@@ -495,37 +492,390 @@ int tcp_pkt_free(tcp_packet_t *tcp)
     return 0;
 }
 
-int tcp_ip_to_pkt(ipv4_packet_t *ip_tcp, tcp_packet_t *tcp)
+int tcp_opt_encode(tcp_options_t *opt, uint8_t *buf, int len)
 {
     int i = 0;
-    uint32_t sum;
-    uint16_t carry;
-    uint16_t chk;
-    uint8_t *p;
-    uint8_t *p_opt;
-    uint8_t *p_pay;
+    
+    if (!opt) {
+        error = TCP_ERROR_INVAL;
+        return -1;
+    }
+    
+    if (!buf) {
+        error = TCP_ERROR_INVAL;
+        return -1;
+    }
+    
+    /* Every option is emitted 32-bit aligned, so no padding is needed */
+    if (opt->to_flags & TCP_OPTF_MSS) {
+        if ((i + 4) > len) {
+            error = TCP_ERROR_INVAL;
+            return -1;
+        }
+        
+        buf[i++] = TCP_OPT_MSS;
+        buf[i++] = TCP_OPT_LEN_MSS;
+        buf[i++] = HI16(opt->to_mss);
+        buf[i++] = LO16(opt->to_mss);
+    }
+    
+    if (opt->to_flags & TCP_OPTF_SACKP) {
+        if ((i + 4) > len) {
+            error = TCP_ERROR_INVAL;
+            return -1;
+        }
+        
+        buf[i++] = TCP_OPT_NOP;
+        buf[i++] = TCP_OPT_NOP;
+        buf[i++] = TCP_OPT_SACKP;
+        buf[i++] = TCP_OPT_LEN_SACKP;
+    }
+    
+    if (opt->to_flags & TCP_OPTF_WSCALE) {
+        if ((i + 4) > len) {
+            error = TCP_ERROR_INVAL;
+            return -1;
+        }
+        
+        buf[i++] = TCP_OPT_NOP;
+        buf[i++] = TCP_OPT_WSCALE;
+        buf[i++] = TCP_OPT_LEN_WSCALE;
+        
+        if (opt->to_wscale > TCP_WSCALE_MAX)
+            buf[i++] = TCP_WSCALE_MAX;
+        else
+            buf[i++] = opt->to_wscale;
+    }
+    
+    return i;
+}
+
+int tcp_opt_decode(uint8_t *buf, int len, tcp_options_t *opt)
+{
+    int i = 0;
+    uint8_t kind;
+    uint8_t olen;
+    
+    if (!opt) {
+        error = TCP_ERROR_INVAL;
+        return -1;
+    }
+    
+    opt->to_flags = 0;
+    opt->to_mss = TCP_MSS_DEFAULT;
+    opt->to_wscale = 0;
+    
+    if (len < 1)
+        return 0;
+    
+    if (!buf) {
+        error = TCP_ERROR_INVAL;
+        return -1;
+    }
+    
+    while (i < len) {
+        kind = buf[i];
+        
+        if (kind == TCP_OPT_EOL)
+            break;
+        
+        if (kind == TCP_OPT_NOP) {
+            i++;
+            continue;
+        }
+        
+        if ((i + 1) >= len) {
+            error = TCP_ERROR_UNKNOWN;
+            return -1;
+        }
+        
+        olen = buf[i + 1];
+        
+        if ((olen < 2) || ((i + olen) > len)) {
+            error = TCP_ERROR_UNKNOWN;
+            return -1;
+        }
+        
+        switch (kind) {
+        case TCP_OPT_MSS:
+            if (olen != TCP_OPT_LEN_MSS) {
+                error = TCP_ERROR_UNKNOWN;
+                return -1;
+            }
+            
+            opt->to_mss = ((uint16_t) buf[i + 2] << 8);
+            opt->to_mss |= (uint16_t) buf[i + 3];
+            opt->to_flags |= TCP_OPTF_MSS;
+            break;
+        case TCP_OPT_WSCALE:
+            if (olen != TCP_OPT_LEN_WSCALE) {
+                error = TCP_ERROR_UNKNOWN;
+                return -1;
+            }
+            
+            /* RFC 7323: treat shift counts above 14 as 14 */
+            opt->to_wscale = buf[i + 2];
+            
+            if (opt->to_wscale > TCP_WSCALE_MAX)
+                opt->to_wscale = TCP_WSCALE_MAX;
+            
+            opt->to_flags |= TCP_OPTF_WSCALE;
+            break;
+        case TCP_OPT_SACKP:
+            if (olen != TCP_OPT_LEN_SACKP) {
+                error = TCP_ERROR_UNKNOWN;
+                return -1;
+            }
+            
+            opt->to_flags |= TCP_OPTF_SACKP;
+            break;
+        default:
+            /* Unknown options are skipped */
+            break;
+        }
+        
+        i += olen;
+    }
+    
+    return 0;
+}
+
+int tcp_opt_negotiate(tcp_options_t *local, 
+                      tcp_options_t *peer, 
+                      tcp_nego_t *nego)
+{
+    uint16_t mss_local;
+    uint16_t mss_peer;
+    
+    if (!local) {
+        error = TCP_ERROR_INVAL;
+        return -1;
+    }
+    
+    if (!peer) {
+        error = TCP_ERROR_INVAL;
+        return -1;
+    }
+    
+    if (!nego) {
+        error = TCP_ERROR_INVAL;
+        return -1;
+    }
+    
+    if (local->to_flags & TCP_OPTF_MSS)
+        mss_local = local->to_mss;
+    else
+        mss_local = TCP_MSS_DEFAULT;
+    
+    if (peer->to_flags & TCP_OPTF_MSS)
+        mss_peer = peer->to_mss;
+    else
+        mss_peer = TCP_MSS_DEFAULT;
+    
+    if (mss_peer < mss_local)
+        nego->tn_mss = mss_peer;
+    else
+        nego->tn_mss = mss_local;
+    
+    /* Window scaling is only in effect if both sides sent the option */
+    if ((local->to_flags & TCP_OPTF_WSCALE) && 
+        (peer->to_flags & TCP_OPTF_WSCALE)) {
+        nego->tn_snd_wscale = peer->to_wscale;
+        nego->tn_rcv_wscale = local->to_wscale;
+    } else {
+        nego->tn_snd_wscale = 0;
+        nego->tn_rcv_wscale = 0;
+    }
+    
+    if ((local->to_flags & TCP_OPTF_SACKP) && 
+        (peer->to_flags & TCP_OPTF_SACKP))
+        nego->tn_sack = 1;
+    else
+        nego->tn_sack = 0;
+    
+    return 0;
+}
+
+int tcp_pkt_set_opts(tcp_packet_t *tcp, tcp_options_t *opt)
+{
+    uint8_t buf[TCP_OPT_LEN_MAX];
     int len;
-    int opt_len = 0;
     
-    if (!ip_tcp) {
+    if (!tcp) {
         error = TCP_ERROR_INVAL;
         return -1;
     }
     
+    len = tcp_opt_encode(opt, buf, TCP_OPT_LEN_MAX);
+    
+    if (len == -1)
+        return -1;
+    
+    if (len == 0) {
+        options_clear(tcp);
+        return 0;
+    }
+    
+    return tcp_pkt_set_options(tcp, buf, len);
+}
+
+int tcp_pkt_get_opts(tcp_packet_t *tcp, tcp_options_t *opt)
+{
     if (!tcp) {
         error = TCP_ERROR_INVAL;
         return -1;
     }
     
-    sum = ipv4_sum(ip_tcp);
-    len = ipv4_pkt_get_payload_len(ip_tcp);
+    return tcp_opt_decode(tcp->tp_options_buf, tcp->tp_options_len, opt);
+}
+
+int tcp_pkt_set_win_scaled(tcp_packet_t *tcp, uint32_t win, uint8_t shift)
+{
+    if (!tcp) {
+        error = TCP_ERROR_INVAL;
+        return -1;
+    }
+    
+    if (shift > TCP_WSCALE_MAX) {
+        error = TCP_ERROR_INVAL;
+        return -1;
+    }
+    
+    win >>= shift;
+    
+    if (win > 0xFFFF)
+        win = 0xFFFF;
+    
+    tcp->tp_hdr.th_win = (uint16_t) win;
+    return 0;
+}
+
+int tcp_pkt_get_win_scaled(tcp_packet_t *tcp, uint8_t shift, uint32_t *win)
+{
+    if (!tcp) {
+        error = TCP_ERROR_INVAL;
+        return -1;
+    }
+    
+    if (!win) {
+        error = TCP_ERROR_INVAL;
+        return -1;
+    }
+    
+    if (shift > TCP_WSCALE_MAX) {
+        error = TCP_ERROR_INVAL;
+        return -1;
+    }
+    
+    /* Window field of SYN segments is never scaled (RFC 7323) */
+    if (tcp->tp_hdr.th_flags & TCP_FLAG_SYN)
+        (*win) = tcp->tp_hdr.th_win;
+    else
+        (*win) = ((uint32_t) tcp->tp_hdr.th_win << shift);
+    
+    return 0;
+}
+
+static uint16_t sum_finish(uint32_t sum)
+{
+    uint16_t carry;
+    
+    carry = (uint16_t) (sum >> 16);
+    sum = ((sum & 0xFFFF) + carry);
+    carry = (uint16_t) (sum >> 16);
+    sum = ((sum & 0xFFFF) + carry);
+    sum = ~sum;
+    return (uint16_t) sum;
+}
+
+/* Shared by IPv4 and IPv6, 'sum' is the pseudo header sum */
+static uint8_t *pkt_encode(tcp_packet_t *tcp, uint32_t sum, int len)
+{
+    int i = 0;
+    uint8_t *p;
+    
+    tcp->tp_hdr.th_chk = sum_finish(sum + tcp_sum(tcp));
+    p = (uint8_t *) malloc(len);
+    
+    if (!p) {
+        error = TCP_ERROR_NOMEM;
+        return NULL;
+    }
+    
+    p[i++] = HI16(tcp->tp_hdr.th_srcp);
+    p[i++] = LO16(tcp->tp_hdr.th_srcp);
+    p[i++] = HI16(tcp->tp_hdr.th_dstp);
+    p[i++] = LO16(tcp->tp_hdr.th_dstp);
+    p[i++] = (uint8_t) ((tcp->tp_hdr.th_seqn & 0xFF000000) >> 24);
+    p[i++] = (uint8_t) ((tcp->tp_hdr.th_seqn & 0x00FF0000) >> 16);
+    p[i++] = (uint8_t) ((tcp->tp_hdr.th_seqn & 0x0000FF00) >> 8);
+    p[i++] = (uint8_t) (tcp->tp_hdr.th_seqn & 0x000000FF);
+    p[i++] = (uint8_t) ((tcp->tp_hdr.th_ackn & 0xFF000000) >> 24);
+    p[i++] = (uint8_t) ((tcp->tp_hdr.th_ackn & 0x00FF0000) >> 16);
+    p[i++] = (uint8_t) ((tcp->tp_hdr.th_ackn & 0x0000FF00) >> 8);
+    p[i++] = (uint8_t) (tcp->tp_hdr.th_ackn & 0x000000FF);
+    p[i] = ((uint8_t) tcp->tp_hdr.th_off << 4);
+    p[i++] |= (uint8_t) tcp->tp_hdr.th_res;
+    p[i++] = tcp->tp_hdr.th_flags;
+    p[i++] = HI16(tcp->tp_hdr.th_win);
+    p[i++] = LO16(tcp->tp_hdr.th_win);
+    p[i++] = HI16(tcp->tp_hdr.th_chk);
+    p[i++] = LO16(tcp->tp_hdr.th_chk);
+    p[i++] = HI16(tcp->tp_hdr.th_urgp);
+    p[i++] = LO16(tcp->tp_hdr.th_urgp);
+    
+    if (tcp->tp_options_len > 0) {
+        if (!tcp->tp_options_buf) {
+            free(p);
+            error = TCP_ERROR_INTERNAL;
+            return NULL;
+        }
+        
+        memcpy(&p[i], tcp->tp_options_buf, tcp->tp_options_len);
+        i += tcp->tp_options_len;
+    }
+    
+    if (tcp->tp_payload_len > 0) {
+        if (!tcp->tp_payload_buf) {
+            free(p);
+            error = TCP_ERROR_INTERNAL;
+            return NULL;
+        }
+        
+        memcpy(&p[i], tcp->tp_payload_buf, tcp->tp_payload_len);
+    }
+    
+    return p;
+}
+
+/* Shared by IPv4 and IPv6, 'sum' is the pseudo header sum */
+static int pkt_decode(uint8_t *p, int len, uint32_t sum, int chk_done, tcp_packet_t *tcp)
+{
+    int i = 0;
+    uint8_t *p_opt;
+    uint8_t *p_pay;
+    int opt_len = 0;
     
     if (len < TCP_HDR_LEN) {
         error = TCP_ERROR_UNKNOWN;
         return -1;
     }
     
-    ipv4_pkt_get_payload(ip_tcp, &p);
+    /* Verify on the wire format first, bad segments cost no heap */
+    if (!chk_done) {
+        for (i = 0; i < (len - 1); i += 2)
+            sum += ((uint16_t) p[i] << 8) | p[i + 1];
+        
+        if (len & 1)
+            sum += ((uint16_t) p[len - 1] << 8);
+        
+        if (sum_finish(sum) != 0) {
+            error = TCP_ERROR_CHKSUM;
+            return -1;
+        }
+    }
+    
+    i = 0;
     tcp->tp_hdr.th_srcp = ((uint16_t) p[i++] << 8);
     tcp->tp_hdr.th_srcp |= (uint16_t) p[i++];
     tcp->tp_hdr.th_dstp = ((uint16_t) p[i++] << 8);
@@ -547,6 +897,16 @@ int tcp_ip_to_pkt(ipv4_packet_t *ip_tcp, tcp_packet_t *tcp)
     tcp->tp_hdr.th_chk |= (uint16_t) p[i++];
     tcp->tp_hdr.th_urgp = ((uint16_t) p[i++] << 8);
     tcp->tp_hdr.th_urgp |= (uint16_t) p[i++];
+    tcp->tp_options_buf = NULL;
+    tcp->tp_options_len = 0;
+    tcp->tp_payload_buf = NULL;
+    tcp->tp_payload_len = 0;
+    
+    if (((tcp->tp_hdr.th_off * 4) > len) || 
+        ((tcp->tp_hdr.th_off * 4) < TCP_HDR_LEN)) {
+        error = TCP_ERROR_UNKNOWN;
+        return -1;
+    }
     
     if (tcp->tp_hdr.th_off > (TCP_HDR_LEN / 4)) {
         opt_len = (tcp->tp_hdr.th_off * 4) - TCP_HDR_LEN;
@@ -571,6 +931,8 @@ int tcp_ip_to_pkt(ipv4_packet_t *ip_tcp, tcp_packet_t *tcp)
             if (tcp->tp_options_buf)
                 free(tcp->tp_options_buf);
             
+            tcp->tp_options_buf = NULL;
+            tcp->tp_options_len = 0;
             error = TCP_ERROR_NOMEM;
             return -1;
         }
@@ -580,26 +942,41 @@ int tcp_ip_to_pkt(ipv4_packet_t *ip_tcp, tcp_packet_t *tcp)
         memcpy(tcp->tp_payload_buf, &p[i], tcp->tp_payload_len);
     }
     
-    sum += tcp_sum(tcp);
-    carry = (uint16_t) (sum >> 16);
-    sum = ((sum & 0xFFFF) + carry);
-    sum = ~sum;
-    chk = (uint16_t) sum;
+    return 0;
+}
+
+int tcp_ip_to_pkt(ipv4_packet_t *ip_tcp, tcp_packet_t *tcp)
+{
+    uint32_t sum;
+    uint8_t *p;
+    int len;
     
-    if (tcp->tp_hdr.th_chk != chk) {
-        tcp_pkt_free(tcp);
-        error = TCP_ERROR_CHKSUM;
+    if (!ip_tcp) {
+        error = TCP_ERROR_INVAL;
         return -1;
     }
     
-    return 0;
+    if (!tcp) {
+        error = TCP_ERROR_INVAL;
+        return -1;
+    }
+    
+    len = ipv4_pkt_get_payload_len(ip_tcp);
+    ipv4_pkt_get_payload(ip_tcp, &p);
+    
+    if (!p) {
+        error = TCP_ERROR_UNKNOWN;
+        return -1;
+    }
+    
+    sum = ipv4_pseudo_sum(&ip_tcp->ip_hdr.ih_src, &ip_tcp->ip_hdr.ih_dst, 
+                          len, IPV4_PROT_TCP);
+    return pkt_decode(p, len, sum, (ip_tcp->ip_attr & IPV4_ATTR_L4_CHK), tcp);
 }
 
 int tcp_pkt_to_ip(tcp_packet_t *tcp, ipv4_packet_t *ip_tcp)
 {
-    int i = 0;
     uint32_t sum;
-    uint16_t carry;
     uint8_t *p;
     int len;
     
@@ -613,69 +990,95 @@ int tcp_pkt_to_ip(tcp_packet_t *tcp, ipv4_packet_t *ip_tcp)
         return -1;
     }
     
-    sum = ipv4_sum(ip_tcp);
-    sum += tcp_sum(tcp);
-    carry = (uint16_t) (sum >> 16);
-    sum = ((sum & 0xFFFF) + carry);
-    sum = ~sum;
-    tcp->tp_hdr.th_chk = (uint16_t) sum;
+    /* Payload isn't attached yet, ih_tlen can't be used for the pseudo header */
     len = tcp_pkt_get_len(tcp);
-    p = (uint8_t *) malloc(len);
+    sum = ipv4_pseudo_sum(&ip_tcp->ip_hdr.ih_src, &ip_tcp->ip_hdr.ih_dst, 
+                          len, IPV4_PROT_TCP);
+    p = pkt_encode(tcp, sum, len);
+    
+    if (!p)
+        return -1;
+    
+    if (ipv4_pkt_set_payload(ip_tcp, p, len) == -1) {
+        error = TCP_ERROR_INTERNAL;
+        free(p);
+        return -1;
+    }
+    
+    free(p);
+    return 0;
+}
+
+int tcp_ip6_to_pkt(ipv6_packet_t *ip_tcp, tcp_packet_t *tcp)
+{
+    uint32_t sum;
+    uint8_t *p;
+    uint8_t proto;
+    int len;
+    int off;
+    
+    if (!ip_tcp) {
+        error = TCP_ERROR_INVAL;
+        return -1;
+    }
+    
+    if (!tcp) {
+        error = TCP_ERROR_INVAL;
+        return -1;
+    }
+    
+    len = ipv6_pkt_get_payload_len(ip_tcp);
+    ipv6_pkt_get_payload(ip_tcp, &p);
     
     if (!p) {
-        error = TCP_ERROR_NOMEM;
+        error = TCP_ERROR_UNKNOWN;
         return -1;
     }
     
-    p[i++] = HI16(tcp->tp_hdr.th_srcp);
-    p[i++] = LO16(tcp->tp_hdr.th_srcp);
-    p[i++] = HI16(tcp->tp_hdr.th_dstp);
-    p[i++] = LO16(tcp->tp_hdr.th_dstp);
-    p[i++] = (uint8_t) ((tcp->tp_hdr.th_seqn & 0xFF000000) >> 24);
-    p[i++] = (uint8_t) ((tcp->tp_hdr.th_seqn & 0x00FF0000) >> 16);
-    p[i++] = (uint8_t) ((tcp->tp_hdr.th_seqn & 0x0000FF00) >> 8);
-    p[i++] = (uint8_t) (tcp->tp_hdr.th_seqn & 0x000000FF);
-    p[i++] = (uint8_t) ((tcp->tp_hdr.th_ackn & 0xFF000000) >> 24);
-    p[i++] = (uint8_t) ((tcp->tp_hdr.th_ackn & 0x00FF0000) >> 16);
-    p[i++] = (uint8_t) ((tcp->tp_hdr.th_ackn & 0x0000FF00) >> 8);
-    p[i++] = (uint8_t) (tcp->tp_hdr.th_ackn & 0x000000FF);
-    p[i] = ((uint8_t) tcp->tp_hdr.th_off << 4);
-    p[i++] |= (uint8_t) tcp->tp_hdr.th_res;
-    p[i++] = tcp->tp_hdr.th_flags;
-    p[i++] = HI16(tcp->tp_hdr.th_win);
-    p[i++] = LO16(tcp->tp_hdr.th_win);
-    p[i++] = HI16(tcp->tp_hdr.th_chk);
-    p[i++] = LO16(tcp->tp_hdr.th_chk);
-    p[i++] = HI16(tcp->tp_hdr.th_urgp);
-    p[i++] = LO16(tcp->tp_hdr.th_urgp);
+    off = ipv6_ext_walk(p, len, ip_tcp->ip_hdr.ih_nhdr, &proto);
     
-    if (tcp->tp_options_len > 0) {
-        if (!tcp->tp_options_buf) {
-            free(p);
-            error = TCP_ERROR_INTERNAL;
-            return -1;
-        }
-        
-        memcpy(&p[i], tcp->tp_options_buf, tcp->tp_options_len);
-        i += tcp->tp_options_len;
+    if ((off == -1) || (proto != IPV6_NHDR_TCP)) {
+        error = TCP_ERROR_UNKNOWN;
+        return -1;
     }
     
-    if (tcp->tp_payload_len > 0) {
-        if (!tcp->tp_payload_buf) {
-            free(p);
-            error = TCP_ERROR_INTERNAL;
-            return -1;
-        }
-        
-        memcpy(&p[i], tcp->tp_payload_buf, tcp->tp_payload_len);
+    len -= off;
+    sum = ipv6_pseudo_sum(&ip_tcp->ip_hdr.ih_src, &ip_tcp->ip_hdr.ih_dst, 
+                          len, IPV6_NHDR_TCP);
+    return pkt_decode(&p[off], len, sum, 0, tcp);
+}
+
+int tcp_pkt_to_ip6(tcp_packet_t *tcp, ipv6_packet_t *ip_tcp)
+{
+    uint32_t sum;
+    uint8_t *p;
+    int len;
+    
+    if (!tcp) {
+        error = TCP_ERROR_INVAL;
+        return -1;
     }
     
-    if (ipv4_pkt_set_payload(ip_tcp, p, len) == -1) {
+    if (!ip_tcp) {
+        error = TCP_ERROR_INVAL;
+        return -1;
+    }
+    
+    len = tcp_pkt_get_len(tcp);
+    sum = ipv6_pseudo_sum(&ip_tcp->ip_hdr.ih_src, &ip_tcp->ip_hdr.ih_dst, 
+                          len, IPV6_NHDR_TCP);
+    p = pkt_encode(tcp, sum, len);
+    
+    if (!p)
+        return -1;
+    
+    if (ipv6_pkt_set_payload(ip_tcp, p, len) == -1) {
         error = TCP_ERROR_INTERNAL;
         free(p);
         return -1;
     }
     
+    ipv6_pkt_set_nhdr(ip_tcp, IPV6_NHDR_TCP);
     free(p);
     return 0;
 }
@@ -5,9 +5,9 @@
  * Project  : lib-avr
  * Author   : Copyright (C) 2019 Johannes Krottmayer <krjdev@gmail.com>
  * Created  : 2019-08-09
- * Modified : 2019-08-11
+ * Modified : 2026-10-19
  * Revised  : 
- * Version  : 0.1.0.2
+ * Version  : 0.3.0.0
  * License  : ISC (see file LICENSE.txt)
  * Target   : Atmel AVR Series
  *
@@ -23,6 +23,7 @@
 #include <stdint.h>
 
 #include "ipv4.h"
+#include "ipv6.h"
 
 #define TCP_ERROR_SUCCESS       0
 #define TCP_ERROR_INVAL         1
@@ -40,6 +41,23 @@
 #define TCP_FLAG_ECE            0x40
 #define TCP_FLAG_CWR            0x80
 
+/* Option kinds */
+#define TCP_OPT_EOL             0
+#define TCP_OPT_NOP             1
+#define TCP_OPT_MSS             2
+#define TCP_OPT_WSCALE          3
+#define TCP_OPT_SACKP           4
+
+/* Option presence flags (tcp_options_t) */
+#define TCP_OPTF_MSS            0x01
+#define TCP_OPTF_WSCALE         0x02
+#define TCP_OPTF_SACKP          0x04
+
+#define TCP_OPT_LEN_MAX         40
+#define TCP_MSS_DEFAULT         536     /* RFC 879, used without MSS option */
+#define TCP_MSS_ETHERNET        1460    /* 1500 byte MTU - IPv4 - TCP header */
+#define TCP_WSCALE_MAX          14      /* RFC 7323 */
+
 typedef struct tcp_hdr {
     uint16_t th_srcp;
     uint16_t th_dstp;
@@ -61,6 +79,19 @@ typedef struct tcp_packet {
     int tp_payload_len;
 } tcp_packet_t;
 
+typedef struct tcp_options {
+    uint8_t to_flags;   /* TCP_OPTF_* */
+    uint16_t to_mss;    /* Maximum segment size */
+    uint8_t to_wscale;  /* Window scale shift count */
+} tcp_options_t;
+
+typedef struct tcp_nego {
+    uint16_t tn_mss;        /* Effective send MSS */
+    uint8_t tn_snd_wscale;  /* Shift for windows received from peer */
+    uint8_t tn_rcv_wscale;  /* Shift for windows sent to peer */
+    uint8_t tn_sack;        /* SACK permitted on both sides */
+} tcp_nego_t;
+
 extern int tcp_pkt_set_srcp(tcp_packet_t *tcp, uint16_t srcp);
 extern int tcp_pkt_set_dstp(tcp_packet_t *tcp, uint16_t dstp);
 extern int tcp_pkt_set_seqn(tcp_packet_t *tcp, uint32_t seqn);
@@ -88,8 +119,19 @@ extern int tcp_pkt_create(uint16_t srcp, uint16_t dstp,
                           uint16_t urgp, 
                           tcp_packet_t *tcp);
 extern int tcp_pkt_free(tcp_packet_t *tcp);
+extern int tcp_opt_encode(tcp_options_t *opt, uint8_t *buf, int len);
+extern int tcp_opt_decode(uint8_t *buf, int len, tcp_options_t *opt);
+extern int tcp_opt_negotiate(tcp_options_t *local, 
+                             tcp_options_t *peer, 
+                             tcp_nego_t *nego);
+extern int tcp_pkt_set_opts(tcp_packet_t *tcp, tcp_options_t *opt);
+extern int tcp_pkt_get_opts(tcp_packet_t *tcp, tcp_options_t *opt);
+extern int tcp_pkt_set_win_scaled(tcp_packet_t *tcp, uint32_t win, uint8_t shift);
+extern int tcp_pkt_get_win_scaled(tcp_packet_t *tcp, uint8_t shift, uint32_t *win);
 extern int tcp_ip_to_pkt(ipv4_packet_t *ip, tcp_packet_t *tcp);
 extern int tcp_pkt_to_ip(tcp_packet_t *tcp, ipv4_packet_t *ip);
+extern int tcp_ip6_to_pkt(ipv6_packet_t *ip, tcp_packet_t *tcp);
+extern int tcp_pkt_to_ip6(tcp_packet_t *tcp, ipv6_packet_t *ip);
 extern int tcp_get_last_error(void);
 
 #endif
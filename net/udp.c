@@ -5,9 +5,9 @@
  * Project  : lib-avr
  * Author   : Copyright (C) 2019 Johannes Krottmayer <krjdev@gmail.com>
  * Created  : 2019-01-30
- * Modified : 2019-08-09
+ * Modified : 2026-10-19
  * Revised  : 
- * Version  : 0.3.0.1
+ * Version  : 0.4.0.0
  * License  : ISC (see file LICENSE.txt)
  * Target   : Atmel AVR Series
  *
@@ -29,31 +29,6 @@
 
 static int error = UDP_ERROR_SUCCESS;
 
-static uint32_t ipv4_sum(ipv4_packet_t *ip)
-{
-    uint32_t sum = 0;
-    uint16_t tmp;
-    
-    if (!ip)
-        return 0;
-    
-    tmp = ((uint16_t) ip->ip_hdr.ih_src.ia_byte0 << 8);
-    tmp |= (uint16_t) ip->ip_hdr.ih_src.ia_byte1;
-    sum += tmp;
-    tmp = ((uint16_t) ip->ip_hdr.ih_src.ia_byte2 << 8);
-    tmp |= (uint16_t) ip->ip_hdr.ih_src.ia_byte3;
-    sum += tmp;
-    tmp = ((uint16_t) ip->ip_hdr.ih_dst.ia_byte0 << 8);
-    tmp |= (uint16_t) ip->ip_hdr.ih_dst.ia_byte1;
-    sum += tmp;
-    tmp = ((uint16_t) ip->ip_hdr.ih_dst.ia_byte2 << 8);
-    tmp |= (uint16_t) ip->ip_hdr.ih_dst.ia_byte3;
-    sum += tmp;
-    sum += ip->ip_hdr.ih_prot;
-    sum += (ip->ip_hdr.ih_tlen - (ip->ip_hdr.ih_ihl * 4));
-    return sum;
-}
-
 static uint32_t udp_sum(udp_packet_t *udp)
 {
     int i = 0;
@@ -250,35 +225,35 @@ int udp_pkt_free(udp_packet_t *udp)
     return 0;
 }
 
-int udp_pkt_to_ip(udp_packet_t *udp, ipv4_packet_t *ip_udp)
+static uint16_t sum_finish(uint32_t sum)
 {
-    uint32_t sum;
     uint16_t carry;
-    uint8_t *p;
-    uint8_t *p_payl;
-    int i = 0;
-    
-    if (!udp) {
-        error = UDP_ERROR_INVAL;
-        return -1;
-    }
-    
-    if (!ip_udp) {
-        error = UDP_ERROR_INVAL;
-        return -1;
-    }
     
-    sum = ipv4_sum(ip_udp);
-    sum += udp_sum(udp);
+    carry = (uint16_t) (sum >> 16);
+    sum = ((sum & 0xFFFF) + carry);
     carry = (uint16_t) (sum >> 16);
     sum = ((sum & 0xFFFF) + carry);
     sum = ~sum;
-    udp->up_hdr.uh_chk = (uint16_t) sum;
+    
+    /* Zero means 'no checksum' (RFC 768) */
+    if ((uint16_t) sum == 0)
+        return 0xFFFF;
+    
+    return (uint16_t) sum;
+}
+
+/* Shared by IPv4 and IPv6, 'sum' is the pseudo header sum */
+static uint8_t *pkt_encode(udp_packet_t *udp, uint32_t sum)
+{
+    uint8_t *p;
+    int i = 0;
+    
+    udp->up_hdr.uh_chk = sum_finish(sum + udp_sum(udp));
     p = (uint8_t *) malloc(udp->up_hdr.uh_len);
     
     if (!p) {
         error = UDP_ERROR_NOMEM;
-        return -1;
+        return NULL;
     }
     
     p[i++] = HI16(udp->up_hdr.uh_srcp);
@@ -290,13 +265,109 @@ int udp_pkt_to_ip(udp_packet_t *udp, ipv4_packet_t *ip_udp)
     p[i++] = HI16(udp->up_hdr.uh_chk);
     p[i++] = LO16(udp->up_hdr.uh_chk);
     
-    if (udp_pkt_get_payload(udp, &p_payl) == -1) {
-        free(p);
-        error = UDP_ERROR_INTERNAL;
+    if (udp->up_payload_len > 0) {
+        if (!udp->up_payload_buf) {
+            free(p);
+            error = UDP_ERROR_INTERNAL;
+            return NULL;
+        }
+        
+        memcpy(&p[i], udp->up_payload_buf, udp->up_payload_len);
+    }
+    
+    return p;
+}
+
+/* Shared by IPv4 and IPv6, 'sum' is the pseudo header sum */
+static int pkt_decode(uint8_t *p, int len, uint32_t sum, int chk_opt, int chk_done, udp_packet_t *udp)
+{
+    uint8_t *p_pay;
+    int i = 0;
+    
+    if (len < UDP_HDR_LEN) {
+        error = UDP_ERROR_UNKNOWN;
         return -1;
     }
     
-    memcpy(&p[i], p_payl, udp_pkt_get_payload_len(udp));
+    udp->up_hdr.uh_srcp = ((uint16_t) p[i++] << 8);
+    udp->up_hdr.uh_srcp |= (uint16_t) p[i++];
+    udp->up_hdr.uh_dstp = ((uint16_t) p[i++] << 8);
+    udp->up_hdr.uh_dstp |= (uint16_t) p[i++];
+    udp->up_hdr.uh_len = ((uint16_t) p[i++] << 8);
+    udp->up_hdr.uh_len |= (uint16_t) p[i++];
+    udp->up_hdr.uh_chk = ((uint16_t) p[i++] << 8);
+    udp->up_hdr.uh_chk |= (uint16_t) p[i++];
+    udp->up_payload_buf = NULL;
+    udp->up_payload_len = 0;
+    
+    if (udp->up_hdr.uh_len != len) {
+        error = UDP_ERROR_UNKNOWN;
+        return -1;
+    }
+    
+    /* Only IPv4 allows a disabled checksum (RFC 8200 8.1) */
+    if (udp->up_hdr.uh_chk == 0) {
+        if (!chk_opt) {
+            error = UDP_ERROR_CHKSUM;
+            return -1;
+        }
+    } else if (!chk_done) {
+        /* Skipped if the NIC has verified it already */
+        sum += ((uint16_t) p[0] << 8) | p[1];
+        sum += ((uint16_t) p[2] << 8) | p[3];
+        sum += udp->up_hdr.uh_len;
+        
+        for (i = UDP_HDR_LEN; i < (len - 1); i += 2)
+            sum += ((uint16_t) p[i] << 8) | p[i + 1];
+        
+        if (len & 1)
+            sum += ((uint16_t) p[len - 1] << 8);
+        
+        if (sum_finish(sum) != udp->up_hdr.uh_chk) {
+            error = UDP_ERROR_CHKSUM;
+            return -1;
+        }
+    }
+    
+    /* Verified before allocating, bad datagrams cost no heap */
+    if (len > UDP_HDR_LEN) {
+        p_pay = (uint8_t *) malloc((len - UDP_HDR_LEN));
+        
+        if (!p_pay) {
+            error = UDP_ERROR_NOMEM;
+            return -1;
+        }
+        
+        udp->up_payload_buf = p_pay;
+        udp->up_payload_len = (len - UDP_HDR_LEN);
+        memcpy(udp->up_payload_buf, &p[UDP_HDR_LEN], udp->up_payload_len);
+    }
+    
+    return 0;
+}
+
+int udp_pkt_to_ip(udp_packet_t *udp, ipv4_packet_t *ip_udp)
+{
+    uint32_t sum;
+    uint8_t *p;
+    
+    if (!udp) {
+        error = UDP_ERROR_INVAL;
+        return -1;
+    }
+    
+    if (!ip_udp) {
+        error = UDP_ERROR_INVAL;
+        return -1;
+    }
+    
+    /* Payload isn't attached yet, use the UDP length for the pseudo header */
+    sum = ipv4_pseudo_sum(&ip_udp->ip_hdr.ih_src, &ip_udp->ip_hdr.ih_dst, 
+                          udp->up_hdr.uh_len, IPV4_PROT_UDP);
+    p = pkt_encode(udp, sum);
+    
+    if (!p)
+        return -1;
     
     if (ipv4_pkt_set_payload(ip_udp, p, udp->up_hdr.uh_len) == -1) {
         error = UDP_ERROR_INTERNAL;
@@ -310,12 +381,8 @@ int udp_pkt_to_ip(udp_packet_t *udp, ipv4_packet_t *ip_udp)
 
 int udp_ip_to_pkt(ipv4_packet_t *ip_udp, udp_packet_t *udp)
 {
-    uint8_t *p;
-    uint8_t *p_pay;
     uint32_t sum;
-    uint16_t carry;
-    uint16_t chk;
-    int i = 0;
+    uint8_t *p;
     int len;
     
     if (!ip_udp) {
@@ -328,57 +395,91 @@ int udp_ip_to_pkt(ipv4_packet_t *ip_udp, udp_packet_t *udp)
         return -1;
     }
     
-    sum = ipv4_sum(ip_udp);
     len = ipv4_pkt_get_payload_len(ip_udp);
+    ipv4_pkt_get_payload(ip_udp, &p);
     
-    if (len < UDP_HDR_LEN) {
+    if (!p) {
         error = UDP_ERROR_UNKNOWN;
         return -1;
     }
     
-    ipv4_pkt_get_payload(ip_udp, &p);
-    udp->up_hdr.uh_srcp = ((uint16_t) p[i++] << 8);
-    udp->up_hdr.uh_srcp |= (uint16_t) p[i++];
-    udp->up_hdr.uh_dstp = ((uint16_t) p[i++] << 8);
-    udp->up_hdr.uh_dstp |= (uint16_t) p[i++];
-    udp->up_hdr.uh_len = ((uint16_t) p[i++] << 8);
-    udp->up_hdr.uh_len |= (uint16_t) p[i++];
-    udp->up_hdr.uh_chk = ((uint16_t) p[i++] << 8);
-    udp->up_hdr.uh_chk |= (uint16_t) p[i++];
+    sum = ipv4_pseudo_sum(&ip_udp->ip_hdr.ih_src, &ip_udp->ip_hdr.ih_dst, 
+                          len, IPV4_PROT_UDP);
+    return pkt_decode(p, len, sum, 1, (ip_udp->ip_attr & IPV4_ATTR_L4_CHK), udp);
+}
+
+int udp_pkt_to_ip6(udp_packet_t *udp, ipv6_packet_t *ip_udp)
+{
+    uint32_t sum;
+    uint8_t *p;
     
-    if (udp->up_hdr.uh_len != len) {
-        error = UDP_ERROR_UNKNOWN;
+    if (!udp) {
+        error = UDP_ERROR_INVAL;
         return -1;
     }
     
-    if (len > UDP_HDR_LEN) {
-        p_pay = (uint8_t *) malloc((len - UDP_HDR_LEN));
-        
-        if (!p_pay) {
-            error = UDP_ERROR_NOMEM;
-            return -1;
-        }
-        
-        udp->up_payload_buf = p_pay;
-        udp->up_payload_len = (len - UDP_HDR_LEN);
-        memcpy(udp->up_payload_buf, &p[i], udp->up_payload_len);
+    if (!ip_udp) {
+        error = UDP_ERROR_INVAL;
+        return -1;
     }
     
-    sum += udp_sum(udp);
-    carry = (uint16_t) (sum >> 16);
-    sum = ((sum & 0xFFFF) + carry);
-    sum = ~sum;
-    chk = (uint16_t) sum;
+    sum = ipv6_pseudo_sum(&ip_udp->ip_hdr.ih_src, &ip_udp->ip_hdr.ih_dst, 
+                          udp->up_hdr.uh_len, IPV6_NHDR_UDP);
+    p = pkt_encode(udp, sum);
     
-    if (udp->up_hdr.uh_chk != chk) {
-        error = UDP_ERROR_CHKSUM;
-        udp_pkt_free(udp);
+    if (!p)
+        return -1;
+    
+    if (ipv6_pkt_set_payload(ip_udp, p, udp->up_hdr.uh_len) == -1) {
+        error = UDP_ERROR_INTERNAL;
+        free(p);
         return -1;
     }
     
+    ipv6_pkt_set_nhdr(ip_udp, IPV6_NHDR_UDP);
+    free(p);
     return 0;
 }
 
+int udp_ip6_to_pkt(ipv6_packet_t *ip_udp, udp_packet_t *udp)
+{
+    uint32_t sum;
+    uint8_t *p;
+    uint8_t proto;
+    int len;
+    int off;
+    
+    if (!ip_udp) {
+        error = UDP_ERROR_INVAL;
+        return -1;
+    }
+    
+    if (!udp) {
+        error = UDP_ERROR_INVAL;
+        return -1;
+    }
+    
+    len = ipv6_pkt_get_payload_len(ip_udp);
+    ipv6_pkt_get_payload(ip_udp, &p);
+    
+    if (!p) {
+        error = UDP_ERROR_UNKNOWN;
+        return -1;
+    }
+    
+    off = ipv6_ext_walk(p, len, ip_udp->ip_hdr.ih_nhdr, &proto);
+    
+    if ((off == -1) || (proto != IPV6_NHDR_UDP)) {
+        error = UDP_ERROR_UNKNOWN;
+        return -1;
+    }
+    
+    len -= off;
+    sum = ipv6_pseudo_sum(&ip_udp->ip_hdr.ih_src, &ip_udp->ip_hdr.ih_dst, 
+                          len, IPV6_NHDR_UDP);
+    return pkt_decode(&p[off], len, sum, 0, 0, udp);
+}
+
 int udp_get_last_error(void)
 {
     int err;
@@ -5,9 +5,9 @@
  * Project  : lib-avr
  * Author   : Copyright (C) 2019 Johannes Krottmayer <krjdev@gmail.com>
  * Created  : 2019-01-30
- * Modified : 2019-08-09
+ * Modified : 2026-10-19
  * Revised  : 
- * Version  : 0.3.0.1
+ * Version  : 0.4.0.0
  * License  : ISC (see file LICENSE.txt)
  * Target   : Atmel AVR Series
  *
@@ -23,6 +23,7 @@
 #include <stdint.h>
 
 #include "ipv4.h"
+#include "ipv6.h"
 
 #define UDP_ERROR_SUCCESS       0
 #define UDP_ERROR_INVAL         1
@@ -58,6 +59,8 @@ extern int udp_pkt_create(uint16_t srcp, uint16_t dstp,
 extern int udp_pkt_free(udp_packet_t *udp);
 extern int udp_pkt_to_ip(udp_packet_t *udp, ipv4_packet_t *ip_udp);
 extern int udp_ip_to_pkt(ipv4_packet_t *ip_udp, udp_packet_t *udp);
+extern int udp_pkt_to_ip6(udp_packet_t *udp, ipv6_packet_t *ip_udp);
+extern int udp_ip6_to_pkt(ipv6_packet_t *ip_udp, udp_packet_t *udp);
 extern int udp_get_last_error(void);
 
 #endif
@@ -0,0 +1,591 @@
+/**
+ *
+ * File Name: udp_socket.c
+ * Title    : UDP socket library
+ * Project  : lib-avr
+ * Author   : Copyright (C) 2026 Johannes Krottmayer <krjdev@gmail.com>
+ * Created  : 2026-10-19
+ * Modified : 
+ * Revised  : 
+ * Version  : 0.1.0.0
+ * License  : ISC (see file LICENSE.txt)
+ * Target   : Atmel AVR Series
+ *
+ * NOTE: This code is currently below version 1.0, and therefore is considered
+ * to be lacking in some functionality or documentation, or may not be fully
+ * tested. Nonetheless, you can expect most functions to work.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "udp.h"
+#include "icmp.h"
+#include "../lib/buffer.h"
+#include "udp_socket.h"
+
+/* Receive queue record: src IP (4), src port (2), length (2), data */
+#define REC_HDR_LEN     8
+#define DRAIN_LEN       16
+
+#define HASH(port)      ((port) & (UDP_SOCKET_HASH_SIZE - 1))
+
+#define HI16(val)       ((uint8_t) (((val) & 0xFF00) >> 8))
+#define LO16(val)       ((uint8_t) ((val) & 0x00FF))
+
+typedef struct udp_sock {
+    uint8_t us_used;
+    uint16_t us_port;
+    int8_t us_next;
+    uint8_t us_df;
+    buffer_t *us_rxq;
+} udp_sock_t;
+
+static int error = UDP_SOCKET_ERROR_SUCCESS;
+static udp_sock_t sock[UDP_SOCKET_MAX];
+/* Empty chains also before udp_socket_init() */
+static int8_t hash[UDP_SOCKET_HASH_SIZE] = { [0 ... (UDP_SOCKET_HASH_SIZE - 1)] = -1 };
+static uint16_t port_next = UDP_SOCKET_PORT_EPHEMERAL;
+static ipv4_addr_t ip_local;
+static udp_socket_output_t output_hook = NULL;
+static udp_socket_stats_t stats;
+
+static int sock_lookup(uint16_t port)
+{
+    int8_t sd;
+    
+    sd = hash[HASH(port)];
+    
+    while (sd != -1) {
+        if (sock[sd].us_port == port)
+            return sd;
+        
+        sd = sock[sd].us_next;
+    }
+    
+    return -1;
+}
+
+static void sock_unhash(int sd)
+{
+    int8_t *p;
+    
+    if (!sock[sd].us_port)
+        return;
+    
+    p = &hash[HASH(sock[sd].us_port)];
+    
+    while (*p != -1) {
+        if (*p == sd) {
+            *p = sock[sd].us_next;
+            break;
+        }
+        
+        p = &sock[(int) *p].us_next;
+    }
+    
+    sock[sd].us_next = -1;
+    sock[sd].us_port = 0;
+}
+
+static void sock_hash(int sd, uint16_t port)
+{
+    sock[sd].us_port = port;
+    sock[sd].us_next = hash[HASH(port)];
+    hash[HASH(port)] = sd;
+}
+
+static uint16_t port_ephemeral(void)
+{
+    uint16_t port;
+    uint16_t n = 0;
+    
+    do {
+        port = port_next;
+        
+        if (port_next == 0xFFFF)
+            port_next = UDP_SOCKET_PORT_EPHEMERAL;
+        else
+            port_next++;
+        
+        if (sock_lookup(port) == -1)
+            return port;
+    } while (++n < (0xFFFF - UDP_SOCKET_PORT_EPHEMERAL));
+    
+    return 0;
+}
+
+static int sock_valid(int sd)
+{
+    if ((sd < 0) || (sd >= UDP_SOCKET_MAX))
+        return 0;
+    
+    return sock[sd].us_used;
+}
+
+static int ipv4_send(ipv4_addr_t *dst, uint8_t prot, uint8_t *buf, int len)
+{
+    ipv4_packet_t ip;
+    int ret;
+    
+    ipv4_pkt_create_empty(&ip, 0, 0);
+    ipv4_pkt_set_prot(&ip, prot);
+    ipv4_pkt_set_src(&ip, &ip_local);
+    ipv4_pkt_set_dst(&ip, dst);
+    
+    if (ipv4_pkt_set_payload(&ip, buf, len) == -1) {
+        error = UDP_SOCKET_ERROR_NOMEM;
+        return -1;
+    }
+    
+    ret = output_hook(&ip);
+    ipv4_pkt_free(&ip);
+    
+    if (ret == -1) {
+        error = UDP_SOCKET_ERROR_OUTPUT;
+        return -1;
+    }
+    
+    return 0;
+}
+
+static void send_unreachable_port(ipv4_packet_t *ip)
+{
+    icmp_packet_t icmp;
+    ipv4_addr_t dst;
+    uint8_t *p;
+    int len;
+    
+    /* Never answer broadcast or multicast datagrams (RFC 1122 3.2.2) */
+    if (ipv4_addr_is_broadcast(&ip->ip_hdr.ih_dst))
+        return;
+    
+    if ((ip->ip_hdr.ih_dst.ia_byte0 & 0xF0) == 0xE0)
+        return;
+    
+    len = ipv4_pkt_get_len_icmp(ip);
+    p = (uint8_t *) malloc(len);
+    
+    if (!p)
+        return;
+    
+    if (ipv4_pkt_to_buf_icmp(ip, p) == -1) {
+        free(p);
+        return;
+    }
+    
+    memset(&icmp, 0, sizeof(icmp_packet_t));
+    
+    if (icmp_create_unreachable_port(p, len, 0, &icmp) == -1) {
+        free(p);
+        return;
+    }
+    
+    free(p);
+    len = icmp_pkt_get_len(&icmp);
+    p = (uint8_t *) malloc(len);
+    
+    if (!p) {
+        icmp_pkt_free(&icmp);
+        return;
+    }
+    
+    if (icmp_pkt_to_buf(&icmp, p) != -1) {
+        ipv4_addr_cpy(&dst, &ip->ip_hdr.ih_src);
+        ipv4_send(&dst, IPV4_PROT_ICMP, p, len);
+    }
+    
+    free(p);
+    icmp_pkt_free(&icmp);
+}
+
+int udp_socket_init(ipv4_addr_t *src_ip, udp_socket_output_t output)
+{
+    int i;
+    
+    if (!src_ip) {
+        error = UDP_SOCKET_ERROR_INVAL;
+        return -1;
+    }
+    
+    if (!output) {
+        error = UDP_SOCKET_ERROR_INVAL;
+        return -1;
+    }
+    
+    for (i = 0; i < UDP_SOCKET_MAX; i++) {
+        if (sock[i].us_used && sock[i].us_rxq)
+            buffer_close(sock[i].us_rxq);
+        
+        sock[i].us_used = 0;
+        sock[i].us_port = 0;
+        sock[i].us_next = -1;
+        sock[i].us_df = 0;
+        sock[i].us_rxq = NULL;
+    }
+    
+    for (i = 0; i < UDP_SOCKET_HASH_SIZE; i++)
+        hash[i] = -1;
+    
+    ipv4_addr_cpy(&ip_local, src_ip);
+    output_hook = output;
+    port_next = UDP_SOCKET_PORT_EPHEMERAL;
+    memset(&stats, 0, sizeof(udp_socket_stats_t));
+    return 0;
+}
+
+int udp_socket_open(int rxq_len)
+{
+    int i;
+    
+    if (rxq_len <= REC_HDR_LEN) {
+        error = UDP_SOCKET_ERROR_INVAL;
+        return -1;
+    }
+    
+    for (i = 0; i < UDP_SOCKET_MAX; i++) {
+        if (!sock[i].us_used)
+            break;
+    }
+    
+    if (i == UDP_SOCKET_MAX) {
+        error = UDP_SOCKET_ERROR_NOSOCK;
+        return -1;
+    }
+    
+    sock[i].us_rxq = buffer_init(rxq_len);
+    
+    if (!sock[i].us_rxq) {
+        error = UDP_SOCKET_ERROR_NOMEM;
+        return -1;
+    }
+    
+    sock[i].us_used = 1;
+    sock[i].us_port = 0;
+    sock[i].us_next = -1;
+    sock[i].us_df = 0;
+    return i;
+}
+
+int udp_socket_close(int sd)
+{
+    if (!sock_valid(sd)) {
+        error = UDP_SOCKET_ERROR_INVAL;
+        return -1;
+    }
+    
+    sock_unhash(sd);
+    buffer_close(sock[sd].us_rxq);
+    sock[sd].us_rxq = NULL;
+    sock[sd].us_used = 0;
+    return 0;
+}
+
+int udp_socket_bind(int sd, uint16_t port)
+{
+    if (!sock_valid(sd)) {
+        error = UDP_SOCKET_ERROR_INVAL;
+        return -1;
+    }
+    
+    if (sock[sd].us_port) {
+        error = UDP_SOCKET_ERROR_INVAL;
+        return -1;
+    }
+    
+    if (!port) {
+        port = port_ephemeral();
+        
+        if (!port) {
+            error = UDP_SOCKET_ERROR_NOPORT;
+            return -1;
+        }
+    } else if (sock_lookup(port) != -1) {
+        error = UDP_SOCKET_ERROR_INUSE;
+        return -1;
+    }
+    
+    sock_hash(sd, port);
+    return 0;
+}
+
+int udp_socket_sendto(int sd, 
+                      uint8_t *buf, 
+                      int len, 
+                      ipv4_addr_t *dst_ip, 
+                      uint16_t dst_port)
+{
+    udp_packet_t udp;
+    ipv4_packet_t ip;
+    int ret;
+    
+    if (!sock_valid(sd)) {
+        error = UDP_SOCKET_ERROR_INVAL;
+        return -1;
+    }
+    
+    if (!buf || !dst_ip) {
+        error = UDP_SOCKET_ERROR_INVAL;
+        return -1;
+    }
+    
+    if (len < 1) {
+        error = UDP_SOCKET_ERROR_INVAL;
+        return -1;
+    }
+    
+    if (!output_hook) {
+        error = UDP_SOCKET_ERROR_OUTPUT;
+        return -1;
+    }
+    
+    /* Implicit bind to an ephemeral port */
+    if (!sock[sd].us_port) {
+        if (udp_socket_bind(sd, 0) == -1)
+            return -1;
+    }
+    
+    memset(&udp, 0, sizeof(udp_packet_t));
+    
+    if (udp_pkt_create(sock[sd].us_port, dst_port, buf, len, &udp) == -1) {
+        error = UDP_SOCKET_ERROR_UDPLIB;
+        return -1;
+    }
+    
+    if (!udp.up_payload_buf) {
+        error = UDP_SOCKET_ERROR_NOMEM;
+        return -1;
+    }
+    
+    ipv4_pkt_create_empty(&ip, (sock[sd].us_df ? IPV4_FLAG_DF : 0), 0);
+    ipv4_pkt_set_prot(&ip, IPV4_PROT_UDP);
+    ipv4_pkt_set_src(&ip, &ip_local);
+    ipv4_pkt_set_dst(&ip, dst_ip);
+    
+    if (udp_pkt_to_ip(&udp, &ip) == -1) {
+        udp_pkt_free(&udp);
+        error = UDP_SOCKET_ERROR_UDPLIB;
+        return -1;
+    }
+    
+    udp_pkt_free(&udp);
+    ret = output_hook(&ip);
+    ipv4_pkt_free(&ip);
+    
+    if (ret == -1) {
+        error = UDP_SOCKET_ERROR_OUTPUT;
+        return -1;
+    }
+    
+    stats.tx_dgr++;
+    return len;
+}
+
+int udp_socket_recvfrom(int sd, 
+                        uint8_t *buf, 
+                        int len, 
+                        ipv4_addr_t *src_ip, 
+                        uint16_t *src_port)
+{
+    uint8_t hdr[REC_HDR_LEN];
+    uint8_t drain[DRAIN_LEN];
+    int dlen;
+    int n;
+    
+    if (!sock_valid(sd)) {
+        error = UDP_SOCKET_ERROR_INVAL;
+        return -1;
+    }
+    
+    if (!buf) {
+        error = UDP_SOCKET_ERROR_INVAL;
+        return -1;
+    }
+    
+    if (len < 1) {
+        error = UDP_SOCKET_ERROR_INVAL;
+        return -1;
+    }
+    
+    if (!sock[sd].us_port) {
+        error = UDP_SOCKET_ERROR_NOTBOUND;
+        return -1;
+    }
+    
+    /* Nothing queued, non-blocking (0 is an empty datagram) */
+    if (buffer_get_num(sock[sd].us_rxq) < REC_HDR_LEN) {
+        error = UDP_SOCKET_ERROR_AGAIN;
+        return -1;
+    }
+    
+    if (buffer_rd(sock[sd].us_rxq, hdr, REC_HDR_LEN) == -1) {
+        error = UDP_SOCKET_ERROR_INTERNAL;
+        return -1;
+    }
+    
+    if (src_ip) {
+        src_ip->ia_byte0 = hdr[0];
+        src_ip->ia_byte1 = hdr[1];
+        src_ip->ia_byte2 = hdr[2];
+        src_ip->ia_byte3 = hdr[3];
+    }
+    
+    if (src_port) {
+        (*src_port) = ((uint16_t) hdr[4] << 8);
+        (*src_port) |= (uint16_t) hdr[5];
+    }
+    
+    dlen = ((int) hdr[6] << 8) | (int) hdr[7];
+    
+    if (len > dlen)
+        len = dlen;
+    
+    if (buffer_rd(sock[sd].us_rxq, buf, len) == -1) {
+        error = UDP_SOCKET_ERROR_INTERNAL;
+        return -1;
+    }
+    
+    /* Datagram semantics: discard what doesn't fit into the user buffer */
+    dlen -= len;
+    
+    while (dlen > 0) {
+        n = (dlen > DRAIN_LEN) ? DRAIN_LEN : dlen;
+        
+        if (buffer_rd(sock[sd].us_rxq, drain, n) == -1) {
+            error = UDP_SOCKET_ERROR_INTERNAL;
+            return -1;
+        }
+        
+        dlen -= n;
+    }
+    
+    return len;
+}
+
+int udp_socket_pending(int sd)
+{
+    if (!sock_valid(sd)) {
+        error = UDP_SOCKET_ERROR_INVAL;
+        return -1;
+    }
+    
+    return (buffer_get_num(sock[sd].us_rxq) >= REC_HDR_LEN);
+}
+
+int udp_socket_setopt(int sd, int opt, int val)
+{
+    if (!sock_valid(sd)) {
+        error = UDP_SOCKET_ERROR_INVAL;
+        return -1;
+    }
+    
+    switch (opt) {
+    case UDP_SOCKET_OPT_DF:
+        sock[sd].us_df = (val ? 1 : 0);
+        break;
+    default:
+        error = UDP_SOCKET_ERROR_INVAL;
+        return -1;
+    }
+    
+    return 0;
+}
+
+int udp_socket_getopt(int sd, int opt, int *val)
+{
+    if (!sock_valid(sd) || !val) {
+        error = UDP_SOCKET_ERROR_INVAL;
+        return -1;
+    }
+    
+    switch (opt) {
+    case UDP_SOCKET_OPT_DF:
+        (*val) = sock[sd].us_df;
+        break;
+    default:
+        error = UDP_SOCKET_ERROR_INVAL;
+        return -1;
+    }
+    
+    return 0;
+}
+
+int udp_socket_input(ipv4_packet_t *ip)
+{
+    udp_packet_t udp;
+    uint8_t hdr[REC_HDR_LEN];
+    int sd;
+    int len;
+    
+    if (!ip) {
+        error = UDP_SOCKET_ERROR_INVAL;
+        return -1;
+    }
+    
+    if (ip->ip_hdr.ih_prot != IPV4_PROT_UDP) {
+        error = UDP_SOCKET_ERROR_INVAL;
+        return -1;
+    }
+    
+    memset(&udp, 0, sizeof(udp_packet_t));
+    
+    if (udp_ip_to_pkt(ip, &udp) == -1) {
+        error = UDP_SOCKET_ERROR_UDPLIB;
+        return -1;
+    }
+    
+    sd = sock_lookup(udp.up_hdr.uh_dstp);
+    
+    if (sd == -1) {
+        udp_pkt_free(&udp);
+        stats.rx_noport++;
+        
+        if (output_hook)
+            send_unreachable_port(ip);
+        
+        error = UDP_SOCKET_ERROR_NOPORT;
+        return -1;
+    }
+    
+    len = udp.up_payload_len;
+    
+    /* Queue whole datagrams only */
+    if (buffer_get_free(sock[sd].us_rxq) < (REC_HDR_LEN + len)) {
+        udp_pkt_free(&udp);
+        stats.rx_drop++;
+        error = UDP_SOCKET_ERROR_NOMEM;
+        return -1;
+    }
+    
+    hdr[0] = ip->ip_hdr.ih_src.ia_byte0;
+    hdr[1] = ip->ip_hdr.ih_src.ia_byte1;
+    hdr[2] = ip->ip_hdr.ih_src.ia_byte2;
+    hdr[3] = ip->ip_hdr.ih_src.ia_byte3;
+    hdr[4] = HI16(udp.up_hdr.uh_srcp);
+    hdr[5] = LO16(udp.up_hdr.uh_srcp);
+    hdr[6] = HI16(len);
+    hdr[7] = LO16(len);
+    buffer_wr(sock[sd].us_rxq, hdr, REC_HDR_LEN);
+    
+    if (len > 0)
+        buffer_wr(sock[sd].us_rxq, udp.up_payload_buf, len);
+    
+    udp_pkt_free(&udp);
+    stats.rx_dgr++;
+    return 0;
+}
+
+udp_socket_stats_t udp_socket_get_stats(void)
+{
+    return stats;
+}
+
+int udp_socket_get_last_error(void)
+{
+    int err;
+    
+    err = error;
+    error = UDP_SOCKET_ERROR_SUCCESS;
+    return err;
+}
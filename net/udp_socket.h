@@ -0,0 +1,77 @@
+/**
+ *
+ * File Name: udp_socket.h
+ * Title    : UDP socket library
+ * Project  : lib-avr
+ * Author   : Copyright (C) 2026 Johannes Krottmayer <krjdev@gmail.com>
+ * Created  : 2026-10-19
+ * Modified : 
+ * Revised  : 
+ * Version  : 0.1.0.0
+ * License  : ISC (see file LICENSE.txt)
+ * Target   : Atmel AVR Series
+ *
+ * NOTE: This code is currently below version 1.0, and therefore is considered
+ * to be lacking in some functionality or documentation, or may not be fully
+ * tested. Nonetheless, you can expect most functions to work.
+ *
+ */
+
+#ifndef LIBAVR_NET_UDP_SOCKET_H
+#define LIBAVR_NET_UDP_SOCKET_H
+
+#include <stdint.h>
+
+#include "ipv4.h"
+
+#define UDP_SOCKET_MAX                  8
+#define UDP_SOCKET_HASH_SIZE            16  /* Must be a power of 2 */
+#define UDP_SOCKET_PORT_EPHEMERAL       49152
+
+#define UDP_SOCKET_ERROR_SUCCESS        0
+#define UDP_SOCKET_ERROR_INVAL          1
+#define UDP_SOCKET_ERROR_NOMEM          2
+#define UDP_SOCKET_ERROR_NOSOCK         3
+#define UDP_SOCKET_ERROR_INUSE          4
+#define UDP_SOCKET_ERROR_NOTBOUND       5
+#define UDP_SOCKET_ERROR_NOPORT         6
+#define UDP_SOCKET_ERROR_UDPLIB         7
+#define UDP_SOCKET_ERROR_OUTPUT         8
+#define UDP_SOCKET_ERROR_INTERNAL       9
+#define UDP_SOCKET_ERROR_AGAIN          10  /* Receive queue empty */
+
+/* Socket options (udp_socket_setopt) */
+#define UDP_SOCKET_OPT_DF               0   /* Set DF, no fragmentation */
+
+typedef struct udp_socket_stats {
+    uint32_t rx_dgr;    /* Datagrams queued */
+    uint32_t tx_dgr;    /* Datagrams sent */
+    uint16_t rx_drop;   /* Dropped, receive queue full */
+    uint16_t rx_noport; /* Dropped, no socket bound to port */
+} udp_socket_stats_t;
+
+/* Transmit hook, sends a complete IPv4 packet (e.g. Ethernet + nic_send) */
+typedef int (*udp_socket_output_t)(ipv4_packet_t *ip);
+
+extern int udp_socket_init(ipv4_addr_t *src_ip, udp_socket_output_t output);
+extern int udp_socket_open(int rxq_len);
+extern int udp_socket_close(int sd);
+extern int udp_socket_bind(int sd, uint16_t port);
+extern int udp_socket_sendto(int sd, 
+                             uint8_t *buf, 
+                             int len, 
+                             ipv4_addr_t *dst_ip, 
+                             uint16_t dst_port);
+extern int udp_socket_recvfrom(int sd, 
+                               uint8_t *buf, 
+                               int len, 
+                               ipv4_addr_t *src_ip, 
+                               uint16_t *src_port);
+extern int udp_socket_pending(int sd);
+extern int udp_socket_setopt(int sd, int opt, int val);
+extern int udp_socket_getopt(int sd, int opt, int *val);
+extern int udp_socket_input(ipv4_packet_t *ip);
+extern udp_socket_stats_t udp_socket_get_stats(void);
+extern int udp_socket_get_last_error(void);
+
+#endif
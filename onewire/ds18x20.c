@@ -5,9 +5,9 @@
  * Project  : lib-avr
  * Author   : Copyright (C) 2018-2019 Johannes Krottmayer <krjdev@gmail.com>
  * Created  : 2018-11-30
- * Modified : 2019-01-13
+ * Modified : 2026-10-19
  * Revised  : 
- * Version  : 0.2.2.0
+ * Version  : 0.3.0.0
  * License  : ISC (see file LICENSE.txt)
  * Target   : Atmel AVR Series
  *
@@ -52,6 +52,17 @@
 #define CONVTIME_11BIT          375
 #define CONVTIME_12BIT          750 /* DS18S20 needs always this time */
 
+/* Scheduler states */
+#define SCHED_IDLE              0
+#define SCHED_CONV              1
+#define SCHED_READ              2
+
+static ds18x20_sensor_t *sched_sensors = NULL;
+static int sched_num = 0;
+static int sched_idx = 0;
+static volatile int sched_state = SCHED_IDLE;
+static volatile uint16_t sched_timer = 0;
+
 static void write_scratchpad(int type, uint8_t *buf)
 {
     uint8_t cmd[4];
@@ -93,6 +104,61 @@ static void copy_scratchpad(void)
     onewire_send(&cmd, 1);
 }
 
+static int calc_temp(uint8_t *buf, int type, int res, float *temp)
+{
+    uint16_t temp_raw;
+    float temp_ret;
+    
+    temp_raw = (buf[REG_TEMPH] << 8);
+    temp_raw |= buf[REG_TEMPL];
+    
+    switch (res) {
+    case RESOLUTION_9BIT:
+        if (type == TYPE_DS18S20)
+            temp_ret = (float) (int16_t) temp_raw / 2.0;
+        else {
+            temp_raw &= 0xFFF8;
+            temp_ret = (float) (int16_t) temp_raw / 16.0;
+        }
+        break;
+    case RESOLUTION_10BIT:
+        if (type == TYPE_DS18S20)
+            return -1;
+        else {
+            temp_raw &= 0xFFFC;
+            temp_ret = (float) (int16_t) temp_raw / 16.0;
+        }
+        break;
+    case RESOLUTION_11BIT:
+        if (type == TYPE_DS18S20)
+            return -1;
+        else {
+            temp_raw &= 0xFFFE;
+            temp_ret = (float) (int16_t) temp_raw / 16.0;
+        }
+        break;
+    case RESOLUTION_12BIT:
+        if (type == TYPE_DS18S20) {
+            if (temp_raw & 0x8000) {
+                temp_raw >>= 1;
+                temp_raw |= 0x8000;
+            } else
+                temp_raw >>= 1;
+            
+            temp_ret = (float) (int16_t) temp_raw - 0.25 + 
+                       (((float) buf[REG_COUNTPC] - (float) buf[REG_COUNTRE]) / 
+                       (float) buf[REG_COUNTPC]);
+        } else
+            temp_ret = (float) (int16_t) temp_raw / 16.0;
+        break;
+    default:
+        return -1;
+    }
+    
+    (*temp) = temp_ret;
+    return 0;
+}
+
 void ds18x20_init(void)
 {
     onewire_init();
@@ -184,8 +250,6 @@ int ds18x20_convert(ow_rom_t *rom)
 int ds18x20_get_temp(ow_rom_t *rom, int type, int res, float *temp)
 {
     uint8_t buf[9];
-    uint16_t temp_raw;
-    float temp_ret;
     
     if (rom) {
         if (onewire_match_rom(rom) == -1)
@@ -199,54 +263,7 @@ int ds18x20_get_temp(ow_rom_t *rom, int type, int res, float *temp)
     if (!crc8_dallas_check(buf, 8, buf[REG_CRC]))
         return -1;
     
-    temp_raw = (buf[REG_TEMPH] << 8);
-    temp_raw |= buf[REG_TEMPL];
-    
-    switch (res) {
-    case RESOLUTION_9BIT:
-        if (type == TYPE_DS18S20)
-            temp_ret = (float) (int16_t) temp_raw / 2.0;
-        else {
-            temp_raw &= 0xFFF8;
-            temp_ret = (float) (int16_t) temp_raw / 16.0;
-        }
-        break;
-    case RESOLUTION_10BIT:
-        if (type == TYPE_DS18S20)
-            return -1;
-        else {
-            temp_raw &= 0xFFFC;
-            temp_ret = (float) (int16_t) temp_raw / 16.0;
-        }
-        break;
-    case RESOLUTION_11BIT:
-        if (type == TYPE_DS18S20)
-            return -1;
-        else {
-            temp_raw &= 0xFFFE;
-            temp_ret = (float) (int16_t) temp_raw / 16.0;
-        }
-        break;
-    case RESOLUTION_12BIT:
-        if (type == TYPE_DS18S20) {
-            if (temp_raw & 0x8000) {
-                temp_raw >>= 1;
-                temp_raw |= 0x8000;
-            } else
-                temp_raw >>= 1;
-            
-            temp_ret = (float) (int16_t) temp_raw - 0.25 + 
-                       (((float) buf[REG_COUNTPC] - (float) buf[REG_COUNTRE]) / 
-                       (float) buf[REG_COUNTPC]);
-        } else
-            temp_ret = (float) (int16_t) temp_raw / 16.0;
-        break;
-    default:
-        return -1;
-    }
-    
-    (*temp) = temp_ret;
-    return 0;
+    return calc_temp(buf, type, res, temp);
 }
 
 int ds18x20_set_resolution(ow_rom_t *rom, int res)
@@ -314,3 +331,106 @@ int ds18x20_set_alarm(ow_rom_t *rom, int type, int8_t temp_high, int8_t temp_low
     _delay_ms(20);
     return 0;
 }
+
+static uint16_t conv_time(int type, int res)
+{
+    if (type == TYPE_DS18S20)
+        return CONVTIME_12BIT;
+    
+    switch (res) {
+    case RESOLUTION_9BIT:
+        return CONVTIME_9BIT;
+    case RESOLUTION_10BIT:
+        return CONVTIME_10BIT;
+    case RESOLUTION_11BIT:
+        return CONVTIME_11BIT;
+    default:
+        return CONVTIME_12BIT;
+    }
+}
+
+int ds18x20_sched_start(ds18x20_sensor_t *sensors, int num)
+{
+    uint16_t ms = 0;
+    uint8_t cmd;
+    int i;
+    
+    if (!sensors)
+        return -1;
+    
+    if (num < 1)
+        return -1;
+    
+    if (sched_state != SCHED_IDLE)
+        return -1;
+    
+    /* The slowest sensor on the bus determines the sweep */
+    for (i = 0; i < num; i++) {
+        if (conv_time(sensors[i].ds_type, sensors[i].ds_res) > ms)
+            ms = conv_time(sensors[i].ds_type, sensors[i].ds_res);
+    }
+    
+    /* One broadcast CONVERT T for all sensors */
+    if (onewire_skip_rom() == -1)
+        return -1;
+    
+    cmd = CMD_CONVERT_T;
+    onewire_send(&cmd, 1);
+    sched_sensors = sensors;
+    sched_num = num;
+    sched_idx = 0;
+    sched_timer = (ms / DS18X20_TICK_MS) + 1;
+    sched_state = SCHED_CONV;
+    return 0;
+}
+
+int ds18x20_sched_poll(void)
+{
+    ds18x20_sensor_t *s;
+    uint8_t buf[9];
+    int i;
+    
+    switch (sched_state) {
+    case SCHED_CONV:
+#ifndef DS18X20_PARASITE
+        /* Sensors hold the bus low during a read slot until they are done */
+        if ((sched_timer != 0) && !onewire_read_bit())
+            return DS18X20_SCHED_BUSY;
+#else
+        if (sched_timer != 0)
+            return DS18X20_SCHED_BUSY;
+#endif
+        sched_state = SCHED_READ;
+        return DS18X20_SCHED_BUSY;
+    case SCHED_READ:
+        for (i = 0; (i < DS18X20_SCHED_BATCH) && (sched_idx < sched_num); i++) {
+            s = &sched_sensors[sched_idx++];
+            s->ds_valid = 0;
+            
+            if (onewire_match_rom(&s->ds_rom) == -1)
+                continue;
+            
+            read_scratchpad(buf);
+            
+            if (!crc8_dallas_check(buf, 8, buf[REG_CRC]))
+                continue;
+            
+            if (calc_temp(buf, s->ds_type, s->ds_res, &s->ds_temp) == 0)
+                s->ds_valid = 1;
+        }
+        
+        if (sched_idx < sched_num)
+            return DS18X20_SCHED_BUSY;
+        
+        sched_state = SCHED_IDLE;
+        return DS18X20_SCHED_DONE;
+    default:
+        return -1;
+    }
+}
+
+void ds18x20_sched_tick(void)
+{
+    if (sched_timer)
+        sched_timer--;
+}
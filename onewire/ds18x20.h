@@ -5,9 +5,9 @@
  * Project  : lib-avr
  * Author   : Copyright (C) 2018-2019 Johannes Krottmayer <krjdev@gmail.com>
  * Created  : 2018-11-30
- * Modified : 2019-01-13
+ * Modified : 2026-10-19
  * Revised  : 
- * Version  : 0.2.2.0
+ * Version  : 0.3.0.0
  * License  : ISC (see file LICENSE.txt)
  * Target   : Atmel AVR Series
  *
@@ -32,6 +32,24 @@
 #define RESOLUTION_11BIT    11 /* DS18B20 only */
 #define RESOLUTION_12BIT    12
 
+/* Conversion scheduler */
+#define DS18X20_TICK_MS     10  /* Interval of ds18x20_sched_tick() calls */
+#define DS18X20_SCHED_BATCH 1   /* Scratchpads read per ds18x20_sched_poll() */
+
+/* Parasite power: no read slots while converting, wait the full time */
+/* #define DS18X20_PARASITE */
+
+#define DS18X20_SCHED_BUSY  0
+#define DS18X20_SCHED_DONE  1
+
+typedef struct ds18x20_sensor {
+    ow_rom_t ds_rom;
+    int ds_type;
+    int ds_res;
+    float ds_temp;
+    uint8_t ds_valid;       /* ds_temp is from the last sweep */
+} ds18x20_sensor_t;
+
 extern void ds18x20_init(void);
 extern int ds18x20_read_rom(int type, ow_rom_t *rom);
 extern int ds18x20_search_rom(int type, ow_rom_t *roms, int num);
@@ -40,5 +58,8 @@ extern int ds18x20_convert(ow_rom_t *rom);
 extern int ds18x20_get_temp(ow_rom_t *rom, int type, int res, float *temp);
 extern int ds18x20_set_resolution(ow_rom_t *rom, int res); /* DS18B20 only */
 extern int ds18x20_set_alarm(ow_rom_t *rom, int type, int8_t temp_high, int8_t temp_low);
+extern int ds18x20_sched_start(ds18x20_sensor_t *sensors, int num);
+extern int ds18x20_sched_poll(void);
+extern void ds18x20_sched_tick(void);
 
 #endif
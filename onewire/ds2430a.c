@@ -5,9 +5,9 @@
  * Project  : lib-avr
  * Author   : Copyright (C) 2018-2019 Johannes Krottmayer <krjdev@gmail.com>
  * Created  : 2018-12-01
- * Modified : 2019-01-13
+ * Modified : 2026-10-19
  * Revised  : 
- * Version  : 0.2.1.0
+ * Version  : 0.3.0.0
  * License  : ISC (see file LICENSE.txt)
  * Target   : Atmel AVR Series
  *
@@ -86,24 +86,19 @@ static void copy_scratchpad(void)
     onewire_reset();
 }
 
-static void read_memory(uint8_t addr, uint8_t *buf, int len)
+/* Presence of the closing reset, at Overdrive speed it catches a failed read */
+static int read_memory(uint8_t addr, uint8_t *buf, int len)
 {
     uint8_t cmd[2];
     
     if (len < 1)
-        return;
-    
-    if (len == MEMORY_SIZE) {
-        cmd[0] = CMD_MEMORY_READ;
-        onewire_send(cmd, 1);
-    } else {
-        cmd[0] = CMD_MEMORY_READ;
-        cmd[1] = addr;
-        onewire_send(cmd, 2);
-    }
+        return 0;
     
+    cmd[0] = CMD_MEMORY_READ;
+    cmd[1] = addr;
+    onewire_send(cmd, 2);
     onewire_recv(buf, len);
-    onewire_reset();
+    return onewire_reset();
 }
 
 static void read_status(uint8_t *status)
@@ -228,6 +223,11 @@ int ds2430a_write_memory(ow_rom_t *rom, uint8_t addr, uint8_t *buf, int len)
 
 int ds2430a_read_memory(ow_rom_t *rom, uint8_t addr, uint8_t *buf, int len)
 {
+#ifdef DS2430A_OVERDRIVE
+    int ret;
+    int i;
+#endif
+
     if (addr > (MEMORY_SIZE - 1))
         return -1;
     
@@ -240,6 +240,23 @@ int ds2430a_read_memory(ow_rom_t *rom, uint8_t addr, uint8_t *buf, int len)
     if (len > (MEMORY_SIZE - addr))
         return -1;
     
+#ifdef DS2430A_OVERDRIVE
+    /* A failed Overdrive read leaves the device at standard speed, retry */
+    for (i = 0; i < 2; i++) {
+        if (rom)
+            ret = onewire_od_match_rom(rom);
+        else
+            ret = onewire_od_skip_rom();
+        
+        if (ret == -1)
+            return -1;
+        
+        if (read_memory(addr, buf, len))
+            return 0;
+    }
+    
+    return -1;
+#else
     if (rom) {
         if (onewire_match_rom(rom) == -1)
             return -1;
@@ -249,6 +266,7 @@ int ds2430a_read_memory(ow_rom_t *rom, uint8_t addr, uint8_t *buf, int len)
     
     read_memory(addr, buf, len);
     return 0;
+#endif
 }
 
 int ds2430a_write_app_reg(ow_rom_t *rom, uint8_t addr, uint8_t *buf, int len)
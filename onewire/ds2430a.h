@@ -5,9 +5,9 @@
  * Project  : lib-avr
  * Author   : Copyright (C) 2018-2019 Johannes Krottmayer <krjdev@gmail.com>
  * Created  : 2018-12-01
- * Modified : 2019-01-13
+ * Modified : 2026-10-19
  * Revised  : 
- * Version  : 0.2.1.0
+ * Version  : 0.3.0.0
  * License  : ISC (see file LICENSE.txt)
  * Target   : Atmel AVR Series
  *
@@ -24,6 +24,9 @@
 
 #include "sw-onewire.h"
 
+/* Memory reads at Overdrive speed (-DDS2430A_OVERDRIVE), off by default */
+/* The DS2430A itself has no OVERDRIVE SKIP/MATCH ROM (3Ch/69h), enable it only for parts that do */
+
 extern void ds2430a_init(void);
 extern int ds2430a_read_rom(ow_rom_t *rom);
 extern int ds2430a_search_rom(ow_rom_t *roms, int num);
@@ -0,0 +1,248 @@
+/**
+ *
+ * File Name: ow-table.c
+ * Title    : Cached 1-Wire device table library
+ * Project  : lib-avr
+ * Author   : Copyright (C) 2026 Johannes Krottmayer <krjdev@gmail.com>
+ * Created  : 2026-10-19
+ * Modified : 
+ * Revised  : 
+ * Version  : 0.1.0.0
+ * License  : ISC (see file LICENSE.txt)
+ * Target   : Atmel AVR Series
+ *
+ * NOTE: This code is currently below version 1.0, and therefore is considered
+ * to be lacking in some functionality or documentation, or may not be fully
+ * tested. Nonetheless, you can expect most functions to work.
+ *
+ */
+
+#include <string.h>
+
+#include "ow-table.h"
+#include "../lib/crc8_dallas.h"
+
+#ifdef OW_TABLE_EEPROM
+#include "../i2c/m24cxx.h"
+#endif
+
+/* Bus time of the bit-banged slots (microseconds) */
+#define RESET_US            970
+#define WRITE_US            181
+#define READ_US             116
+
+/* One search pass: reset, command, 64 triplets (two reads, one write) */
+#define PASS_US             (RESET_US + (8 * WRITE_US) + (64 * ((2 * READ_US) + WRITE_US)))
+
+#define EEPROM_MAGIC        0xA5
+#define EEPROM_LEN          (2 + (OW_TABLE_MAX * 8) + 1)
+
+static ow_rom_t table[OW_TABLE_MAX];
+static int table_num = 0;
+static int probe_idx = 0;
+static int poll_cnt = 0;
+static uint32_t saved_us = 0;
+static ow_table_stats_t stats;
+
+static void time_saved(uint32_t us)
+{
+    saved_us += us;
+    stats.time_saved += saved_us / 1000;
+    saved_us %= 1000;
+}
+
+static int table_find(ow_rom_t *rom)
+{
+    int i;
+    
+    for (i = 0; i < table_num; i++) {
+        if (!memcmp(&table[i], rom, sizeof(ow_rom_t)))
+            return i;
+    }
+    
+    return -1;
+}
+
+void onewire_table_init(void)
+{
+    memset(table, 0, sizeof(table));
+    memset(&stats, 0, sizeof(ow_table_stats_t));
+    table_num = 0;
+    probe_idx = 0;
+    poll_cnt = 0;
+    saved_us = 0;
+}
+
+int onewire_table_scan(void)
+{
+    ow_rom_t roms[OW_TABLE_MAX];
+    int num;
+    int changed;
+    
+    num = onewire_search_rom(TYPE_SEARCH_ALL, roms, OW_TABLE_MAX);
+    
+    if (num == -1)
+        return -1;
+    
+    if (num > OW_TABLE_MAX)
+        num = OW_TABLE_MAX;
+    
+    changed = (num != table_num) || memcmp(table, roms, (num * sizeof(ow_rom_t)));
+    memcpy(table, roms, (num * sizeof(ow_rom_t)));
+    table_num = num;
+    probe_idx = 0;
+    poll_cnt = 0;
+    stats.searches++;
+    return changed;
+}
+
+/* Probes one cached device per call, searches only on a change */
+int onewire_table_poll(void)
+{
+    int ret;
+    
+    if ((table_num == 0) || (++poll_cnt >= OW_TABLE_RESCAN))
+        return onewire_table_scan();
+    
+    if (probe_idx >= table_num)
+        probe_idx = 0;
+    
+    ret = onewire_verify_rom(&table[probe_idx]);
+    stats.probes++;
+    
+    if (ret == -1)
+        return -1;
+    
+    if (ret == 0)
+        return onewire_table_scan();
+    
+    probe_idx++;
+    time_saved((uint32_t) (table_num - 1) * PASS_US);
+    return 0;
+}
+
+int onewire_table_search_family(uint8_t family)
+{
+    ow_rom_t roms[OW_TABLE_MAX];
+    int num;
+    int i;
+    
+    num = onewire_search_family(TYPE_SEARCH_ALL, family, roms, OW_TABLE_MAX);
+    
+    if (num == -1)
+        return -1;
+    
+    if (num > OW_TABLE_MAX)
+        num = OW_TABLE_MAX;
+    
+    for (i = 0; i < num; i++) {
+        if (roms[i].or_family != family)
+            continue;
+        
+        if ((table_find(&roms[i]) == -1) && (table_num < OW_TABLE_MAX))
+            table[table_num++] = roms[i];
+    }
+    
+    /* A full search would walk every device on the bus */
+    if (table_num > num)
+        time_saved((uint32_t) (table_num - num) * PASS_US);
+    
+    return num;
+}
+
+int onewire_table_get(ow_rom_t *roms, int num)
+{
+    if ((roms == NULL) && (num > 0))
+        return -1;
+    
+    if (num > table_num)
+        num = table_num;
+    
+    if (num > 0)
+        memcpy(roms, table, (num * sizeof(ow_rom_t)));
+    
+    return table_num;
+}
+
+int onewire_table_get_family(uint8_t family, ow_rom_t *roms, int num)
+{
+    int cnt = 0;
+    int i;
+    
+    if ((roms == NULL) && (num > 0))
+        return -1;
+    
+    for (i = 0; i < table_num; i++) {
+        if (table[i].or_family != family)
+            continue;
+        
+        if (cnt < num)
+            roms[cnt] = table[i];
+        
+        cnt++;
+    }
+    
+    return cnt;
+}
+
+ow_table_stats_t onewire_table_get_stats(void)
+{
+    return stats;
+}
+
+#ifdef OW_TABLE_EEPROM
+int onewire_table_load(int type, uint8_t subaddr, uint16_t addr)
+{
+    uint8_t buf[EEPROM_LEN];
+    int num;
+    int len;
+    int i;
+    
+    if (m24cxx_read(type, subaddr, addr, buf, 2) == -1)
+        return -1;
+    
+    num = buf[1];
+    
+    if ((buf[0] != EEPROM_MAGIC) || (num > OW_TABLE_MAX))
+        return -1;
+    
+    len = 2 + (num * 8) + 1;
+    
+    if (m24cxx_read(type, subaddr, addr, buf, len) == -1)
+        return -1;
+    
+    if (!crc8_dallas_check(buf, (len - 1), buf[len - 1]))
+        return -1;
+    
+    for (i = 0; i < num; i++) {
+        table[i].or_family = buf[2 + (i * 8)];
+        memcpy(table[i].or_serial, &buf[3 + (i * 8)], 6);
+        table[i].or_crc = buf[9 + (i * 8)];
+    }
+    
+    table_num = num;
+    probe_idx = 0;
+    poll_cnt = 0;
+    return num;
+}
+
+int onewire_table_save(int type, uint8_t subaddr, uint16_t addr)
+{
+    uint8_t buf[EEPROM_LEN];
+    int len;
+    int i;
+    
+    buf[0] = EEPROM_MAGIC;
+    buf[1] = (uint8_t) table_num;
+    
+    for (i = 0; i < table_num; i++) {
+        buf[2 + (i * 8)] = table[i].or_family;
+        memcpy(&buf[3 + (i * 8)], table[i].or_serial, 6);
+        buf[9 + (i * 8)] = table[i].or_crc;
+    }
+    
+    len = 2 + (table_num * 8);
+    buf[len] = (uint8_t) crc8_dallas_calc(buf, len);
+    return m24cxx_write(type, subaddr, addr, buf, (len + 1));
+}
+#endif
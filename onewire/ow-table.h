@@ -0,0 +1,51 @@
+/**
+ *
+ * File Name: ow-table.h
+ * Title    : Cached 1-Wire device table library header
+ * Project  : lib-avr
+ * Author   : Copyright (C) 2026 Johannes Krottmayer <krjdev@gmail.com>
+ * Created  : 2026-10-19
+ * Modified : 
+ * Revised  : 
+ * Version  : 0.1.0.0
+ * License  : ISC (see file LICENSE.txt)
+ * Target   : Atmel AVR Series
+ *
+ * NOTE: This code is currently below version 1.0, and therefore is considered
+ * to be lacking in some functionality or documentation, or may not be fully
+ * tested. Nonetheless, you can expect most functions to work.
+ *
+ */
+
+#ifndef LIBAVR_ONEWIRE_OW_TABLE_H
+#define LIBAVR_ONEWIRE_OW_TABLE_H
+
+#include <stdint.h>
+
+#include "sw-onewire.h"
+
+#define OW_TABLE_MAX            16  /* Cached devices */
+#define OW_TABLE_RESCAN         64  /* Polls between full searches (hot-plug) */
+
+/* Table stored in a M24Cxx EEPROM (onewire_table_load/save) */
+/* #define OW_TABLE_EEPROM */
+
+typedef struct ow_table_stats {
+    uint16_t searches;      /* Full searches */
+    uint32_t probes;        /* Single-ROM probes */
+    uint32_t time_saved;    /* Bus time saved against a full search (ms) */
+} ow_table_stats_t;
+
+extern void onewire_table_init(void);
+extern int onewire_table_scan(void);
+extern int onewire_table_poll(void);
+extern int onewire_table_search_family(uint8_t family);
+extern int onewire_table_get(ow_rom_t *roms, int num);
+extern int onewire_table_get_family(uint8_t family, ow_rom_t *roms, int num);
+extern ow_table_stats_t onewire_table_get_stats(void);
+#ifdef OW_TABLE_EEPROM
+extern int onewire_table_load(int type, uint8_t subaddr, uint16_t addr);
+extern int onewire_table_save(int type, uint8_t subaddr, uint16_t addr);
+#endif
+
+#endif
@@ -0,0 +1,405 @@
+/**
+ *
+ * File Name: sim-onewire.c
+ * Title    : 1-Wire bus simulator (bit level)
+ * Project  : lib-avr
+ * Author   : Copyright (C) 2026 Johannes Krottmayer <krjdev@gmail.com>
+ * Created  : 2026-10-19
+ * Modified : 2026-10-19
+ * Revised  : 
+ * Version  : 0.2.0.0
+ * License  : ISC (see file LICENSE.txt)
+ * Target   : Linux (host)
+ *
+ * NOTE: This code is currently below version 1.0, and therefore is considered
+ * to be lacking in some functionality or documentation, or may not be fully
+ * tested. Nonetheless, you can expect most functions to work.
+ *
+ */
+
+#include <string.h>
+
+#include "sim-onewire.h"
+#include "tm-onewire.h"
+
+/* Device timing (nanoseconds), standard speed */
+#define T_RESET_MIN         480000  /* Low time detected as reset */
+#define T_PDHIGH            30000   /* Presence pulse delay */
+#define T_PDLOW             120000  /* Presence pulse length */
+#define T_SAMPLE            15000   /* Shorter low time is a 1 */
+#define T_HOLD              30000   /* Device holds a 0 bit */
+
+/* Overdrive, a standard reset returns the device to standard speed */
+#define T_RESET_MIN_OD      48000
+#define T_RESET_MAX_OD      80000   /* Longer low time is out of spec */
+#define T_WRITE0_MAX_OD     16000
+#define T_PDHIGH_OD         2000
+#define T_PDLOW_OD          10000
+#define T_SAMPLE_OD         2000
+#define T_HOLD_OD           3000
+
+#define CMD_ROM_READ        0x33
+#define CMD_ROM_MATCH       0x55
+#define CMD_ROM_SKIP        0xCC
+#define CMD_ROM_SEARCH      0xF0
+#define CMD_OD_SKIP         0x3C
+#define CMD_OD_MATCH        0x69
+#define CMD_SCRATCHPAD_READ 0xBE
+#define CMD_MEMORY_READ     0xF0
+
+#define D_IDLE              0
+#define D_ROM_RX            1 /* ROM command */
+#define D_MATCH_RX          2 /* ROM of MATCH ROM */
+#define D_FN_RX             3 /* Function command */
+#define D_TX                4
+#define D_SEARCH            5
+#define D_ROM_TX            6 /* READ ROM, a function command follows */
+#define D_ADDR_RX           7 /* Address of READ MEMORY */
+
+#define GET_BIT(buf, i)     (((buf)[(i) >> 3] >> ((i) & 0x07)) & 0x01)
+
+typedef struct sim_dev {
+    uint8_t sd_used;
+    uint8_t sd_rom[8];
+    uint8_t sd_mem[OW_SIM_MEM_LEN];
+    uint8_t sd_od_cap;      /* Overdrive capable */
+    uint8_t sd_od;          /* Running at Overdrive speed */
+    uint8_t sd_state;
+    uint8_t sd_buf[OW_SIM_MEM_LEN]; /* Shift buffer of the current transfer */
+    uint16_t sd_nbits;
+    uint16_t sd_bit;
+    uint8_t sd_sub;         /* Search: bit, complement, direction */
+    uint64_t sd_low_from;
+    uint64_t sd_low_until;
+} sim_dev_t;
+
+static sim_dev_t devs[OW_SIM_DEV_MAX];
+static uint64_t now = 0;
+static uint64_t t_fall = 0;
+static uint64_t t_event = 0;
+static int armed = 0;
+static int master_low = 0;
+static uint32_t latency = 0;
+
+static void dev_rx(sim_dev_t *d, uint8_t state, uint16_t nbits)
+{
+    memset(d->sd_buf, 0, sizeof(d->sd_buf));
+    d->sd_state = state;
+    d->sd_nbits = nbits;
+    d->sd_bit = 0;
+}
+
+static void dev_tx(sim_dev_t *d, uint8_t state, uint8_t *data, uint16_t nbits)
+{
+    memcpy(d->sd_buf, data, ((nbits + 7) / 8));
+    d->sd_state = state;
+    d->sd_nbits = nbits;
+    d->sd_bit = 0;
+}
+
+static void dev_rx_done(sim_dev_t *d)
+{
+    switch (d->sd_state) {
+    case D_ROM_RX:
+        switch (d->sd_buf[0]) {
+        case CMD_ROM_READ:
+            dev_tx(d, D_ROM_TX, d->sd_rom, 64);
+            break;
+        case CMD_ROM_MATCH:
+            dev_rx(d, D_MATCH_RX, 64);
+            break;
+        case CMD_ROM_SKIP:
+            dev_rx(d, D_FN_RX, 8);
+            break;
+        case CMD_ROM_SEARCH:
+            d->sd_state = D_SEARCH;
+            d->sd_bit = 0;
+            d->sd_sub = 0;
+            break;
+        case CMD_OD_SKIP:
+            if (!d->sd_od_cap) {
+                d->sd_state = D_IDLE;
+                break;
+            }
+            
+            d->sd_od = 1;
+            dev_rx(d, D_FN_RX, 8);
+            break;
+        case CMD_OD_MATCH:
+            if (!d->sd_od_cap) {
+                d->sd_state = D_IDLE;
+                break;
+            }
+            
+            d->sd_od = 1;
+            dev_rx(d, D_MATCH_RX, 64);
+            break;
+        default:
+            d->sd_state = D_IDLE;
+        }
+        
+        break;
+    case D_MATCH_RX:
+        if (!memcmp(d->sd_buf, d->sd_rom, 8))
+            dev_rx(d, D_FN_RX, 8);
+        else
+            d->sd_state = D_IDLE;
+        
+        break;
+    case D_FN_RX:
+        if (d->sd_buf[0] == CMD_SCRATCHPAD_READ)
+            dev_tx(d, D_TX, d->sd_mem, 72);
+        else if (d->sd_buf[0] == CMD_MEMORY_READ)
+            dev_rx(d, D_ADDR_RX, 8);
+        else
+            d->sd_state = D_IDLE;
+        
+        break;
+    case D_ADDR_RX:
+        if (d->sd_buf[0] < OW_SIM_MEM_LEN)
+            dev_tx(d, D_TX, &d->sd_mem[d->sd_buf[0]], 
+                   (OW_SIM_MEM_LEN - d->sd_buf[0]) * 8);
+        else
+            d->sd_state = D_IDLE;
+        
+        break;
+    default:
+        d->sd_state = D_IDLE;
+    }
+}
+
+/* Bit the device puts on the bus in this slot, 1 if it does not send */
+static int dev_tx_bit(sim_dev_t *d)
+{
+    switch (d->sd_state) {
+    case D_TX:
+    case D_ROM_TX:
+        return GET_BIT(d->sd_buf, d->sd_bit);
+    case D_SEARCH:
+        if (d->sd_sub == 0)
+            return GET_BIT(d->sd_rom, d->sd_bit);
+        
+        if (d->sd_sub == 1)
+            return !GET_BIT(d->sd_rom, d->sd_bit);
+        
+        return 1;
+    default:
+        return 1;
+    }
+}
+
+static void dev_slot(sim_dev_t *d, int val)
+{
+    switch (d->sd_state) {
+    case D_ROM_RX:
+    case D_MATCH_RX:
+    case D_FN_RX:
+    case D_ADDR_RX:
+        if (val)
+            d->sd_buf[d->sd_bit >> 3] |= (1 << (d->sd_bit & 0x07));
+        
+        if (++d->sd_bit == d->sd_nbits)
+            dev_rx_done(d);
+        
+        break;
+    case D_TX:
+        if (++d->sd_bit == d->sd_nbits)
+            d->sd_state = D_IDLE;
+        
+        break;
+    case D_ROM_TX:
+        if (++d->sd_bit == d->sd_nbits)
+            dev_rx(d, D_FN_RX, 8);
+        
+        break;
+    case D_SEARCH:
+        if (d->sd_sub < 2) {
+            d->sd_sub++;
+            break;
+        }
+        
+        if (val != GET_BIT(d->sd_rom, d->sd_bit)) {
+            d->sd_state = D_IDLE;
+            break;
+        }
+        
+        d->sd_sub = 0;
+        
+        if (++d->sd_bit == 64)
+            dev_rx(d, D_FN_RX, 8);
+        
+        break;
+    default:
+        break;
+    }
+}
+
+void ow_sim_init(void)
+{
+    memset(devs, 0, sizeof(devs));
+    now = 0;
+    t_fall = 0;
+    armed = 0;
+    master_low = 0;
+    latency = 0;
+}
+
+/* Delay of every compare match, like other interrupts running before the ISR */
+void ow_sim_set_latency(uint32_t ns)
+{
+    latency = ns;
+}
+
+int ow_sim_add(uint8_t *rom, uint8_t *mem, int len, int od)
+{
+    int i;
+    
+    if (!rom)
+        return -1;
+    
+    if ((len < 0) || (len > OW_SIM_MEM_LEN))
+        return -1;
+    
+    for (i = 0; i < OW_SIM_DEV_MAX; i++) {
+        if (devs[i].sd_used)
+            continue;
+        
+        memset(&devs[i], 0, sizeof(sim_dev_t));
+        memcpy(devs[i].sd_rom, rom, 8);
+        
+        if (mem)
+            memcpy(devs[i].sd_mem, mem, len);
+        
+        devs[i].sd_od_cap = od ? 1 : 0;
+        devs[i].sd_used = 1;
+        return i;
+    }
+    
+    return -1;
+}
+
+int ow_sim_remove(uint8_t *rom)
+{
+    int i;
+    
+    if (!rom)
+        return -1;
+    
+    for (i = 0; i < OW_SIM_DEV_MAX; i++) {
+        if (devs[i].sd_used && !memcmp(devs[i].sd_rom, rom, 8)) {
+            devs[i].sd_used = 0;
+            return 0;
+        }
+    }
+    
+    return -1;
+}
+
+static void dev_reset(sim_dev_t *d)
+{
+    dev_rx(d, D_ROM_RX, 8);
+    
+    if (d->sd_od) {
+        d->sd_low_from = now + T_PDHIGH_OD;
+        d->sd_low_until = now + T_PDHIGH_OD + T_PDLOW_OD;
+    } else {
+        d->sd_low_from = now + T_PDHIGH;
+        d->sd_low_until = now + T_PDHIGH + T_PDLOW;
+    }
+}
+
+void ow_sim_drive(int low)
+{
+    uint64_t dur;
+    sim_dev_t *d;
+    int i;
+    
+    if (low && !master_low) {
+        t_fall = now;
+        
+        for (i = 0; i < OW_SIM_DEV_MAX; i++) {
+            d = &devs[i];
+            
+            if (d->sd_used && !dev_tx_bit(d)) {
+                d->sd_low_from = now;
+                d->sd_low_until = now + (d->sd_od ? T_HOLD_OD : T_HOLD);
+            }
+        }
+    } else if (!low && master_low) {
+        dur = now - t_fall;
+        
+        for (i = 0; i < OW_SIM_DEV_MAX; i++) {
+            d = &devs[i];
+            
+            if (!d->sd_used)
+                continue;
+            
+            if (dur >= T_RESET_MIN) {
+                d->sd_od = 0;
+                dev_reset(d);
+            } else if (d->sd_od && (dur > T_RESET_MAX_OD))
+                d->sd_state = D_IDLE;
+            else if (d->sd_od && (dur >= T_RESET_MIN_OD))
+                dev_reset(d);
+            else if (d->sd_od && (dur > T_WRITE0_MAX_OD))
+                d->sd_state = D_IDLE;
+            else if (d->sd_od)
+                dev_slot(d, (dur < T_SAMPLE_OD));
+            else
+                dev_slot(d, (dur < T_SAMPLE));
+        }
+    }
+    
+    master_low = low;
+}
+
+/* Wired-AND of the master and all devices */
+int ow_sim_sample(void)
+{
+    int i;
+    
+    if (master_low)
+        return 0;
+    
+    for (i = 0; i < OW_SIM_DEV_MAX; i++) {
+        if (devs[i].sd_used && 
+            (now >= devs[i].sd_low_from) && 
+            (now < devs[i].sd_low_until))
+            return 0;
+    }
+    
+    return 1;
+}
+
+void ow_sim_delay(uint32_t ns)
+{
+    now += ns;
+}
+
+void ow_sim_timer_start(uint32_t ns)
+{
+    t_event = now + ns;
+    armed = 1;
+}
+
+void ow_sim_timer_stop(void)
+{
+    armed = 0;
+}
+
+/* Advances to the next compare match and runs the ISR */
+void ow_sim_step(void)
+{
+    if (!armed)
+        return;
+    
+    now = t_event + latency;
+    armed = 0;
+    onewire_tm_isr();
+}
+
+/* Microseconds */
+uint32_t ow_sim_get_time(void)
+{
+    return (uint32_t) (now / 1000);
+}
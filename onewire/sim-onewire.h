@@ -0,0 +1,43 @@
+/**
+ *
+ * File Name: sim-onewire.h
+ * Title    : 1-Wire bus simulator (bit level) header
+ * Project  : lib-avr
+ * Author   : Copyright (C) 2026 Johannes Krottmayer <krjdev@gmail.com>
+ * Created  : 2026-10-19
+ * Modified : 2026-10-19
+ * Revised  : 
+ * Version  : 0.2.0.0
+ * License  : ISC (see file LICENSE.txt)
+ * Target   : Linux (host)
+ *
+ * NOTE: This code is currently below version 1.0, and therefore is considered
+ * to be lacking in some functionality or documentation, or may not be fully
+ * tested. Nonetheless, you can expect most functions to work.
+ *
+ */
+
+#ifndef LIBAVR_ONEWIRE_SIM_ONEWIRE_H
+#define LIBAVR_ONEWIRE_SIM_ONEWIRE_H
+
+#include <stdint.h>
+
+#define OW_SIM_DEV_MAX              8
+#define OW_SIM_MEM_LEN              32
+
+/* Simulated devices (ROM 8 bytes, family first; memory, the first 9 bytes are the scratchpad) */
+extern void ow_sim_init(void);
+extern int ow_sim_add(uint8_t *rom, uint8_t *mem, int len, int od);
+extern int ow_sim_remove(uint8_t *rom);
+extern void ow_sim_set_latency(uint32_t ns);
+
+/* Hooks of tm-onewire, built with -DONEWIRE_SIM */
+extern void ow_sim_drive(int low);
+extern int ow_sim_sample(void);
+extern void ow_sim_delay(uint32_t ns);
+extern void ow_sim_timer_start(uint32_t ns);
+extern void ow_sim_timer_stop(void);
+extern void ow_sim_step(void);
+extern uint32_t ow_sim_get_time(void);
+
+#endif
@@ -5,9 +5,9 @@
  * Project  : lib-avr
  * Author   : Copyright (C) 2018-2019 Johannes Krottmayer <krjdev@gmail.com>
  * Created  : 2018-09-28
- * Modified : 2019-01-06
+ * Modified : 2026-10-19
  * Revised  : 
- * Version  : 0.3.0.0
+ * Version  : 0.6.0.0
  * License  : ISC (see file LICENSE.txt)
  * Target   : Atmel AVR Series
  *
@@ -19,6 +19,7 @@
 
 #include <stdlib.h>
 #include <string.h>
+#include <avr/interrupt.h>
 #include <util/delay.h>
 
 #include "sw-onewire.h"
@@ -32,9 +33,151 @@
 #define ONEWIRE_CMD_ROM_MATCH       0x55
 #define ONEWIRE_CMD_ROM_SKIP        0xCC
 #define ONEWIRE_CMD_ALARM_SEARCH    0xEC
+#define ONEWIRE_CMD_OD_SKIP         0x3C
+#define ONEWIRE_CMD_OD_MATCH        0x69
+
+/* Last Overdrive selection, index in od_devs or one of these */
+#define OD_LAST_NONE                -2
+#define OD_LAST_SKIP                -1
+
+typedef struct od_dev {
+    ow_rom_t od_rom;
+    uint8_t od_hold;    /* Selects left at standard speed */
+} od_dev_t;
+
+static int speed = ONEWIRE_SPEED_STD;
+static od_dev_t od_devs[ONEWIRE_OD_DEV_MAX];
+static int od_num = 0;
+static int od_next = 0;
+static int od_last = OD_LAST_NONE;
+static uint8_t od_skip_hold = 0;
+
+/* Overdrive slots (AN126), an interrupt would stretch them */
+static void od_write_bit(uint8_t val)
+{
+    uint8_t sreg;
+    
+    sreg = SREG;
+    cli();
+    
+    if (val) {
+        DQ_TX_LOW;
+        _delay_us(1);
+        DQ_TX_HIGH;
+        _delay_us(7.5);
+    } else {
+        DQ_TX_LOW;
+        _delay_us(7.5);
+        DQ_TX_HIGH;
+        _delay_us(2.5);
+    }
+    
+    SREG = sreg;
+}
+
+static uint8_t od_read_bit(void)
+{
+    uint8_t sreg;
+    uint8_t ret;
+    
+    sreg = SREG;
+    cli();
+    DQ_TX_LOW;
+    _delay_us(1);
+    DQ_TX_HIGH;
+    _delay_us(1);
+    
+    if (DQ_RX_PORT & DQ_RX_PIN)
+        ret = 1;
+    else
+        ret = 0;
+    
+    SREG = sreg;
+    _delay_us(7);
+    return ret;
+}
+
+static od_dev_t *od_find(ow_rom_t *rom)
+{
+    int i;
+    
+    for (i = 0; i < od_num; i++) {
+        if (!memcmp(&od_devs[i].od_rom, rom, sizeof(ow_rom_t)))
+            return &od_devs[i];
+    }
+    
+    return NULL;
+}
+
+/* Unknown devices replace the oldest entry once the table is full */
+static int od_add(ow_rom_t *rom)
+{
+    od_dev_t *dev;
+    int idx;
+    
+    dev = od_find(rom);
+    
+    if (dev)
+        return (dev - od_devs);
+    
+    if (od_num < ONEWIRE_OD_DEV_MAX) {
+        idx = od_num;
+        od_num++;
+    } else {
+        idx = od_next;
+        od_next = (od_next + 1) % ONEWIRE_OD_DEV_MAX;
+    }
+    
+    memcpy(&od_devs[idx].od_rom, rom, sizeof(ow_rom_t));
+    od_devs[idx].od_hold = 0;
+    return idx;
+}
+
+/* Falls back to standard speed, a standard reset returns all devices too */
+static void od_fail(int idx)
+{
+    if (idx == OD_LAST_SKIP)
+        od_skip_hold = ONEWIRE_OD_HOLD;
+    else if (idx >= 0)
+        od_devs[idx].od_hold = ONEWIRE_OD_HOLD;
+    
+    od_last = OD_LAST_NONE;
+    speed = ONEWIRE_SPEED_STD;
+}
+
+static int od_reset(void)
+{
+    uint8_t sreg;
+    int ret;
+    
+    sreg = SREG;
+    cli();
+    DQ_TX_LOW;
+    _delay_us(70);
+    DQ_TX_HIGH;
+    _delay_us(8.5);
+    
+    if (!(DQ_RX_PORT & DQ_RX_PIN))
+        ret = 1;
+    else
+        ret = 0;
+    
+    SREG = sreg;
+    _delay_us(40);
+    
+    if (!ret)
+        od_fail(od_last);
+    
+    return ret;
+}
 
 static void write_bit(uint8_t val)
 {
+    if (speed == ONEWIRE_SPEED_OD) {
+        od_write_bit(val);
+        return;
+    }
+    
     if (val) {
         DQ_TX_LOW;
         _delay_us(1);
@@ -54,6 +197,9 @@ static uint8_t read_bit(void)
 {
     uint8_t ret;
     
+    if (speed == ONEWIRE_SPEED_OD)
+        return od_read_bit();
+    
     DQ_TX_LOW;
     _delay_us(1);
     DQ_TX_HIGH;
@@ -103,10 +249,21 @@ void onewire_init(void)
     DQ_TX_HIGH;
 }
 
+/* ROM commands always start at standard speed */
+static int std_reset(void)
+{
+    speed = ONEWIRE_SPEED_STD;
+    od_last = OD_LAST_NONE;
+    return onewire_reset();
+}
+
 int onewire_reset(void)
 {
     int ret;
     
+    if (speed == ONEWIRE_SPEED_OD)
+        return od_reset();
+    
     DQ_TX_LOW;
     _delay_us(480);
     DQ_TX_HIGH;
@@ -133,6 +290,15 @@ int onewire_send(uint8_t *data, int len)
     if (len < 1)
         return -1;
     
+    if (speed == ONEWIRE_SPEED_OD) {
+        for (j = 0; j < len; j++) {
+            for (i = 0; i < 8; i++)
+                od_write_bit((data[j] >> i) & 0x01);
+        }
+        
+        return 0;
+    }
+    
     for (j = 0; j < len; j++) {
         tmp = 0x01;
         
@@ -168,6 +334,21 @@ int onewire_recv(uint8_t *data, int len)
     if (len < 1)
         return -1;
     
+    if (speed == ONEWIRE_SPEED_OD) {
+        for (j = 0; j < len; j++) {
+            tmp = 0x00;
+            
+            for (i = 0; i < 8; i++) {
+                if (od_read_bit())
+                    tmp |= (1 << i);
+            }
+            
+            data[j] = tmp;
+        }
+        
+        return 0;
+    }
+    
     for (j = 0; j < len; j++) {
         tmp = 0x00;
         
@@ -189,12 +370,17 @@ int onewire_recv(uint8_t *data, int len)
     return 0;
 }
 
+int onewire_read_bit(void)
+{
+    return read_bit();
+}
+
 int onewire_read_rom(ow_rom_t *rom)
 {
     uint8_t cmd;
     uint8_t buf[8];
     
-    if (!onewire_reset())
+    if (!std_reset())
         return -1;
     
     cmd = ONEWIRE_CMD_ROM_READ;
@@ -234,7 +420,7 @@ int onewire_search_rom(int type, ow_rom_t *roms, int num)
     first = 1;
     
     while (rep_o) {
-        if (!onewire_reset()) {
+        if (!std_reset()) {
             return 0;
         }
     
@@ -348,7 +534,7 @@ int onewire_search_family(int type, uint8_t family, ow_rom_t *roms, int num)
     first = 1;
     
     while (rep_o) {
-        if (!onewire_reset()) {
+        if (!std_reset()) {
             return 0;
         }
     
@@ -478,7 +664,7 @@ int onewire_match_rom(ow_rom_t *rom)
     if (!rom)
         return -1;
     
-    if (!onewire_reset())
+    if (!std_reset())
         return -1;
     
     cmd[0] = ONEWIRE_CMD_ROM_MATCH;
@@ -490,11 +676,51 @@ int onewire_match_rom(ow_rom_t *rom)
     return 0;
 }
 
+/* Search ROM with the path forced to one ROM, fails if it does not answer */
+int onewire_verify_rom(ow_rom_t *rom)
+{
+    uint8_t cmd;
+    uint8_t buf[8];
+    uint8_t r_bit;
+    uint8_t r_bit_c;
+    uint8_t val;
+    int i;
+    
+    if (!rom)
+        return -1;
+    
+    if (!std_reset())
+        return 0;
+    
+    buf[0] = rom->or_family;
+    memcpy(&buf[1], rom->or_serial, 6);
+    buf[7] = rom->or_crc;
+    cmd = ONEWIRE_CMD_ROM_SEARCH;
+    onewire_send(&cmd, 1);
+    
+    for (i = 0; i < 64; i++) {
+        val = (buf[i >> 3] >> (i & 0x07)) & 0x01;
+        r_bit = read_bit();
+        r_bit_c = read_bit();
+        
+        /* No device left, or all remaining ones differ in this bit */
+        if (r_bit && r_bit_c)
+            return 0;
+        
+        if ((r_bit != r_bit_c) && (r_bit != val))
+            return 0;
+        
+        write_bit(val);
+    }
+    
+    return 1;
+}
+
 int onewire_skip_rom(void)
 {
     uint8_t cmd;
     
-    if (!onewire_reset())
+    if (!std_reset())
         return -1;
     
     cmd = ONEWIRE_CMD_ROM_SKIP;
@@ -502,6 +728,109 @@ int onewire_skip_rom(void)
     return 0;
 }
 
+int onewire_set_speed(int val)
+{
+    if ((val != ONEWIRE_SPEED_STD) && (val != ONEWIRE_SPEED_OD))
+        return -1;
+    
+    speed = val;
+    return 0;
+}
+
+int onewire_get_speed(void)
+{
+    return speed;
+}
+
+/* Overdrive capable devices switch after the command byte */
+int onewire_od_skip_rom(void)
+{
+    uint8_t cmd;
+    
+    if (od_skip_hold) {
+        od_skip_hold--;
+        return onewire_skip_rom();
+    }
+    
+    if (!std_reset())
+        return -1;
+    
+    cmd = ONEWIRE_CMD_OD_SKIP;
+    onewire_send(&cmd, 1);
+    speed = ONEWIRE_SPEED_OD;
+    od_last = OD_LAST_SKIP;
+    return 0;
+}
+
+/* Command byte at standard speed, the ROM already at Overdrive speed */
+int onewire_od_match_rom(ow_rom_t *rom)
+{
+    uint8_t cmd;
+    uint8_t buf[8];
+    int idx;
+    
+    if (!rom)
+        return -1;
+    
+    idx = od_add(rom);
+    
+    if (od_devs[idx].od_hold) {
+        od_devs[idx].od_hold--;
+        return onewire_match_rom(rom);
+    }
+    
+    if (!std_reset())
+        return -1;
+    
+    cmd = ONEWIRE_CMD_OD_MATCH;
+    onewire_send(&cmd, 1);
+    speed = ONEWIRE_SPEED_OD;
+    od_last = idx;
+    buf[0] = rom->or_family;
+    memcpy(&buf[1], rom->or_serial, 6);
+    buf[7] = rom->or_crc;
+    onewire_send(buf, 8);
+    return 0;
+}
+
+/* For errors only the caller can see (e.g. CRC), NULL for OVERDRIVE SKIP */
+void onewire_od_error(ow_rom_t *rom)
+{
+    od_dev_t *dev;
+    
+    if (!rom) {
+        od_fail(OD_LAST_SKIP);
+        return;
+    }
+    
+    dev = od_find(rom);
+    
+    if (dev)
+        od_fail(dev - od_devs);
+    else
+        od_fail(od_add(rom));
+}
+
+/* Speed the next onewire_od_match_rom() runs at */
+int onewire_get_dev_speed(ow_rom_t *rom)
+{
+    od_dev_t *dev;
+    
+    if (!rom) {
+        if (od_skip_hold)
+            return ONEWIRE_SPEED_STD;
+        
+        return ONEWIRE_SPEED_OD;
+    }
+    
+    dev = od_find(rom);
+    
+    if (dev && dev->od_hold)
+        return ONEWIRE_SPEED_STD;
+    
+    return ONEWIRE_SPEED_OD;
+}
+
 int onewire_get_family(ow_rom_t *rom, uint8_t *family)
 {
     if (!rom)
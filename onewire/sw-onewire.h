@@ -5,9 +5,9 @@
  * Project  : lib-avr
  * Author   : Copyright (C) 2018-2019 Johannes Krottmayer <krjdev@gmail.com>
  * Created  : 2018-09-28
- * Modified : 2019-01-06
+ * Modified : 2026-10-19
  * Revised  : 
- * Version  : 0.3.0.0
+ * Version  : 0.6.0.0
  * License  : ISC (see file LICENSE.txt)
  * Target   : Atmel AVR Series
  *
@@ -32,6 +32,15 @@
 #define TYPE_SEARCH_ALL             0
 #define TYPE_SEARCH_ALARM           1
 
+#define ONEWIRE_SPEED_STD           0
+#define ONEWIRE_SPEED_OD            1
+
+/* Devices with tracked Overdrive state */
+#define ONEWIRE_OD_DEV_MAX          8
+
+/* Selects at standard speed after an Overdrive error, then it retries */
+#define ONEWIRE_OD_HOLD             16
+
 typedef struct ow_rom {
     uint8_t or_family;
     uint8_t or_serial[6];
@@ -42,11 +51,19 @@ extern void onewire_init(void);
 extern int onewire_reset(void);
 extern int onewire_send(uint8_t *data, int len);
 extern int onewire_recv(uint8_t *data, int len);
+extern int onewire_read_bit(void);
 extern int onewire_read_rom(ow_rom_t *rom);
 extern int onewire_search_rom(int type, ow_rom_t *roms, int num);
 extern int onewire_search_family(int type, uint8_t family, ow_rom_t *roms, int num);
 extern int onewire_match_rom(ow_rom_t *rom);
+extern int onewire_verify_rom(ow_rom_t *rom);
 extern int onewire_skip_rom(void);
+extern int onewire_set_speed(int val);
+extern int onewire_get_speed(void);
+extern int onewire_od_skip_rom(void);
+extern int onewire_od_match_rom(ow_rom_t *rom);
+extern void onewire_od_error(ow_rom_t *rom);
+extern int onewire_get_dev_speed(ow_rom_t *rom);
 extern int onewire_get_family(ow_rom_t *rom, uint8_t *family);
 extern int onewire_get_serial(ow_rom_t *rom, uint8_t *buf);
 extern int onewire_get_crc(ow_rom_t *rom, uint8_t *crc);
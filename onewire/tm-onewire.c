@@ -0,0 +1,373 @@
+/**
+ *
+ * File Name: tm-onewire.c
+ * Title    : Timer driven 1-Wire library
+ * Project  : lib-avr
+ * Author   : Copyright (C) 2026 Johannes Krottmayer <krjdev@gmail.com>
+ * Created  : 2026-10-19
+ * Modified : 2026-10-19
+ * Revised  : 
+ * Version  : 0.2.0.0
+ * License  : ISC (see file LICENSE.txt)
+ * Target   : Atmel AVR Series
+ *
+ * NOTE: This code is currently below version 1.0, and therefore is considered
+ * to be lacking in some functionality or documentation, or may not be fully
+ * tested. Nonetheless, you can expect most functions to work.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "tm-onewire.h"
+
+#ifndef ONEWIRE_SIM
+#include <avr/interrupt.h>
+#include <util/delay.h>
+
+#define DELAY_US(us)        _delay_us(us)
+#else
+#define DELAY_US(us)        ow_sim_delay((uint32_t) ((us) * 1000))
+#endif
+
+/* Slot timing inside the ISR (microseconds), standard speed and Overdrive */
+#define T_A                 6   /* Write 1 / read low time */
+#define T_E                 9   /* Read sample after release */
+#define T_I                 70  /* Presence sample after release */
+#define T_A_OD              1
+#define T_C_OD              7.5 /* Write 0 low time, max 16 */
+#define T_E_OD              1
+#define T_H_OD              70  /* Reset low time, max 80 */
+#define T_I_OD              8.5
+
+#define CMD_OD_SKIP         0x3C
+#define CMD_OD_MATCH        0x69
+
+/* Timer driven slot timing (half microseconds) */
+typedef struct tm_timing {
+    uint16_t tt_b;          /* Write 1 recovery */
+    uint16_t tt_c;          /* Write 0 low time */
+    uint16_t tt_d;          /* Write 0 recovery */
+    uint16_t tt_f;          /* Read recovery */
+    uint16_t tt_h;          /* Reset low time */
+    uint16_t tt_j;          /* Reset recovery */
+} tm_timing_t;
+
+/* AN126 recommended values, Overdrive tt_c/tt_h are timed in the ISR */
+static const tm_timing_t timing[2] = {
+    { 128, 120, 20, 110, 960, 820 },
+    { 15, 15, 5, 14, 140, 80 }
+};
+
+#define ST_IDLE             0
+#define ST_RESET            1 /* Reset pulse running */
+#define ST_RESET_END        2 /* Presence sampled, recovery running */
+#define ST_SLOT             3 /* Next slot starts on the compare match */
+#define ST_WRITE0           4 /* Write 0 low time running */
+
+static volatile uint8_t state = ST_IDLE;
+static volatile int result;
+static uint8_t *tx_ptr;
+static int tx_cnt;
+static uint8_t *rx_ptr;
+static int rx_cnt;
+static int pos;
+static uint8_t bit;
+static ow_done_t done_cb;
+static volatile uint8_t speed = ONEWIRE_TM_SPEED_STD;
+static uint8_t od_switch = 0;
+static uint8_t od_buf[9];
+
+static void finish(int res)
+{
+    TM_TIMER_STOP;
+    od_switch = 0;
+    result = res;
+    state = ST_IDLE;
+    
+    if (done_cb)
+        done_cb(res);
+}
+
+static void next_bit(void)
+{
+    bit++;
+    
+    if (bit == 8) {
+        bit = 0;
+        pos++;
+        
+        /* OVERDRIVE SKIP/MATCH ROM, the command byte is still standard speed */
+        if (od_switch) {
+            od_switch = 0;
+            speed = ONEWIRE_TM_SPEED_OD;
+        }
+    }
+}
+
+static void low_pulse(void)
+{
+    TM_DQ_TX_LOW;
+    
+    if (speed == ONEWIRE_TM_SPEED_OD)
+        DELAY_US(T_A_OD);
+    else
+        DELAY_US(T_A);
+    
+    TM_DQ_TX_HIGH;
+}
+
+/* Low pulse and sample point run inside the ISR, others can only delay a slot */
+static void slot_start(void)
+{
+    if (pos < tx_cnt) {
+        if ((tx_ptr[pos] >> bit) & 0x01) {
+            low_pulse();
+            TM_TIMER_START(timing[speed].tt_b);
+            state = ST_SLOT;
+        } else if (speed == ONEWIRE_TM_SPEED_OD) {
+            /* A late compare match would overrun the 16 us maximum */
+            TM_DQ_TX_LOW;
+            DELAY_US(T_C_OD);
+            TM_DQ_TX_HIGH;
+            TM_TIMER_START(timing[speed].tt_d);
+            state = ST_SLOT;
+        } else {
+            TM_DQ_TX_LOW;
+            TM_TIMER_START(timing[speed].tt_c);
+            state = ST_WRITE0;
+        }
+        
+        next_bit();
+        
+        if (pos == tx_cnt) {
+            pos = 0;
+            tx_cnt = 0;
+        }
+        
+        return;
+    }
+    
+    if (pos < rx_cnt) {
+        if (bit == 0)
+            rx_ptr[pos] = 0x00;
+        
+        low_pulse();
+        
+        if (speed == ONEWIRE_TM_SPEED_OD)
+            DELAY_US(T_E_OD);
+        else
+            DELAY_US(T_E);
+        
+        if (TM_DQ_RX)
+            rx_ptr[pos] |= (1 << bit);
+        
+        TM_TIMER_START(timing[speed].tt_f);
+        state = ST_SLOT;
+        next_bit();
+        return;
+    }
+    
+    finish(result);
+}
+
+#ifndef ONEWIRE_SIM
+ISR(TM_TIMER_vect)
+{
+    onewire_tm_isr();
+}
+#endif
+
+void onewire_tm_isr(void)
+{
+    switch (state) {
+    case ST_RESET:
+        /* Whole Overdrive reset pulse here, a late compare match would overrun 80 us */
+        if (speed == ONEWIRE_TM_SPEED_OD) {
+            TM_DQ_TX_LOW;
+            DELAY_US(T_H_OD);
+        }
+        
+        TM_DQ_TX_HIGH;
+        
+        if (speed == ONEWIRE_TM_SPEED_OD)
+            DELAY_US(T_I_OD);
+        else
+            DELAY_US(T_I);
+        
+        result = TM_DQ_RX ? 0 : 1;
+        TM_TIMER_START(timing[speed].tt_j);
+        
+        /* No presence at Overdrive speed, the next reset is a standard one */
+        if (!result)
+            speed = ONEWIRE_TM_SPEED_STD;
+        
+        state = ST_RESET_END;
+        break;
+    case ST_RESET_END:
+        /* Without presence the rest of a transfer is skipped */
+        if (!result)
+            finish(0);
+        else
+            slot_start();
+        
+        break;
+    case ST_SLOT:
+        slot_start();
+        break;
+    case ST_WRITE0:
+        TM_DQ_TX_HIGH;
+        TM_TIMER_START(timing[speed].tt_d);
+        state = ST_SLOT;
+        break;
+    default:
+        TM_TIMER_STOP;
+    }
+}
+
+void onewire_tm_init(void)
+{
+    TM_DQ_TX_CONFIG;
+    TM_DQ_TX_HIGH;
+    TM_TIMER_CONFIG;
+    state = ST_IDLE;
+}
+
+int onewire_tm_xfer(uint8_t *tx, int tx_len, uint8_t *rx, int rx_len, ow_done_t done)
+{
+    if (((tx == NULL) && (tx_len > 0)) || ((rx == NULL) && (rx_len > 0)))
+        return -1;
+    
+    if ((tx_len < 0) || (rx_len < 0))
+        return -1;
+    
+    if (state != ST_IDLE)
+        return -1;
+    
+    tx_ptr = tx;
+    tx_cnt = tx_len;
+    rx_ptr = rx;
+    rx_cnt = rx_len;
+    pos = 0;
+    bit = 0;
+    done_cb = done;
+    result = 0;
+    state = ST_RESET;
+    
+    if (speed == ONEWIRE_TM_SPEED_OD) {
+        TM_TIMER_START(2);
+        return 0;
+    }
+    
+    TM_DQ_TX_LOW;
+    TM_TIMER_START(timing[speed].tt_h);
+    return 0;
+}
+
+/* Standard reset, then OVERDRIVE MATCH ROM (8 bytes) or SKIP ROM (NULL) */
+int onewire_tm_od_select(uint8_t *rom, ow_done_t done)
+{
+    if (state != ST_IDLE)
+        return -1;
+    
+    speed = ONEWIRE_TM_SPEED_STD;
+    
+    if (rom) {
+        od_buf[0] = CMD_OD_MATCH;
+        memcpy(&od_buf[1], rom, 8);
+        od_switch = 1;
+        return onewire_tm_xfer(od_buf, 9, NULL, 0, done);
+    }
+    
+    od_buf[0] = CMD_OD_SKIP;
+    od_switch = 1;
+    return onewire_tm_xfer(od_buf, 1, NULL, 0, done);
+}
+
+int onewire_tm_set_speed(int val)
+{
+    if ((val != ONEWIRE_TM_SPEED_STD) && (val != ONEWIRE_TM_SPEED_OD))
+        return -1;
+    
+    if (state != ST_IDLE)
+        return -1;
+    
+    speed = val;
+    return 0;
+}
+
+int onewire_tm_get_speed(void)
+{
+    return speed;
+}
+
+int onewire_tm_reset(ow_done_t done)
+{
+    return onewire_tm_xfer(NULL, 0, NULL, 0, done);
+}
+
+int onewire_tm_send(uint8_t *data, int len, ow_done_t done)
+{
+    if (!data)
+        return -1;
+    
+    if (len < 1)
+        return -1;
+    
+    if (state != ST_IDLE)
+        return -1;
+    
+    tx_ptr = data;
+    tx_cnt = len;
+    rx_ptr = NULL;
+    rx_cnt = 0;
+    pos = 0;
+    bit = 0;
+    done_cb = done;
+    result = 0;
+    state = ST_SLOT;
+    TM_TIMER_START(2);
+    return 0;
+}
+
+int onewire_tm_recv(uint8_t *data, int len, ow_done_t done)
+{
+    if (!data)
+        return -1;
+    
+    if (len < 1)
+        return -1;
+    
+    if (state != ST_IDLE)
+        return -1;
+    
+    tx_ptr = NULL;
+    tx_cnt = 0;
+    rx_ptr = data;
+    rx_cnt = len;
+    pos = 0;
+    bit = 0;
+    done_cb = done;
+    result = 0;
+    state = ST_SLOT;
+    TM_TIMER_START(2);
+    return 0;
+}
+
+int onewire_tm_busy(void)
+{
+    return (state != ST_IDLE);
+}
+
+/* Blocking wrapper, the transfer itself still runs in the ISR */
+int onewire_tm_wait(void)
+{
+    while (state != ST_IDLE) {
+#ifdef ONEWIRE_SIM
+        ow_sim_step();
+#endif
+    }
+    
+    return result;
+}
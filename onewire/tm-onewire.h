@@ -0,0 +1,70 @@
+/**
+ *
+ * File Name: tm-onewire.h
+ * Title    : Timer driven 1-Wire library header
+ * Project  : lib-avr
+ * Author   : Copyright (C) 2026 Johannes Krottmayer <krjdev@gmail.com>
+ * Created  : 2026-10-19
+ * Modified : 2026-10-19
+ * Revised  : 
+ * Version  : 0.2.0.0
+ * License  : ISC (see file LICENSE.txt)
+ * Target   : Atmel AVR Series
+ *
+ * NOTE: This code is currently below version 1.0, and therefore is considered
+ * to be lacking in some functionality or documentation, or may not be fully
+ * tested. Nonetheless, you can expect most functions to work.
+ *
+ */
+
+#ifndef LIBAVR_ONEWIRE_TM_ONEWIRE_H
+#define LIBAVR_ONEWIRE_TM_ONEWIRE_H
+
+#include <stdint.h>
+
+#ifndef ONEWIRE_SIM
+#include <avr/io.h>
+
+/* DQ wiring, same as sw-onewire */
+#define TM_DQ_TX_CONFIG             (DDRH |= (1 << PH0))
+#define TM_DQ_TX_HIGH               (PORTH |= (1 << PH0))
+#define TM_DQ_TX_LOW                (PORTH &= ~(1 << PH0))
+#define TM_DQ_RX                    (PINH & (1 << PINH1))
+
+/* Timer/Counter1, CTC mode, clk/8, started in half microseconds */
+#define TM_TIMER_CONFIG             (TCCR1A = 0, TCCR1B = (1 << WGM12))
+#define TM_TIMER_START(hus)         (OCR1A = (((F_CPU / 2000000UL) * (hus)) / 8) - 1, TCNT1 = 0, TIFR1 = (1 << OCF1A), TIMSK1 |= (1 << OCIE1A), TCCR1B |= (1 << CS11))
+#define TM_TIMER_STOP               (TCCR1B &= ~(1 << CS11), TIMSK1 &= ~(1 << OCIE1A))
+#define TM_TIMER_vect               TIMER1_COMPA_vect
+#else
+#include "sim-onewire.h"
+
+/* Host simulation, see sim-onewire.c */
+#define TM_DQ_TX_CONFIG             ow_sim_drive(0)
+#define TM_DQ_TX_HIGH               ow_sim_drive(0)
+#define TM_DQ_TX_LOW                ow_sim_drive(1)
+#define TM_DQ_RX                    ow_sim_sample()
+#define TM_TIMER_CONFIG             ow_sim_timer_stop()
+#define TM_TIMER_START(hus)         ow_sim_timer_start((uint32_t) (hus) * 500)
+#define TM_TIMER_STOP               ow_sim_timer_stop()
+#endif
+
+#define ONEWIRE_TM_SPEED_STD        0
+#define ONEWIRE_TM_SPEED_OD         1
+
+/* Completion callback, presence (1/0) for a reset or transfer, else 0 */
+typedef void (*ow_done_t)(int result);
+
+extern void onewire_tm_init(void);
+extern int onewire_tm_reset(ow_done_t done);
+extern int onewire_tm_send(uint8_t *data, int len, ow_done_t done);
+extern int onewire_tm_recv(uint8_t *data, int len, ow_done_t done);
+extern int onewire_tm_xfer(uint8_t *tx, int tx_len, uint8_t *rx, int rx_len, ow_done_t done);
+extern int onewire_tm_od_select(uint8_t *rom, ow_done_t done);
+extern int onewire_tm_set_speed(int val);
+extern int onewire_tm_get_speed(void);
+extern int onewire_tm_busy(void);
+extern int onewire_tm_wait(void);
+extern void onewire_tm_isr(void);
+
+#endif
@@ -5,9 +5,9 @@
  * Project  : lib-avr
  * Author   : Copyright (C) 2018-2019 Johannes Krottmayer <krjdev@gmail.com>
  * Created  : 2018-09-22
- * Modified : 2019-06-08
+ * Modified : 2026-10-19
  * Revised  : 
- * Version  : 0.5.0.1
+ * Version  : 0.8.0.0
  * License  : ISC (see file LICENSE.txt)
  * Target   : Atmel AVR Series
  *
@@ -18,13 +18,14 @@
  */
 
 #include <stdlib.h>
+#include <string.h>
 #include <util/delay.h>
 
 #include "enc28j60.h"
 #include "spi.h"
 
 #define DRIVER_NAME         "ENC28J60"
-#define DRIVER_VERSION      "0.5.0.1"
+#define DRIVER_VERSION      "0.8.0.0"
 
 #define HI16(u16)           ((uint8_t) (((u16) & 0xFF00) >> 8))
 #define LO16(u16)           ((uint8_t) ((u16) & 0x00FF))
@@ -33,17 +34,28 @@
 
 #define BUF_SIZE            8192
 #define BUF_RX_START        0x0000
-#define BUF_RX_END          0x19FF
+#define BUF_RX_END          0x13FF
 #define BUF_RX_SIZE         (BUF_RX_END - BUF_RX_START + 1)
-#define BUF_TX_START        0x1A00
+#define BUF_TX_START        0x1400
 #define BUF_TX_END          0x1FFF
 #define BUF_TX_SIZE         (BUF_TX_END - BUF_TX_START + 1)
+#define BUF_TX_SLOT_SIZE    0x0600 /* Control byte, frame and TSV */
+#define BUF_TX_SLOTS        2
 #define BUF_PTR_SIZE         2
 #define BUF_PTR_LO           0
 #define BUF_PTR_HI           1
 
 #define TIMEOUT_CNT          500
 
+#define FRM_HDR_LEN         14
+#define FRM_MAX_LEN         (ETHERNET_MAX_FRAME_SIZE - 4) /* CRC by the MAC */
+#define TX_RETRY_MAX        15
+
+/* TX slot states */
+#define TX_FREE             0
+#define TX_QUEUED           1
+#define TX_ACTIVE           2
+
 /* SPI Instruction Set */
 #define SPI_RCR     0x00 /* Read Control Register */
 #define SPI_RBM     0x3A /* Read Buffer Memory */
@@ -395,6 +407,13 @@ static int error = ENC28J60_ERR_NOERR;
 static mac_addr_t mac;
 static nic_stats_t stats;
 static uint16_t ptr_pkg_next;
+static uint8_t rx_pend;
+static uint16_t rx_frm_start;
+static int rx_frm_len;
+static uint8_t tx_state[BUF_TX_SLOTS];
+static uint16_t tx_len[BUF_TX_SLOTS];
+static uint8_t tx_retry;
+static uint8_t tx_next;
 
 static int select_bank(uint8_t bank)
 {
@@ -671,6 +690,269 @@ static int free_rx_memory(void)
     return 0;
 }
 
+static uint16_t rx_addr(uint16_t addr, int off)
+{
+    uint32_t tmp;
+    
+    tmp = (uint32_t) addr + off;
+    
+    if (tmp > BUF_RX_END)
+        tmp -= BUF_RX_SIZE;
+    
+    return (uint16_t) tmp;
+}
+
+static int rx_read_wrap(uint16_t addr, uint8_t *buf, int len)
+{
+    int len_warp;
+    
+    if ((addr + len - 1) <= BUF_RX_END)
+        return read_buffer(addr, buf, len);
+    
+    len_warp = BUF_RX_END - addr + 1;
+    
+    if (read_buffer(addr, buf, len_warp) == -1)
+        return -1;
+    
+    return read_buffer(BUF_RX_START, &buf[len_warp], (len - len_warp));
+}
+
+/* The next pointer can not be trusted, the ring is restarted empty */
+static int rx_reset(void)
+{
+    uint8_t econ1;
+    uint8_t tmp;
+    
+    /* Read again before every write, TXRTS may have changed meanwhile */
+    if (read_reg(BANK0, ECON1, &econ1) == -1)
+        return -1;
+    
+    tmp = econ1 & ~(1 << ECON1_RXEN);
+    
+    if (write_reg(BANK0, ECON1, (tmp | (1 << ECON1_RXRST))) == -1)
+        return -1;
+    
+    if (read_reg(BANK0, ECON1, &tmp) == -1)
+        return -1;
+    
+    if (write_reg(BANK0, ECON1, (tmp & ~(1 << ECON1_RXRST))) == -1)
+        return -1;
+    
+    /* Writing ERXST also moves the write pointer to the start */
+    if (write_reg(BANK0, ERXSTL, LO16(BUF_RX_START)) == -1)
+        return -1;
+    
+    if (write_reg(BANK0, ERXSTH, HI16(BUF_RX_START)) == -1)
+        return -1;
+    
+    if (write_reg(BANK0, ERXRDPTL, LO16(BUF_RX_END)) == -1)
+        return -1;
+    
+    if (write_reg(BANK0, ERXRDPTH, HI16(BUF_RX_END)) == -1)
+        return -1;
+    
+    /* Frames still counted in EPKTCNT are gone with the ring */
+    while (1) {
+        if (read_reg(BANK1, EPKTCNT, &tmp) == -1)
+            return -1;
+        
+        if (tmp == 0)
+            break;
+        
+        if (read_reg(BANK0, ECON2, &tmp) == -1)
+            return -1;
+        
+        if (write_reg(BANK0, ECON2, (tmp | (1 << ECON2_PKTDEC))) == -1)
+            return -1;
+    }
+    
+    ptr_pkg_next = BUF_RX_START;
+    rx_pend = 0;
+    
+    if (read_reg(BANK0, ECON1, &tmp) == -1)
+        return -1;
+    
+    return write_reg(BANK0, ECON1, (tmp | (econ1 & (1 << ECON1_RXEN))));
+}
+
+static int rx_release(void)
+{
+    rx_pend = 0;
+    return free_rx_memory();
+}
+
+/* Reads the header of the next frame, the frame stays in the chip */
+static int rx_next(void)
+{
+    uint16_t ptr_pkg_start;
+    uint8_t hdr[BUF_PTR_SIZE + 4];
+    uint8_t *rsv;
+    uint16_t dist;
+    uint8_t tmp;
+    
+    if (rx_pend)
+        return 1;
+    
+    if (read_reg(BANK1, EPKTCNT, &tmp) == -1)
+        return -1;
+    
+    if (tmp < 1)
+        return 0;
+    
+    ptr_pkg_start = ptr_pkg_next;
+    
+    if (rx_read_wrap(ptr_pkg_start, hdr, sizeof(hdr)) == -1)
+        return -1;
+    
+    rsv = &hdr[BUF_PTR_SIZE];
+    ptr_pkg_next = (uint16_t) hdr[BUF_PTR_LO];
+    ptr_pkg_next |= ((uint16_t) hdr[BUF_PTR_HI] << 8);
+    rx_frm_start = rx_addr(ptr_pkg_start, sizeof(hdr));
+    rx_frm_len = (uint16_t) rsv[RSV_BCNTL];
+    rx_frm_len |= ((uint16_t) rsv[RSV_BCNTH] << 8);
+    
+    if (ISCLR(rsv[RSV_BYTE2], RSV_OK)) {
+        stats.rx_err++;
+        
+        if (free_rx_memory() == -1)
+            return -1;
+        
+        error = ENC28J60_ERR_FRMIN;
+        return -1;
+    }
+    
+    /* Frames start on even addresses, the next pointer says the same */
+    if (ptr_pkg_next >= rx_frm_start)
+        dist = ptr_pkg_next - rx_frm_start;
+    else
+        dist = ptr_pkg_next + BUF_RX_SIZE - rx_frm_start;
+    
+    if ((dist != rx_frm_len) && (dist != (rx_frm_len + 1))) {
+        stats.rx_err++;
+        
+        if (rx_reset() == -1)
+            return -1;
+        
+        error = ENC28J60_ERR_INTER;
+        return -1;
+    }
+    
+    if ((rx_frm_len > ETHERNET_MAX_FRAME_SIZE) || (rx_frm_len < 4)) {
+        stats.rx_err++;
+        
+        if (free_rx_memory() == -1)
+            return -1;
+        
+        error = ENC28J60_ERR_FRMTB;
+        return -1;
+    }
+    
+    rx_pend = 1;
+    return 1;
+}
+
+static int tx_start(uint8_t slot)
+{
+    uint16_t addr;
+    uint8_t tmp;
+    
+    addr = BUF_TX_START + (slot * BUF_TX_SLOT_SIZE);
+    
+    if (tx_state[slot] == TX_QUEUED)
+        tx_retry = 0;
+    
+    /* Errata, reset the transmit logic before every transmission */
+    if (read_reg(BANK0, ECON1, &tmp) == -1)
+        return -1;
+    
+    tmp |= (1 << ECON1_TXRST);
+    
+    if (write_reg(BANK0, ECON1, tmp) == -1)
+        return -1;
+    
+    tmp &= ~(1 << ECON1_TXRST);
+    
+    if (write_reg(BANK0, ECON1, tmp) == -1)
+        return -1;
+    
+    if (read_reg(BANK0, EIR, &tmp) == -1)
+        return -1;
+    
+    tmp &= ~((1 << EIR_TXERIF) | (1 << EIR_TXIF));
+    
+    if (write_reg(BANK0, EIR, tmp) == -1)
+        return -1;
+    
+    if (write_reg(BANK0, ETXSTL, LO16(addr)) == -1)
+        return -1;
+    
+    if (write_reg(BANK0, ETXSTH, HI16(addr)) == -1)
+        return -1;
+    
+    if (write_reg(BANK0, ETXNDL, LO16((addr + tx_len[slot]))) == -1)
+        return -1;
+    
+    if (write_reg(BANK0, ETXNDH, HI16((addr + tx_len[slot]))) == -1)
+        return -1;
+    
+    if (read_reg(BANK0, ECON1, &tmp) == -1)
+        return -1;
+    
+    tmp |= (1 << ECON1_TXRTS);
+    
+    if (write_reg(BANK0, ECON1, tmp) == -1)
+        return -1;
+    
+    tx_state[slot] = TX_ACTIVE;
+    return 0;
+}
+
+static int rx_pause(uint8_t *econ1)
+{
+    uint8_t tmp;
+    
+    /* Filters must not change while a frame is being received */
+    if (read_reg(BANK0, ECON1, econ1) == -1)
+        return -1;
+    
+    tmp = (*econ1) & ~(1 << ECON1_RXEN);
+    
+    if (write_reg(BANK0, ECON1, tmp) == -1)
+        return -1;
+    
+    return 0;
+}
+
+static uint8_t hash_ptr(mac_addr_t *addr)
+{
+    uint8_t buf[6];
+    uint32_t crc = 0xFFFFFFFF;
+    uint8_t bit;
+    int i;
+    int j;
+    
+    buf[0] = addr->ma_byte0;
+    buf[1] = addr->ma_byte1;
+    buf[2] = addr->ma_byte2;
+    buf[3] = addr->ma_byte3;
+    buf[4] = addr->ma_byte4;
+    buf[5] = addr->ma_byte5;
+    
+    /* CRC-32 as the MAC computes it, data LSB first, no final inversion */
+    for (i = 0; i < 6; i++) {
+        for (j = 0; j < 8; j++) {
+            bit = ((crc >> 31) ^ (buf[i] >> j)) & 1;
+            crc <<= 1;
+            
+            if (bit)
+                crc ^= 0x04C11DB7;
+        }
+    }
+    
+    /* Bits 28:23 select one of the 64 hash table bits */
+    return (uint8_t) ((crc >> 23) & 0x3F);
+}
+
 int enc28j60_init(int mode, mac_addr_t *addr)
 {
     uint8_t tmp;
@@ -692,6 +974,9 @@ int enc28j60_init(int mode, mac_addr_t *addr)
     ethernet_crc_enable();
     ethernet_addr_cpy(&mac, addr); 
     ptr_pkg_next = BUF_RX_START;
+    rx_pend = 0;
+    memset(tx_state, TX_FREE, sizeof(tx_state));
+    tx_next = 0;
     ENC28J60_RS_CONFIG;
     ENC28J60_RS_HIGH;
     
@@ -731,9 +1016,7 @@ int enc28j60_init(int mode, mac_addr_t *addr)
         return -1;
     
     /* Receive Filter */
-    if (write_reg(BANK1, ERXFCON, ((1 << ERXFCON_MCEN) | 
-                                   (1 << ERXFCON_UCEN) | 
-                                   (1 << ERXFCON_BCEN))) == -1)
+    if (write_reg(BANK1, ERXFCON, ENC28J60_FILTER_DEFAULT) == -1)
         return -1;
     
     /* Waiting for OST */
@@ -810,6 +1093,12 @@ int enc28j60_init(int mode, mac_addr_t *addr)
             return -1;
     }
     
+    /* Transmit done/error raise INT, for callers not polling enc28j60_tx_poll() */
+    if (write_reg(BANK0, EIE, ((1 << EIE_INTIE) | 
+                               (1 << EIE_TXIE) | 
+                               (1 << EIE_TXERIE))) == -1)
+        return -1;
+    
     /* Enable increment */
     if (write_reg(BANK0, ECON2, (1 << ECON2_AUTOINC)) == -1)
         return -1;
@@ -823,111 +1112,181 @@ int enc28j60_init(int mode, mac_addr_t *addr)
 
 int enc28j60_send(eth_frame_t *frame)
 {
-    int i;
-    int ret;
     int frm_len;
     int timeout = TIMEOUT_CNT;
-    uint8_t *p;
-    uint8_t tmp = 0x00;
-    uint8_t tsv[7];
+    uint16_t addr;
+    uint8_t hdr[FRM_HDR_LEN + 1];
+    uint8_t slot;
+    int i = 0;
     
     if (!frame) {
         error = ENC28J60_ERR_INVAL;
         return -1;
     }
     
-    frm_len = ethernet_frame_get_len(frame);
-    
-    if (frm_len == -1) {
-        error = ENC28J60_ERR_ETLIB;
-        return -1;
-    }
+    frm_len = FRM_HDR_LEN + frame->ef_payload_len;
     
-    if (frm_len > ETHERNET_MAX_FRAME_SIZE) {
+    if (frm_len > FRM_MAX_LEN) {
         stats.tx_err++;
         error = ENC28J60_ERR_FRMTB;
         return -1;
     }
     
-    p = (uint8_t *) malloc(frm_len);
-    
-    if (!p) {
-        error = ENC28J60_ERR_NOMEM;
+    if ((frame->ef_payload_len > 0) && !frame->ef_payload_buf) {
+        error = ENC28J60_ERR_INVAL;
         return -1;
     }
     
-    if (ethernet_frm_to_buf(frame, p) == -1) {
-        error = ENC28J60_ERR_ETLIB;
-        free(p);
-        return -1;
-    }
+    slot = tx_next;
     
-    if (write_buffer(BUF_TX_START, &tmp, 1) == -1) {
-        free(p);
-        return -1;
+    /* Both slots in use, wait until the frame on the wire is done */
+    while (tx_state[slot] != TX_FREE) {
+        if (enc28j60_tx_poll() == -1)
+            return -1;
+        
+        if (tx_state[slot] == TX_FREE)
+            break;
+        
+        _delay_us(20);
+        timeout--;
+        
+        if (timeout == 0) {
+            error = ENC28J60_ERR_TIMEO;
+            return -1;
+        }
     }
     
-    if (write_buffer((BUF_TX_START + 1), p, frm_len) == -1) {
-        free(p);
-        return -1;
+    /* Per packet control byte, then the frame written straight from the frame */
+    hdr[i++] = 0x00;
+    hdr[i++] = frame->ef_dst.ma_byte0;
+    hdr[i++] = frame->ef_dst.ma_byte1;
+    hdr[i++] = frame->ef_dst.ma_byte2;
+    hdr[i++] = frame->ef_dst.ma_byte3;
+    hdr[i++] = frame->ef_dst.ma_byte4;
+    hdr[i++] = frame->ef_dst.ma_byte5;
+    hdr[i++] = frame->ef_src.ma_byte0;
+    hdr[i++] = frame->ef_src.ma_byte1;
+    hdr[i++] = frame->ef_src.ma_byte2;
+    hdr[i++] = frame->ef_src.ma_byte3;
+    hdr[i++] = frame->ef_src.ma_byte4;
+    hdr[i++] = frame->ef_src.ma_byte5;
+    hdr[i++] = HI16(frame->ef_type);
+    hdr[i++] = LO16(frame->ef_type);
+    addr = BUF_TX_START + (slot * BUF_TX_SLOT_SIZE);
+    
+    if (write_buffer(addr, hdr, FRM_HDR_LEN + 1) == -1)
+        return -1;
+    
+    if (frame->ef_payload_len > 0) {
+        if (write_buffer((addr + FRM_HDR_LEN + 1), 
+                         frame->ef_payload_buf, 
+                         frame->ef_payload_len) == -1)
+            return -1;
     }
     
-    free(p);
+    tx_len[slot] = frm_len;
+    tx_state[slot] = TX_QUEUED;
+    tx_next = (slot + 1) % BUF_TX_SLOTS;
     
-    if (write_reg(BANK0, ETXNDL, LO16((BUF_TX_START + frm_len))) == -1)
-        return -1;
+    /* Other slot idle, start right away, else tx_poll() starts it */
+    if (tx_state[tx_next] != TX_ACTIVE) {
+        if (tx_start(slot) == -1)
+            return -1;
+    }
     
-    if (write_reg(BANK0, ETXNDH, HI16((BUF_TX_START + frm_len))) == -1)
-        return -1;
+    return frm_len;
+}
+
+int enc28j60_tx_poll(void)
+{
+    uint16_t addr;
+    uint8_t tsv[7];
+    uint8_t slot;
+    uint8_t tmp;
     
-    if (read_reg(BANK0, ECON1, &tmp) == -1)
-        return -1;
+    for (slot = 0; slot < BUF_TX_SLOTS; slot++) {
+        if (tx_state[slot] == TX_ACTIVE)
+            break;
+    }
     
-    tmp |= (1 << ECON1_TXRST);
+    if (slot == BUF_TX_SLOTS)
+        return 0;
     
-    if (write_reg(BANK0, ECON1, tmp) == -1)
+    if (read_reg(BANK0, EIR, &tmp) == -1)
         return -1;
     
+    if (ISCLR(tmp, EIR_TXIF) && ISCLR(tmp, EIR_TXERIF))
+        return 0;
+    
     if (read_reg(BANK0, ECON1, &tmp) == -1)
         return -1;
     
-    tmp &= ~(1 << ECON1_TXRST);
+    tmp &= ~(1 << ECON1_TXRTS);
     
     if (write_reg(BANK0, ECON1, tmp) == -1)
         return -1;
     
-    if (read_reg(BANK0, EIR, &tmp) == -1)
-        return -1;
-    
-    tmp &= ~(1 << EIR_TXERIF);
+    addr = BUF_TX_START + (slot * BUF_TX_SLOT_SIZE);
     
-    if (write_reg(BANK0, EIR, tmp) == -1)
+    if (read_buffer((addr + tx_len[slot] + 1), tsv, 7) == -1)
         return -1;
     
     if (read_reg(BANK0, EIR, &tmp) == -1)
         return -1;
     
-    tmp &= ~(1 << EIR_TXIF);
-    
-    if (write_reg(BANK0, EIR, tmp) == -1)
-        return -1;
+    /* Errata, late collisions in half duplex need a retransmit */
+    if (ISSET(tmp, EIR_TXERIF) && ISSET(tsv[TSV_BYTE3], TSV_LATECOLL) && 
+        (tx_retry < TX_RETRY_MAX)) {
+        tx_retry++;
+        
+        if (tx_start(slot) == -1)
+            return -1;
+        
+        return 0;
+    }
     
+    tx_state[slot] = TX_FREE;
     
-    if (read_reg(BANK0, ECON1, &tmp) == -1)
-        return -1;
+    /* Failed frames are only counted, the send call returned long ago */
+    if (ISCLR(tsv[TSV_BYTE2], TSV_DONE)) {
+        stats.tx_err++;
+    } else {
+        stats.tx_frm++;
+        stats.tx_byt += ((uint16_t) tsv[TSV_BCNTH] << 8) | tsv[TSV_BCNTL];
+    }
     
-    tmp |= (1 << ECON1_TXRTS);
+    /* Frame written meanwhile into the other slot goes out next */
+    slot = (slot + 1) % BUF_TX_SLOTS;
     
-    if (write_reg(BANK0, ECON1, tmp) == -1)
-        return -1;
+    if (tx_state[slot] == TX_QUEUED) {
+        if (tx_start(slot) == -1)
+            return -1;
+    }
     
-    _delay_us(20);
+    return 1;
+}
+
+int enc28j60_tx_pending(void)
+{
+    int cnt = 0;
+    int i;
     
-    if (read_reg(BANK0, EIR, &tmp) == -1)
-        return -1;
+    for (i = 0; i < BUF_TX_SLOTS; i++) {
+        if (tx_state[i] != TX_FREE)
+            cnt++;
+    }
     
-    while (ISCLR(tmp, EIR_TXIF) && ISCLR(tmp, EIR_TXERIF)) {
-        read_reg(BANK0, EIR, &tmp);
+    return cnt;
+}
+
+int enc28j60_tx_flush(void)
+{
+    int timeout = TIMEOUT_CNT;
+    
+    while (enc28j60_tx_pending() > 0) {
+        if (enc28j60_tx_poll() == -1)
+            return -1;
+        
         _delay_us(20);
         timeout--;
         
@@ -937,262 +1296,179 @@ int enc28j60_send(eth_frame_t *frame)
         }
     }
     
-    if (read_reg(BANK0, ECON1, &tmp) == -1)
+    return 0;
+}
+
+int enc28j60_recv(eth_frame_t *frame)
+{
+    uint8_t *p;
+    int ret;
+    
+    if (!frame) {
+        error = ENC28J60_ERR_INVAL;
         return -1;
+    }
     
-    tmp &= ~(1 << ECON1_TXRTS);
+    ret = rx_next();
     
-    if (write_reg(BANK0, ECON1, tmp) == -1)
+    if (ret < 1)
+        return ret;
+    
+    p = (uint8_t *) malloc(rx_frm_len);
+    
+    if (!p) {
+        error = ENC28J60_ERR_NOMEM;
+        stats.rx_err++;
         return -1;
+    }
     
-    for (i = 0; i < 15; i++) {
-        if (read_buffer((BUF_TX_START + frm_len + 1), tsv, 7) == -1)
-            return -1;
-        
-        _delay_us(20);
-        
-        if (read_reg(BANK0, EIR, &tmp) == -1)
-            return -1;
-        
-        if (ISSET(tmp, EIR_TXERIF) && ISSET(tsv[TSV_BYTE3], TSV_LATECOLL)) {
-            if (read_reg(BANK0, ECON1, &tmp) == -1)
-                return -1;
-            
-        tmp |= (1 << ECON1_TXRST);
-        
-        if (write_reg(BANK0, ECON1, tmp) == -1)
-            return -1;
-        
-        if (read_reg(BANK0, ECON1, &tmp) == -1)
-            return -1;
-        
-        tmp &= ~(1 << ECON1_TXRST);
-        
-        if (write_reg(BANK0, ECON1, tmp) == -1)
-            return -1;
-        
-        if (read_reg(BANK0, EIR, &tmp) == -1)
-            return -1;
-        
-        tmp &= ~(1 << EIR_TXERIF);
-        
-        if (write_reg(BANK0, EIR, tmp) == -1)
-            return -1;
-        
-        if (read_reg(BANK0, EIR, &tmp) == -1)
-            return -1;
-        
-        tmp &= ~(1 << EIR_TXIF);
-        
-        if (write_reg(BANK0, EIR, tmp) == -1)
-            return -1;
-        
-        
-        if (read_reg(BANK0, ECON1, &tmp) == -1)
-            return -1;
-        
-        tmp |= (1 << ECON1_TXRTS);
-        
-        if (write_reg(BANK0, ECON1, tmp) == -1)
-            return -1;
-        
-        if (read_reg(BANK0, EIR, &tmp) == -1)
-            return -1;
-        
-        while (ISCLR(tmp, EIR_TXIF) && ISCLR(tmp, EIR_TXERIF)) {
-            read_reg(BANK0, EIR, &tmp);
-            _delay_us(20);
-            timeout--;
-            
-            if (timeout == 0) {
-                error = ENC28J60_ERR_TIMEO;
-                return -1;
-            }
+    if (rx_read_wrap(rx_frm_start, p, rx_frm_len) == -1) {
+        free(p);
+        return -1;
+    }
+    
+    if (ethernet_buf_to_frm(p, rx_frm_len, frame) == -1) {
+        switch (ethernet_get_last_error()) {
+        case ETHERNET_ERROR_CRC:
+            error = ENC28J60_ERR_RXCRC;
+            break;
+        case ETHERNET_ERROR_NOMEM:
+            error = ENC28J60_ERR_NOMEM;
+            break;
+        default:
+            error = ENC28J60_ERR_ETLIB;
         }
         
-        if (read_reg(BANK0, ECON1, &tmp) == -1)
-            return -1;
-        
-        tmp &= ~(1 << ECON1_TXRTS);
-        
-        if (write_reg(BANK0, ECON1, tmp) == -1)
-            return -1;
-        }
+        stats.rx_err++;
+        free(p);
+        rx_release();
+        return -1;
     }
     
-    if (ISCLR(tsv[TSV_BYTE2], TSV_DONE)) {
-        stats.tx_err++;
-        error = ENC28J60_ERR_TXERR;
+    free(p);
+    
+    if (rx_release() == -1)
         return -1;
-    }
     
-    ret = (uint16_t) tsv[TSV_BCNTL];
-    ret |= ((uint16_t) tsv[TSV_BCNTH] << 8);
-    stats.tx_frm++;
-    stats.tx_byt += ret;
-    return ret;
+    stats.rx_frm++;
+    stats.rx_byt += (rx_frm_len - 4);
+    return (rx_frm_len - 4);
 }
 
-int enc28j60_recv(eth_frame_t *frame)
+int enc28j60_rx_peek(void)
 {
-    uint16_t ptr_pkg_start;
-    uint16_t ptr_frm_start;
-    uint16_t ptr_rsv_start;
-    int frm_len_ptr;
-    int frm_len_warp;
-    int frm_len_rsv;
-    int rsv_len_warp;
-    uint8_t rsv[4];
-    uint8_t *p;
-    uint8_t tmp;
+    int ret;
     
-    if (!frame) {
+    ret = rx_next();
+    
+    if (ret < 1)
+        return ret;
+    
+    /* Without the CRC, like enc28j60_recv() */
+    return (rx_frm_len - 4);
+}
+
+int enc28j60_rx_read(int off, uint8_t *buf, int len)
+{
+    if (!buf || (off < 0) || (len < 0)) {
         error = ENC28J60_ERR_INVAL;
         return -1;
     }
     
-    if (read_reg(BANK1, EPKTCNT, &tmp) == -1)
+    if (!rx_pend || ((off + len) > rx_frm_len)) {
+        error = ENC28J60_ERR_INVAL;
         return -1;
+    }
     
-    if (tmp < 1)
-        return 0;
+    return rx_read_wrap(rx_addr(rx_frm_start, off), buf, len);
+}
+
+int enc28j60_rx_checksum(int off, int len, uint16_t *sum)
+{
+    uint16_t start;
+    uint16_t end;
+    uint8_t tmp;
+    int timeout = TIMEOUT_CNT;
     
-    frm_len_warp = -1;
-    ptr_pkg_start = ptr_pkg_next;
+    if (!sum || (off < 0) || (len < 1)) {
+        error = ENC28J60_ERR_INVAL;
+        return -1;
+    }
     
-    if (read_buffer(ptr_pkg_start, rsv, BUF_PTR_SIZE) == -1)
+    if (!rx_pend || ((off + len) > rx_frm_len)) {
+        error = ENC28J60_ERR_INVAL;
         return -1;
+    }
     
-    ptr_pkg_next = (uint16_t) rsv[BUF_PTR_LO];
-    ptr_pkg_next |= ((uint16_t)rsv[BUF_PTR_HI] << 8);
+    /* The DMA wraps at ERXND by itself, like the receive hardware */
+    start = rx_addr(rx_frm_start, off);
+    end = rx_addr(rx_frm_start, (off + len - 1));
     
-    if (ptr_pkg_start < ptr_pkg_next) {
-        ptr_rsv_start = ptr_pkg_start + 2;
-        ptr_frm_start = ptr_rsv_start + 4;
-        
-        if (read_buffer(ptr_rsv_start, rsv, 4) == -1)
-            return -1;
-        
-        frm_len_ptr = ptr_pkg_next - ptr_frm_start;
-    } else {
-        if ((ptr_pkg_start + 6) > BUF_RX_END) {
-            ptr_rsv_start = ptr_pkg_start + 2;
-            rsv_len_warp = BUF_RX_END - ptr_rsv_start + 1;
-            ptr_frm_start = (4 - rsv_len_warp) - BUF_RX_START;
-            frm_len_ptr = ptr_pkg_next - ptr_frm_start;
-            
-            if (read_buffer(ptr_rsv_start, rsv, rsv_len_warp) == -1)
-                return -1;
-            
-            if (read_buffer(BUF_RX_START, &rsv[rsv_len_warp], 
-                (4 - rsv_len_warp)) == -1)
-                return -1;
-        } else if ((ptr_pkg_start + 2) > BUF_RX_END) {
-            ptr_rsv_start = BUF_RX_START;
-            ptr_frm_start = ptr_rsv_start + 4;
-            
-            if (read_buffer(ptr_rsv_start, rsv, 4) == -1)
-                return -1;
-            
-            frm_len_ptr = ptr_pkg_next - ptr_frm_start;
-        } else {
-            ptr_rsv_start = ptr_pkg_start + 2;
-            ptr_frm_start = ptr_rsv_start + 4;
-            frm_len_warp = BUF_RX_END - ptr_frm_start + 1;
-            frm_len_ptr = frm_len_warp + ptr_pkg_next - BUF_RX_START;
-            
-            if (read_buffer(ptr_rsv_start, rsv, 4) == -1)
-                return -1;
-        }
-    }
+    if (write_reg(BANK0, EDMASTL, LO16(start)) == -1)
+        return -1;
     
-    frm_len_rsv = (uint16_t) rsv[RSV_BCNTL];
-    frm_len_rsv |= ((uint16_t) rsv[RSV_BCNTH] << 8);
+    if (write_reg(BANK0, EDMASTH, HI16(start)) == -1)
+        return -1;
     
-    if (ISCLR(rsv[RSV_BYTE2], RSV_OK)) {
-        stats.rx_err++;
-        
-        if (free_rx_memory() == -1)
-            return -1;
-        
-        error = ENC28J60_ERR_FRMIN;
+    if (write_reg(BANK0, EDMANDL, LO16(end)) == -1)
         return -1;
-    }
     
-    if (frm_len_rsv & 1) {
-        if ((frm_len_ptr - 1) != frm_len_rsv) {
-            stats.rx_err++;
-            error = ENC28J60_ERR_INTER;
-            return -1;
-        }
-    } else {
-        if (frm_len_ptr != frm_len_rsv) {
-            stats.rx_err++;
-            error = ENC28J60_ERR_INTER;
-            return -1;
-        }
-    }
+    if (write_reg(BANK0, EDMANDH, HI16(end)) == -1)
+        return -1;
     
-    if (frm_len_rsv > ETHERNET_MAX_FRAME_SIZE) {
-        stats.tx_err++;
-        
-        if (free_rx_memory() == -1)
-            return -1;
-        
-        error = ENC28J60_ERR_FRMTB;
+    if (read_reg(BANK0, ECON1, &tmp) == -1)
         return -1;
-    }
     
-    p = (uint8_t *) malloc(frm_len_rsv);
+    tmp |= ((1 << ECON1_CSUMEN) | (1 << ECON1_DMAST));
     
-    if (!p) {
-        error = ENC28J60_ERR_NOMEM;
-        stats.rx_err++;
+    if (write_reg(BANK0, ECON1, tmp) == -1)
         return -1;
-    }
     
-    if (frm_len_warp != -1) {
-        if (read_buffer(ptr_frm_start, p, frm_len_warp) == -1) {
-            free(p);
-            return -1;
-        }
+    /* About 1 byte per 80 ns, a full frame takes ~120 us */
+    do {
+        _delay_us(5);
         
-        if (read_buffer(BUF_RX_START, &p[frm_len_warp], frm_len_rsv - frm_len_warp) == -1) {
-            free(p);
+        if (read_reg(BANK0, ECON1, &tmp) == -1)
             return -1;
-        }
-    } else {
-        if (read_buffer(ptr_frm_start, p, frm_len_rsv) == -1) {
-            free(p);
+        
+        timeout--;
+        
+        if (timeout == 0) {
+            error = ENC28J60_ERR_TIMEO;
             return -1;
         }
-    }
+    } while (ISSET(tmp, ECON1_DMAST));
     
-    if (ethernet_buf_to_frm(p, frm_len_rsv, frame) == -1) {
-        switch (ethernet_get_last_error()) {
-        case ETHERNET_ERROR_CRC:
-            error = ENC28J60_ERR_RXCRC;
-            break;
-        case ETHERNET_ERROR_NOMEM:
-            error = ENC28J60_ERR_NOMEM;
-            break;
-        default:
-            error = ENC28J60_ERR_ETLIB;
-        }
-        
-        stats.rx_err++;
-        free(p);
+    tmp &= ~(1 << ECON1_CSUMEN);
+    
+    if (write_reg(BANK0, ECON1, tmp) == -1)
         return -1;
-    }
     
-    free(p);
+    if (read_reg(BANK0, EDMACSL, &tmp) == -1)
+        return -1;
     
-    if (free_rx_memory() == -1)
+    (*sum) = tmp;
+    
+    if (read_reg(BANK0, EDMACSH, &tmp) == -1)
         return -1;
     
-    stats.rx_frm++;
-    stats.rx_byt += (frm_len_rsv - 4);
-    return (frm_len_rsv - 4);
+    (*sum) |= ((uint16_t) tmp << 8);
+    return 0;
+}
+
+int enc28j60_rx_drop(void)
+{
+    int ret;
+    
+    ret = rx_next();
+    
+    if (ret < 1)
+        return ret;
+    
+    if (rx_release() == -1)
+        return -1;
+    
+    return 1;
 }
 
 int enc28j60_set_mac(mac_addr_t *addr)
@@ -1263,6 +1539,130 @@ int enc28j60_get_mac(mac_addr_t *addr)
     return 0;
 }
 
+int enc28j60_filter_set(uint8_t flags)
+{
+    uint8_t econ1;
+    
+    if (rx_pause(&econ1) == -1)
+        return -1;
+    
+    if (write_reg(BANK1, ERXFCON, flags) == -1)
+        return -1;
+    
+    if (write_reg(BANK0, ECON1, econ1) == -1)
+        return -1;
+    
+    return 0;
+}
+
+int enc28j60_filter_get(uint8_t *flags)
+{
+    if (!flags) {
+        error = ENC28J60_ERR_INVAL;
+        return -1;
+    }
+    
+    return read_reg(BANK1, ERXFCON, flags);
+}
+
+int enc28j60_filter_hash(mac_addr_t *list, int num)
+{
+    uint8_t eht[8];
+    uint8_t ptr;
+    uint8_t econ1;
+    int i;
+    
+    if (!list && (num > 0)) {
+        error = ENC28J60_ERR_INVAL;
+        return -1;
+    }
+    
+    memset(eht, 0, sizeof(eht));
+    
+    for (i = 0; i < num; i++) {
+        ptr = hash_ptr(&list[i]);
+        eht[ptr >> 3] |= (1 << (ptr & 0x07));
+    }
+    
+    if (rx_pause(&econ1) == -1)
+        return -1;
+    
+    for (i = 0; i < 8; i++) {
+        if (write_reg(BANK1, (EHT0 + i), eht[i]) == -1)
+            return -1;
+    }
+    
+    if (write_reg(BANK0, ECON1, econ1) == -1)
+        return -1;
+    
+    return 0;
+}
+
+int enc28j60_filter_pattern(uint16_t offset, uint8_t *pattern, uint8_t *mask)
+{
+    uint32_t sum = 0;
+    uint16_t word = 0;
+    uint8_t econ1;
+    int odd = 0;
+    int i;
+    
+    if (!pattern || !mask) {
+        error = ENC28J60_ERR_INVAL;
+        return -1;
+    }
+    
+    if (offset > (ETHERNET_MAX_FRAME_SIZE - 64)) {
+        error = ENC28J60_ERR_INVAL;
+        return -1;
+    }
+    
+    /* Checksum over the selected bytes only, packed like a byte stream */
+    for (i = 0; i < 64; i++) {
+        if (!(mask[i >> 3] & (1 << (i & 0x07))))
+            continue;
+        
+        if (odd) {
+            sum += word | pattern[i];
+            odd = 0;
+        } else {
+            word = ((uint16_t) pattern[i] << 8);
+            odd = 1;
+        }
+    }
+    
+    if (odd)
+        sum += word;
+    
+    sum = (sum & 0xFFFF) + (sum >> 16);
+    sum = (sum & 0xFFFF) + (sum >> 16);
+    sum = ~sum;
+    
+    if (rx_pause(&econ1) == -1)
+        return -1;
+    
+    for (i = 0; i < 8; i++) {
+        if (write_reg(BANK1, (EPMM0 + i), mask[i]) == -1)
+            return -1;
+    }
+    
+    if (write_reg(BANK1, EPMCSL, LO16(sum)) == -1)
+        return -1;
+    
+    if (write_reg(BANK1, EPMCSH, HI16(sum)) == -1)
+        return -1;
+    
+    if (write_reg(BANK1, EPMOL, LO16(offset)) == -1)
+        return -1;
+    
+    if (write_reg(BANK1, EPMOH, HI16(offset)) == -1)
+        return -1;
+    
+    if (write_reg(BANK0, ECON1, econ1) == -1)
+        return -1;
+    
+    return 0;
+}
+
 int enc28j60_is_link_up(void)
 {
     uint16_t l = 0;
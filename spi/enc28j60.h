@@ -5,9 +5,9 @@
  * Project  : lib-avr
  * Author   : Copyright (C) 2018-2019 Johannes Krottmayer <krjdev@gmail.com>
  * Created  : 2018-09-22
- * Modified : 2019-06-08
+ * Modified : 2026-10-19
  * Revised  : 
- * Version  : 0.5.0.1
+ * Version  : 0.8.0.0
  * License  : ISC (see file LICENSE.txt)
  * Target   : Atmel AVR Series
  *
@@ -40,6 +40,17 @@
 #define ENC28J60_MODE_FDPX      0
 #define ENC28J60_MODE_HDPX      1
 
+/* ENC28J60 receive filters (ERXFCON), frames must pass to be received */
+#define ENC28J60_FILTER_BCAST   (1 << 0) /* Broadcast */
+#define ENC28J60_FILTER_MCAST   (1 << 1) /* Any multicast */
+#define ENC28J60_FILTER_HASH    (1 << 2) /* Hash table, see filter_hash() */
+#define ENC28J60_FILTER_MAGIC   (1 << 3) /* Magic Packet for our MAC */
+#define ENC28J60_FILTER_PATTERN (1 << 4) /* Pattern match, see filter_pattern() */
+#define ENC28J60_FILTER_CRC     (1 << 5) /* Drop frames with bad CRC */
+#define ENC28J60_FILTER_AND     (1 << 6) /* All enabled filters must match */
+#define ENC28J60_FILTER_UCAST   (1 << 7) /* Unicast to our MAC */
+#define ENC28J60_FILTER_DEFAULT (ENC28J60_FILTER_UCAST | ENC28J60_FILTER_MCAST | ENC28J60_FILTER_BCAST)
+
 /* ENC28J60 Error codes */
 #define ENC28J60_ERR_NOERR      0
 #define ENC28J60_ERR_NOMEM      1
@@ -86,6 +97,17 @@ extern int enc28j60_set_mac(mac_addr_t *addr);
 extern int enc28j60_get_mac(mac_addr_t *addr);
 extern int enc28j60_send(eth_frame_t *frame);
 extern int enc28j60_recv(eth_frame_t *frame);
+extern int enc28j60_rx_peek(void);
+extern int enc28j60_rx_read(int off, uint8_t *buf, int len);
+extern int enc28j60_rx_checksum(int off, int len, uint16_t *sum);
+extern int enc28j60_rx_drop(void);
+extern int enc28j60_tx_poll(void);
+extern int enc28j60_tx_pending(void);
+extern int enc28j60_tx_flush(void);
+extern int enc28j60_filter_set(uint8_t flags);
+extern int enc28j60_filter_get(uint8_t *flags);
+extern int enc28j60_filter_hash(mac_addr_t *list, int num);
+extern int enc28j60_filter_pattern(uint16_t offset, uint8_t *pattern, uint8_t *mask);
 extern int enc28j60_is_link_up(void);
 extern int enc28j60_get_free_rx_space(void);
 extern int enc28j60_get_last_error(void);
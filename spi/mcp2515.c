@@ -0,0 +1,861 @@
+/**
+ *
+ * File Name: mcp2515.c
+ * Title    : SPI device Microchip MCP2515 CAN controller driver
+ * Project  : lib-avr
+ * Author   : Copyright (C) 2026 Johannes Krottmayer <krjdev@gmail.com>
+ * Created  : 2026-10-19
+ * Modified : 
+ * Revised  : 
+ * Version  : 0.1.0.0
+ * License  : ISC (see file LICENSE.txt)
+ * Target   : Atmel AVR Series
+ *
+ * NOTE: This code is currently below version 1.0, and therefore is considered
+ * to be lacking in some functionality or documentation, or may not be fully
+ * tested. Nonetheless, you can expect most functions to work.
+ *
+ */
+
+#include <string.h>
+#include <avr/interrupt.h>
+#include <util/delay.h>
+
+#include "mcp2515.h"
+#include "spi.h"
+
+#define DRIVER_NAME         "MCP2515"
+#define DRIVER_VERSION      "0.1.0.0"
+
+#define ISSET(reg, bit)     ((reg) & (1 << (bit)))
+
+#define TIMEOUT_CNT         500
+
+/* SPI Instruction Set */
+#define SPI_RESET           0xC0 /* Reset */
+#define SPI_READ            0x03 /* Read Register */
+#define SPI_READ_RX         0x90 /* Read RX Buffer (n,m bits) */
+#define SPI_WRITE           0x02 /* Write Register */
+#define SPI_LOAD_TX         0x40 /* Load TX Buffer (a,b,c bits) */
+#define SPI_RTS             0x80 /* Request-To-Send (TXBn bits) */
+#define SPI_BIT_MODIFY      0x05 /* Bit Modify */
+
+/* Filter and mask registers (SIDH, SIDL, EID8, EID0) */
+#define RXF0SIDH    0x00
+#define RXF1SIDH    0x04
+#define RXF2SIDH    0x08
+#define RXF3SIDH    0x10
+#define RXF4SIDH    0x14
+#define RXF5SIDH    0x18
+#define RXM0SIDH    0x20
+#define RXM1SIDH    0x24
+
+#define TEC         0x1C /* Transmit Error Counter */
+#define REC         0x1D /* Receive Error Counter */
+#define CANSTAT     0x0E /* CAN Status Register */
+#define CANCTRL     0x0F /* CAN Control Register */
+
+    /* CANCTRL/CANSTAT operation mode (REQOP/OPMOD) */
+    #define OPMOD_SHIFT     5
+    #define OPMOD_MASK      0xE0
+    #define OPMOD_CONFIG    4
+
+#define CNF3        0x28 /* Configuration Register 3 */
+#define CNF2        0x29 /* Configuration Register 2 */
+
+    /* CNF2 flags */
+    #define CNF2_BTLMODE    7 /* PS2 Bit Time Length bit */
+
+#define CNF1        0x2A /* Configuration Register 1 */
+#define CANINTE     0x2B /* CAN Interrupt Enable Register */
+#define CANINTF     0x2C /* CAN Interrupt Flag Register */
+
+    /* CANINTE/CANINTF flags */
+    #define INT_RX0I        0 /* Receive Buffer 0 Full */
+    #define INT_RX1I        1 /* Receive Buffer 1 Full */
+    #define INT_TX0I        2 /* Transmit Buffer 0 Empty */
+    #define INT_TX1I        3 /* Transmit Buffer 1 Empty */
+    #define INT_TX2I        4 /* Transmit Buffer 2 Empty */
+    #define INT_ERRI        5 /* Error */
+    #define INT_WAKI        6 /* Wake-up */
+    #define INT_MERR        7 /* Message Error */
+
+#define EFLG        0x2D /* Error Flag Register */
+
+    /* EFLG flags */
+    #define EFLG_TXBO       5 /* Bus-Off Error Flag bit */
+    #define EFLG_RX0OVR     6 /* Receive Buffer 0 Overflow Flag bit */
+    #define EFLG_RX1OVR     7 /* Receive Buffer 1 Overflow Flag bit */
+
+#define TXB0CTRL    0x30 /* Transmit Buffer 0 Control Register */
+#define RXB0CTRL    0x60 /* Receive Buffer 0 Control Register */
+
+    /* RXB0CTRL flags */
+    #define RXB0CTRL_BUKT   2 /* Rollover Enable bit */
+
+#define RXB1CTRL    0x70 /* Receive Buffer 1 Control Register */
+
+/* Buffer layout, as read by READ RX and written by LOAD TX */
+#define BUF_SIDH    0
+#define BUF_SIDL    1
+
+    /* SIDL flags */
+    #define SIDL_EXIDE      3 /* Extended Identifier Enable bit */
+    #define SIDL_SRR        4 /* Standard Frame Remote Transmit Request bit */
+
+#define BUF_EID8    2
+#define BUF_EID0    3
+#define BUF_DLC     4
+
+    /* DLC flags */
+    #define DLC_RTR         6 /* Remote Transmission Request bit */
+
+#define BUF_DATA    5
+#define BUF_LEN     13
+
+#define ID_EID_MASK         0x0003FFFFUL
+#define HW_FILTER_NUM       6
+
+static int error = MCP2515_ERR_NOERR;
+static can_stats_t stats;
+static uint32_t bus_rate;
+static uint32_t bus_bits;
+static uint8_t op_mode;
+
+/* Rules as given, the hardware filters may be wider (merged) */
+static can_filter_t rules[CAN_IF_FILTER_MAX];
+static int rules_num;
+
+static can_frame_t rxq[MCP2515_RXQ_LEN];
+static volatile uint8_t rxq_head;
+static volatile uint8_t rxq_tail;
+static volatile uint8_t rxq_cnt;
+
+/* Sorted by arbitration key, head is sent next */
+static can_frame_t txq[MCP2515_TXQ_LEN];
+static uint32_t txq_key[MCP2515_TXQ_LEN];
+static volatile uint8_t txq_cnt;
+static volatile uint8_t tx_busy;
+
+/* Set by the INT4 handler, the SPI bus is serviced in mcp2515_poll() */
+static volatile uint8_t int_pending;
+static uint8_t busoff;
+
+static void read_regs(uint8_t addr, uint8_t *buf, int len)
+{
+    uint8_t cmd[2];
+    
+    cmd[0] = SPI_READ;
+    cmd[1] = addr;
+    MCP2515_CS_ENABLE;
+    spi_master_send(cmd, 2);
+    spi_master_recv(buf, len);
+    MCP2515_CS_DISABL;
+}
+
+static void write_regs(uint8_t addr, uint8_t *buf, int len)
+{
+    uint8_t cmd[2];
+    
+    cmd[0] = SPI_WRITE;
+    cmd[1] = addr;
+    MCP2515_CS_ENABLE;
+    spi_master_send(cmd, 2);
+    spi_master_send(buf, len);
+    MCP2515_CS_DISABL;
+}
+
+static uint8_t read_reg(uint8_t addr)
+{
+    uint8_t val;
+    
+    read_regs(addr, &val, 1);
+    return val;
+}
+
+static void write_reg(uint8_t addr, uint8_t val)
+{
+    write_regs(addr, &val, 1);
+}
+
+static void bit_modify(uint8_t addr, uint8_t mask, uint8_t val)
+{
+    uint8_t cmd[4];
+    
+    cmd[0] = SPI_BIT_MODIFY;
+    cmd[1] = addr;
+    cmd[2] = mask;
+    cmd[3] = val;
+    MCP2515_CS_ENABLE;
+    spi_master_send(cmd, 4);
+    MCP2515_CS_DISABL;
+}
+
+static int set_mode(uint8_t mode)
+{
+    int timeout = TIMEOUT_CNT;
+    
+    bit_modify(CANCTRL, OPMOD_MASK, (mode << OPMOD_SHIFT));
+    
+    while (((read_reg(CANSTAT) & OPMOD_MASK) >> OPMOD_SHIFT) != mode) {
+        _delay_us(20);
+        timeout--;
+        
+        if (timeout == 0) {
+            error = MCP2515_ERR_TIMEO;
+            return -1;
+        }
+    }
+    
+    return 0;
+}
+
+/* Identifier in the 29 bit layout, standard frames use bits 28:18 */
+static uint32_t frame_id(can_frame_t *frame, uint8_t *ext)
+{
+    switch (frame->f_type) {
+    case CAN_TYPE_DATA_EXT:
+        (*ext) = 1;
+        return (((uint32_t) frame->f_d_ext.sid << 18) |
+                (frame->f_d_ext.eid & ID_EID_MASK));
+    case CAN_TYPE_REMOTE_EXT:
+        (*ext) = 1;
+        return (((uint32_t) frame->f_r_ext.sid << 18) |
+                (frame->f_r_ext.eid & ID_EID_MASK));
+    case CAN_TYPE_REMOTE_STD:
+        (*ext) = 0;
+        return ((uint32_t) frame->f_r_std.sid << 18);
+    default:
+        (*ext) = 0;
+        return ((uint32_t) frame->f_d_std.sid << 18);
+    }
+}
+
+/* Lower key wins arbitration: ID, then IDE, then RTR */
+static uint32_t frame_key(can_frame_t *frame)
+{
+    uint32_t id;
+    uint8_t ext;
+    uint8_t rtr;
+    
+    id = frame_id(frame, &ext);
+    rtr = ((frame->f_type == CAN_TYPE_REMOTE_STD) || 
+           (frame->f_type == CAN_TYPE_REMOTE_EXT));
+    
+    return ((((id >> 18) << 19) |
+             ((uint32_t) ext << 18) |
+             (id & ID_EID_MASK)) << 1) | rtr;
+}
+
+static void id_to_regs(uint32_t id, uint8_t ext, uint8_t *r)
+{
+    uint16_t sid;
+    
+    sid = (uint16_t) (id >> 18);
+    r[BUF_SIDH] = (uint8_t) (sid >> 3);
+    r[BUF_SIDL] = (uint8_t) ((sid & 0x07) << 5);
+    r[BUF_EID8] = 0;
+    r[BUF_EID0] = 0;
+    
+    if (ext) {
+        r[BUF_SIDL] |= (1 << SIDL_EXIDE);
+        r[BUF_SIDL] |= (uint8_t) ((id >> 16) & 0x03);
+        r[BUF_EID8] = (uint8_t) (id >> 8);
+        r[BUF_EID0] = (uint8_t) id;
+    }
+}
+
+static int rule_match(can_frame_t *frame)
+{
+    uint32_t id;
+    uint8_t ext;
+    int i;
+    
+    if (rules_num == 0)
+        return 1;
+    
+    id = frame_id(frame, &ext);
+    
+    if (!ext)
+        id >>= 18;
+    
+    for (i = 0; i < rules_num; i++) {
+        if ((rules[i].cf_ext == ext) && 
+            (((id ^ rules[i].cf_id) & rules[i].cf_mask) == 0))
+            return 1;
+    }
+    
+    return 0;
+}
+
+static int bits_set(uint32_t val)
+{
+    int cnt = 0;
+    
+    while (val) {
+        val &= (val - 1);
+        cnt++;
+    }
+    
+    return cnt;
+}
+
+/* Common mask of a group, standard members must not mask data bytes */
+static uint32_t group_mask(can_filter_t *f, int num, uint8_t sel, uint8_t want)
+{
+    uint32_t mask = 0xFFFFFFFF;
+    int std = 0;
+    int i;
+    
+    for (i = 0; i < num; i++) {
+        if (((sel >> i) & 1) != want)
+            continue;
+        
+        mask &= f[i].cf_mask;
+        
+        if (!f[i].cf_ext)
+            std = 1;
+    }
+    
+    if (std)
+        mask &= ~ID_EID_MASK;
+    
+    return mask;
+}
+
+static void write_filter(uint8_t addr, can_filter_t *f)
+{
+    uint8_t r[4];
+    
+    id_to_regs(f->cf_id, f->cf_ext, r);
+    write_regs(addr, r, 4);
+}
+
+static void write_mask(uint8_t addr, uint32_t mask)
+{
+    uint8_t r[4];
+    
+    id_to_regs(mask, 1, r);
+    r[BUF_SIDL] &= ~(1 << SIDL_EXIDE);
+    write_regs(addr, r, 4);
+}
+
+static void rx_buffer(uint8_t n)
+{
+    can_frame_t f;
+    uint8_t r[BUF_LEN];
+    uint8_t cmd;
+    uint16_t sid;
+    uint32_t eid;
+    uint8_t dlc;
+    
+    /* READ RX clears RXnIF when CS is released */
+    cmd = SPI_READ_RX | (n ? 0x04 : 0x00);
+    MCP2515_CS_ENABLE;
+    spi_master_send(&cmd, 1);
+    spi_master_recv(r, BUF_LEN);
+    MCP2515_CS_DISABL;
+    sid = ((uint16_t) r[BUF_SIDH] << 3) | (r[BUF_SIDL] >> 5);
+    eid = ((uint32_t) (r[BUF_SIDL] & 0x03) << 16) |
+          ((uint16_t) r[BUF_EID8] << 8) | r[BUF_EID0];
+    dlc = r[BUF_DLC] & 0x0F;
+    
+    if (dlc > CAN_DATA_LENMAX)
+        dlc = CAN_DATA_LENMAX;
+    
+    if (ISSET(r[BUF_SIDL], SIDL_EXIDE)) {
+        if (ISSET(r[BUF_DLC], DLC_RTR)) {
+            f.f_type = CAN_TYPE_REMOTE_EXT;
+            f.f_r_ext.sid = sid;
+            f.f_r_ext.eid = eid;
+        } else {
+            f.f_type = CAN_TYPE_DATA_EXT;
+            f.f_d_ext.sid = sid;
+            f.f_d_ext.eid = eid;
+            f.f_d_ext.dlen = dlc;
+            memcpy(f.f_d_ext.data, &r[BUF_DATA], dlc);
+        }
+    } else {
+        if (ISSET(r[BUF_SIDL], SIDL_SRR)) {
+            f.f_type = CAN_TYPE_REMOTE_STD;
+            f.f_r_std.sid = sid;
+        } else {
+            f.f_type = CAN_TYPE_DATA_STD;
+            f.f_d_std.sid = sid;
+            f.f_d_std.dlen = dlc;
+            memcpy(f.f_d_std.data, &r[BUF_DATA], dlc);
+        }
+    }
+    
+    bus_bits += can_frame_get_bits(&f);
+    
+    if (!rule_match(&f)) {
+        stats.rx_filt++;
+        return;
+    }
+    
+    if (rxq_cnt == MCP2515_RXQ_LEN) {
+        stats.rx_drop++;
+        return;
+    }
+    
+    rxq[rxq_tail] = f;
+    rxq_tail = (rxq_tail + 1) % MCP2515_RXQ_LEN;
+    rxq_cnt++;
+    stats.rx_frm++;
+}
+
+/* Thread context only (shared SPI bus), only TXB0 is used to keep ID order */
+static void tx_load(void)
+{
+    can_frame_t *f;
+    uint8_t r[BUF_LEN];
+    uint8_t cmd;
+    uint8_t ext;
+    uint8_t dlen = 0;
+    
+    if (tx_busy || (txq_cnt == 0))
+        return;
+    
+    f = &txq[0];
+    id_to_regs(frame_id(f, &ext), ext, r);
+    
+    switch (f->f_type) {
+    case CAN_TYPE_DATA_STD:
+        dlen = f->f_d_std.dlen;
+        memcpy(&r[BUF_DATA], f->f_d_std.data, dlen);
+        r[BUF_DLC] = dlen;
+        break;
+    case CAN_TYPE_DATA_EXT:
+        dlen = f->f_d_ext.dlen;
+        memcpy(&r[BUF_DATA], f->f_d_ext.data, dlen);
+        r[BUF_DLC] = dlen;
+        break;
+    default:
+        r[BUF_DLC] = (1 << DLC_RTR);
+    }
+    
+    cmd = SPI_LOAD_TX;
+    MCP2515_CS_ENABLE;
+    spi_master_send(&cmd, 1);
+    spi_master_send(r, (BUF_DATA + dlen));
+    MCP2515_CS_DISABL;
+    cmd = SPI_RTS | 0x01;
+    MCP2515_CS_ENABLE;
+    spi_master_send(&cmd, 1);
+    MCP2515_CS_DISABL;
+    bus_bits += can_frame_get_bits(f);
+    tx_busy = 1;
+    txq_cnt--;
+    memmove(&txq[0], &txq[1], (txq_cnt * sizeof(can_frame_t)));
+    memmove(&txq_key[0], &txq_key[1], (txq_cnt * sizeof(uint32_t)));
+}
+
+static void err_update(void)
+{
+    uint8_t eflg;
+    
+    eflg = read_reg(EFLG);
+    stats.tec = read_reg(TEC);
+    stats.rec = read_reg(REC);
+    
+    if (ISSET(eflg, EFLG_RX0OVR) || ISSET(eflg, EFLG_RX1OVR)) {
+        stats.rx_drop++;
+        bit_modify(EFLG, ((1 << EFLG_RX0OVR) | (1 << EFLG_RX1OVR)), 0x00);
+    }
+    
+    /* ERRI is raised on every EFLG change, so recovery clears it again */
+    busoff = ISSET(eflg, EFLG_TXBO) ? 1 : 0;
+}
+
+ISR(MCP2515_INT_vect)
+{
+    mcp2515_isr();
+}
+
+int mcp2515_init(uint32_t bitrate, int mode)
+{
+    uint32_t brp;
+    uint8_t ntq;
+    uint8_t prseg;
+    uint8_t ps1;
+    uint8_t ps2;
+    uint8_t cmd;
+    
+    error = MCP2515_ERR_NOERR;
+    
+    if ((mode != MCP2515_MODE_NORMAL) && 
+        (mode != MCP2515_MODE_LOOPBACK) && 
+        (mode != MCP2515_MODE_LISTEN)) {
+        error = MCP2515_ERR_INVAL;
+        return -1;
+    }
+    
+    if (bitrate == 0) {
+        error = MCP2515_ERR_BITRATE;
+        return -1;
+    }
+    
+    /* 16 TQ (sample point 75%), 8 TQ if the oscillator is too slow */
+    ntq = 16;
+    prseg = 5;
+    ps1 = 6;
+    ps2 = 4;
+    
+    if ((MCP2515_F_OSC % (2UL * ntq * bitrate)) != 0) {
+        ntq = 8;
+        prseg = 2;
+        ps1 = 3;
+        ps2 = 2;
+    }
+    
+    if ((MCP2515_F_OSC % (2UL * ntq * bitrate)) != 0) {
+        error = MCP2515_ERR_BITRATE;
+        return -1;
+    }
+    
+    brp = (MCP2515_F_OSC / (2UL * ntq * bitrate)) - 1;
+    
+    if (brp > 63) {
+        error = MCP2515_ERR_BITRATE;
+        return -1;
+    }
+    
+    memset(&stats, 0, sizeof(can_stats_t));
+    bus_rate = bitrate;
+    bus_bits = 0;
+    rules_num = 0;
+    rxq_head = 0;
+    rxq_tail = 0;
+    rxq_cnt = 0;
+    txq_cnt = 0;
+    tx_busy = 0;
+    op_mode = mode;
+    
+    MCP2515_INT_DISABL;
+    MCP2515_CS_CONFIG;
+    MCP2515_CS_DISABL;
+    spi_master_init(SPI_MODE_0, SPI_FOSC_2, SPI_ORDER_MSB);
+    
+    /* Soft reset, controller enters configuration mode */
+    cmd = SPI_RESET;
+    MCP2515_CS_ENABLE;
+    spi_master_send(&cmd, 1);
+    MCP2515_CS_DISABL;
+    _delay_ms(2);
+    
+    if (set_mode(OPMOD_CONFIG) == -1)
+        return -1;
+    
+    write_reg(CNF1, (uint8_t) brp);
+    write_reg(CNF2, ((1 << CNF2_BTLMODE) | ((ps1 - 1) << 3) | (prseg - 1)));
+    write_reg(CNF3, (ps2 - 1));
+    
+    /* Filters on, masks cleared (accept all), RXB0 rolls over into RXB1 */
+    write_reg(RXB0CTRL, (1 << RXB0CTRL_BUKT));
+    write_reg(RXB1CTRL, 0x00);
+    write_mask(RXM0SIDH, 0);
+    write_mask(RXM1SIDH, 0);
+    write_reg(CANINTF, 0x00);
+    write_reg(CANINTE, ((1 << INT_RX0I) |
+                        (1 << INT_RX1I) |
+                        (1 << INT_TX0I) |
+                        (1 << INT_ERRI) |
+                        (1 << INT_MERR)));
+    
+    if (set_mode(op_mode) == -1)
+        return -1;
+    
+    MCP2515_INT_CONFIG;
+    MCP2515_INT_ENABLE;
+    return 0;
+}
+
+int mcp2515_set_filters(can_filter_t *r, int num)
+{
+    can_filter_t f[CAN_IF_FILTER_MAX];
+    can_filter_t tmp;
+    uint32_t m0;
+    uint32_t m1;
+    uint32_t m;
+    uint8_t sel;
+    uint8_t best_sel = 0;
+    int best_score = -1;
+    int best_a = 0;
+    int best_b = 0;
+    int score;
+    int cnt;
+    int n;
+    int i;
+    int j;
+    int k;
+    
+    if ((num < 0) || (num > CAN_IF_FILTER_MAX) || (!r && (num > 0))) {
+        error = MCP2515_ERR_INVAL;
+        return -1;
+    }
+    
+    /* Work in the 29 bit layout, standard identifiers in bits 28:18 */
+    for (i = 0; i < num; i++) {
+        f[i] = r[i];
+        
+        if (!f[i].cf_ext) {
+            f[i].cf_id = (f[i].cf_id & 0x7FF) << 18;
+            f[i].cf_mask = (f[i].cf_mask & 0x7FF) << 18;
+        }
+        
+        f[i].cf_id &= f[i].cf_mask;
+    }
+    
+    n = num;
+    
+    /* Six hardware filters, merge the pair that loses the fewest mask bits */
+    while (n > HW_FILTER_NUM) {
+        best_score = -1;
+        
+        for (i = 0; i < n; i++) {
+            for (j = i + 1; j < n; j++) {
+                if (f[i].cf_ext != f[j].cf_ext)
+                    continue;
+                
+                m = f[i].cf_mask & f[j].cf_mask & ~(f[i].cf_id ^ f[j].cf_id);
+                score = bits_set(m);
+                
+                if (score > best_score) {
+                    best_score = score;
+                    best_a = i;
+                    best_b = j;
+                }
+            }
+        }
+        
+        f[best_a].cf_mask &= f[best_b].cf_mask & ~(f[best_a].cf_id ^ f[best_b].cf_id);
+        f[best_a].cf_id &= f[best_a].cf_mask;
+        f[best_b] = f[n - 1];
+        n--;
+    }
+    
+    /* RXB0 has two filters, RXB1 four, pick the tightest split */
+    best_score = -1;
+    
+    for (sel = 0; sel < (1 << n); sel++) {
+        cnt = bits_set(sel);
+        
+        if ((cnt > 2) || ((n - cnt) > 4))
+            continue;
+        
+        m0 = group_mask(f, n, sel, 1);
+        m1 = group_mask(f, n, sel, 0);
+        score = (cnt * bits_set(m0)) + ((n - cnt) * bits_set(m1));
+        
+        if (score > best_score) {
+            best_score = score;
+            best_sel = sel;
+        }
+    }
+    
+    /* Members of RXB0 first */
+    for (i = 0, k = 0; i < n; i++) {
+        if ((best_sel >> i) & 1) {
+            tmp = f[k];
+            f[k] = f[i];
+            f[i] = tmp;
+            k++;
+        }
+    }
+    
+    /* Thread context only, RX is serviced by mcp2515_poll() and not the ISR */
+    if (set_mode(OPMOD_CONFIG) == -1)
+        return -1;
+    
+    if (n == 0) {
+        write_mask(RXM0SIDH, 0);
+        write_mask(RXM1SIDH, 0);
+    } else {
+        m0 = group_mask(f, k, 0x00, 0);
+        m1 = group_mask(&f[k], (n - k), 0x00, 0);
+        
+        /* An empty group repeats the other one, filters of 0 accept ID 0 */
+        if (k == 0)
+            m0 = m1;
+        
+        if (k == n)
+            m1 = m0;
+        
+        write_mask(RXM0SIDH, m0);
+        write_mask(RXM1SIDH, m1);
+        write_filter(RXF0SIDH, &f[0]);
+        write_filter(RXF1SIDH, ((k > 1) ? &f[1] : &f[0]));
+        write_filter(RXF2SIDH, ((k < n) ? &f[k] : &f[0]));
+        write_filter(RXF3SIDH, (((k + 1) < n) ? &f[k + 1] : &f[(k < n) ? k : 0]));
+        write_filter(RXF4SIDH, (((k + 2) < n) ? &f[k + 2] : &f[(k < n) ? k : 0]));
+        write_filter(RXF5SIDH, (((k + 3) < n) ? &f[k + 3] : &f[(k < n) ? k : 0]));
+    }
+    
+    if (set_mode(op_mode) == -1)
+        return -1;
+    
+    /* Software stage removes what the merged hardware filters let through */
+    memcpy(rules, r, (num * sizeof(can_filter_t)));
+    rules_num = num;
+    return 0;
+}
+
+int mcp2515_send(can_frame_t *frame)
+{
+    uint32_t key;
+    uint8_t sreg;
+    int i;
+    
+    if (!frame) {
+        error = MCP2515_ERR_INVAL;
+        return -1;
+    }
+    
+    if ((frame->f_type < CAN_TYPE_DATA_STD) || (frame->f_type > CAN_TYPE_REMOTE_EXT)) {
+        error = MCP2515_ERR_INVAL;
+        return -1;
+    }
+    
+    key = frame_key(frame);
+    sreg = SREG;
+    cli();
+    
+    if (txq_cnt == MCP2515_TXQ_LEN) {
+        SREG = sreg;
+        stats.tx_err++;
+        error = MCP2515_ERR_TXFULL;
+        return -1;
+    }
+    
+    /* Insert behind equal keys, same ID frames keep their order */
+    i = txq_cnt;
+    
+    while ((i > 0) && (txq_key[i - 1] > key)) {
+        txq[i] = txq[i - 1];
+        txq_key[i] = txq_key[i - 1];
+        i--;
+    }
+    
+    txq[i] = (*frame);
+    txq_key[i] = key;
+    txq_cnt++;
+    SREG = sreg;
+    tx_load();
+    return 0;
+}
+
+int mcp2515_recv(can_frame_t *frame)
+{
+    uint8_t sreg;
+    
+    if (!frame) {
+        error = MCP2515_ERR_INVAL;
+        return -1;
+    }
+    
+    sreg = SREG;
+    cli();
+    
+    if (rxq_cnt == 0) {
+        SREG = sreg;
+        return 0;
+    }
+    
+    (*frame) = rxq[rxq_head];
+    rxq_head = (rxq_head + 1) % MCP2515_RXQ_LEN;
+    rxq_cnt--;
+    SREG = sreg;
+    return 1;
+}
+
+/* Only latches the interrupt, SPI is shared with ENC28J60 and SD */
+void mcp2515_isr(void)
+{
+    int_pending = 1;
+}
+
+void mcp2515_poll(void)
+{
+    uint8_t flags;
+    
+    /* A missed edge (e.g. before INT4 was enabled) leaves INT held low */
+    if (!int_pending && !MCP2515_INT_LOW)
+        return;
+    
+    /* Cleared first, an edge during the service loop is not lost */
+    int_pending = 0;
+    
+    /* INT stays low while flags are pending, handle all of them */
+    flags = read_reg(CANINTF);
+    
+    while (flags & ((1 << INT_RX0I) |
+                    (1 << INT_RX1I) |
+                    (1 << INT_TX0I) |
+                    (1 << INT_ERRI) |
+                    (1 << INT_MERR))) {
+        if (ISSET(flags, INT_RX0I))
+            rx_buffer(0);
+        
+        if (ISSET(flags, INT_RX1I))
+            rx_buffer(1);
+        
+        if (ISSET(flags, INT_ERRI) || ISSET(flags, INT_MERR)) {
+            if (ISSET(flags, INT_MERR))
+                stats.tx_err++;
+            
+            err_update();
+            bit_modify(CANINTF, ((1 << INT_ERRI) | (1 << INT_MERR)), 0x00);
+        }
+        
+        if (ISSET(flags, INT_TX0I)) {
+            bit_modify(CANINTF, (1 << INT_TX0I), 0x00);
+            stats.tx_frm++;
+            tx_busy = 0;
+            tx_load();
+        }
+        
+        flags = read_reg(CANINTF);
+    }
+}
+
+void mcp2515_tick(void)
+{
+    uint32_t bits;
+    
+    bits = bus_bits;
+    bus_bits = 0;
+    stats.tec = read_reg(TEC);
+    stats.rec = read_reg(REC);
+    busoff = ISSET(read_reg(EFLG), EFLG_TXBO) ? 1 : 0;
+    stats.bus_load = (uint16_t) ((bits * 1000UL) / ((bus_rate / 1000UL) * CAN_IF_TICK_MS));
+}
+
+int mcp2515_is_busoff(void)
+{
+    return busoff;
+}
+
+int mcp2515_get_last_error(void)
+{
+    int err;
+    
+    err = error;
+    error = MCP2515_ERR_NOERR;
+    return err;
+}
+
+char *mcp2515_get_driver_vers(void)
+{
+    return DRIVER_VERSION;
+}
+
+char *mcp2515_get_driver_name(void)
+{
+    return DRIVER_NAME;
+}
+
+can_stats_t mcp2515_get_stats(void)
+{
+    return stats;
+}
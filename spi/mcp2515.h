@@ -0,0 +1,74 @@
+/**
+ *
+ * File Name: mcp2515.h
+ * Title    : SPI device Microchip MCP2515 CAN controller driver
+ * Project  : lib-avr
+ * Author   : Copyright (C) 2026 Johannes Krottmayer <krjdev@gmail.com>
+ * Created  : 2026-10-19
+ * Modified : 
+ * Revised  : 
+ * Version  : 0.1.0.0
+ * License  : ISC (see file LICENSE.txt)
+ * Target   : Atmel AVR Series
+ *
+ * NOTE: This code is currently below version 1.0, and therefore is considered
+ * to be lacking in some functionality or documentation, or may not be fully
+ * tested. Nonetheless, you can expect most functions to work.
+ *
+ */
+
+#ifndef LIBAVR_SPI_MCP2515_H
+#define LIBAVR_SPI_MCP2515_H
+
+#include <stdint.h>
+#include <avr/io.h>
+
+#include "../can/can.h"
+#include "../can/can_if.h"
+
+/* MCP2515 chip select pin */
+#define MCP2515_CS_CONFIG   (DDRJ |= (1 << PJ2))
+#define MCP2515_CS_ENABLE   (PORTJ &= ~(1 << PJ2))
+#define MCP2515_CS_DISABL   (PORTJ |= (1 << PJ2))
+
+/* MCP2515 INT pin (active low), external interrupt INT4 */
+#define MCP2515_INT_CONFIG  (EICRB |= (1 << ISC41))
+#define MCP2515_INT_ENABLE  (EIMSK |= (1 << INT4))
+#define MCP2515_INT_DISABL  (EIMSK &= ~(1 << INT4))
+#define MCP2515_INT_vect    INT4_vect
+#define MCP2515_INT_LOW     (!(PINE & (1 << PINE4)))
+
+/* MCP2515 oscillator */
+#define MCP2515_F_OSC       16000000UL
+
+/* Software queues (frames) */
+#define MCP2515_RXQ_LEN     8
+#define MCP2515_TXQ_LEN     8
+
+/* MCP2515 operation modes */
+#define MCP2515_MODE_NORMAL     0
+#define MCP2515_MODE_LOOPBACK   2
+#define MCP2515_MODE_LISTEN     3
+
+/* MCP2515 Error codes */
+#define MCP2515_ERR_NOERR       0
+#define MCP2515_ERR_INVAL       1
+#define MCP2515_ERR_TIMEO       2
+#define MCP2515_ERR_BITRATE     3
+#define MCP2515_ERR_TXFULL      4
+#define MCP2515_ERR_BUSOFF      5
+
+extern int mcp2515_init(uint32_t bitrate, int mode);
+extern int mcp2515_set_filters(can_filter_t *rules, int num);
+extern int mcp2515_send(can_frame_t *frame);
+extern int mcp2515_recv(can_frame_t *frame);
+extern void mcp2515_isr(void);
+extern void mcp2515_poll(void);
+extern void mcp2515_tick(void);
+extern int mcp2515_is_busoff(void);
+extern int mcp2515_get_last_error(void);
+extern char *mcp2515_get_driver_vers(void);
+extern char *mcp2515_get_driver_name(void);
+extern can_stats_t mcp2515_get_stats(void);
+
+#endif